@@ -635,6 +635,45 @@ is_bridge_pvid_changed(NMDevice *device, NMSettingBridge *s_bridge)
     }
 }
 
+static NMPlatformBridgeVlan *
+merge_bridge_vlan_default_pvid(NMPlatformBridgeVlan *vlans, guint *num_vlans, guint default_pvid)
+{
+    NMPlatformBridgeVlan *vlan;
+    gboolean              has_pvid = FALSE;
+    guint                 i;
+
+    for (i = 0; i < *num_vlans; i++) {
+        if (vlans[i].pvid) {
+            has_pvid = TRUE;
+            break;
+        }
+    }
+
+    /* search if the list of VLANs already contains the default PVID */
+    vlan = NULL;
+    for (i = 0; i < *num_vlans; i++) {
+        if (default_pvid >= vlans[i].vid_start && default_pvid <= vlans[i].vid_end) {
+            vlan = &vlans[i];
+            break;
+        }
+    }
+
+    if (!vlan) {
+        /* VLAN id not found, append the default PVID at the end.
+         * Set the PVID flag only if the port didn't have one. */
+        vlans = g_realloc_n(vlans, *num_vlans + 1, sizeof(NMPlatformBridgeVlan));
+        (*num_vlans)++;
+        vlans[*num_vlans - 1] = (NMPlatformBridgeVlan) {
+            .vid_start = default_pvid,
+            .vid_end   = default_pvid,
+            .untagged  = TRUE,
+            .pvid      = !has_pvid,
+        };
+    }
+
+    return vlans;
+}
+
 static gboolean
 bridge_set_vlan_options(NMDevice *device, NMSettingBridge *s_bridge, gboolean is_reapply)
 {
@@ -648,6 +687,7 @@ bridge_set_vlan_options(NMDevice *device, NMSettingBridge *s_bridge, gboolean is
     gs_unref_ptrarray GPtrArray  *vlans      = NULL;
     gs_free NMPlatformBridgeVlan *plat_vlans = NULL;
     guint                         num_vlans;
+    gboolean                      reset_vlans;
 
     if (self->vlan_configured)
         return TRUE;
@@ -678,7 +718,8 @@ bridge_set_vlan_options(NMDevice *device, NMSettingBridge *s_bridge, gboolean is
 
     self->vlan_configured = TRUE;
 
-    if (!is_reapply || is_bridge_pvid_changed(device, s_bridge)) {
+    reset_vlans = !is_reapply || is_bridge_pvid_changed(device, s_bridge);
+    if (reset_vlans) {
         /* Filtering must be disabled to change the default PVID.
          * Clear the default PVID so that we later can force the re-creation of
          * default PVID VLANs by writing the option again. */
@@ -715,9 +756,19 @@ bridge_set_vlan_options(NMDevice *device, NMSettingBridge *s_bridge, gboolean is
      * any PVID VLAN overrides the bridge's default PVID. */
     g_object_get(s_bridge, NM_SETTING_BRIDGE_VLANS, &vlans, NULL);
     plat_vlans = setting_vlans_to_platform(vlans, &num_vlans);
-    if (plat_vlans
-        && !nm_platform_link_set_bridge_vlans(plat, ifindex, FALSE, plat_vlans, num_vlans))
-        return FALSE;
+    if (reset_vlans) {
+        if (plat_vlans
+            && !nm_platform_link_set_bridge_vlans(plat, ifindex, FALSE, plat_vlans, num_vlans))
+            return FALSE;
+    } else {
+        /* The default PVID didn't change, so the kernel keeps its VLAN on the
+         * bridge. Only send the VLANs that differ from the current ones. */
+        pvid = nm_setting_bridge_get_vlan_default_pvid(s_bridge);
+        if (pvid)
+            plat_vlans = merge_bridge_vlan_default_pvid(plat_vlans, &num_vlans, pvid);
+        if (!nm_platform_link_sync_bridge_vlans(plat, ifindex, FALSE, plat_vlans, num_vlans))
+            return FALSE;
+    }
 
     nm_platform_link_set_bridge_info(plat,
                                      ifindex,
@@ -729,45 +780,6 @@ bridge_set_vlan_options(NMDevice *device, NMSettingBridge *s_bridge, gboolean is
     return TRUE;
 }
 
-static NMPlatformBridgeVlan *
-merge_bridge_vlan_default_pvid(NMPlatformBridgeVlan *vlans, guint *num_vlans, guint default_pvid)
-{
-    NMPlatformBridgeVlan *vlan;
-    gboolean              has_pvid = FALSE;
-    guint                 i;
-
-    for (i = 0; i < *num_vlans; i++) {
-        if (vlans[i].pvid) {
-            has_pvid = TRUE;
-            break;
-        }
-    }
-
-    /* search if the list of VLANs already contains the default PVID */
-    vlan = NULL;
-    for (i = 0; i < *num_vlans; i++) {
-        if (default_pvid >= vlans[i].vid_start && default_pvid <= vlans[i].vid_end) {
-            vlan = &vlans[i];
-            break;
-        }
-    }
-
-    if (!vlan) {
-        /* VLAN id not found, append the default PVID at the end.
-         * Set the PVID flag only if the port didn't have one. */
-        vlans = g_realloc_n(vlans, *num_vlans + 1, sizeof(NMPlatformBridgeVlan));
-        (*num_vlans)++;
-        vlans[*num_vlans - 1] = (NMPlatformBridgeVlan) {
-            .vid_start = default_pvid,
-            .vid_end   = default_pvid,
-            .untagged  = TRUE,
-            .pvid      = !has_pvid,
-        };
-    }
-
-    return vlans;
-}
-
 void
 nm_device_reapply_bridge_port_vlans(NMDevice *device)
 {
@@ -777,12 +789,9 @@ nm_device_reapply_bridge_port_vlans(NMDevice *device)
     NMSettingBridge              *s_bridge;
     gs_unref_ptrarray GPtrArray  *tmp_vlans         = NULL;
     gs_free NMPlatformBridgeVlan *setting_vlans     = NULL;
-    gs_free NMPlatformBridgeVlan *plat_vlans        = NULL;
     guint                         num_setting_vlans = 0;
-    guint                         num_plat_vlans    = 0;
     NMPlatform                   *plat;
     int                           ifindex;
-    gboolean                      do_reapply;
 
     s_bridge_port = nm_device_get_applied_setting(device, NM_TYPE_SETTING_BRIDGE_PORT);
     if (!s_bridge_port)
@@ -815,33 +824,14 @@ nm_device_reapply_bridge_port_vlans(NMDevice *device)
     plat    = nm_device_get_platform(device);
     ifindex = nm_device_get_ifindex(device);
 
-    if (!nm_platform_link_get_bridge_vlans(plat, ifindex, &plat_vlans, &num_plat_vlans)) {
-        _LOGD(LOGD_DEVICE, "reapply-bridge-port-vlans: can't get current VLANs from platform");
-        do_reapply = TRUE;
-    } else {
-        nmp_utils_bridge_vlan_normalize(setting_vlans, &num_setting_vlans);
-        nmp_utils_bridge_vlan_normalize(plat_vlans, &num_plat_vlans);
-        if (!nmp_utils_bridge_normalized_vlans_equal(setting_vlans,
-                                                     num_setting_vlans,
-                                                     plat_vlans,
-                                                     num_plat_vlans)) {
-            _LOGD(LOGD_DEVICE, "reapply-bridge-port-vlans: VLANs in platform need reapply");
-            do_reapply = TRUE;
-        } else {
-            _LOGD(LOGD_DEVICE, "reapply-bridge-port-vlans: VLANs in platform didn't change");
-            do_reapply = FALSE;
-        }
-    }
-
-    if (do_reapply) {
-        nm_platform_link_set_bridge_vlans(plat, ifindex, TRUE, NULL, 0);
-        if (num_setting_vlans > 0)
-            nm_platform_link_set_bridge_vlans(plat,
-                                              ifindex,
-                                              TRUE,
-                                              setting_vlans,
-                                              num_setting_vlans);
-    }
+    /* Only the VLANs that differ from the ones in platform are changed. The
+     * others stay configured and keep forwarding traffic. */
+    if (!nm_platform_link_sync_bridge_vlans(plat,
+                                            ifindex,
+                                            TRUE,
+                                            setting_vlans,
+                                            num_setting_vlans))
+        _LOGD(LOGD_DEVICE, "reapply-bridge-port-vlans: failure to sync VLANs");
 }
 
 static void
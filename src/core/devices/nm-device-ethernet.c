@@ -2033,6 +2033,13 @@ static const NMDBusInterfaceInfoExtended interface_info_device_wired = {
                 .annotations = NM_GDBUS_ANNOTATION_INFO_LIST_DEPRECATED(), ), ), ),
 };
 
+/* See check_connection_compatible(). */
+static const char *const connection_types_check_compatible[] = {
+    NM_SETTING_WIRED_SETTING_NAME,
+    NM_SETTING_PPPOE_SETTING_NAME,
+    NULL,
+};
+
 static void
 nm_device_ethernet_class_init(NMDeviceEthernetClass *klass)
 {
@@ -2052,6 +2059,8 @@ nm_device_ethernet_class_init(NMDeviceEthernetClass *klass)
     device_class->connection_type_supported = NM_SETTING_WIRED_SETTING_NAME;
     device_class->link_types                = NM_DEVICE_DEFINE_LINK_TYPES(NM_LINK_TYPE_ETHERNET);
 
+    device_class->connection_types_check_compatible = connection_types_check_compatible;
+
     device_class->get_generic_capabilities    = get_generic_capabilities;
     device_class->check_connection_compatible = check_connection_compatible;
     device_class->complete_connection         = complete_connection;
@@ -182,6 +182,14 @@ static const NMDBusInterfaceInfoExtended interface_info_device_veth = {
             NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE("Peer", "o", NM_DEVICE_VETH_PEER), ), ),
 };
 
+/* See check_connection_compatible() of NMDeviceEthernet. */
+static const char *const connection_types_check_compatible[] = {
+    NM_SETTING_WIRED_SETTING_NAME,
+    NM_SETTING_PPPOE_SETTING_NAME,
+    NM_SETTING_VETH_SETTING_NAME,
+    NULL,
+};
+
 static void
 nm_device_veth_class_init(NMDeviceVethClass *klass)
 {
@@ -196,6 +204,8 @@ nm_device_veth_class_init(NMDeviceVethClass *klass)
     device_class->connection_type_supported = NULL;
     device_class->link_types                = NM_DEVICE_DEFINE_LINK_TYPES(NM_LINK_TYPE_VETH);
 
+    device_class->connection_types_check_compatible = connection_types_check_compatible;
+
     device_class->can_unmanaged_external_down = can_unmanaged_external_down;
     device_class->link_changed                = link_changed;
     device_class->parent_changed_notify       = parent_changed_notify;
@@ -1026,13 +1026,12 @@ _peers_remove_all(NMDeviceWireGuard *self)
 }
 
 static void
-_peers_update_all(NMDeviceWireGuard *self, NMSettingWireGuard *s_wg, gboolean *out_peers_removed)
+_peers_update_all(NMDeviceWireGuard *self, NMSettingWireGuard *s_wg)
 {
     NMDeviceWireGuardPrivate *priv = NM_DEVICE_WIREGUARD_GET_PRIVATE(self);
     PeerData                 *peer_data_safe;
     PeerData                 *peer_data;
     guint                     i, n;
-    gboolean                  peers_removed = FALSE;
 
     c_list_for_each_entry (peer_data, &priv->lst_peers_head, lst_peers)
         peer_data->dirty_update_all = TRUE;
@@ -1052,13 +1051,9 @@ _peers_update_all(NMDeviceWireGuard *self, NMSettingWireGuard *s_wg, gboolean *o
     }
 
     c_list_for_each_entry_safe (peer_data, peer_data_safe, &priv->lst_peers_head, lst_peers) {
-        if (peer_data->dirty_update_all) {
+        if (peer_data->dirty_update_all)
             _peers_remove(self, peer_data);
-            peers_removed = TRUE;
-        }
     }
-
-    NM_SET_OUT(out_peers_removed, peers_removed);
 }
 
 static void
@@ -1432,7 +1427,6 @@ link_config(NMDeviceWireGuard   *self,
     gs_free NMPlatformWireGuardChangePeerFlags *plpeer_flags = NULL;
     guint                                       plpeers_len  = 0;
     const char                                 *setting_name;
-    gboolean                                    peers_removed;
     NMPlatformWireGuardChangeFlags              wg_change_flags;
     int                                         ifindex;
     int                                         r;
@@ -1484,15 +1478,18 @@ link_config(NMDeviceWireGuard   *self,
         return NM_ACT_STAGE_RETURN_FAILURE;
     }
 
-    _peers_update_all(self, s_wg, &peers_removed);
+    _peers_update_all(self, s_wg);
 
     wg_lnk = (NMPlatformLnkWireGuard) {};
 
     wg_change_flags = NM_PLATFORM_WIREGUARD_CHANGE_FLAG_NONE;
 
-    if (NM_IN_SET(config_mode, LINK_CONFIG_MODE_FULL)
-        || (NM_IN_SET(config_mode, LINK_CONFIG_MODE_REAPPLY) && peers_removed))
+    /* On reapply, only send the peers that changed. That also removes the
+     * peers that are no longer in the profile. */
+    if (NM_IN_SET(config_mode, LINK_CONFIG_MODE_FULL))
         wg_change_flags |= NM_PLATFORM_WIREGUARD_CHANGE_FLAG_REPLACE_PEERS;
+    else if (NM_IN_SET(config_mode, LINK_CONFIG_MODE_REAPPLY))
+        wg_change_flags |= NM_PLATFORM_WIREGUARD_CHANGE_FLAG_SYNC_PEERS;
 
     if (NM_IN_SET(config_mode, LINK_CONFIG_MODE_FULL, LINK_CONFIG_MODE_REAPPLY)) {
         wg_lnk.listen_port = nm_setting_wireguard_get_listen_port(s_wg);
@@ -761,10 +761,9 @@ typedef struct _NMDevicePrivate {
     guint sriov_reset_pending;
 
     struct {
-        GSource *timeout_source;
-        guint    refresh_rate_ms;
-        guint64  tx_bytes;
-        guint64  rx_bytes;
+        guint   refresh_rate_ms;
+        guint64 tx_bytes;
+        guint64 rx_bytes;
     } stats;
 
     bool mtu_force_set_done : 1;
@@ -832,6 +831,7 @@ static void realize_start_setup(NMDevice             *self,
 static void _set_mtu(NMDevice *self, guint32 mtu);
 static void _commit_mtu(NMDevice *self);
 static void _cancel_activation(NMDevice *self);
+static void _stats_refresh_schedule(NMDevice *self);
 
 static void _dev_ipll4_check_fallback(NMDevice *self, const NML3ConfigData *l3cd_new);
 static void _dev_ipll4_notify_event(NMDevice *self);
@@ -5026,6 +5026,8 @@ _set_ifindex(NMDevice *self, int ifindex, gboolean is_ip_ifindex)
         _cleanup_ip_pre(self, AF_INET6, CLEANUP_TYPE_KEEP, FALSE);
     }
 
+    _stats_refresh_schedule(self);
+
     _LOGD(LOGD_DEVICE,
           "ifindex: set %sifindex %d%s%s%s%s%s%s",
           is_ip_ifindex ? "ip-" : "",
@@ -5507,22 +5509,6 @@ _stats_update_counters_from_pllink(NMDevice *self, const NMPlatformLink *pllink)
     _stats_update_counters(self, pllink->tx_bytes, pllink->rx_bytes);
 }
 
-static gboolean
-_stats_timeout_cb(gpointer user_data)
-{
-    NMDevice *self = user_data;
-    int       ifindex;
-
-    ifindex = nm_device_get_ip_ifindex(self);
-
-    _LOGT(LOGD_DEVICE, "stats: refresh %d", ifindex);
-
-    if (ifindex > 0)
-        nm_platform_link_refresh(nm_device_get_platform(self), ifindex);
-
-    return G_SOURCE_CONTINUE;
-}
-
 static guint
 _stats_refresh_rate_real(guint refresh_rate_ms)
 {
@@ -5540,6 +5526,19 @@ _stats_refresh_rate_real(guint refresh_rate_ms)
     return refresh_rate_ms;
 }
 
+static void
+_stats_refresh_schedule(NMDevice *self)
+{
+    NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE(self);
+
+    /* The platform refreshes the statistics of all devices that are due
+     * at the same time together. The result reaches us via device_link_changed(). */
+    nm_platform_link_stats_set_refresh(nm_device_get_platform(self),
+                                       self,
+                                       nm_device_is_real(self) ? nm_device_get_ip_ifindex(self) : 0,
+                                       _stats_refresh_rate_real(priv->stats.refresh_rate_ms));
+}
+
 static void
 _stats_set_refresh_rate(NMDevice *self, guint refresh_rate_ms)
 {
@@ -5565,7 +5564,7 @@ _stats_set_refresh_rate(NMDevice *self, guint refresh_rate_ms)
     if (_stats_refresh_rate_real(old_rate) == refresh_rate_ms)
         return;
 
-    nm_clear_g_source_inst(&priv->stats.timeout_source);
+    _stats_refresh_schedule(self);
 
     if (!refresh_rate_ms)
         return;
@@ -5576,8 +5575,6 @@ _stats_set_refresh_rate(NMDevice *self, guint refresh_rate_ms)
     ifindex = nm_device_get_ip_ifindex(self);
     if (ifindex > 0)
         nm_platform_link_refresh(nm_device_get_platform(self), ifindex);
-
-    priv->stats.timeout_source = nm_g_timeout_add_source(refresh_rate_ms, _stats_timeout_cb, self);
 }
 
 /*****************************************************************************/
@@ -8225,7 +8222,6 @@ realize_start_setup(NMDevice             *self,
     NMPlatform          *platform;
     NMDeviceCapabilities capabilities = 0;
     NMConfig            *config;
-    guint                refresh_rate_ms;
     gboolean             unmanaged;
 
     /* plink is a NMPlatformLink type, however, we require it to come from the platform
@@ -8329,12 +8325,7 @@ realize_start_setup(NMDevice             *self,
 
     nm_device_set_carrier_from_platform(self);
 
-    nm_assert(!priv->stats.timeout_source);
-    refresh_rate_ms = _stats_refresh_rate_real(priv->stats.refresh_rate_ms);
-    if (refresh_rate_ms > 0) {
-        priv->stats.timeout_source =
-            nm_g_timeout_add_source(refresh_rate_ms, _stats_timeout_cb, self);
-    }
+    _stats_refresh_schedule(self);
 
     klass->realize_start_notify(self, plink);
 
@@ -8509,7 +8500,7 @@ nm_device_unrealize(NMDevice *self, gboolean remove_resources, GError **error)
         _notify(self, PROP_PHYSICAL_PORT_ID);
     }
 
-    nm_clear_g_source_inst(&priv->stats.timeout_source);
+    _stats_refresh_schedule(self);
     _stats_update_counters(self, 0, 0);
 
     priv->hw_addr_len_ = 0;
@@ -9822,6 +9813,38 @@ nm_device_check_connection_compatible(NMDevice     *self,
                                                                   error);
 }
 
+/**
+ * nm_device_get_connection_type_check_compatible:
+ * @self: the #NMDevice
+ *
+ * Returns: if not %NULL, nm_device_check_connection_compatible() rejects all
+ *   profiles that are not of this connection.type.
+ */
+const char *
+nm_device_get_connection_type_check_compatible(NMDevice *self)
+{
+    g_return_val_if_fail(NM_IS_DEVICE(self), NULL);
+
+    return NM_DEVICE_GET_CLASS(self)->connection_type_check_compatible;
+}
+
+/**
+ * nm_device_get_connection_types_check_compatible:
+ * @self: the #NMDevice
+ *
+ * Returns: if not %NULL, a %NULL terminated list of connection.type values.
+ *   nm_device_check_connection_compatible() rejects all profiles of other
+ *   types. This is only set for device types that handle several types, see
+ *   nm_device_get_connection_type_check_compatible().
+ */
+const char *const *
+nm_device_get_connection_types_check_compatible(NMDevice *self)
+{
+    g_return_val_if_fail(NM_IS_DEVICE(self), NULL);
+
+    return NM_DEVICE_GET_CLASS(self)->connection_types_check_compatible;
+}
+
 gboolean
 nm_device_check_port_connection_compatible(NMDevice *self, NMConnection *port)
 {
@@ -10655,7 +10678,11 @@ tc_commit(NMDevice *self)
     qdiscs   = nm_utils_qdiscs_from_tc_setting(platform, s_tc, ip_ifindex);
     tfilters = nm_utils_tfilters_from_tc_setting(platform, s_tc, ip_ifindex);
 
-    if (!nm_platform_tc_sync(platform, ip_ifindex, qdiscs, tfilters))
+    if (!nm_platform_tc_sync(platform,
+                             ip_ifindex,
+                             qdiscs,
+                             tfilters,
+                             NM_PLATFORM_TC_SYNC_MODE_RECONCILE))
         return FALSE;
 
     return TRUE;
@@ -16854,7 +16881,11 @@ nm_device_cleanup(NMDevice *self, NMDeviceStateReason reason, CleanupType cleanu
             nm_device_l3cfg_commit(self, NM_L3_CFG_COMMIT_TYPE_REAPPLY, TRUE);
 
             if (nm_device_get_applied_setting(self, NM_TYPE_SETTING_TC_CONFIG)) {
-                nm_platform_tc_sync(platform, ifindex, NULL, NULL);
+                nm_platform_tc_sync(platform,
+                                    ifindex,
+                                    NULL,
+                                    NULL,
+                                    NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL);
             }
         }
     }
@@ -19262,7 +19293,7 @@ dispose(GObject *object)
 
     nm_clear_g_source(&priv->check_delete_unrealized_id);
 
-    nm_clear_g_source_inst(&priv->stats.timeout_source);
+    nm_platform_link_stats_set_refresh(nm_device_get_platform(self), self, 0, 0);
 
     carrier_disconnected_action_cancel(self);
 
@@ -180,6 +180,11 @@ typedef struct _NMDeviceClass {
      * is the connection.type setting, as checked by nm_device_check_connection_compatible() */
     const char *connection_type_check_compatible;
 
+    /* some device types can handle profiles of several, but not of all types. If
+     * connection_type_check_compatible is unset, this is the NULL terminated list of
+     * the connection.type settings that check_connection_compatible() accepts. */
+    const char *const *connection_types_check_compatible;
+
     const NMLinkType *link_types;
 
     /* if the device MTU is set based on parent's one, this specifies
@@ -550,6 +555,10 @@ gboolean nm_device_check_connection_compatible(NMDevice     *device,
                                                GError      **error);
 
 gboolean nm_device_check_port_connection_compatible(NMDevice *device, NMConnection *connection);
+
+const char        *nm_device_get_connection_type_check_compatible(NMDevice *self);
+const char *const *nm_device_get_connection_types_check_compatible(NMDevice *self);
+
 gboolean nm_device_can_be_parent(NMDevice *device);
 
 gboolean nm_device_can_assume_connections(NMDevice *self);
@@ -886,6 +886,11 @@ static const ConfigGroup config_groups[] = {
         .group = NM_CONFIG_KEYFILE_GROUP_IFUPDOWN,
         .keys  = NM_MAKE_STRV(NM_CONFIG_KEYFILE_KEY_IFUPDOWN_MANAGED, ),
     },
+    {
+        .group = NM_CONFIG_KEYFILE_GROUP_PLATFORM,
+        .keys  = NM_MAKE_STRV(NM_CONFIG_KEYFILE_KEY_PLATFORM_ROUTE_TABLES,
+                             NM_CONFIG_KEYFILE_KEY_PLATFORM_NETLINK_THREAD, ),
+    },
     {
         .group     = NM_CONFIG_KEYFILE_GROUPPREFIX_DEVICE,
         .is_prefix = TRUE,
@@ -126,6 +126,11 @@ struct _NML3ConfigData {
 
     NMIPConfigSource source;
 
+    /* A hash over everything that nm_l3_config_data_cmp() considers. It is
+     * only computed for sealed instances, when first needed. See
+     * @content_hash_valid. */
+    guint64 content_hash;
+
     int ndisc_hop_limit_val;
 
     guint32 mtu;
@@ -152,6 +157,7 @@ struct _NML3ConfigData {
     NMMptcpFlags mptcp_flags : 18;
 
     bool is_sealed : 1;
+    bool content_hash_valid : 1;
 
     bool has_routes_with_type_local_4_set : 1;
     bool has_routes_with_type_local_6_set : 1;
@@ -720,6 +726,129 @@ nm_l3_config_data_new(NMDedupMultiIndex *multi_idx, int ifindex, NMIPConfigSourc
     return self;
 }
 
+static guint64
+_content_hash_compute(const NML3ConfigData *self)
+{
+    static const NMPObjectType obj_types[] = {
+        NMP_OBJECT_TYPE_IP4_ADDRESS,
+        NMP_OBJECT_TYPE_IP6_ADDRESS,
+        NMP_OBJECT_TYPE_IP4_ROUTE,
+        NMP_OBJECT_TYPE_IP6_ROUTE,
+    };
+    NMHashState h;
+    int         IS_IPv4;
+    guint       i;
+
+    /* This must be consistent with nm_l3_config_data_cmp_full(NM_L3_CONFIG_CMP_FLAGS_ALL):
+     * instances that compare equal must have the same hash. */
+
+    nm_hash_init(&h, 1786549053u);
+
+    nm_hash_update_val(&h, self->ifindex);
+
+    for (i = 0; i < G_N_ELEMENTS(obj_types); i++) {
+        NMDedupMultiIter iter;
+        const NMPObject *obj;
+
+        nm_hash_update_val(&h, (guint) nm_l3_config_data_get_num_objs(self, obj_types[i]));
+        nm_l3_config_data_iter_obj_for_each (&iter, self, &obj, obj_types[i])
+            nmp_object_hash_update(obj, &h);
+    }
+
+    for (IS_IPv4 = 1; IS_IPv4 >= 0; IS_IPv4--) {
+        const NML3ConfigDatFlags FLAG = NM_L3_CONFIG_DAT_FLAGS_HAS_DNS_PRIORITY(IS_IPv4);
+        GPtrArray *const        *strvs[] = {
+            &self->nameservers_x[IS_IPv4],
+            &self->domains_x[IS_IPv4],
+            &self->searches_x[IS_IPv4],
+            &self->dns_options_x[IS_IPv4],
+        };
+        GHashTable    *options;
+        GHashTableIter h_iter;
+        const char    *key;
+        const char    *val;
+        guint64        options_hash = 0;
+
+        if (self->best_default_route_x[IS_IPv4])
+            nmp_object_hash_update(self->best_default_route_x[IS_IPv4], &h);
+        else
+            nm_hash_update_val(&h, (guint) 0);
+
+        for (i = 0; i < G_N_ELEMENTS(strvs); i++) {
+            const GPtrArray *strv = *strvs[i];
+            guint            j;
+
+            /* NULL and empty arrays compare equal. */
+            nm_hash_update_val(&h, nm_g_ptr_array_len(strv));
+            for (j = 0; j < nm_g_ptr_array_len(strv); j++)
+                nm_hash_update_str0(&h, strv->pdata[j]);
+        }
+
+        if (NM_FLAGS_ANY(self->flags, FLAG))
+            nm_hash_update_val(&h, self->dns_priority_x[IS_IPv4]);
+
+        /* The lease options are compared regardless of their order. */
+        options = nm_dhcp_lease_get_options(self->dhcp_lease_x[IS_IPv4]);
+        if (options) {
+            g_hash_table_iter_init(&h_iter, options);
+            while (g_hash_table_iter_next(&h_iter, (gpointer *) &key, (gpointer *) &val)) {
+                NMHashState h_opt;
+
+                nm_hash_init(&h_opt, 1786549053u);
+                nm_hash_update_str0(&h_opt, key);
+                nm_hash_update_str0(&h_opt, val);
+                options_hash += nm_hash_complete_u64(&h_opt);
+            }
+        }
+        nm_hash_update_vals(&h,
+                            (guint) nm_g_hash_table_size(options),
+                            options_hash,
+                            self->route_table_sync_x[IS_IPv4],
+                            self->never_default_x[IS_IPv4]);
+    }
+
+    nm_hash_update_val(&h, nm_g_array_len(self->wins));
+    if (nm_g_array_len(self->wins) > 0)
+        nm_hash_update(&h, self->wins->data, self->wins->len * sizeof(in_addr_t));
+    nm_hash_update_val(&h, nm_g_array_len(self->nis_servers));
+    if (nm_g_array_len(self->nis_servers) > 0)
+        nm_hash_update(&h, self->nis_servers->data, self->nis_servers->len * sizeof(in_addr_t));
+
+    nm_hash_update_str0(&h, nm_ref_string_get_str(self->nis_domain));
+    nm_hash_update_str0(&h, nm_ref_string_get_str(self->proxy_pac_url));
+    nm_hash_update_str0(&h, nm_ref_string_get_str(self->proxy_pac_script));
+
+    nm_hash_update_vals(&h,
+                        self->mdns,
+                        self->llmnr,
+                        self->dns_over_tls,
+                        self->flags,
+                        self->ip6_token.id,
+                        self->mtu,
+                        self->ip6_mtu,
+                        (int) self->metered,
+                        (int) self->proxy_browser_only,
+                        (int) self->proxy_method,
+                        (int) self->ip6_privacy,
+                        (guint32) self->mptcp_flags,
+                        self->source);
+
+    nm_hash_update_bools(&h,
+                         self->ndisc_hop_limit_set,
+                         self->ndisc_reachable_time_msec_set,
+                         self->ndisc_retrans_timer_msec_set,
+                         self->routed_dns_4,
+                         self->routed_dns_6);
+    if (self->ndisc_hop_limit_set)
+        nm_hash_update_val(&h, self->ndisc_hop_limit_val);
+    if (self->ndisc_reachable_time_msec_set)
+        nm_hash_update_val(&h, self->ndisc_reachable_time_msec_val);
+    if (self->ndisc_retrans_timer_msec_set)
+        nm_hash_update_val(&h, self->ndisc_retrans_timer_msec_val);
+
+    return nm_hash_complete_u64(&h);
+}
+
 const NML3ConfigData *
 nm_l3_config_data_ref(const NML3ConfigData *self)
 {
@@ -758,6 +887,20 @@ nm_l3_config_data_is_sealed(const NML3ConfigData *self)
     return self->is_sealed;
 }
 
+guint64
+nm_l3_config_data_get_content_hash(const NML3ConfigData *self)
+{
+    nm_assert(_NM_IS_L3_CONFIG_DATA(self, TRUE));
+    nm_assert(self->is_sealed);
+
+    /* The instance is immutable, so the hash is computed only once. */
+    if (!self->content_hash_valid) {
+        ((NML3ConfigData *) self)->content_hash       = _content_hash_compute(self);
+        ((NML3ConfigData *) self)->content_hash_valid = TRUE;
+    }
+    return self->content_hash;
+}
+
 void
 nm_l3_config_data_unref(const NML3ConfigData *self)
 {
@@ -2493,6 +2636,7 @@ nm_l3_config_data_cmp_full(const NML3ConfigData *a,
      * - multi_idx
      * - ref_count
      * - is_sealed
+     * - content_hash, content_hash_valid
      */
 
     return 0;
@@ -125,6 +125,8 @@ nm_l3_config_data_reset_take(const NML3ConfigData **dst, const NML3ConfigData *s
 
 gboolean nm_l3_config_data_is_sealed(const NML3ConfigData *self);
 
+guint64 nm_l3_config_data_get_content_hash(const NML3ConfigData *self);
+
 NML3ConfigData *nm_l3_config_data_new_clone(const NML3ConfigData *src, int ifindex);
 
 NML3ConfigData *nm_l3_config_data_new_from_connection(NMDedupMultiIndex *multi_idx,
@@ -220,6 +222,12 @@ nm_l3_config_data_cmp(const NML3ConfigData *a, const NML3ConfigData *b)
 static inline gboolean
 nm_l3_config_data_equal(const NML3ConfigData *a, const NML3ConfigData *b)
 {
+    /* Sealed instances have a content hash, computed on first use. If it differs,
+     * they cannot be equal and we can avoid comparing all addresses and routes. */
+    if (a && b && a != b && nm_l3_config_data_is_sealed(a) && nm_l3_config_data_is_sealed(b)
+        && nm_l3_config_data_get_content_hash(a) != nm_l3_config_data_get_content_hash(b))
+        return FALSE;
+
     return nm_l3_config_data_cmp(a, b) == 0;
 }
 
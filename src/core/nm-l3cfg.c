@@ -254,6 +254,19 @@ typedef struct _NML3CfgPrivate {
 
     const NML3ConfigData *combined_l3cd_commited;
 
+    /* The sorted l3_config_datas that were last merged into combined_l3cd_merged,
+     * and the (sealed) result of merging only the first merge_prefix_len of them.
+     * On the next update, merging can resume after the prefix that did not change. */
+    L3ConfigData         *merge_inputs;
+    const NML3ConfigData *merge_prefix_l3cd;
+    guint                 merge_inputs_len;
+    guint                 merge_prefix_len;
+    guint                 merge_prefix_acd_generation;
+
+    /* Bumped whenever an AcdData gets added, removed or changes its state. The
+     * result of merging depends on that. */
+    guint acd_generation;
+
     CList commit_type_lst_head;
 
     GHashTable *obj_state_hash;
@@ -302,7 +315,17 @@ typedef struct _NML3CfgPrivate {
     /* This is for rate-limiting the creation of nacd instance. */
     GSource *nacd_instance_ensure_retry;
 
-    GSource *commit_on_idle_source;
+    /* The state of a commit between _l3_commit_begin() and _l3_commit_finish().
+     * The route changes are only prepared by _l3_commit_begin(). When committing
+     * on idle, NMNetns sends the route changes of all NML3Cfg instances together,
+     * before completing the commits. */
+    struct {
+        const NML3ConfigData  *l3cd_old;
+        NMPlatformIPRouteSync *route_sync_x[2];
+        NML3CfgCommitType      commit_type;
+        bool                   changed_combined_l3cd : 1;
+        bool                   pending : 1;
+    } commit_state;
 
     guint64 pseudo_timestamp_counter;
 
@@ -352,6 +375,8 @@ typedef struct _NML3CfgPrivate {
     bool changed_configs_configs : 1;
     bool changed_configs_acd_state : 1;
 
+    bool merge_prefix_to_commit : 1;
+
     bool rp_filter_handled : 1;
     bool rp_filter_set : 1;
 } NML3CfgPrivate;
@@ -1147,15 +1172,32 @@ _obj_states_track_prune_dirty(NML3Cfg *self, gboolean also_dynamic)
     }
 }
 
+static const NMPObjectType _obj_states_obj_types[] = {
+    NMP_OBJECT_TYPE_IP4_ADDRESS,
+    NMP_OBJECT_TYPE_IP6_ADDRESS,
+    NMP_OBJECT_TYPE_IP4_ROUTE,
+    NMP_OBJECT_TYPE_IP6_ROUTE,
+};
+
+static gboolean
+_obj_states_track_skip(const NMPObject *obj)
+{
+    if (_obj_is_route_nodev(obj)) {
+        /* this is a nodev route. We don't track an obj-state for this. */
+        return TRUE;
+    }
+    if (NMP_OBJECT_GET_TYPE(obj) == NMP_OBJECT_TYPE_IP4_ROUTE
+        && NMP_OBJECT_CAST_IP4_ROUTE(obj)->weight > 0) {
+        /* this route weight is bigger than 0, that means we don't know
+         * which kind of route this will be. It can only be determined during commit. */
+        return TRUE;
+    }
+    return FALSE;
+}
+
 static void
 _obj_states_update_all(NML3Cfg *self)
 {
-    static const NMPObjectType obj_types[] = {
-        NMP_OBJECT_TYPE_IP4_ADDRESS,
-        NMP_OBJECT_TYPE_IP6_ADDRESS,
-        NMP_OBJECT_TYPE_IP4_ROUTE,
-        NMP_OBJECT_TYPE_IP6_ROUTE,
-    };
     ObjStateData *obj_state;
     int           i;
     gboolean      any_dirty = FALSE;
@@ -1164,8 +1206,8 @@ _obj_states_update_all(NML3Cfg *self)
 
     any_dirty = _obj_states_track_mark_dirty(self, FALSE);
 
-    for (i = 0; i < (int) G_N_ELEMENTS(obj_types); i++) {
-        const NMPObjectType obj_type = obj_types[i];
+    for (i = 0; i < (int) G_N_ELEMENTS(_obj_states_obj_types); i++) {
+        const NMPObjectType obj_type = _obj_states_obj_types[i];
         NMDedupMultiIter    o_iter;
         const NMPObject    *obj;
 
@@ -1176,21 +1218,77 @@ _obj_states_update_all(NML3Cfg *self)
                                              self->priv.p->combined_l3cd_commited,
                                              &obj,
                                              obj_type) {
-            if (_obj_is_route_nodev(obj)) {
-                /* this is a nodev route. We don't track an obj-state for this. */
+            if (_obj_states_track_skip(obj))
                 continue;
-            }
-            if (obj_type == NMP_OBJECT_TYPE_IP4_ROUTE
-                && NMP_OBJECT_CAST_IP4_ROUTE(obj)->weight > 0) {
-                /* this route weight is bigger than 0, that means we don't know
-                 * which kind of route this will be. It can only be determined during commit. */
+            obj_state = g_hash_table_lookup(self->priv.p->obj_state_hash, &obj);
+            if (!obj_state) {
+                _obj_states_track_new(self, obj, FALSE);
                 continue;
             }
+
+            _obj_states_track_update(self, obj_state, obj, FALSE);
+        }
+    }
+
+    if (any_dirty)
+        _obj_states_track_prune_dirty(self, FALSE);
+}
+
+static void
+_obj_states_update_delta(NML3Cfg *self, const NML3ConfigData *l3cd_old)
+{
+    const NML3ConfigData *l3cd = self->priv.p->combined_l3cd_commited;
+    ObjStateData         *obj_state;
+    int                   i;
+    gboolean              any_dirty = FALSE;
+
+    nm_assert(NM_IS_L3CFG(self));
+
+    if (!l3cd_old || !l3cd) {
+        _obj_states_update_all(self);
+        return;
+    }
+
+    /* The non-dynamic obj-states are the objects of the previously commited
+     * l3cd. Instead of marking all of them dirty, only mark those that are
+     * no longer part of the new l3cd. Likewise, obj-states that already
+     * track the very same (deduplicated) object need no update. */
+    for (i = 0; i < (int) G_N_ELEMENTS(_obj_states_obj_types); i++) {
+        NMDedupMultiIter o_iter;
+        const NMPObject *obj;
+
+        nm_l3_config_data_iter_obj_for_each (&o_iter, l3cd_old, &obj, _obj_states_obj_types[i]) {
+            const NMDedupMultiEntry *entry;
+
+            if (_obj_states_track_skip(obj))
+                continue;
+            entry = nm_l3_config_data_lookup_obj(l3cd, obj);
+            if (entry && !_obj_states_track_skip(entry->obj))
+                continue;
+            obj_state = g_hash_table_lookup(self->priv.p->obj_state_hash, &obj);
+            if (!obj_state || !obj_state->os_non_dynamic
+                || !c_list_is_empty(&obj_state->os_zombie_lst))
+                continue;
+            obj_state->os_non_dynamic_dirty = TRUE;
+            any_dirty                       = TRUE;
+        }
+    }
+
+    for (i = 0; i < (int) G_N_ELEMENTS(_obj_states_obj_types); i++) {
+        NMDedupMultiIter o_iter;
+        const NMPObject *obj;
+
+        nm_l3_config_data_iter_obj_for_each (&o_iter, l3cd, &obj, _obj_states_obj_types[i]) {
+            if (_obj_states_track_skip(obj))
+                continue;
             obj_state = g_hash_table_lookup(self->priv.p->obj_state_hash, &obj);
             if (!obj_state) {
                 _obj_states_track_new(self, obj, FALSE);
                 continue;
             }
+            if (obj_state->obj == obj && obj_state->os_non_dynamic
+                && !obj_state->os_non_dynamic_dirty && c_list_is_empty(&obj_state->os_zombie_lst))
+                continue;
 
             _obj_states_track_update(self, obj_state, obj, FALSE);
         }
@@ -2093,6 +2191,7 @@ _l3_acd_data_prune_one(NML3Cfg *self, AcdData *acd_data, gboolean all /* or only
     _LOGT_acd(acd_data, "removed");
     if (!g_hash_table_remove(self->priv.p->acd_lst_hash, acd_data))
         nm_assert_not_reached();
+    self->priv.p->acd_generation++;
     _acd_data_free(acd_data);
 }
 
@@ -2177,6 +2276,7 @@ _l3_acd_data_add(NML3Cfg              *self,
         c_list_link_tail(&self->priv.p->acd_lst_head, &acd_data->acd_lst);
         if (!g_hash_table_add(self->priv.p->acd_lst_hash, acd_data))
             nm_assert_not_reached();
+        self->priv.p->acd_generation++;
         acd_track = NULL;
     } else
         acd_track = _acd_data_find_track(acd_data, l3cd, obj, tag);
@@ -2421,6 +2521,7 @@ _nm_printf(5, 6) static void _l3_acd_data_state_set_full(NML3Cfg         *self,
 
     old_state            = acd_data->info.state;
     acd_data->info.state = state;
+    self->priv.p->acd_generation++;
     _nm_l3cfg_emit_signal_notify_acd_event_queue(self, acd_data);
 
     if (state == NM_L3_ACD_ADDR_STATE_EXTERNAL_REMOVED)
@@ -3350,26 +3451,6 @@ nm_l3cfg_check_ready(NML3Cfg               *self,
 
 /*****************************************************************************/
 
-static gboolean
-_l3_commit_on_idle_cb(gpointer user_data)
-{
-    _nm_unused gs_unref_object NML3Cfg *self_keep_alive = NULL;
-    NML3Cfg                            *self            = user_data;
-    NML3CfgCommitType                   commit_type;
-
-    commit_type = self->priv.p->commit_on_idle_type;
-
-    if (nm_clear_g_source_inst(&self->priv.p->commit_on_idle_source))
-        self_keep_alive = self;
-    else
-        nm_assert_not_reached();
-
-    self->priv.p->commit_on_idle_type = NM_L3_CFG_COMMIT_TYPE_AUTO;
-
-    _l3_commit(self, commit_type, TRUE);
-    return G_SOURCE_REMOVE;
-}
-
 /* DOC(l3cfg:commit-type):
  *
  * Usually we don't want to call the synchronous nm_l3cfg_commit(), because
@@ -3395,7 +3476,7 @@ nm_l3cfg_commit_on_idle_schedule(NML3Cfg *self, NML3CfgCommitType commit_type)
                         NM_L3_CFG_COMMIT_TYPE_UPDATE,
                         NM_L3_CFG_COMMIT_TYPE_REAPPLY));
 
-    if (self->priv.p->commit_on_idle_source) {
+    if (c_list_is_linked(&self->internal_netns.commit_on_idle_lst)) {
         if (self->priv.p->commit_on_idle_type < commit_type) {
             /* For multiple calls, we collect the maximum "commit-type". */
             _LOGT("schedule commit on idle (upgrade type to %s)",
@@ -3409,11 +3490,13 @@ nm_l3cfg_commit_on_idle_schedule(NML3Cfg *self, NML3CfgCommitType commit_type)
 
     _LOGT("schedule commit on idle (%s)",
           _l3_cfg_commit_type_to_string(commit_type, sbuf_commit_type, sizeof(sbuf_commit_type)));
-    self->priv.p->commit_on_idle_source = nm_g_idle_add_source(_l3_commit_on_idle_cb, self);
-    self->priv.p->commit_on_idle_type   = commit_type;
+    self->priv.p->commit_on_idle_type = commit_type;
 
-    /* While we have an idle update scheduled, we need to keep the instance alive. */
+    /* The commit happens on an idle handler of NMNetns, together with the
+     * commits of the other NML3Cfg instances of the namespace. While it is
+     * scheduled, we need to keep the instance alive. */
     g_object_ref(self);
+    nm_netns_l3cfg_commit_on_idle_schedule(self->priv.netns, self);
 
     return TRUE;
 }
@@ -3423,7 +3506,7 @@ nm_l3cfg_commit_on_idle_is_scheduled(NML3Cfg *self)
 {
     nm_assert(NM_IS_L3CFG(self));
 
-    return !!(self->priv.p->commit_on_idle_source);
+    return c_list_is_linked(&self->internal_netns.commit_on_idle_lst);
 }
 
 /*****************************************************************************/
@@ -4021,6 +4104,62 @@ _l3cfg_routed_dns(NML3Cfg *self, NML3ConfigData *l3cd)
     }
 }
 
+static int
+_l3_config_datas_merge_cmp(const L3ConfigData *a, const L3ConfigData *b)
+{
+    /* Compares whether merging @a gives the same result as merging @b. */
+    NM_CMP_DIRECT_PTR(a->l3cd, b->l3cd);
+    NM_CMP_DIRECT_PTR(a->tag_confdata, b->tag_confdata);
+    NM_CMP_FIELD(a, b, config_flags);
+    NM_CMP_FIELD(a, b, merge_flags);
+    NM_CMP_FIELD_MEMCMP(a, b, default_route_table_x);
+    NM_CMP_FIELD_MEMCMP(a, b, default_route_metric_x);
+    NM_CMP_FIELD_MEMCMP(a, b, default_route_penalty_x);
+    NM_CMP_FIELD_MEMCMP(a, b, default_dns_priority_x);
+    return 0;
+}
+
+static void
+_l3_merge_inputs_clear(NML3Cfg *self)
+{
+    guint i;
+
+    for (i = 0; i < self->priv.p->merge_inputs_len; i++)
+        nm_l3_config_data_unref(self->priv.p->merge_inputs[i].l3cd);
+    nm_clear_g_free(&self->priv.p->merge_inputs);
+    self->priv.p->merge_inputs_len = 0;
+}
+
+static void
+_l3_merge_inputs_set(NML3Cfg *self, const L3ConfigData *const *infos, guint infos_len)
+{
+    L3ConfigData *merge_inputs;
+    guint         i;
+
+    merge_inputs = g_new(L3ConfigData, infos_len);
+    for (i = 0; i < infos_len; i++) {
+        merge_inputs[i] = *infos[i];
+        nm_l3_config_data_ref(merge_inputs[i].l3cd);
+    }
+
+    _l3_merge_inputs_clear(self);
+    self->priv.p->merge_inputs     = merge_inputs;
+    self->priv.p->merge_inputs_len = infos_len;
+}
+
+static guint
+_l3_merge_inputs_get_n_unchanged(NML3Cfg *self, const L3ConfigData *const *infos, guint infos_len)
+{
+    guint n = NM_MIN(infos_len, self->priv.p->merge_inputs_len);
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        if (_l3_config_datas_merge_cmp(&self->priv.p->merge_inputs[i], infos[i]) != 0)
+            break;
+    }
+    return i;
+}
+
 static void
 _l3cfg_update_combined_config(NML3Cfg               *self,
                               gboolean               to_commit,
@@ -4097,19 +4236,62 @@ _l3cfg_update_combined_config(NML3Cfg               *self,
         self->priv.p->changed_configs_acd_state = FALSE;
     }
 
-    if (l3_config_datas_len > 0) {
+    if (l3_config_datas_len == 0) {
+        _l3_merge_inputs_clear(self);
+        nm_clear_l3cd(&self->priv.p->merge_prefix_l3cd);
+    } else {
         L3ConfigMergeHookAddObjData hook_data = {
             .self      = self,
             .to_commit = to_commit,
         };
+        guint n_unchanged;
+        guint merge_start;
+        guint merge_prefix_len;
+
+        /* Merging is done in order, and with NM_L3_CONFIG_ADD_FLAGS_EXCLUSIVE an entry
+         * only depends on the entries before it. If the first entries are still the
+         * same as during the previous merge, we can continue from the cached result
+         * of merging them. That result also depends on the ACD state (see
+         * _l3_hook_add_obj_cb()), which must be unchanged as well. */
+        n_unchanged =
+            _l3_merge_inputs_get_n_unchanged(self, l3_config_datas_arr, l3_config_datas_len);
+
+        if (self->priv.p->merge_prefix_l3cd && self->priv.p->merge_prefix_len <= n_unchanged
+            && self->priv.p->merge_prefix_acd_generation == self->priv.p->acd_generation
+            && self->priv.p->merge_prefix_to_commit == to_commit) {
+            merge_start = self->priv.p->merge_prefix_len;
+            l3cd        = nm_l3_config_data_new_clone(self->priv.p->merge_prefix_l3cd, 0);
+        } else {
+            nm_clear_l3cd(&self->priv.p->merge_prefix_l3cd);
+            merge_start = 0;
+            l3cd        = nm_l3_config_data_new(nm_platform_get_multi_idx(self->priv.platform),
+                                                self->priv.ifindex,
+                                                NM_IP_CONFIG_SOURCE_UNKNOWN);
+        }
 
-        l3cd = nm_l3_config_data_new(nm_platform_get_multi_idx(self->priv.platform),
-                                     self->priv.ifindex,
-                                     NM_IP_CONFIG_SOURCE_UNKNOWN);
+        /* Choose which prefix to cache for the next time. The entry that changed
+         * now is likely to change again (for example, on DHCP renewals), so cache
+         * everything before it. Without such information, cache all but the last
+         * entry. */
+        if (n_unchanged > 0 && n_unchanged < l3_config_datas_len)
+            merge_prefix_len = n_unchanged;
+        else if (merge_start > 0)
+            merge_prefix_len = merge_start;
+        else
+            merge_prefix_len = l3_config_datas_len - 1;
 
-        for (i = 0; i < l3_config_datas_len; i++) {
+        for (i = merge_start; i < l3_config_datas_len; i++) {
             const L3ConfigData *l3cd_data = l3_config_datas_arr[i];
 
+            if (i == merge_prefix_len && i > merge_start) {
+                nm_clear_l3cd(&self->priv.p->merge_prefix_l3cd);
+                self->priv.p->merge_prefix_l3cd =
+                    nm_l3_config_data_seal(nm_l3_config_data_new_clone(l3cd, 0));
+                self->priv.p->merge_prefix_len            = i;
+                self->priv.p->merge_prefix_acd_generation = self->priv.p->acd_generation;
+                self->priv.p->merge_prefix_to_commit      = to_commit;
+            }
+
             /* more important entries must be sorted *first*. */
             nm_assert(
                 i == 0
@@ -4134,6 +4316,8 @@ _l3cfg_update_combined_config(NML3Cfg               *self,
                                     &hook_data);
         }
 
+        _l3_merge_inputs_set(self, l3_config_datas_arr, l3_config_datas_len);
+
         if (self->priv.ifindex == NM_LOOPBACK_IFINDEX) {
             NMPlatformIPXAddress ax;
             NMPlatformIPXRoute   rx;
@@ -4212,7 +4396,7 @@ out:
             nm_l3_config_data_ref(self->priv.p->combined_l3cd_merged);
         commited_changed = TRUE;
 
-        _obj_states_update_all(self);
+        _obj_states_update_delta(self, l3cd_commited_old);
 
         NM_SET_OUT(out_old, g_steal_pointer(&l3cd_commited_old));
         NM_SET_OUT(out_changed_combined_l3cd, TRUE);
@@ -5078,7 +5262,6 @@ _l3_commit_one(NML3Cfg              *self,
     gs_unref_ptrarray GPtrArray *routes_nodev    = NULL;
     gs_unref_ptrarray GPtrArray *addresses_prune = NULL;
     gs_unref_ptrarray GPtrArray *routes_prune    = NULL;
-    gs_unref_ptrarray GPtrArray *routes_failed   = NULL;
     NMIPRouteTableSyncMode       route_table_sync;
     char                         sbuf_commit_type[50];
     guint                        i;
@@ -5209,18 +5392,65 @@ _l3_commit_one(NML3Cfg              *self,
 
     _nodev_routes_sync(self, addr_family, commit_type, routes_nodev);
 
-    nm_platform_ip_route_sync(self->priv.platform,
-                              addr_family,
-                              self->priv.ifindex,
-                              routes,
-                              routes_prune,
-                              &routes_failed);
+    /* The routes are only prepared here. They get sent to platform by
+     * _l3_commit_finish(), or before that together with the routes of
+     * other interfaces (see _nm_l3cfg_commit_on_idle_get_route_syncs()). */
+    nm_assert(!self->priv.p->commit_state.route_sync_x[IS_IPv4]);
+    self->priv.p->commit_state.route_sync_x[IS_IPv4] =
+        nm_platform_ip_route_sync_prepare(self->priv.platform,
+                                          addr_family,
+                                          self->priv.ifindex,
+                                          routes,
+                                          routes_prune);
+}
+
+static void
+_l3_commit_one_finish(NML3Cfg *self, int addr_family)
+{
+    const int                    IS_IPv4       = NM_IS_IPv4(addr_family);
+    gs_unref_ptrarray GPtrArray *routes_failed = NULL;
+
+    nm_platform_ip_route_sync_finish(
+        self->priv.platform,
+        g_steal_pointer(&self->priv.p->commit_state.route_sync_x[IS_IPv4]),
+        &routes_failed);
 
     _failedobj_handle_routes(self, addr_family, routes_failed);
 }
 
 static void
-_l3_commit(NML3Cfg *self, NML3CfgCommitType commit_type, gboolean is_idle)
+_l3_commit_finish(NML3Cfg *self)
+{
+    nm_auto_unref_l3cd const NML3ConfigData *l3cd_old = NULL;
+    gboolean                                 changed_combined_l3cd;
+
+    nm_assert(self->priv.p->commit_state.pending);
+
+    l3cd_old                           = g_steal_pointer(&self->priv.p->commit_state.l3cd_old);
+    changed_combined_l3cd              = self->priv.p->commit_state.changed_combined_l3cd;
+    self->priv.p->commit_state.pending = FALSE;
+
+    _l3_commit_one_finish(self, AF_INET);
+    _l3_commit_one_finish(self, AF_INET6);
+
+    _failedobj_reschedule(self, 0);
+
+    _l3_commit_mptcp(self, self->priv.p->commit_state.commit_type);
+
+    _l3_acd_data_process_changes(self);
+
+    nm_assert(self->priv.p->commit_reentrant_count == 1);
+    self->priv.p->commit_reentrant_count--;
+
+    _nm_l3cfg_emit_signal_notify_commit(self,
+                                        NM_L3_CONFIG_NOTIFY_TYPE_POST_COMMIT,
+                                        l3cd_old,
+                                        self->priv.p->combined_l3cd_commited,
+                                        changed_combined_l3cd);
+}
+
+static gboolean
+_l3_commit_begin(NML3Cfg *self, NML3CfgCommitType commit_type, gboolean is_idle)
 {
     _nm_unused gs_unref_object NML3Cfg      *self_keep_alive = NULL;
     nm_auto_unref_l3cd const NML3ConfigData *l3cd_old        = NULL;
@@ -5230,12 +5460,20 @@ _l3_commit(NML3Cfg *self, NML3CfgCommitType commit_type, gboolean is_idle)
     char                                     sbuf_ct[30];
     gboolean                                 changed_combined_l3cd;
 
-    g_return_if_fail(NM_IS_L3CFG(self));
+    nm_assert(NM_IS_L3CFG(self));
     nm_assert(NM_IN_SET(commit_type,
                         NM_L3_CFG_COMMIT_TYPE_NONE,
                         NM_L3_CFG_COMMIT_TYPE_AUTO,
                         NM_L3_CFG_COMMIT_TYPE_UPDATE,
                         NM_L3_CFG_COMMIT_TYPE_REAPPLY));
+
+    if (self->priv.p->commit_state.pending) {
+        /* A commit on idle was started but is not yet completed (we are called
+         * while NMNetns commits several NML3Cfg instances together). Complete it
+         * first. */
+        _l3_commit_finish(self);
+    }
+
     nm_assert(self->priv.p->commit_reentrant_count == 0);
 
     /* The actual commit type is always the maximum of what is requested
@@ -5269,12 +5507,16 @@ _l3_commit(NML3Cfg *self, NML3CfgCommitType commit_type, gboolean is_idle)
 
     nm_assert(commit_type > NM_L3_CFG_COMMIT_TYPE_AUTO);
 
-    if (nm_clear_g_source_inst(&self->priv.p->commit_on_idle_source))
+    if (c_list_is_linked(&self->internal_netns.commit_on_idle_lst)) {
+        /* The commit was scheduled, but we commit now. Drop the reference that
+         * was taken by nm_l3cfg_commit_on_idle_schedule(). */
+        c_list_unlink(&self->internal_netns.commit_on_idle_lst);
         self_keep_alive = self;
+    }
     self->priv.p->commit_on_idle_type = NM_L3_CFG_COMMIT_TYPE_AUTO;
 
     if (commit_type <= NM_L3_CFG_COMMIT_TYPE_NONE)
-        return;
+        return FALSE;
 
     self->priv.p->commit_reentrant_count++;
 
@@ -5293,20 +5535,56 @@ _l3_commit(NML3Cfg *self, NML3CfgCommitType commit_type, gboolean is_idle)
     _l3_commit_one(self, AF_INET, commit_type, l3cd_old);
     _l3_commit_one(self, AF_INET6, commit_type, l3cd_old);
 
-    _failedobj_reschedule(self, 0);
+    self->priv.p->commit_state.l3cd_old              = g_steal_pointer(&l3cd_old);
+    self->priv.p->commit_state.commit_type           = commit_type;
+    self->priv.p->commit_state.changed_combined_l3cd = changed_combined_l3cd;
+    self->priv.p->commit_state.pending               = TRUE;
+    return TRUE;
+}
 
-    _l3_commit_mptcp(self, commit_type);
+static void
+_l3_commit(NML3Cfg *self, NML3CfgCommitType commit_type, gboolean is_idle)
+{
+    g_return_if_fail(NM_IS_L3CFG(self));
 
-    _l3_acd_data_process_changes(self);
+    if (_l3_commit_begin(self, commit_type, is_idle))
+        _l3_commit_finish(self);
+}
 
-    nm_assert(self->priv.p->commit_reentrant_count == 1);
-    self->priv.p->commit_reentrant_count--;
+void
+_nm_l3cfg_commit_on_idle_begin(NML3Cfg *self)
+{
+    NML3CfgCommitType commit_type;
 
-    _nm_l3cfg_emit_signal_notify_commit(self,
-                                        NM_L3_CONFIG_NOTIFY_TYPE_POST_COMMIT,
-                                        l3cd_old,
-                                        self->priv.p->combined_l3cd_commited,
-                                        changed_combined_l3cd);
+    nm_assert(NM_IS_L3CFG(self));
+    nm_assert(!c_list_is_linked(&self->internal_netns.commit_on_idle_lst));
+
+    commit_type                       = self->priv.p->commit_on_idle_type;
+    self->priv.p->commit_on_idle_type = NM_L3_CFG_COMMIT_TYPE_AUTO;
+
+    _l3_commit_begin(self, commit_type, TRUE);
+}
+
+NMPlatformIPRouteSync *const *
+_nm_l3cfg_commit_on_idle_get_route_syncs(NML3Cfg *self)
+{
+    nm_assert(NM_IS_L3CFG(self));
+    nm_assert(self->priv.p->commit_state.pending
+              || (!self->priv.p->commit_state.route_sync_x[0]
+                  && !self->priv.p->commit_state.route_sync_x[1]));
+
+    return self->priv.p->commit_state.route_sync_x;
+}
+
+void
+_nm_l3cfg_commit_on_idle_finish(NML3Cfg *self)
+{
+    nm_assert(NM_IS_L3CFG(self));
+
+    /* The commit might have been completed already, if somebody
+     * called nm_l3cfg_commit() in the meantime. */
+    if (self->priv.p->commit_state.pending)
+        _l3_commit_finish(self);
 }
 
 NML3CfgBlockHandle *
@@ -5507,6 +5785,18 @@ nm_l3cfg_get_combined_l3cd(NML3Cfg *self, gboolean get_commited)
     return self->priv.p->combined_l3cd_merged;
 }
 
+/* For testing: forget the cached merge inputs and prefix, so that the next
+ * update merges all l3cds from scratch. */
+void
+_nmtst_l3cfg_merge_cache_clear(NML3Cfg *self)
+{
+    nm_assert(NM_IS_L3CFG(self));
+
+    _l3_merge_inputs_clear(self);
+    nm_clear_l3cd(&self->priv.p->merge_prefix_l3cd);
+    self->priv.p->changed_configs_configs = TRUE;
+}
+
 const NMPObject *
 nm_l3cfg_get_best_default_route(NML3Cfg *self, int addr_family, gboolean get_commited)
 {
@@ -5619,7 +5909,9 @@ nm_l3cfg_is_ready(NML3Cfg *self)
         return FALSE;
     if (self->priv.p->changed_configs_acd_state)
         return FALSE;
-    if (self->priv.p->commit_on_idle_source)
+    if (c_list_is_linked(&self->internal_netns.commit_on_idle_lst))
+        return FALSE;
+    if (self->priv.p->commit_state.pending)
         return FALSE;
 
     return TRUE;
@@ -5666,6 +5958,7 @@ nm_l3cfg_init(NML3Cfg *self)
 
     c_list_init(&self->internal_netns.signal_pending_lst);
     c_list_init(&self->internal_netns.ecmp_track_ifindex_lst_head);
+    c_list_init(&self->internal_netns.commit_on_idle_lst);
 
     self->priv.p->obj_state_hash = g_hash_table_new_full(nmp_object_indirect_id_hash,
                                                          nmp_object_indirect_id_equal,
@@ -5736,7 +6029,9 @@ finalize(GObject *object)
     nm_assert(c_list_is_empty(&self->priv.p->blocked_lst_head_4));
     nm_assert(c_list_is_empty(&self->priv.p->blocked_lst_head_6));
 
-    nm_assert(!self->priv.p->commit_on_idle_source);
+    nm_assert(!c_list_is_linked(&self->internal_netns.commit_on_idle_lst));
+    nm_assert(!self->priv.p->commit_state.pending);
+    nm_assert(!self->priv.p->commit_state.l3cd_old);
 
     _l3_acd_data_prune(self, TRUE);
 
@@ -5773,6 +6068,8 @@ finalize(GObject *object)
 
     nm_clear_l3cd(&self->priv.p->combined_l3cd_merged);
     nm_clear_l3cd(&self->priv.p->combined_l3cd_commited);
+    nm_clear_l3cd(&self->priv.p->merge_prefix_l3cd);
+    _l3_merge_inputs_clear(self);
 
     nm_clear_pointer(&self->priv.plobj, nmp_object_unref);
     nm_clear_pointer(&self->priv.plobj_next, nmp_object_unref);
@@ -209,6 +209,7 @@ struct _NML3Cfg {
         guint32 signal_pending_obj_type_flags;
         CList   signal_pending_lst;
         CList   ecmp_track_ifindex_lst_head;
+        CList   commit_on_idle_lst;
     } internal_netns;
 };
 
@@ -228,6 +229,10 @@ void _nm_l3cfg_notify_platform_change(NML3Cfg                   *self,
                                       NMPlatformSignalChangeType change_type,
                                       const NMPObject           *obj);
 
+void                          _nm_l3cfg_commit_on_idle_begin(NML3Cfg *self);
+NMPlatformIPRouteSync *const *_nm_l3cfg_commit_on_idle_get_route_syncs(NML3Cfg *self);
+void                          _nm_l3cfg_commit_on_idle_finish(NML3Cfg *self);
+
 /*****************************************************************************/
 
 struct _NMDedupMultiIndex;
@@ -434,6 +439,8 @@ void nm_l3cfg_commit_type_reset_update(NML3Cfg *self);
 
 const NML3ConfigData *nm_l3cfg_get_combined_l3cd(NML3Cfg *self, gboolean get_commited);
 
+void _nmtst_l3cfg_merge_cache_clear(NML3Cfg *self);
+
 const NMPObject *
 nm_l3cfg_get_best_default_route(NML3Cfg *self, int addr_family, gboolean get_commited);
 
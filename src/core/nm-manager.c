@@ -1231,6 +1231,50 @@ nm_manager_get_activatable_connections(NMManager *manager,
         NULL);
 }
 
+/**
+ * nm_manager_get_activatable_connections_for_device:
+ * @manager: the #NMManager
+ * @device: the #NMDevice
+ * @for_auto_activation: whether the list is for auto activation
+ * @out_len: (optional): the number of returned connections
+ *
+ * Like nm_manager_get_activatable_connections() with sorting, but only
+ * returns the profiles that are candidates for @device. That skips profiles
+ * that are bound to another interface name or MAC address or that have an
+ * incompatible type. The caller still needs to check whether a profile is
+ * available on @device.
+ */
+NMSettingsConnection **
+nm_manager_get_activatable_connections_for_device(NMManager *manager,
+                                                  NMDevice  *device,
+                                                  gboolean   for_auto_activation,
+                                                  guint     *out_len)
+{
+    NMManagerPrivate                         *priv = NM_MANAGER_GET_PRIVATE(manager);
+    const GetActivatableConnectionsFilterData d    = {
+           .self                = manager,
+           .for_auto_activation = for_auto_activation,
+    };
+    const char *const *connection_types;
+    const char        *connection_types_buf[2];
+
+    connection_types_buf[0] = nm_device_get_connection_type_check_compatible(device);
+    connection_types_buf[1] = NULL;
+    if (connection_types_buf[0])
+        connection_types = connection_types_buf;
+    else
+        connection_types = nm_device_get_connection_types_check_compatible(device);
+
+    return nm_settings_get_candidate_connections_clone(
+        priv->settings,
+        nm_device_get_iface(device),
+        nm_device_get_permanent_hw_address(device),
+        connection_types,
+        out_len,
+        _get_activatable_connections_filter,
+        (gpointer) &d);
+}
+
 static NMActiveConnection *
 active_connection_get_by_path(NMManager *self, const char *path)
 {
@@ -1716,6 +1760,69 @@ nm_manager_notify_delete_settings_connections(NMManager *self, NMSettingsConnect
 
 /*****************************************************************************/
 
+static void
+_platform_route_table_filter_update(NMManager *self, const NMConfigData *config_data)
+{
+    NMManagerPrivate     *priv   = NM_MANAGER_GET_PRIVATE(self);
+    gs_unref_array GArray *ranges = NULL;
+    gs_free const char   **strv   = NULL;
+    gs_free char          *value  = NULL;
+    gsize                  i;
+
+    value = nm_config_data_get_value(config_data,
+                                     NM_CONFIG_KEYFILE_GROUP_PLATFORM,
+                                     NM_CONFIG_KEYFILE_KEY_PLATFORM_ROUTE_TABLES,
+                                     NM_CONFIG_GET_VALUE_STRIP | NM_CONFIG_GET_VALUE_NO_EMPTY);
+
+    strv   = nm_strsplit_set_full(value, ",", NM_STRSPLIT_SET_FLAGS_STRSTRIP);
+    ranges = g_array_new(FALSE, FALSE, sizeof(NMPlatformRouteTableRange));
+    for (i = 0; strv && strv[i]; i++) {
+        NMPlatformRouteTableRange range;
+        gs_free char             *s_from = g_strdup(strv[i]);
+        char                     *s_to;
+        gint64                    from;
+        gint64                    to;
+
+        s_to = strchr(s_from, '-');
+        if (s_to)
+            *(s_to++) = '\0';
+
+        from = _nm_utils_ascii_str_to_int64(s_from, 10, 1, G_MAXUINT32, -1);
+        to   = s_to ? _nm_utils_ascii_str_to_int64(s_to, 10, 1, G_MAXUINT32, -1) : from;
+        if (from < 0 || to < from) {
+            _LOGW(LOGD_PLATFORM,
+                  "config: ignore invalid route table \"%s\" in %s.%s",
+                  strv[i],
+                  NM_CONFIG_KEYFILE_GROUP_PLATFORM,
+                  NM_CONFIG_KEYFILE_KEY_PLATFORM_ROUTE_TABLES);
+            continue;
+        }
+
+        range = (NMPlatformRouteTableRange){
+            .table_from = from,
+            .table_to   = to,
+        };
+        g_array_append_val(ranges, range);
+    }
+
+    nm_platform_set_route_table_filter(priv->platform,
+                                       (const NMPlatformRouteTableRange *) ranges->data,
+                                       ranges->len);
+}
+
+static void
+_platform_netlink_thread_update(NMManager *self, const NMConfigData *config_data)
+{
+    NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE(self);
+
+    nm_platform_netlink_set_parse_thread(
+        priv->platform,
+        nm_config_data_get_value_boolean(config_data,
+                                         NM_CONFIG_KEYFILE_GROUP_PLATFORM,
+                                         NM_CONFIG_KEYFILE_KEY_PLATFORM_NETLINK_THREAD,
+                                         FALSE));
+}
+
 static void
 _config_changed_cb(NMConfig           *config,
                    NMConfigData       *config_data,
@@ -1723,6 +1830,9 @@ _config_changed_cb(NMConfig           *config,
                    NMConfigData       *old_data,
                    NMManager          *self)
 {
+    _platform_route_table_filter_update(self, config_data);
+    _platform_netlink_thread_update(self, config_data);
+
     g_object_freeze_notify(G_OBJECT(self));
 
     if (NM_FLAGS_HAS(changes, NM_CONFIG_CHANGE_GLOBAL_DNS_CONFIG))
@@ -7782,6 +7892,61 @@ impl_manager_get_logging(NMDBusObject                      *obj,
         g_variant_new("(ss)", nm_logging_level_to_string(), nm_logging_domains_to_string()));
 }
 
+static void
+impl_manager_get_platform_stats(NMDBusObject                      *obj,
+                                const NMDBusInterfaceInfoExtended *interface_info,
+                                const NMDBusMethodInfoExtended    *method_info,
+                                GDBusConnection                   *connection,
+                                const char                        *sender,
+                                GDBusMethodInvocation             *invocation,
+                                GVariant                          *parameters)
+{
+    NMManager             *self = NM_MANAGER(obj);
+    NMManagerPrivate      *priv = NM_MANAGER_GET_PRIVATE(self);
+    NMPlatformNetlinkStats stats;
+    NMPlatformSysctlStats  sysctl_stats;
+    GVariantBuilder        builder;
+    int                    i;
+
+#define _ADD(key, value) g_variant_builder_add(&builder, "{sv}", (key), (value))
+#define _USEC(nsec)      g_variant_new_uint64((nsec) / 1000u)
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a{sv}"));
+
+    if (nm_platform_netlink_stats_get(priv->platform, &stats)) {
+        _ADD("netlink-overflows", g_variant_new_uint64(stats.overflows));
+        _ADD("resync-dumps", g_variant_new_uint64(stats.resync_dumps));
+        _ADD("resyncs-completed", g_variant_new_uint64(stats.resyncs_completed));
+        _ADD("resync-in-progress", g_variant_new_boolean(stats.resync_in_progress));
+        _ADD("rcvbuf-size", g_variant_new_uint32(stats.rcvbuf_size));
+        _ADD("refresh-all", g_variant_new_uint64(stats.refresh_all));
+        _ADD("dumps-completed", g_variant_new_uint64(stats.dumps_completed));
+        _ADD("dumps-usec", _USEC(stats.dumps_nsec));
+        _ADD("dumps-max-usec", _USEC(stats.dumps_max_nsec));
+
+        for (i = 0; i < _NM_PLATFORM_NETLINK_MSG_KIND_NUM; i++) {
+            const NMPlatformNetlinkMsgStats *msg_stats = &stats.msg_kinds[i];
+            const char                      *kind = nm_platform_netlink_msg_kind_to_string(i);
+            char                             key[64];
+
+            _ADD(nm_sprintf_buf(key, "%s-messages", kind), g_variant_new_uint64(msg_stats->msgs));
+            _ADD(nm_sprintf_buf(key, "%s-parse-usec", kind), _USEC(msg_stats->parse_nsec));
+            _ADD(nm_sprintf_buf(key, "%s-cache-usec", kind), _USEC(msg_stats->cache_nsec));
+        }
+    }
+
+    if (nm_platform_sysctl_stats_get(priv->platform, &sysctl_stats)) {
+        _ADD("sysctl-writes", g_variant_new_uint64(sysctl_stats.writes));
+        _ADD("sysctl-write-hits", g_variant_new_uint64(sysctl_stats.write_hits));
+        _ADD("sysctl-async-coalesced", g_variant_new_uint64(sysctl_stats.async_coalesced));
+    }
+
+#undef _ADD
+#undef _USEC
+
+    g_dbus_method_invocation_return_value(invocation, g_variant_new("(a{sv})", &builder));
+}
+
 typedef struct {
     NMManager             *self;
     GDBusMethodInvocation *context;
@@ -8885,6 +9050,9 @@ constructed(GObject *object)
                      G_CALLBACK(_config_changed_cb),
                      self);
 
+    _platform_route_table_filter_update(self, nm_config_get_data(priv->config));
+    _platform_netlink_thread_update(self, nm_config_get_data(priv->config));
+
     state = nm_config_state_get(priv->config);
 
     priv->net_enabled = state->net_enabled;
@@ -9408,6 +9576,12 @@ static const NMDBusInterfaceInfoExtended interface_info_manager = {
                                                      NM_DEFINE_GDBUS_ARG_INFO("level", "s"),
                                                      NM_DEFINE_GDBUS_ARG_INFO("domains", "s"), ), ),
                 .handle = impl_manager_get_logging, ),
+            NM_DEFINE_DBUS_METHOD_INFO_EXTENDED(
+                NM_DEFINE_GDBUS_METHOD_INFO_INIT(
+                    "GetPlatformStats",
+                    .out_args = NM_DEFINE_GDBUS_ARG_INFOS(
+                        NM_DEFINE_GDBUS_ARG_INFO("stats", "a{sv}"), ), ),
+                .handle = impl_manager_get_platform_stats, ),
             NM_DEFINE_DBUS_METHOD_INFO_EXTENDED(
                 NM_DEFINE_GDBUS_METHOD_INFO_INIT(
                     "CheckConnectivity",
@@ -85,6 +85,9 @@ typedef struct {
 
     CList    l3cfg_signal_pending_lst_head;
     GSource *signal_pending_idle_source;
+
+    CList    l3cfg_commit_on_idle_lst_head;
+    GSource *commit_on_idle_source;
 } NMNetnsPrivate;
 
 struct _NMNetns {
@@ -484,6 +487,86 @@ _platform_signal_on_idle_cb(gpointer user_data)
     return G_SOURCE_CONTINUE;
 }
 
+static gboolean
+_l3cfg_commit_on_idle_cb(gpointer user_data)
+{
+    gs_unref_object NMNetns     *self        = g_object_ref(NM_NETNS(user_data));
+    NMNetnsPrivate              *priv        = NM_NETNS_GET_PRIVATE(self);
+    gs_unref_ptrarray GPtrArray *l3cfgs      = NULL;
+    gs_unref_ptrarray GPtrArray *route_syncs = NULL;
+    NML3Cfg                     *l3cfg;
+    CList                        work_list;
+    guint                        i;
+    int                          IS_IPv4;
+
+    nm_clear_g_source_inst(&priv->commit_on_idle_source);
+
+    /* We commit all NML3Cfg instances that scheduled a commit together. First,
+     * each of them prepares its changes. Then the route changes of all interfaces
+     * get sent to platform in one pipeline, instead of waiting for the kernel's
+     * response for one interface after the other. Finally, the commits are completed.
+     *
+     * Like for _platform_signal_on_idle_cb(), commits that get scheduled in the
+     * meantime are handled by a future idle handler. */
+
+    c_list_init(&work_list);
+    c_list_splice(&work_list, &priv->l3cfg_commit_on_idle_lst_head);
+
+    l3cfgs = g_ptr_array_new_with_free_func(g_object_unref);
+
+    while ((l3cfg = c_list_first_entry(&work_list, NML3Cfg, internal_netns.commit_on_idle_lst))) {
+        nm_assert(NM_IS_L3CFG(l3cfg));
+        c_list_unlink(&l3cfg->internal_netns.commit_on_idle_lst);
+
+        /* Take over the reference from nm_l3cfg_commit_on_idle_schedule(). */
+        g_ptr_array_add(l3cfgs, l3cfg);
+
+        _nm_l3cfg_commit_on_idle_begin(l3cfg);
+    }
+
+    /* Only collect the route changes after all commits began. The signal
+     * handlers of one commit might already complete another one. */
+    for (i = 0; i < l3cfgs->len; i++) {
+        NMPlatformIPRouteSync *const *syncs;
+
+        syncs = _nm_l3cfg_commit_on_idle_get_route_syncs(l3cfgs->pdata[i]);
+        for (IS_IPv4 = 1; IS_IPv4 >= 0; IS_IPv4--) {
+            if (!syncs[IS_IPv4])
+                continue;
+            if (!route_syncs)
+                route_syncs = g_ptr_array_new();
+            g_ptr_array_add(route_syncs, syncs[IS_IPv4]);
+        }
+    }
+
+    if (route_syncs) {
+        nm_platform_ip_route_sync_execute(priv->platform,
+                                          (NMPlatformIPRouteSync *const *) route_syncs->pdata,
+                                          route_syncs->len);
+    }
+
+    for (i = 0; i < l3cfgs->len; i++)
+        _nm_l3cfg_commit_on_idle_finish(l3cfgs->pdata[i]);
+
+    return G_SOURCE_CONTINUE;
+}
+
+void
+nm_netns_l3cfg_commit_on_idle_schedule(NMNetns *self, NML3Cfg *l3cfg)
+{
+    NMNetnsPrivate *priv = NM_NETNS_GET_PRIVATE(self);
+
+    nm_assert_l3cfg(self, l3cfg);
+    nm_assert(c_list_is_empty(&l3cfg->internal_netns.commit_on_idle_lst));
+
+    c_list_link_tail(&priv->l3cfg_commit_on_idle_lst_head,
+                     &l3cfg->internal_netns.commit_on_idle_lst);
+    if (!priv->commit_on_idle_source)
+        priv->commit_on_idle_source = nm_g_idle_add_source(_l3cfg_commit_on_idle_cb, self);
+}
+
+/*****************************************************************************/
+
 static void
 _platform_signal_cb(NMPlatform   *platform,
                     int           obj_type_i,
@@ -1452,6 +1535,7 @@ nm_netns_init(NMNetns *self)
     priv->_self_signal_user_data = self;
 
     c_list_init(&priv->l3cfg_signal_pending_lst_head);
+    c_list_init(&priv->l3cfg_commit_on_idle_lst_head);
 
     G_STATIC_ASSERT_EXPR(G_STRUCT_OFFSET(EcmpTrackObj, obj) == 0);
     priv->ecmp_track_by_obj =
@@ -1545,6 +1629,7 @@ dispose(GObject *object)
 
     nm_assert(nm_g_hash_table_size(priv->l3cfgs) == 0);
     nm_assert(c_list_is_empty(&priv->l3cfg_signal_pending_lst_head));
+    nm_assert(c_list_is_empty(&priv->l3cfg_commit_on_idle_lst_head));
     nm_assert(!priv->shared_ips);
     nm_assert(nm_g_hash_table_size(priv->watcher_idx) == 0);
     nm_assert(nm_g_hash_table_size(priv->watcher_by_tag_idx) == 0);
@@ -1558,6 +1643,7 @@ dispose(GObject *object)
     nm_clear_pointer(&priv->watcher_ip_data_idx, g_hash_table_destroy);
 
     nm_clear_g_source_inst(&priv->signal_pending_idle_source);
+    nm_clear_g_source_inst(&priv->commit_on_idle_source);
 
     if (priv->platform)
         g_signal_handlers_disconnect_by_data(priv->platform, &priv->_self_signal_user_data);
@@ -39,6 +39,8 @@ NML3Cfg *nm_netns_l3cfg_get(NMNetns *self, int ifindex);
 
 NML3Cfg *nm_netns_l3cfg_acquire(NMNetns *netns, int ifindex);
 
+void nm_netns_l3cfg_commit_on_idle_schedule(NMNetns *self, NML3Cfg *l3cfg);
+
 /*****************************************************************************/
 
 typedef struct {
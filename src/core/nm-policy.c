@@ -1460,7 +1460,10 @@ _auto_activate_device(NMPolicy *self, NMDevice *device)
     if (!nm_device_autoconnect_allowed(device))
         return;
 
-    connections = nm_manager_get_activatable_connections(priv->manager, TRUE, TRUE, &len);
+    /* Only consider the profiles that are candidates for this device. With many
+     * devices and profiles, checking all profiles for each device is expensive. */
+    connections =
+        nm_manager_get_activatable_connections_for_device(priv->manager, device, TRUE, &len);
     if (!connections[0])
         return;
 
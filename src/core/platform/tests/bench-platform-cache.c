@@ -0,0 +1,454 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/*
+ * A benchmark for the platform cache.
+ *
+ * It adds links, addresses and routes and reports the time and the resident
+ * memory for each step. The fake variant measures only the cache and the
+ * platform code. The linux variant goes through netlink in a private netns,
+ * so the kernel and the parsing of the notifications are part of it.
+ *
+ * The benchmark is not part of the test suite. Run it with
+ *   meson test -C build --benchmark --suite NetworkManager --verbose
+ * The sizes can be set with the environment variables NMTST_BENCH_LINKS,
+ * NMTST_BENCH_ADDRESSES and NMTST_BENCH_ROUTES (up to 1000000 each).
+ * The linux variant also configures all 4094 bridge VLANs on the ports of a
+ * bridge, whose number is set by NMTST_BENCH_BRIDGE_PORTS, and syncs
+ * NMTST_BENCH_RULES policy routing rules of 100 tenants via NMPGlobalTracker.
+ * The objects are always the same for the same sizes, so that results of
+ * different runs can be compared.
+ */
+
+#include "src/core/nm-default-daemon.h"
+
+#include <stdio.h>
+#include <linux/fib_rules.h>
+
+#include "libnm-platform/nmp-global-tracker.h"
+
+#include "test-common.h"
+
+/*****************************************************************************/
+
+#define BENCH_METRIC 31187u
+
+#define BENCH_N_LOOKUPS 100u
+
+static struct {
+    guint n_links;
+    guint n_addresses;
+    guint n_routes;
+    guint n_bridge_ports;
+    guint n_rules;
+} bench;
+
+typedef struct {
+    const char            *name;
+    gint64                 start_nsec;
+    NMPlatformNetlinkStats stats;
+    gboolean               has_stats;
+} BenchStep;
+
+/*****************************************************************************/
+
+static guint
+_bench_param(const char *env, guint default_val)
+{
+    return _nm_utils_ascii_str_to_int64(g_getenv(env), 10, 1, 1000000, default_val);
+}
+
+static gsize
+_bench_rss_kib(void)
+{
+    FILE         *f;
+    unsigned long rss_pages = 0;
+
+    f = fopen("/proc/self/statm", "re");
+    if (!f)
+        return 0;
+    if (fscanf(f, "%*u %lu", &rss_pages) != 1)
+        rss_pages = 0;
+    fclose(f);
+
+    return ((gsize) rss_pages) * ((gsize) sysconf(_SC_PAGESIZE)) / 1024u;
+}
+
+static guint64
+_bench_stats_cache_nsec(const NMPlatformNetlinkStats *stats)
+{
+    guint64 nsec = 0;
+    int     i;
+
+    for (i = 0; i < _NM_PLATFORM_NETLINK_MSG_KIND_NUM; i++)
+        nsec += stats->msg_kinds[i].cache_nsec;
+    return nsec;
+}
+
+static void
+_bench_step_start(BenchStep *step, const char *name)
+{
+    *step = (BenchStep) {
+        .name = name,
+    };
+    step->has_stats  = nm_platform_netlink_stats_get(NM_PLATFORM_GET, &step->stats);
+    step->start_nsec = nm_utils_get_monotonic_timestamp_nsec();
+}
+
+static void
+_bench_step_end(BenchStep *step, guint n_ops)
+{
+    gint64                 duration_nsec;
+    NMPlatformNetlinkStats stats;
+    char                   buf_cache[64];
+
+    duration_nsec = nm_utils_get_monotonic_timestamp_nsec() - step->start_nsec;
+
+    /* The time spent in cache_on_change() is only known for the linux platform. */
+    if (step->has_stats && nm_platform_netlink_stats_get(NM_PLATFORM_GET, &stats)) {
+        nm_sprintf_buf(buf_cache,
+                       "%.3f msec",
+                       (double) (_bench_stats_cache_nsec(&stats)
+                                 - _bench_stats_cache_nsec(&step->stats))
+                           / 1e6);
+    } else
+        nm_sprintf_buf(buf_cache, "n/a");
+
+    g_test_message("bench: %-24s %8u ops %12.3f msec %10.3f usec/op, rss %8zu KiB, "
+                   "cache_on_change %s",
+                   step->name,
+                   n_ops,
+                   (double) duration_nsec / 1e6,
+                   n_ops > 0 ? ((double) duration_nsec / 1e3) / n_ops : 0.0,
+                   _bench_rss_kib(),
+                   buf_cache);
+}
+
+/*****************************************************************************/
+
+static GPtrArray *
+_bench_routes_new(int ifindex, guint n_routes)
+{
+    GPtrArray *routes;
+    guint      i;
+
+    routes = g_ptr_array_new_full(n_routes, (GDestroyNotify) nmp_object_unref);
+    for (i = 0; i < n_routes; i++) {
+        const NMPlatformIP4Route r = {
+            .ifindex   = ifindex,
+            .rt_source = NM_IP_CONFIG_SOURCE_USER,
+            .network   = htonl(0x40000000u + (i << 8)),
+            .plen      = 24,
+            .metric    = BENCH_METRIC,
+        };
+
+        g_ptr_array_add(routes,
+                        nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r));
+    }
+    return routes;
+}
+
+static guint
+_bench_lookup_count(NMPObjectType obj_type, int ifindex)
+{
+    const NMDedupMultiHeadEntry *head_entry;
+    NMPLookup                    lookup;
+
+    nmp_lookup_init_object_by_ifindex(&lookup, obj_type, ifindex);
+    head_entry = nm_platform_lookup(NM_PLATFORM_GET, &lookup);
+    return head_entry ? head_entry->len : 0u;
+}
+
+static void
+bench_platform_cache(void)
+{
+    const guint                  n_pairs       = NM_MAX(bench.n_links / 2u, 1u);
+    gs_free int                 *ifindexes     = g_new(int, n_pairs * 2u);
+    gs_unref_ptrarray GPtrArray *routes        = NULL;
+    gs_unref_ptrarray GPtrArray *routes_prune  = NULL;
+    gs_unref_ptrarray GPtrArray *routes_failed = NULL;
+    BenchStep                    step;
+    guint                        n;
+    guint                        i;
+
+    g_test_message("bench: %s, %u links, %u addresses, %u routes",
+                   nmtstp_is_root_test() ? "linux" : "fake",
+                   n_pairs * 2u,
+                   bench.n_addresses,
+                   bench.n_routes);
+
+    _bench_step_start(&step, "links-add");
+    for (i = 0; i < n_pairs; i++) {
+        char name[IFNAMSIZ];
+        char peer[IFNAMSIZ];
+
+        nm_sprintf_buf(name, "nmbench%u", i);
+        nm_sprintf_buf(peer, "nmbenchp%u", i);
+        ifindexes[2u * i]      = nmtstp_link_veth_add(NM_PLATFORM_GET, FALSE, name, peer)->ifindex;
+        ifindexes[2u * i + 1u] = nmtstp_link_get(NM_PLATFORM_GET, -1, peer)->ifindex;
+        nmtstp_link_set_updown(NM_PLATFORM_GET, FALSE, ifindexes[2u * i + 1u], TRUE);
+        nmtstp_link_set_updown(NM_PLATFORM_GET, FALSE, ifindexes[2u * i], TRUE);
+    }
+    _bench_step_end(&step, n_pairs * 2u);
+
+    _bench_step_start(&step, "addresses-add");
+    for (i = 0; i < bench.n_addresses; i++) {
+        g_assert(nm_platform_ip4_address_add(NM_PLATFORM_GET,
+                                             ifindexes[i % (n_pairs * 2u)],
+                                             htonl(0x0A000000u + i),
+                                             32,
+                                             htonl(0x0A000000u + i),
+                                             0,
+                                             NM_PLATFORM_LIFETIME_PERMANENT,
+                                             NM_PLATFORM_LIFETIME_PERMANENT,
+                                             0,
+                                             NULL,
+                                             NULL));
+    }
+    _bench_step_end(&step, bench.n_addresses);
+
+    routes = _bench_routes_new(ifindexes[0], bench.n_routes);
+
+    _bench_step_start(&step, "route-sync-add");
+    g_assert(nm_platform_ip_route_sync(NM_PLATFORM_GET,
+                                       AF_INET,
+                                       ifindexes[0],
+                                       routes,
+                                       NULL,
+                                       &routes_failed));
+    g_assert(!routes_failed);
+    _bench_step_end(&step, bench.n_routes);
+
+    _bench_step_start(&step, "route-sync-unchanged");
+    g_assert(nm_platform_ip_route_sync(NM_PLATFORM_GET,
+                                       AF_INET,
+                                       ifindexes[0],
+                                       routes,
+                                       NULL,
+                                       &routes_failed));
+    g_assert(!routes_failed);
+    _bench_step_end(&step, bench.n_routes);
+
+    _bench_step_start(&step, "lookup-routes");
+    for (i = 0; i < BENCH_N_LOOKUPS; i++) {
+        n = _bench_lookup_count(NMP_OBJECT_TYPE_IP4_ROUTE, ifindexes[0]);
+        g_assert_cmpuint(n, >=, bench.n_routes);
+    }
+    _bench_step_end(&step, BENCH_N_LOOKUPS);
+
+    _bench_step_start(&step, "lookup-addresses");
+    for (i = 0; i < BENCH_N_LOOKUPS; i++)
+        _bench_lookup_count(NMP_OBJECT_TYPE_IP4_ADDRESS, ifindexes[i % (n_pairs * 2u)]);
+    _bench_step_end(&step, BENCH_N_LOOKUPS);
+
+    _bench_step_start(&step, "route-lookup-obj");
+    for (i = 0; i < bench.n_routes; i++) {
+        g_assert(nm_platform_lookup_obj(NM_PLATFORM_GET,
+                                        NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+                                        routes->pdata[i]));
+    }
+    _bench_step_end(&step, bench.n_routes);
+
+    routes_prune = nm_platform_ip_route_get_prune_list(NM_PLATFORM_GET,
+                                                       AF_INET,
+                                                       ifindexes[0],
+                                                       NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN);
+    n            = bench.n_routes - (bench.n_routes / 2u);
+    g_ptr_array_set_size(routes, bench.n_routes / 2u);
+
+    _bench_step_start(&step, "route-sync-prune");
+    g_assert(nm_platform_ip_route_sync(NM_PLATFORM_GET,
+                                       AF_INET,
+                                       ifindexes[0],
+                                       routes,
+                                       routes_prune,
+                                       &routes_failed));
+    g_assert(!routes_failed);
+    _bench_step_end(&step, n);
+
+    _bench_step_start(&step, "links-delete");
+    for (i = 0; i < n_pairs; i++)
+        nmtstp_link_delete(NM_PLATFORM_GET, FALSE, ifindexes[2u * i], NULL, TRUE);
+    _bench_step_end(&step, n_pairs * 2u);
+}
+
+static NMPlatformBridgeVlan *
+_bench_bridge_vlans_new(guint vid_max, guint untagged_every)
+{
+    NMPlatformBridgeVlan *vlans;
+    guint                 i;
+
+    /* One entry per VLAN, like a profile that lists each VLAN separately. */
+    vlans = g_new(NMPlatformBridgeVlan, vid_max);
+    for (i = 0; i < vid_max; i++) {
+        vlans[i] = (NMPlatformBridgeVlan) {
+            .vid_start = i + 1u,
+            .vid_end   = i + 1u,
+            .untagged  = (i % untagged_every) == 0,
+            .pvid      = i == 0,
+        };
+    }
+    return vlans;
+}
+
+static void
+bench_bridge_vlans(void)
+{
+    const guint                   n_ports     = bench.n_bridge_ports;
+    gs_free int                  *ifindexes   = g_new(int, n_ports);
+    gs_free NMPlatformBridgeVlan *vlans       = _bench_bridge_vlans_new(4094, 4094);
+    gs_free NMPlatformBridgeVlan *vlans_other = _bench_bridge_vlans_new(4000, 100);
+    BenchStep                     step;
+    int                           ifindex_bridge;
+    guint                         i;
+
+    g_test_message("bench: linux, %u bridge ports with 4094 VLANs", n_ports);
+
+    ifindex_bridge =
+        nmtstp_link_bridge_add(NULL, FALSE, "nmbenchbr", &nm_platform_lnk_bridge_default)->ifindex;
+    g_assert(nm_platform_link_set_bridge_info(NM_PLATFORM_GET,
+                                              ifindex_bridge,
+                                              &((NMPlatformLinkSetBridgeInfoData) {
+                                                  .vlan_filtering_has = TRUE,
+                                                  .vlan_filtering_val = TRUE,
+                                              })));
+
+    for (i = 0; i < n_ports; i++) {
+        char name[IFNAMSIZ];
+
+        nm_sprintf_buf(name, "nmbenchbp%u", i);
+        ifindexes[i] = nmtstp_link_dummy_add(NM_PLATFORM_GET, FALSE, name)->ifindex;
+        g_assert(nm_platform_link_attach_port(NM_PLATFORM_GET, ifindex_bridge, ifindexes[i]));
+    }
+
+    _bench_step_start(&step, "bridge-vlans-flush-set");
+    for (i = 0; i < n_ports; i++) {
+        g_assert(nm_platform_link_set_bridge_vlans(NM_PLATFORM_GET, ifindexes[i], TRUE, NULL, 0));
+        g_assert(
+            nm_platform_link_set_bridge_vlans(NM_PLATFORM_GET, ifindexes[i], TRUE, vlans, 4094));
+    }
+    _bench_step_end(&step, n_ports);
+
+    _bench_step_start(&step, "bridge-vlans-sync-unchanged");
+    for (i = 0; i < n_ports; i++) {
+        g_assert(
+            nm_platform_link_sync_bridge_vlans(NM_PLATFORM_GET, ifindexes[i], TRUE, vlans, 4094));
+    }
+    _bench_step_end(&step, n_ports);
+
+    _bench_step_start(&step, "bridge-vlans-sync-change");
+    for (i = 0; i < n_ports; i++) {
+        g_assert(nm_platform_link_sync_bridge_vlans(NM_PLATFORM_GET,
+                                                    ifindexes[i],
+                                                    TRUE,
+                                                    vlans_other,
+                                                    4000));
+    }
+    _bench_step_end(&step, n_ports);
+
+    _bench_step_start(&step, "bridge-links-delete");
+    for (i = 0; i < n_ports; i++)
+        nmtstp_link_delete(NM_PLATFORM_GET, FALSE, ifindexes[i], NULL, TRUE);
+    nmtstp_link_delete(NM_PLATFORM_GET, FALSE, ifindex_bridge, NULL, TRUE);
+    _bench_step_end(&step, n_ports + 1u);
+}
+
+#define BENCH_N_TENANTS 100u
+
+static void
+_bench_rules_track(NMPGlobalTracker *global_tracker,
+                   const guint8     *tenants,
+                   guint             i_tenant,
+                   guint32           table_offset)
+{
+    guint i;
+
+    /* Each tenant has its own range of rule priorities, and a route table
+     * per tenant. */
+    for (i = i_tenant; i < bench.n_rules; i += BENCH_N_TENANTS) {
+        nmp_global_tracker_track_rule(global_tracker,
+                                      &((NMPlatformRoutingRule) {
+                                          .addr_family = AF_INET,
+                                          .priority    = 10000u + i,
+                                          .table       = 1000u + i_tenant + table_offset,
+                                          .action      = FR_ACT_TO_TBL,
+                                      }),
+                                      10,
+                                      &tenants[i_tenant],
+                                      NULL);
+    }
+}
+
+static void
+bench_global_tracker_rules(void)
+{
+    nm_auto_unref_global_tracker NMPGlobalTracker *global_tracker =
+        nmp_global_tracker_new(NM_PLATFORM_GET);
+    guint8    tenants[BENCH_N_TENANTS];
+    BenchStep step;
+    guint     n_tenant_rules;
+    guint     i;
+
+    g_test_message("bench: linux, %u routing rules of %u tenants",
+                   bench.n_rules,
+                   BENCH_N_TENANTS);
+
+    n_tenant_rules = (bench.n_rules + BENCH_N_TENANTS - 1u) / BENCH_N_TENANTS;
+
+    _bench_step_start(&step, "rules-track-sync");
+    for (i = 0; i < BENCH_N_TENANTS; i++)
+        _bench_rules_track(global_tracker, tenants, i, 0);
+    nmp_global_tracker_sync(global_tracker, NMP_OBJECT_TYPE_ROUTING_RULE, FALSE);
+    _bench_step_end(&step, bench.n_rules);
+
+    g_assert_cmpint(nmtstp_platform_routing_rules_get_count(NM_PLATFORM_GET, AF_INET),
+                    >=,
+                    bench.n_rules);
+
+    /* Nothing changed. The sync only needs to look at the rules that were
+     * touched by the previous sync. */
+    _bench_step_start(&step, "rules-sync-unchanged");
+    nmp_global_tracker_sync(global_tracker, NMP_OBJECT_TYPE_ROUTING_RULE, FALSE);
+    _bench_step_end(&step, 1);
+
+    /* One tenant moves its rules to another table, like a reapply does. */
+    _bench_step_start(&step, "rules-sync-one-tenant");
+    nmp_global_tracker_set_dirty(global_tracker, &tenants[0]);
+    _bench_rules_track(global_tracker, tenants, 0, BENCH_N_TENANTS);
+    nmp_global_tracker_untrack_all(global_tracker, &tenants[0], FALSE, FALSE);
+    nmp_global_tracker_sync(global_tracker, NMP_OBJECT_TYPE_ROUTING_RULE, FALSE);
+    _bench_step_end(&step, n_tenant_rules);
+
+    _bench_step_start(&step, "rules-untrack-sync");
+    for (i = 0; i < BENCH_N_TENANTS; i++)
+        nmp_global_tracker_untrack_all(global_tracker, &tenants[i], TRUE, FALSE);
+    nmp_global_tracker_sync(global_tracker, NMP_OBJECT_TYPE_ROUTING_RULE, FALSE);
+    _bench_step_end(&step, bench.n_rules);
+}
+
+/*****************************************************************************/
+
+NMTstpSetupFunc const _nmtstp_setup_platform_func = SETUP;
+
+void
+_nmtstp_init_tests(int *argc, char ***argv)
+{
+    nmtst_init_with_logging(argc, argv, "WARN", "ALL");
+}
+
+void
+_nmtstp_setup_tests(void)
+{
+    bench.n_links     = _bench_param("NMTST_BENCH_LINKS", 10);
+    bench.n_addresses = _bench_param("NMTST_BENCH_ADDRESSES", 1000);
+    bench.n_routes    = _bench_param("NMTST_BENCH_ROUTES", 10000);
+
+    g_test_add_func("/bench/platform-cache", bench_platform_cache);
+
+    /* The fake platform implements neither bridge VLANs nor routing rules. */
+    if (nmtstp_is_root_test()) {
+        bench.n_bridge_ports = _bench_param("NMTST_BENCH_BRIDGE_PORTS", 48);
+        bench.n_rules        = _bench_param("NMTST_BENCH_RULES", 10000);
+        g_test_add_func("/bench/bridge-vlans", bench_bridge_vlans);
+        g_test_add_func("/bench/global-tracker-rules", bench_global_tracker_rules);
+    }
+}
@@ -7,6 +7,7 @@
 
 #include <sched.h>
 #include <sys/mount.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <linux/if_tun.h>
@@ -1364,6 +1365,49 @@ _test_wireguard_change(NMPlatform *platform, int ifindex, int test_mode)
                                               | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK
                                               | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_REPLACE_PEERS);
     g_assert(NMTST_NM_ERR_SUCCESS(r));
+
+    if (test_mode == 2) {
+        const NMPObject *lnk;
+        guint            i_step;
+
+        /* Remove some peers and change another one. With SYNC_PEERS, only the
+         * difference is sent and the cache gets updated without reading back all
+         * peers. After a refresh, the kernel must agree with the cache. Sync the
+         * same peers twice, the second time there is nothing to send. */
+        g_array_remove_range(peers, 0, 10);
+        nm_g_array_first(peers, NMPWireGuardPeer).persistent_keepalive_interval = 5;
+
+        for (i_step = 0; i_step < 2; i_step++) {
+            r = nm_platform_link_wireguard_change(
+                platform,
+                ifindex,
+                &lnk_wireguard,
+                nm_g_array_first_p(peers, const NMPWireGuardPeer),
+                NULL,
+                peers->len,
+                NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_PRIVATE_KEY
+                    | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT
+                    | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK
+                    | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_SYNC_PEERS);
+            g_assert(NMTST_NM_ERR_SUCCESS(r));
+
+            lnk = NMP_OBJECT_UP_CAST(nm_platform_link_get_lnk_wireguard(platform, ifindex, NULL));
+            g_assert(lnk);
+            g_assert_cmpint(lnk->_lnk_wireguard.peers_len, ==, peers->len);
+            g_assert_cmpint(lnk->_lnk_wireguard.peers[0].persistent_keepalive_interval, ==, 5);
+        }
+
+        nm_platform_link_refresh(platform, ifindex);
+
+        lnk = NMP_OBJECT_UP_CAST(nm_platform_link_get_lnk_wireguard(platform, ifindex, NULL));
+        g_assert(lnk);
+        g_assert_cmpint(lnk->_lnk_wireguard.peers_len, ==, peers->len);
+        g_assert_cmpint(lnk->_lnk_wireguard.peers[0].persistent_keepalive_interval, ==, 5);
+        g_assert(memcmp(lnk->_lnk_wireguard.peers[0].public_key,
+                        nm_g_array_first(peers, NMPWireGuardPeer).public_key,
+                        NMP_WIREGUARD_PUBLIC_KEY_LEN)
+                 == 0);
+    }
 }
 
 /*****************************************************************************/
@@ -2727,6 +2771,67 @@ test_link_set_properties(void)
 
 /*****************************************************************************/
 
+static void
+test_link_stats_refresh(void)
+{
+    static const char *const USER_TAG = "test-link-stats-refresh";
+    const NMPlatformLink    *link;
+    nm_auto_close int        fd = -1;
+    struct sockaddr_in       sin;
+    in_addr_t                addr;
+    guint64                  tx_packets;
+    guint64                  tx_bytes;
+    gint64                   until_ms;
+    int                      ifindex;
+
+    addr    = nmtst_inet4_from_string("192.0.2.1");
+    ifindex = nmtstp_link_dummy_add(NM_PLATFORM_GET, FALSE, "dummy1")->ifindex;
+    nmtstp_link_set_updown(NM_PLATFORM_GET, FALSE, ifindex, TRUE);
+    nmtstp_ip4_address_add(NM_PLATFORM_GET,
+                           FALSE,
+                           ifindex,
+                           addr,
+                           24,
+                           addr,
+                           NM_PLATFORM_LIFETIME_PERMANENT,
+                           NM_PLATFORM_LIFETIME_PERMANENT,
+                           0,
+                           NULL);
+
+    link       = nmtstp_link_get(NM_PLATFORM_GET, ifindex, "dummy1");
+    tx_packets = link->tx_packets;
+    tx_bytes   = link->tx_bytes;
+
+    nm_platform_link_stats_set_refresh(NM_PLATFORM_GET, USER_TAG, ifindex, 100);
+
+    /* The dummy link has no ARP, so the datagram is transmitted right away. */
+    fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    g_assert_cmpint(fd, >=, 0);
+    sin = (struct sockaddr_in) {
+        .sin_family      = AF_INET,
+        .sin_port        = htons(9),
+        .sin_addr.s_addr = nmtst_inet4_from_string("192.0.2.2"),
+    };
+    g_assert_cmpint(sendto(fd, "x", 1, 0, (struct sockaddr *) &sin, sizeof(sin)), ==, 1);
+
+    /* Sending emits no netlink notification. Only the periodic refresh updates
+     * the counters in the cache. */
+    until_ms = nm_utils_get_monotonic_timestamp_msec() + 5000;
+    while (TRUE) {
+        link = nmtstp_link_get(NM_PLATFORM_GET, ifindex, "dummy1");
+        if (link->tx_packets > tx_packets)
+            break;
+        nmtstp_assert_wait_for_signal_until(NM_PLATFORM_GET, until_ms);
+    }
+    g_assert_cmpint(link->tx_bytes, >, tx_bytes);
+
+    nm_platform_link_stats_set_refresh(NM_PLATFORM_GET, USER_TAG, ifindex, 0);
+
+    nmtstp_link_delete(NULL, -1, ifindex, "dummy1", TRUE);
+}
+
+/*****************************************************************************/
+
 static void
 test_create_many_links_do(guint n_devices)
 {
@@ -3890,6 +3995,213 @@ test_sysctl_set_async_fail(void)
     g_main_loop_unref(loop);
 }
 
+typedef struct {
+    GMainLoop  *loop;
+    const char *path;
+    gboolean    expected_success;
+    gint32      expected_value;
+    guint       pending;
+} SetAsyncCoalesceData;
+
+static void
+sysctl_set_async_coalesce_cb(GError *error, gpointer user_data)
+{
+    SetAsyncCoalesceData *data = user_data;
+
+    g_assert_cmpint(data->pending, >, 0);
+
+    if (data->expected_success) {
+        g_assert_no_error(error);
+        g_assert_cmpint(nm_platform_sysctl_get_int32(NM_PLATFORM_GET,
+                                                     NMP_SYSCTL_PATHID_ABSOLUTE(data->path),
+                                                     -1),
+                        ==,
+                        data->expected_value);
+    } else
+        g_assert(error);
+
+    if (--data->pending == 0)
+        g_main_loop_quit(data->loop);
+}
+
+static void
+test_sysctl_set_async_coalesce(void)
+{
+    NMPlatform *const             PL     = NM_PLATFORM_GET;
+    const char *const             IFNAME = "nm-dummy-0";
+    const char *const             PATH   = "/proc/sys/net/ipv4/conf/nm-dummy-0/rp_filter";
+    GMainLoop                    *loop;
+    gs_unref_object GCancellable *cancellable = NULL;
+    NMPlatformSysctlStats         stats_before;
+    NMPlatformSysctlStats         stats;
+    SetAsyncCoalesceData          data;
+    int                           ifindex;
+
+    ifindex     = nmtstp_link_dummy_add(PL, -1, IFNAME)->ifindex;
+    loop        = g_main_loop_new(NULL, FALSE);
+    cancellable = g_cancellable_new();
+
+    data = (SetAsyncCoalesceData) {
+        .loop             = loop,
+        .path             = PATH,
+        .expected_success = access(PATH, W_OK) == 0,
+        .expected_value   = 1,
+        .pending          = 2,
+    };
+
+    g_assert(nm_platform_sysctl_stats_get(PL, &stats_before));
+
+    /* Both requests are queued in the same main loop iteration. Only the
+     * last one gets written, but both callbacks are invoked after the
+     * write, with its result. */
+    nm_platform_sysctl_set_async(PL,
+                                 NMP_SYSCTL_PATHID_ABSOLUTE(PATH),
+                                 (const char *[]) {"2", NULL},
+                                 sysctl_set_async_coalesce_cb,
+                                 &data,
+                                 cancellable);
+    nm_platform_sysctl_set_async(PL,
+                                 NMP_SYSCTL_PATHID_ABSOLUTE(PATH),
+                                 (const char *[]) {"1", NULL},
+                                 sysctl_set_async_coalesce_cb,
+                                 &data,
+                                 cancellable);
+
+    g_assert_cmpint(data.pending, ==, 2);
+
+    if (!nmtst_main_loop_run(loop, 1000))
+        g_assert_not_reached();
+
+    g_assert_cmpint(data.pending, ==, 0);
+    g_assert(nm_platform_sysctl_stats_get(PL, &stats));
+    g_assert_cmpint(stats.async_coalesced, ==, stats_before.async_coalesced + 1);
+    if (data.expected_success) {
+        g_assert_cmpint(nm_platform_sysctl_get_int32(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH), -1),
+                        ==,
+                        1);
+    }
+
+    nmtstp_link_delete(NULL, -1, ifindex, IFNAME, TRUE);
+    g_main_loop_unref(loop);
+}
+
+static void
+test_sysctl_set_async_coalesce_cancel(void)
+{
+    NMPlatform *const             PL     = NM_PLATFORM_GET;
+    const char *const             IFNAME = "nm-dummy-0";
+    const char *const             PATH   = "/proc/sys/net/ipv4/conf/nm-dummy-0/rp_filter";
+    GMainLoop                    *loop;
+    gs_unref_object GCancellable *cancellable   = NULL;
+    gs_unref_object GCancellable *cancellable_2 = NULL;
+    SetAsyncCoalesceData          data;
+    int                           ifindex;
+
+    ifindex       = nmtstp_link_dummy_add(PL, -1, IFNAME)->ifindex;
+    loop          = g_main_loop_new(NULL, FALSE);
+    cancellable   = g_cancellable_new();
+    cancellable_2 = g_cancellable_new();
+
+    data = (SetAsyncCoalesceData) {
+        .loop             = loop,
+        .path             = PATH,
+        .expected_success = access(PATH, W_OK) == 0,
+        .expected_value   = 2,
+        .pending          = 1,
+    };
+
+    /* The last request gets cancelled. The superseded one is still alive,
+     * so its value gets written. */
+    nm_platform_sysctl_set_async(PL,
+                                 NMP_SYSCTL_PATHID_ABSOLUTE(PATH),
+                                 (const char *[]) {"2", NULL},
+                                 sysctl_set_async_coalesce_cb,
+                                 &data,
+                                 cancellable);
+    nm_platform_sysctl_set_async(PL,
+                                 NMP_SYSCTL_PATHID_ABSOLUTE(PATH),
+                                 (const char *[]) {"1", NULL},
+                                 NULL,
+                                 NULL,
+                                 cancellable_2);
+    g_cancellable_cancel(cancellable_2);
+
+    if (!nmtst_main_loop_run(loop, 1000))
+        g_assert_not_reached();
+
+    g_assert_cmpint(data.pending, ==, 0);
+    if (data.expected_success) {
+        g_assert_cmpint(nm_platform_sysctl_get_int32(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH), -1),
+                        ==,
+                        2);
+    }
+
+    nmtstp_link_delete(NULL, -1, ifindex, IFNAME, TRUE);
+    g_main_loop_unref(loop);
+}
+
+static void
+test_sysctl_set_coalesce(void)
+{
+    NMPlatform *const     PL       = NM_PLATFORM_GET;
+    const char *const     IFNAME   = "nm-dummy-0";
+    const char *const     PATH     = "/proc/sys/net/ipv4/conf/nm-dummy-0/rp_filter";
+    const char *const     PATH_FWD = "/proc/sys/net/ipv4/conf/nm-dummy-0/forwarding";
+    const char *const     PATH_ALL = "/proc/sys/net/ipv4/conf/all/forwarding";
+    NMPlatformSysctlStats stats_before;
+    NMPlatformSysctlStats stats;
+    char                  forwarding_all_str[20];
+    gint32                forwarding_all;
+    int                   ifindex;
+
+    ifindex = nmtstp_link_dummy_add(PL, -1, IFNAME)->ifindex;
+
+    if (access(PATH, W_OK) != 0) {
+        nmtstp_link_delete(NULL, -1, ifindex, IFNAME, TRUE);
+        g_test_skip("Cannot write sysctl");
+        return;
+    }
+
+    g_assert(nm_platform_sysctl_stats_get(PL, &stats_before));
+
+    /* Writing the same value twice in one main loop iteration writes it only once. */
+    g_assert(nm_platform_sysctl_set(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH), "2"));
+    g_assert(nm_platform_sysctl_set(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH), "2"));
+    g_assert(nm_platform_sysctl_stats_get(PL, &stats));
+    g_assert_cmpint(stats.writes, ==, stats_before.writes + 1);
+    g_assert_cmpint(stats.write_hits, ==, stats_before.write_hits + 1);
+
+    /* A different value gets written. */
+    g_assert(nm_platform_sysctl_set(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH), "1"));
+    g_assert(nm_platform_sysctl_stats_get(PL, &stats));
+    g_assert_cmpint(stats.writes, ==, stats_before.writes + 2);
+    g_assert_cmpint(nm_platform_sysctl_get_int32(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH), -1), ==, 1);
+
+    /* After the main loop iteration, the value gets written again. */
+    while (g_main_context_iteration(NULL, FALSE)) {}
+    g_assert(nm_platform_sysctl_set(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH), "1"));
+    g_assert(nm_platform_sysctl_stats_get(PL, &stats));
+    g_assert_cmpint(stats.writes, ==, stats_before.writes + 3);
+
+    /* The kernel propagates "conf/all/forwarding" to all interfaces. Afterwards,
+     * writing the interface's value must not be skipped. */
+    forwarding_all = nm_platform_sysctl_get_int32(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH_ALL), -1);
+    g_assert_cmpint(forwarding_all, >=, 0);
+    g_assert(nm_platform_sysctl_set(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH_FWD), "0"));
+    g_assert(nm_platform_sysctl_set(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH_ALL), "1"));
+    g_assert_cmpint(nm_platform_sysctl_get_int32(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH_FWD), -1),
+                    ==,
+                    1);
+    g_assert(nm_platform_sysctl_set(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH_FWD), "0"));
+    g_assert_cmpint(nm_platform_sysctl_get_int32(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH_FWD), -1),
+                    ==,
+                    0);
+    nm_sprintf_buf(forwarding_all_str, "%d", forwarding_all);
+    g_assert(nm_platform_sysctl_set(PL, NMP_SYSCTL_PATHID_ABSOLUTE(PATH_ALL), forwarding_all_str));
+
+    nmtstp_link_delete(NULL, -1, ifindex, IFNAME, TRUE);
+}
+
 /*****************************************************************************/
 
 static gpointer
@@ -4111,6 +4423,7 @@ _nmtstp_setup_tests(void)
         //       g_test_add_func("/link/software/vlan/set-xgress", test_vlan_set_xgress);
 
         g_test_add_func("/link/set-properties", test_link_set_properties);
+        g_test_add_func("/link/stats-refresh", test_link_stats_refresh);
 
         g_test_add_data_func("/link/create-many-links/20",
                              GUINT_TO_POINTER(20),
@@ -4154,6 +4467,10 @@ _nmtstp_setup_tests(void)
         g_test_add_func("/general/sysctl/netns-switch", test_sysctl_netns_switch);
         g_test_add_func("/general/sysctl/set-async", test_sysctl_set_async);
         g_test_add_func("/general/sysctl/set-async-fail", test_sysctl_set_async_fail);
+        g_test_add_func("/general/sysctl/set-async-coalesce", test_sysctl_set_async_coalesce);
+        g_test_add_func("/general/sysctl/set-async-coalesce-cancel",
+                        test_sysctl_set_async_coalesce_cancel);
+        g_test_add_func("/general/sysctl/set-coalesce", test_sysctl_set_coalesce);
 
         g_test_add_func("/link/ethtool/features/get", test_ethtool_features_get);
     }
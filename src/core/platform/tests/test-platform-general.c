@@ -49,6 +49,37 @@ test_link_get_all(void)
 
 /*****************************************************************************/
 
+static void
+test_netlink_stats(void)
+{
+    gs_unref_object NMPlatform *platform = NULL;
+    NMPlatformNetlinkStats      stats;
+    int                         i;
+
+    platform = nm_linux_platform_new(NULL, TRUE, NM_PLATFORM_NETNS_SUPPORT_DEFAULT, TRUE);
+
+    g_assert(nm_platform_netlink_stats_get(platform, &stats));
+    /* The size as reported by the kernel. Without CAP_NET_ADMIN, it is capped
+     * at net.core.rmem_max. */
+    g_assert_cmpuint(stats.rcvbuf_size, >, 0);
+    g_assert_cmpuint(stats.resync_dumps, <=, stats.overflows * 8u);
+    if (stats.overflows == 0) {
+        g_assert(!stats.resync_in_progress);
+        g_assert_cmpuint(stats.resyncs_completed, ==, 0);
+    }
+
+    /* The new instance dumped the links and received at least the loopback device. */
+    g_assert_cmpuint(stats.refresh_all, >, 0);
+    g_assert_cmpuint(stats.dumps_completed, >, 0);
+    g_assert_cmpuint(stats.dumps_max_nsec, <=, stats.dumps_nsec);
+    g_assert_cmpuint(stats.msg_kinds[NM_PLATFORM_NETLINK_MSG_KIND_LINK].msgs, >, 0);
+
+    for (i = 0; i < _NM_PLATFORM_NETLINK_MSG_KIND_NUM; i++)
+        g_assert(nm_platform_netlink_msg_kind_to_string(i));
+}
+
+/*****************************************************************************/
+
 static void
 test_nm_platform_link_flags2str(void)
 {
@@ -885,6 +916,7 @@ main(int argc, char **argv)
 
     g_test_add_func("/general/init_linux_platform", test_init_linux_platform);
     g_test_add_func("/general/link_get_all", test_link_get_all);
+    g_test_add_func("/general/netlink_stats", test_netlink_stats);
     g_test_add_func("/general/nm_platform_link_flags2str", test_nm_platform_link_flags2str);
     g_test_add_data_func("/general/platform_ip_address_pretty_sort_cmp/4",
                          GINT_TO_POINTER(0),
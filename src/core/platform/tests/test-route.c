@@ -623,6 +623,201 @@ test_ip4_zero_gateway(void)
     nmtstp_wait_for_signal(NM_PLATFORM_GET, 50);
 }
 
+static guint
+_ip4_routes_count_in_table(int ifindex, guint32 table)
+{
+    NMDedupMultiIter iter;
+    NMPLookup        lookup;
+    const NMPObject *o;
+    guint            n = 0;
+
+    nmp_cache_iter_for_each (
+        &iter,
+        nm_platform_lookup(
+            NM_PLATFORM_GET,
+            nmp_lookup_init_object_by_ifindex(&lookup, NMP_OBJECT_TYPE_IP4_ROUTE, ifindex)),
+        &o) {
+        if (nm_platform_route_table_uncoerce(NMP_OBJECT_CAST_IP4_ROUTE(o)->table_coerced, TRUE)
+            == table)
+            n++;
+    }
+    return n;
+}
+
+static void
+test_ip4_route_table_filter(void)
+{
+    const int                       ifindex  = DEVICE_IFINDEX;
+    const NMPlatformRouteTableRange ranges[] = {
+        {.table_from = 1000, .table_to = 1009},
+    };
+
+    nm_platform_set_route_table_filter(NM_PLATFORM_GET, ranges, G_N_ELEMENTS(ranges));
+
+    nmtstp_run_command_check("ip route add 1.2.3.0/24 dev %s table 1005", DEVICE_NAME);
+    nmtstp_run_command_check("ip route add 1.2.4.0/24 dev %s table 2000", DEVICE_NAME);
+    nmtstp_run_command_check("ip route add 1.2.5.0/24 dev %s", DEVICE_NAME);
+
+    NMTST_WAIT_ASSERT(100, {
+        nmtstp_wait_for_signal(NM_PLATFORM_GET, 10);
+        if (_ip4_routes_count_in_table(ifindex, 1005) == 1
+            && _ip4_routes_count_in_table(ifindex, RT_TABLE_MAIN) >= 1)
+            break;
+    });
+    g_assert_cmpint(_ip4_routes_count_in_table(ifindex, 2000), ==, 0);
+
+    /* clearing the filter resyncs and makes the route visible. */
+    nm_platform_set_route_table_filter(NM_PLATFORM_GET, NULL, 0);
+    g_assert_cmpint(_ip4_routes_count_in_table(ifindex, 2000), ==, 1);
+    g_assert_cmpint(_ip4_routes_count_in_table(ifindex, 1005), ==, 1);
+
+    /* setting the filter again prunes the route. */
+    nm_platform_set_route_table_filter(NM_PLATFORM_GET, ranges, G_N_ELEMENTS(ranges));
+    g_assert_cmpint(_ip4_routes_count_in_table(ifindex, 2000), ==, 0);
+    g_assert_cmpint(_ip4_routes_count_in_table(ifindex, 1005), ==, 1);
+
+    nm_platform_set_route_table_filter(NM_PLATFORM_GET, NULL, 0);
+
+    nmtstp_run_command_check("ip route flush table 1005");
+    nmtstp_run_command_check("ip route flush table 2000");
+    nmtstp_run_command_check("ip route flush dev %s", DEVICE_NAME);
+
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 50);
+}
+
+static void
+test_ip4_route_table_filter_auto(void)
+{
+    const int                       ifindex  = DEVICE_IFINDEX;
+    const NMPlatformRouteTableRange ranges[] = {
+        {.table_from = 1000, .table_to = 1009},
+    };
+    const NMPlatformIP4Route route = {
+        .ifindex       = ifindex,
+        .rt_source     = NM_IP_CONFIG_SOURCE_USER,
+        .network       = nmtst_inet4_from_string("1.2.6.0"),
+        .plen          = 24,
+        .metric        = 20,
+        .table_coerced = nm_platform_route_table_coerce(3000),
+        .n_nexthops    = 1,
+    };
+    const NMPlatformIP4Route route_sync = {
+        .ifindex       = ifindex,
+        .rt_source     = NM_IP_CONFIG_SOURCE_USER,
+        .network       = nmtst_inet4_from_string("1.2.8.0"),
+        .plen          = 24,
+        .metric        = 20,
+        .table_coerced = nm_platform_route_table_coerce(3001),
+        .n_nexthops    = 1,
+    };
+    gs_unref_ptrarray GPtrArray *routes        = NULL;
+    gs_unref_ptrarray GPtrArray *routes_failed = NULL;
+
+    nm_platform_set_route_table_filter(NM_PLATFORM_GET, ranges, G_N_ELEMENTS(ranges));
+    g_assert(!nm_platform_route_table_is_tracked(NM_PLATFORM_GET, 3000));
+
+    /* Routes that we add ourselves must not become invisible. */
+    g_assert_cmpint(nm_platform_ip4_route_add(NM_PLATFORM_GET, NMP_NLM_FLAG_REPLACE, &route, NULL),
+                    ==,
+                    0);
+    g_assert(nm_platform_route_table_is_tracked(NM_PLATFORM_GET, 3000));
+
+    NMTST_WAIT_ASSERT(100, {
+        nmtstp_wait_for_signal(NM_PLATFORM_GET, 10);
+        if (_ip4_routes_count_in_table(ifindex, 3000) == 1)
+            break;
+    });
+
+    /* The routes that get added by others to that table are seen too. */
+    nmtstp_run_command_check("ip route add 1.2.7.0/24 dev %s table 3000", DEVICE_NAME);
+    NMTST_WAIT_ASSERT(100, {
+        nmtstp_wait_for_signal(NM_PLATFORM_GET, 10);
+        if (_ip4_routes_count_in_table(ifindex, 3000) == 2)
+            break;
+    });
+
+    nmtstp_run_command_check("ip route flush table 3000");
+    NMTST_WAIT_ASSERT(100, {
+        nmtstp_wait_for_signal(NM_PLATFORM_GET, 10);
+        if (_ip4_routes_count_in_table(ifindex, 3000) == 0)
+            break;
+    });
+
+    /* The same for routes that get added with nm_platform_ip_route_sync(),
+     * which sends them as a batch. */
+    g_assert(!nm_platform_route_table_is_tracked(NM_PLATFORM_GET, 3001));
+    routes = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    g_ptr_array_add(
+        routes,
+        nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &route_sync));
+    g_assert(nm_platform_ip_route_sync(NM_PLATFORM_GET,
+                                       AF_INET,
+                                       ifindex,
+                                       routes,
+                                       NULL,
+                                       &routes_failed));
+    g_assert(!routes_failed);
+    g_assert(nm_platform_route_table_is_tracked(NM_PLATFORM_GET, 3001));
+
+    NMTST_WAIT_ASSERT(100, {
+        nmtstp_wait_for_signal(NM_PLATFORM_GET, 10);
+        if (_ip4_routes_count_in_table(ifindex, 3001) == 1)
+            break;
+    });
+
+    /* ... and, as the route is in the cache, it can be pruned again. */
+    g_assert(nm_platform_ip_route_sync(NM_PLATFORM_GET,
+                                       AF_INET,
+                                       ifindex,
+                                       NULL,
+                                       routes,
+                                       &routes_failed));
+    g_assert(!routes_failed);
+    NMTST_WAIT_ASSERT(100, {
+        nmtstp_wait_for_signal(NM_PLATFORM_GET, 10);
+        if (_ip4_routes_count_in_table(ifindex, 3001) == 0)
+            break;
+    });
+
+    nm_platform_set_route_table_filter(NM_PLATFORM_GET, NULL, 0);
+}
+
+static void
+test_ip4_route_parse_thread(void)
+{
+    const int                       ifindex  = DEVICE_IFINDEX;
+    const NMPlatformRouteTableRange ranges[] = {
+        {.table_from = 1000, .table_to = 1009},
+    };
+    const guint n_routes = 50;
+    guint       i;
+
+    nm_platform_set_route_table_filter(NM_PLATFORM_GET, ranges, G_N_ELEMENTS(ranges));
+    nm_platform_netlink_set_parse_thread(NM_PLATFORM_GET, TRUE);
+
+    for (i = 0; i < n_routes; i++) {
+        nmtstp_run_command_check("ip route add 1.3.%u.0/24 dev %s table 1005", i, DEVICE_NAME);
+        nmtstp_run_command_check("ip route add 1.4.%u.0/24 dev %s table 2000", i, DEVICE_NAME);
+    }
+    nmtstp_run_command_check("ip route del 1.3.0.0/24 dev %s table 1005", DEVICE_NAME);
+
+    /* process_events() applies all batches that are still with the worker. */
+    nm_platform_process_events(NM_PLATFORM_GET);
+    g_assert_cmpint(_ip4_routes_count_in_table(ifindex, 1005), ==, n_routes - 1);
+    g_assert_cmpint(_ip4_routes_count_in_table(ifindex, 2000), ==, 0);
+
+    /* stopping the worker applies the pending events too. */
+    nmtstp_run_command_check("ip route flush table 1005");
+    nm_platform_netlink_set_parse_thread(NM_PLATFORM_GET, FALSE);
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 50);
+    g_assert_cmpint(_ip4_routes_count_in_table(ifindex, 1005), ==, 0);
+
+    nm_platform_set_route_table_filter(NM_PLATFORM_GET, NULL, 0);
+
+    nmtstp_run_command_check("ip route flush table 2000");
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 50);
+}
+
 static void
 test_ip4_route_options(gconstpointer test_data)
 {
@@ -1908,6 +2103,41 @@ again:
         g_test_skip("some kernel features were not available and skipped for the test");
 }
 
+static void
+test_rule_keep_deleted(void)
+{
+    const NMPlatformRoutingRule rule = {
+        .addr_family = AF_INET,
+        .priority    = 10005,
+        .table       = 10005,
+        .action      = FR_ACT_TO_TBL,
+        .protocol    = RTPROT_STATIC,
+    };
+    NMPlatform                                    *platform = NM_PLATFORM_GET;
+    nm_auto_unref_global_tracker NMPGlobalTracker *global_tracker =
+        nmp_global_tracker_new(platform);
+    gconstpointer const             USER_TAG = &global_tracker;
+    nm_auto_nmpobj const NMPObject *obj =
+        nmp_object_new(NMP_OBJECT_TYPE_ROUTING_RULE, (const NMPlatformObject *) &rule);
+
+    nmp_global_tracker_track_rule(global_tracker, &rule, 10, USER_TAG, NULL);
+    nmp_global_tracker_sync(global_tracker, NMP_OBJECT_TYPE_ROUTING_RULE, FALSE);
+    g_assert(_platform_has_routing_rule(platform, obj));
+
+    /* Track the rule as absent, but don't remove it yet. */
+    nmp_global_tracker_track_rule(global_tracker, &rule, -10, USER_TAG, NULL);
+    nmp_global_tracker_sync(global_tracker, NMP_OBJECT_TYPE_ROUTING_RULE, TRUE);
+    g_assert(_platform_has_routing_rule(platform, obj));
+
+    /* Nothing changed since, still the next sync removes the rule. */
+    nmp_global_tracker_sync(global_tracker, NMP_OBJECT_TYPE_ROUTING_RULE, FALSE);
+    g_assert(!_platform_has_routing_rule(platform, obj));
+
+    nmp_global_tracker_untrack_all(global_tracker, USER_TAG, TRUE, TRUE);
+    nmp_global_tracker_sync(global_tracker, NMP_OBJECT_TYPE_ROUTING_RULE, FALSE);
+    g_assert(!_platform_has_routing_rule(platform, obj));
+}
+
 /*****************************************************************************/
 
 static void
@@ -1971,6 +2201,93 @@ test_blackhole(gconstpointer test_data)
 
 /*****************************************************************************/
 
+static guint
+_ip4_routes_count_with_metric(int ifindex, guint32 metric)
+{
+    NMDedupMultiIter iter;
+    NMPLookup        lookup;
+    const NMPObject *o;
+    guint            n = 0;
+
+    nmp_cache_iter_for_each (
+        &iter,
+        nm_platform_lookup(
+            NM_PLATFORM_GET,
+            nmp_lookup_init_object_by_ifindex(&lookup, NMP_OBJECT_TYPE_IP4_ROUTE, ifindex)),
+        &o) {
+        if (NMP_OBJECT_CAST_IP4_ROUTE(o)->metric == metric)
+            n++;
+    }
+    return n;
+}
+
+static void
+test_ip4_route_sync_batch(void)
+{
+    const int                    ifindex       = DEVICE_IFINDEX;
+    const guint32                metric        = 22987;
+    const guint                  N             = nmtst_get_rand_uint32() % 1000u + 300u;
+    gs_unref_ptrarray GPtrArray *routes        = NULL;
+    gs_unref_ptrarray GPtrArray *routes_prune  = NULL;
+    gs_unref_ptrarray GPtrArray *routes_failed = NULL;
+    guint                        i;
+
+    /* Sync more routes than what fits into one batch of requests, and check
+     * that all of them get configured (and pruned again). */
+
+    routes = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    for (i = 0; i < N; i++) {
+        const NMPlatformIP4Route r = {
+            .ifindex   = ifindex,
+            .rt_source = NM_IP_CONFIG_SOURCE_USER,
+            .network   = htonl(0x0A000000u | (i << 8)),
+            .plen      = 24,
+            .metric    = metric,
+        };
+
+        g_ptr_array_add(routes,
+                        nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r));
+    }
+
+    g_assert(nm_platform_ip_route_sync(NM_PLATFORM_GET,
+                                       AF_INET,
+                                       ifindex,
+                                       routes,
+                                       NULL,
+                                       &routes_failed));
+    g_assert(!routes_failed);
+    g_assert_cmpint(_ip4_routes_count_with_metric(ifindex, metric), ==, N);
+
+    /* Syncing the same routes again is a no-op. */
+    g_assert(nm_platform_ip_route_sync(NM_PLATFORM_GET,
+                                       AF_INET,
+                                       ifindex,
+                                       routes,
+                                       NULL,
+                                       &routes_failed));
+    g_assert(!routes_failed);
+    g_assert_cmpint(_ip4_routes_count_with_metric(ifindex, metric), ==, N);
+
+    routes_prune = nm_platform_ip_route_get_prune_list(NM_PLATFORM_GET,
+                                                       AF_INET,
+                                                       ifindex,
+                                                       NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN);
+    g_ptr_array_set_size(routes, N / 2u);
+    g_assert(nm_platform_ip_route_sync(NM_PLATFORM_GET,
+                                       AF_INET,
+                                       ifindex,
+                                       routes,
+                                       routes_prune,
+                                       &routes_failed));
+    g_assert(!routes_failed);
+    g_assert_cmpint(_ip4_routes_count_with_metric(ifindex, metric), ==, N / 2u);
+
+    g_assert(nm_platform_ip_route_flush(NM_PLATFORM_GET, AF_INET, ifindex));
+    g_assert_cmpint(_ip4_routes_count_with_metric(ifindex, metric), ==, 0);
+}
+
+/*****************************************************************************/
+
 static gboolean
 _mptcp_has_permissions(void)
 {
@@ -2408,6 +2725,7 @@ _nmtstp_setup_tests(void)
     add_test_func("/route/ip4", test_ip4_route);
     add_test_func("/route/ip6", test_ip6_route);
     add_test_func("/route/ip4_metric0", test_ip4_route_metric0);
+    add_test_func("/route/ip4_sync_batch", test_ip4_route_sync_batch);
     add_test_func_data("/route/ip4_options/1", test_ip4_route_options, GINT_TO_POINTER(1));
     if (nmtstp_is_root_test())
         add_test_func_data("/route/ip4_options/2", test_ip4_route_options, GINT_TO_POINTER(2));
@@ -2420,6 +2738,9 @@ _nmtstp_setup_tests(void)
         add_test_func("/route/ip4_route_get", test_ip4_route_get);
         add_test_func("/route/ip6_route_get", test_ip6_route_get);
         add_test_func("/route/ip4_zero_gateway", test_ip4_zero_gateway);
+        add_test_func("/route/ip4_table_filter", test_ip4_route_table_filter);
+        add_test_func("/route/ip4_table_filter_auto", test_ip4_route_table_filter_auto);
+        add_test_func("/route/ip4_parse_thread", test_ip4_route_parse_thread);
     }
 
     if (nmtstp_is_root_test()) {
@@ -2427,6 +2748,7 @@ _nmtstp_setup_tests(void)
         add_test_func_data("/route/rule/2", test_rule, GINT_TO_POINTER(2));
         add_test_func_data("/route/rule/3", test_rule, GINT_TO_POINTER(3));
         add_test_func_data("/route/rule/4", test_rule, GINT_TO_POINTER(4));
+        add_test_func("/route/rule/keep-deleted", test_rule_keep_deleted);
     }
     if (nmtstp_is_root_test()) {
         add_test_func_data("/route/blackhole/1", test_blackhole, GINT_TO_POINTER(1));
@@ -2,6 +2,7 @@
 
 #include "src/core/nm-default-daemon.h"
 
+#include <linux/if_ether.h>
 #include <linux/pkt_sched.h>
 
 #include "nm-test-utils-core.h"
@@ -37,6 +38,87 @@ qdiscs_lookup(int ifindex)
         NULL);
 }
 
+static NMPObject *
+tfilter_new_mirred(int ifindex, guint32 parent, int mirred_ifindex, gboolean redirect)
+{
+    NMPObject *obj;
+
+    obj          = nmp_object_new(NMP_OBJECT_TYPE_TFILTER, NULL);
+    obj->tfilter = (NMPlatformTfilter) {
+        .ifindex     = ifindex,
+        .kind        = "matchall",
+        .addr_family = AF_UNSPEC,
+        .parent      = parent,
+        .info        = TC_H_MAKE(0, htons(ETH_P_ALL)),
+        .action =
+            {
+                .kind = NM_PLATFORM_ACTION_KIND_MIRRED,
+                .mirred =
+                    {
+                        .ifindex  = mirred_ifindex,
+                        .egress   = TRUE,
+                        .mirror   = !redirect,
+                        .redirect = redirect,
+                    },
+            },
+    };
+
+    return obj;
+}
+
+static GPtrArray *
+tfilters_lookup(int ifindex)
+{
+    NMPLookup lookup;
+
+    return nm_platform_lookup_clone(
+        NM_PLATFORM_GET,
+        nmp_lookup_init_object_by_ifindex(&lookup, NMP_OBJECT_TYPE_TFILTER, ifindex),
+        NULL,
+        NULL);
+}
+
+static const NMPlatformTfilter *
+tfilters_find_mirred(GPtrArray *tfilters, gboolean redirect)
+{
+    const NMPlatformTfilter *found = NULL;
+    guint                    i;
+
+    for (i = 0; tfilters && i < tfilters->len; i++) {
+        const NMPlatformTfilter *tfilter = NMP_OBJECT_CAST_TFILTER(tfilters->pdata[i]);
+
+        if (nm_streq0(tfilter->action.kind, NM_PLATFORM_ACTION_KIND_MIRRED)
+            && tfilter->action.mirred.redirect == redirect) {
+            g_assert(!found);
+            found = tfilter;
+        }
+    }
+    return found;
+}
+
+typedef struct {
+    int   ifindex;
+    guint added;
+    guint removed;
+} TfilterSignalData;
+
+static void
+tfilter_changed_cb(NMPlatform              *platform,
+                   int                      obj_type_i,
+                   int                      ifindex,
+                   const NMPlatformTfilter *tfilter,
+                   int                      change_type_i,
+                   TfilterSignalData       *data)
+{
+    if (ifindex != data->ifindex)
+        return;
+
+    if (change_type_i == NM_PLATFORM_SIGNAL_ADDED)
+        data->added++;
+    else if (change_type_i == NM_PLATFORM_SIGNAL_REMOVED)
+        data->removed++;
+}
+
 static void
 test_qdisc1(void)
 {
@@ -58,7 +140,11 @@ test_qdisc1(void)
     g_ptr_array_add(known, qdisc_new(ifindex, "fq_codel", TC_H_ROOT));
     g_ptr_array_add(known, qdisc_new(ifindex, "ingress", TC_H_INGRESS));
 
-    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET, ifindex, known, NULL));
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known,
+                                 NULL,
+                                 NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL));
     plat = qdiscs_lookup(ifindex);
     g_assert(plat);
     g_assert_cmpint(plat->len, ==, 2);
@@ -98,7 +184,11 @@ test_qdisc_fq_codel(void)
     obj->qdisc.fq_codel.quantum = 1000;
     g_ptr_array_add(known, obj);
 
-    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET, ifindex, known, NULL));
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known,
+                                 NULL,
+                                 NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL));
     plat = qdiscs_lookup(ifindex);
     g_assert(plat);
     g_assert_cmpint(plat->len, ==, 1);
@@ -137,7 +227,11 @@ test_qdisc_sfq(void)
     obj->qdisc.sfq.flows          = 256;
     g_ptr_array_add(known, obj);
 
-    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET, ifindex, known, NULL));
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known,
+                                 NULL,
+                                 NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL));
     plat = qdiscs_lookup(ifindex);
     g_assert(plat);
     g_assert_cmpint(plat->len, ==, 1);
@@ -180,7 +274,11 @@ test_qdisc_tbf(void)
     obj->qdisc.handle = TC_H_MAKE(0x8005 << 16, 0);
     g_ptr_array_add(known, obj);
 
-    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET, ifindex, known, NULL));
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known,
+                                 NULL,
+                                 NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL));
     plat = qdiscs_lookup(ifindex);
     g_assert(plat);
     g_assert_cmpint(plat->len, ==, 2);
@@ -201,6 +299,227 @@ test_qdisc_tbf(void)
     g_assert_cmpint(qdisc->handle, ==, TC_H_MAKE(0x8005 << 16, 0));
 }
 
+static void
+test_qdisc_reconcile(void)
+{
+    int                          ifindex;
+    gs_unref_ptrarray GPtrArray *known = NULL;
+    gs_unref_ptrarray GPtrArray *plat  = NULL;
+    NMPObject                   *obj;
+    const NMPlatformQdisc       *qdisc;
+    guint32                      handle;
+
+    ifindex = nm_platform_link_get_ifindex(NM_PLATFORM_GET, DEVICE_NAME);
+    g_assert_cmpint(ifindex, >, 0);
+
+    nmtstp_run_command("tc qdisc del dev %s root", DEVICE_NAME);
+    nmtstp_run_command("tc qdisc del dev %s ingress", DEVICE_NAME);
+
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 0);
+
+    /* Without a handle, kernel picks one for the qdisc. It only stays the
+     * same as long as the qdisc is not replaced. */
+    known = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    obj   = qdisc_new(ifindex, "fq_codel", TC_H_ROOT);
+    obj->qdisc.fq_codel.memory_limit = NM_PLATFORM_FQ_CODEL_MEMORY_LIMIT_UNSET;
+    obj->qdisc.fq_codel.ce_threshold = NM_PLATFORM_FQ_CODEL_CE_THRESHOLD_DISABLED;
+    g_ptr_array_add(known, obj);
+    g_ptr_array_add(known, qdisc_new(ifindex, "ingress", TC_H_INGRESS));
+
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known,
+                                 NULL,
+                                 NM_PLATFORM_TC_SYNC_MODE_RECONCILE));
+    plat = qdiscs_lookup(ifindex);
+    g_assert(plat);
+    g_assert_cmpint(plat->len, ==, 2);
+    qdisc = NMP_OBJECT_CAST_QDISC(plat->pdata[0]);
+    g_assert_cmpstr(qdisc->kind, ==, "fq_codel");
+    handle = qdisc->handle;
+    g_assert_cmpint(handle, !=, 0);
+    nm_clear_pointer(&plat, g_ptr_array_unref);
+
+    /* Nothing changed, nothing gets replaced. */
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known,
+                                 NULL,
+                                 NM_PLATFORM_TC_SYNC_MODE_RECONCILE));
+    plat = qdiscs_lookup(ifindex);
+    g_assert(plat);
+    g_assert_cmpint(plat->len, ==, 2);
+    qdisc = NMP_OBJECT_CAST_QDISC(plat->pdata[0]);
+    g_assert_cmpstr(qdisc->kind, ==, "fq_codel");
+    g_assert_cmpint(qdisc->handle, ==, handle);
+    nm_clear_pointer(&plat, g_ptr_array_unref);
+
+    /* A changed option replaces the qdisc. */
+    NMP_OBJECT_CAST_QDISC(known->pdata[0])->fq_codel.limit = 2048;
+
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known,
+                                 NULL,
+                                 NM_PLATFORM_TC_SYNC_MODE_RECONCILE));
+    plat = qdiscs_lookup(ifindex);
+    g_assert(plat);
+    g_assert_cmpint(plat->len, ==, 2);
+    qdisc = NMP_OBJECT_CAST_QDISC(plat->pdata[0]);
+    g_assert_cmpstr(qdisc->kind, ==, "fq_codel");
+    g_assert_cmpint(qdisc->fq_codel.limit, ==, 2048);
+    qdisc = NMP_OBJECT_CAST_QDISC(plat->pdata[1]);
+    g_assert_cmpstr(qdisc->kind, ==, "ingress");
+}
+
+static void
+test_tfilter_matchall_mirred(void)
+{
+    const guint32                HANDLE = TC_H_MAKE(0x8144 << 16, 0);
+    int                          ifindex;
+    gs_unref_ptrarray GPtrArray *known_qdiscs   = NULL;
+    gs_unref_ptrarray GPtrArray *known_tfilters = NULL;
+    gs_unref_ptrarray GPtrArray *plat           = NULL;
+    NMPObject                   *obj;
+    const NMPlatformTfilter     *tfilter;
+
+    ifindex = nm_platform_link_get_ifindex(NM_PLATFORM_GET, DEVICE_NAME);
+    g_assert_cmpint(ifindex, >, 0);
+
+    nmtstp_run_command("tc qdisc del dev %s root", DEVICE_NAME);
+
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 0);
+
+    known_qdiscs      = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    obj               = qdisc_new(ifindex, "prio", TC_H_ROOT);
+    obj->qdisc.handle = HANDLE;
+    g_ptr_array_add(known_qdiscs, obj);
+
+    known_tfilters = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    g_ptr_array_add(known_tfilters, tfilter_new_mirred(ifindex, HANDLE, ifindex, TRUE));
+
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known_qdiscs,
+                                 known_tfilters,
+                                 NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL));
+
+    /* The action is parsed back into the cache, so that the filter can be
+     * compared with the requested one. */
+    plat = tfilters_lookup(ifindex);
+    g_assert(plat);
+    g_assert_cmpint(plat->len, ==, 1);
+
+    tfilter = NMP_OBJECT_CAST_TFILTER(plat->pdata[0]);
+    g_assert_cmpstr(tfilter->kind, ==, "matchall");
+    g_assert_cmpint(tfilter->parent, ==, HANDLE);
+    g_assert_cmpint(TC_H_MIN(tfilter->info), ==, htons(ETH_P_ALL));
+    g_assert_cmpstr(tfilter->action.kind, ==, NM_PLATFORM_ACTION_KIND_MIRRED);
+    g_assert_cmpint(tfilter->action.mirred.ifindex, ==, ifindex);
+    g_assert(tfilter->action.mirred.egress);
+    g_assert(!tfilter->action.mirred.ingress);
+    g_assert(tfilter->action.mirred.redirect);
+    g_assert(!tfilter->action.mirred.mirror);
+}
+
+static void
+test_tfilter_reconcile(void)
+{
+    const guint32                HANDLE = TC_H_MAKE(0x8145 << 16, 0);
+    int                          ifindex;
+    gs_unref_ptrarray GPtrArray *known_qdiscs   = NULL;
+    gs_unref_ptrarray GPtrArray *known_tfilters = NULL;
+    gs_unref_ptrarray GPtrArray *plat           = NULL;
+    NMPObject                   *obj;
+    TfilterSignalData            signal_data;
+    gulong                       signal_id;
+
+    ifindex = nm_platform_link_get_ifindex(NM_PLATFORM_GET, DEVICE_NAME);
+    g_assert_cmpint(ifindex, >, 0);
+
+    nmtstp_run_command("tc qdisc del dev %s root", DEVICE_NAME);
+
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 0);
+
+    signal_data = (TfilterSignalData) {
+        .ifindex = ifindex,
+    };
+    signal_id = g_signal_connect(NM_PLATFORM_GET,
+                                 NM_PLATFORM_SIGNAL_TFILTER_CHANGED,
+                                 G_CALLBACK(tfilter_changed_cb),
+                                 &signal_data);
+
+    known_qdiscs      = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    obj               = qdisc_new(ifindex, "prio", TC_H_ROOT);
+    obj->qdisc.handle = HANDLE;
+    g_ptr_array_add(known_qdiscs, obj);
+
+    known_tfilters = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    g_ptr_array_add(known_tfilters, tfilter_new_mirred(ifindex, HANDLE, ifindex, FALSE));
+    g_ptr_array_add(known_tfilters, tfilter_new_mirred(ifindex, HANDLE, ifindex, TRUE));
+
+    /* The filters get added. */
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known_qdiscs,
+                                 known_tfilters,
+                                 NM_PLATFORM_TC_SYNC_MODE_RECONCILE));
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 0);
+    plat = tfilters_lookup(ifindex);
+    g_assert(plat);
+    g_assert_cmpint(plat->len, ==, 2);
+    g_assert(tfilters_find_mirred(plat, FALSE));
+    g_assert(tfilters_find_mirred(plat, TRUE));
+    g_assert_cmpint(signal_data.added, ==, 2);
+    nm_clear_pointer(&plat, g_ptr_array_unref);
+
+    /* Nothing changed, the filters are kept. */
+    signal_data.added   = 0;
+    signal_data.removed = 0;
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known_qdiscs,
+                                 known_tfilters,
+                                 NM_PLATFORM_TC_SYNC_MODE_RECONCILE));
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 0);
+    plat = tfilters_lookup(ifindex);
+    g_assert(plat);
+    g_assert_cmpint(plat->len, ==, 2);
+    g_assert_cmpint(signal_data.added, ==, 0);
+    g_assert_cmpint(signal_data.removed, ==, 0);
+    nm_clear_pointer(&plat, g_ptr_array_unref);
+
+    /* A filter that is no longer requested gets removed. */
+    signal_data.added   = 0;
+    signal_data.removed = 0;
+    g_ptr_array_remove_index(known_tfilters, 1);
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known_qdiscs,
+                                 known_tfilters,
+                                 NM_PLATFORM_TC_SYNC_MODE_RECONCILE));
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 0);
+    plat = tfilters_lookup(ifindex);
+    g_assert(plat);
+    g_assert_cmpint(plat->len, ==, 1);
+    g_assert(tfilters_find_mirred(plat, FALSE));
+    g_assert(!tfilters_find_mirred(plat, TRUE));
+    g_assert_cmpint(signal_data.removed, >=, 1);
+    nm_clear_pointer(&plat, g_ptr_array_unref);
+
+    /* Without filters, all are removed. */
+    g_assert(nm_platform_tc_sync(NM_PLATFORM_GET,
+                                 ifindex,
+                                 known_qdiscs,
+                                 NULL,
+                                 NM_PLATFORM_TC_SYNC_MODE_RECONCILE));
+    nmtstp_wait_for_signal(NM_PLATFORM_GET, 0);
+    plat = tfilters_lookup(ifindex);
+    g_assert(!plat || plat->len == 0);
+
+    g_assert(nm_clear_g_signal_handler(NM_PLATFORM_GET, &signal_id));
+}
+
 /*****************************************************************************/
 
 NMTstpSetupFunc const _nmtstp_setup_platform_func = nm_linux_platform_setup_with_tc_cache;
@@ -218,4 +537,10 @@ _nmtstp_setup_tests(void)
     nmtstp_env1_add_test_func("/link/qdisc/fq_codel", test_qdisc_fq_codel, 1, TRUE);
     nmtstp_env1_add_test_func("/link/qdisc/sfq", test_qdisc_sfq, 1, TRUE);
     nmtstp_env1_add_test_func("/link/qdisc/tbf", test_qdisc_tbf, 1, TRUE);
+    nmtstp_env1_add_test_func("/link/qdisc/reconcile", test_qdisc_reconcile, 1, TRUE);
+    nmtstp_env1_add_test_func("/link/tfilter/matchall-mirred",
+                              test_tfilter_matchall_mirred,
+                              1,
+                              TRUE);
+    nmtstp_env1_add_test_func("/link/tfilter/reconcile", test_tfilter_reconcile, 1, TRUE);
 }
@@ -437,7 +437,7 @@ _nm_settings_connection_set_connection(NMSettingsConnection            *self,
         nm_assert_connection_unchanging(priv->connection);
 
         _getsettings_cached_clear(priv);
-        _nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(priv->settings);
+        _nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(priv->settings, self);
 
         /* note that we only return @connection_old if the new connection actually differs from
          * before.
@@ -2364,7 +2364,7 @@ nm_settings_connection_update_timestamp(NMSettingsConnection *self, guint64 time
 
     _LOGT("timestamp: set timestamp %" G_GUINT64_FORMAT, timestamp);
 
-    _nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(priv->settings);
+    _nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(priv->settings, self);
 
     if (!priv->kf_db_timestamps)
         return;
@@ -2769,6 +2769,8 @@ nm_settings_connection_init(NMSettingsConnection *self)
 
     c_list_init(&self->_connections_lst);
     c_list_init(&self->devcon_con_lst_head);
+    c_rbnode_init(&self->_autoconnect_priority_node);
+    nm_sett_util_candidates_entry_init(&self->_candidates_entry);
     c_list_init(&priv->seen_bssids_lst_head);
     c_list_init(&priv->call_ids_lst_head);
     c_list_init(&priv->auth_lst_head);
@@ -2797,6 +2799,8 @@ dispose(GObject *object)
     nm_assert(!priv->default_wired_device);
 
     nm_assert(c_list_is_empty(&self->_connections_lst));
+    nm_assert(!c_rbnode_is_linked(&self->_autoconnect_priority_node));
+    nm_assert(!nm_sett_util_candidates_entry_is_linked(&self->_candidates_entry));
     nm_assert(c_list_is_empty(&self->devcon_con_lst_head));
     nm_assert(c_list_is_empty(&priv->auth_lst_head));
 
@@ -9,11 +9,14 @@
 
 #include "libnm-core-intern/nm-meta-setting-base.h"
 
+#include "c-rbtree/src/c-rbtree.h"
+
 #include "nm-dbus-object.h"
 #include "nm-connection.h"
 #include "NetworkManagerUtils.h"
 
 #include "nm-settings-storage.h"
+#include "nm-settings-utils.h"
 
 /*****************************************************************************/
 
@@ -202,6 +205,8 @@ struct _NMSettingsConnection {
     NMDBusObject                         parent;
     CList                                _connections_lst;
     CList                                devcon_con_lst_head;
+    CRBNode                              _autoconnect_priority_node;
+    NMSettUtilCandidatesEntry            _candidates_entry;
     struct _NMSettingsConnectionPrivate *_priv;
 };
 
@@ -12,6 +12,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "libnm-core-intern/nm-core-internal.h"
 #include "nm-settings-plugin.h"
 
 /*****************************************************************************/
@@ -159,3 +160,200 @@ nm_sett_util_storages_steal(NMSettUtilStorages *storages,
 
     return storage;
 }
+
+/*****************************************************************************/
+
+struct _NMSettUtilCandidatesBucket {
+    /* must be the first field, for nm_pstr_hash(). */
+    const char *key;
+    GHashTable *idx;
+    CList       lst_head;
+    char        key_buf[];
+};
+
+void
+nm_sett_util_candidates_clear(NMSettUtilCandidates *candidates)
+{
+    nm_assert(!candidates->idx_by_iface || g_hash_table_size(candidates->idx_by_iface) == 0);
+    nm_assert(!candidates->idx_by_hwaddr || g_hash_table_size(candidates->idx_by_hwaddr) == 0);
+    nm_assert(!candidates->idx_by_type || g_hash_table_size(candidates->idx_by_type) == 0);
+
+    nm_clear_pointer(&candidates->idx_by_iface, g_hash_table_destroy);
+    nm_clear_pointer(&candidates->idx_by_hwaddr, g_hash_table_destroy);
+    nm_clear_pointer(&candidates->idx_by_type, g_hash_table_destroy);
+}
+
+/**
+ * nm_sett_util_candidates_get_hwaddr:
+ * @connection: the profile
+ *
+ * Returns: (transfer full): the canonical MAC address that @connection
+ *   is bound to, or %NULL. That is only the case, if a device can only be
+ *   compatible with @connection when its permanent MAC address matches.
+ */
+char *
+nm_sett_util_candidates_get_hwaddr(NMConnection *connection)
+{
+    const char *type = nm_connection_get_connection_type(connection);
+    const char *mac  = NULL;
+
+    /* See check_connection_compatible() of NMDeviceEthernet, NMDeviceWifi
+     * and NMDeviceIwd. */
+    if (nm_streq0(type, NM_SETTING_WIRED_SETTING_NAME)) {
+        NMSettingWired *s_wired = nm_connection_get_setting_wired(connection);
+
+        /* with s390 subchannels, the MAC address may not be checked. */
+        if (s_wired && NM_PTRARRAY_LEN(nm_setting_wired_get_s390_subchannels(s_wired)) == 0)
+            mac = nm_setting_wired_get_mac_address(s_wired);
+    } else if (nm_streq0(type, NM_SETTING_WIRELESS_SETTING_NAME)) {
+        NMSettingWireless *s_wireless = nm_connection_get_setting_wireless(connection);
+
+        if (s_wireless)
+            mac = nm_setting_wireless_get_mac_address(s_wireless);
+    }
+
+    return mac ? nm_utils_hwaddr_canonical(mac, -1) : NULL;
+}
+
+void
+nm_sett_util_candidates_remove(NMSettUtilCandidatesEntry *entry)
+{
+    NMSettUtilCandidatesBucket *bucket = entry->_bucket;
+
+    if (!bucket)
+        return;
+
+    entry->_bucket          = NULL;
+    entry->_connection_type = NULL;
+    c_list_unlink(&entry->_lst);
+    if (c_list_is_empty(&bucket->lst_head))
+        g_hash_table_remove(bucket->idx, bucket);
+}
+
+/**
+ * nm_sett_util_candidates_update:
+ * @candidates: the index
+ * @entry: the entry of the profile
+ * @connection: the current content of the profile
+ *
+ * Adds @entry to the index, or moves it to the bucket that matches @connection.
+ * This must be called whenever the content of the profile changes.
+ */
+void
+nm_sett_util_candidates_update(NMSettUtilCandidates      *candidates,
+                               NMSettUtilCandidatesEntry *entry,
+                               NMConnection              *connection)
+{
+    gs_free char               *hwaddr = NULL;
+    const char                 *connection_type;
+    GHashTable                 *idx;
+    const char                 *key;
+    NMSettUtilCandidatesBucket *bucket;
+    gsize                       l;
+
+    connection_type = nm_connection_get_connection_type(connection);
+
+    if ((key = nm_connection_get_interface_name(connection)))
+        idx = candidates->idx_by_iface;
+    else if ((key = (hwaddr = nm_sett_util_candidates_get_hwaddr(connection))))
+        idx = candidates->idx_by_hwaddr;
+    else {
+        key = connection_type ?: "";
+        idx = candidates->idx_by_type;
+    }
+
+    /* The connection.type of the profile is needed to filter the buckets
+     * by interface name and MAC address. */
+    connection_type = connection_type ? g_intern_string(connection_type) : NULL;
+
+    bucket = entry->_bucket;
+    if (bucket && bucket->idx == idx && nm_streq(bucket->key, key)) {
+        entry->_connection_type = connection_type;
+        return;
+    }
+
+    nm_sett_util_candidates_remove(entry);
+
+    bucket = g_hash_table_lookup(idx, &key);
+    if (!bucket) {
+        l      = strlen(key) + 1;
+        bucket = g_malloc(sizeof(NMSettUtilCandidatesBucket) + l);
+        memcpy(bucket->key_buf, key, l);
+        bucket->key = bucket->key_buf;
+        bucket->idx = idx;
+        c_list_init(&bucket->lst_head);
+        g_hash_table_add(idx, bucket);
+    }
+
+    c_list_link_tail(&bucket->lst_head, &entry->_lst);
+    entry->_bucket          = bucket;
+    entry->_connection_type = connection_type;
+}
+
+static void
+_candidates_collect(GPtrArray         *arr,
+                    GHashTable        *idx,
+                    const char        *key,
+                    const char *const *connection_types)
+{
+    NMSettUtilCandidatesBucket *bucket;
+    NMSettUtilCandidatesEntry  *entry;
+
+    if (!key)
+        return;
+
+    bucket = g_hash_table_lookup(idx, &key);
+    if (!bucket)
+        return;
+
+    c_list_for_each_entry (entry, &bucket->lst_head, _lst) {
+        if (connection_types
+            && (!entry->_connection_type
+                || !nm_strv_contains(connection_types, -1, entry->_connection_type)))
+            continue;
+        g_ptr_array_add(arr, entry);
+    }
+}
+
+/**
+ * nm_sett_util_candidates_collect:
+ * @candidates: the index
+ * @iface: (nullable): the interface name of the device
+ * @hwaddr: (nullable): the permanent MAC address of the device
+ * @connection_types: (nullable): if set, the NULL terminated list of
+ *   connection.type values that the device is compatible with.
+ * @arr: the #NMSettUtilCandidatesEntry of the profiles that could be
+ *   compatible with the device get appended to this array.
+ *
+ * That excludes profiles bound to a different connection.interface-name
+ * or MAC address, and profiles of a type not in @connection_types.
+ */
+void
+nm_sett_util_candidates_collect(const NMSettUtilCandidates *candidates,
+                                const char                 *iface,
+                                const char                 *hwaddr,
+                                const char *const          *connection_types,
+                                GPtrArray                  *arr)
+{
+    gs_free char *hwaddr_canonical = NULL;
+
+    _candidates_collect(arr, candidates->idx_by_iface, iface, connection_types);
+
+    if (hwaddr)
+        hwaddr_canonical = nm_utils_hwaddr_canonical(hwaddr, -1);
+    _candidates_collect(arr, candidates->idx_by_hwaddr, hwaddr_canonical, connection_types);
+
+    if (connection_types) {
+        gsize i;
+
+        for (i = 0; connection_types[i]; i++)
+            _candidates_collect(arr, candidates->idx_by_type, connection_types[i], NULL);
+    } else {
+        GHashTableIter              h_iter;
+        NMSettUtilCandidatesBucket *bucket;
+
+        g_hash_table_iter_init(&h_iter, candidates->idx_by_type);
+        while (g_hash_table_iter_next(&h_iter, (gpointer *) &bucket, NULL))
+            _candidates_collect(arr, candidates->idx_by_type, bucket->key, NULL);
+    }
+}
@@ -88,4 +88,61 @@ typedef struct {
 
 gboolean nm_sett_util_allow_filename_cb(const char *filename, gpointer user_data);
 
+/*****************************************************************************/
+
+typedef struct _NMSettUtilCandidatesBucket NMSettUtilCandidatesBucket;
+
+typedef struct {
+    CList                       _lst;
+    NMSettUtilCandidatesBucket *_bucket;
+    const char                 *_connection_type;
+} NMSettUtilCandidatesEntry;
+
+/* Indexes the profiles that could be compatible with a device. Each profile
+ * is in exactly one bucket: by connection.interface-name, if set. Otherwise,
+ * by the MAC address the profile is bound to, if any. Otherwise, by
+ * connection.type. */
+typedef struct {
+    GHashTable *idx_by_iface;
+    GHashTable *idx_by_hwaddr;
+    GHashTable *idx_by_type;
+} NMSettUtilCandidates;
+
+#define NM_SETT_UTIL_CANDIDATES_INIT                                                         \
+    {                                                                                        \
+        .idx_by_iface  = g_hash_table_new_full(nm_pstr_hash, nm_pstr_equal, g_free, NULL),  \
+        .idx_by_hwaddr = g_hash_table_new_full(nm_pstr_hash, nm_pstr_equal, g_free, NULL),  \
+        .idx_by_type   = g_hash_table_new_full(nm_pstr_hash, nm_pstr_equal, g_free, NULL),  \
+    }
+
+void nm_sett_util_candidates_clear(NMSettUtilCandidates *candidates);
+
+static inline void
+nm_sett_util_candidates_entry_init(NMSettUtilCandidatesEntry *entry)
+{
+    c_list_init(&entry->_lst);
+    entry->_bucket          = NULL;
+    entry->_connection_type = NULL;
+}
+
+static inline gboolean
+nm_sett_util_candidates_entry_is_linked(const NMSettUtilCandidatesEntry *entry)
+{
+    return !!entry->_bucket;
+}
+
+char *nm_sett_util_candidates_get_hwaddr(NMConnection *connection);
+
+void nm_sett_util_candidates_update(NMSettUtilCandidates      *candidates,
+                                    NMSettUtilCandidatesEntry *entry,
+                                    NMConnection              *connection);
+
+void nm_sett_util_candidates_remove(NMSettUtilCandidatesEntry *entry);
+
+void nm_sett_util_candidates_collect(const NMSettUtilCandidates *candidates,
+                                     const char                 *iface,
+                                     const char                 *hwaddr,
+                                     const char *const          *connection_types,
+                                     GPtrArray                  *arr);
+
 #endif /* __NM_SETTINGS_UTILS_H__ */
@@ -385,6 +385,14 @@ typedef struct {
     NMSettingsConnection **connections_cached_list;
     NMSettingsConnection **connections_cached_list_sorted_by_autoconnect_priority;
 
+    /* All connections, sorted by nm_settings_connection_cmp_autoconnect_priority().
+     * A connection whose sort key changes is re-inserted, see
+     * _nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(). */
+    CRBTree connections_autoconnect_priority_tree;
+
+    /* Index for nm_settings_get_candidate_connections_clone(). */
+    NMSettUtilCandidates candidates;
+
     GSList *unmanaged_specs;
     GSList *unrecognized_specs;
 
@@ -405,12 +413,6 @@ typedef struct {
 
     bool started : 1;
 
-    /* Whether NMSettingsConnections changed in a way that affects the comparison
-     * with nm_settings_connection_cmp_autoconnect_priority_with_data(). In that case,
-     * we may need to re-sort the connections_cached_list_sorted_by_autoconnect_priority
-     * list. */
-    bool sorted_by_autoconnect_priority_maybe_changed : 1;
-
 } NMSettingsPrivate;
 
 struct _NMSettings {
@@ -446,6 +448,10 @@ static void default_wired_clear_tag(NMSettings           *self,
                                     gboolean              add_to_no_auto_default);
 
 static void _clear_connections_cached_list(NMSettingsPrivate *priv);
+static void _autoconnect_priority_tree_add(NMSettingsPrivate    *priv,
+                                           NMSettingsConnection *sett_conn);
+static void _candidates_idx_remove(NMSettingsConnection *sett_conn);
+static void _candidates_idx_update(NMSettingsPrivate *priv, NMSettingsConnection *sett_conn);
 
 static void _startup_complete_check(NMSettings *self, gint64 now_msec);
 
@@ -1109,6 +1115,8 @@ _connection_changed_update(NMSettings                      *self,
 
         _clear_connections_cached_list(priv);
         c_list_link_tail(&priv->connections_lst_head, &sett_conn->_connections_lst);
+        _autoconnect_priority_tree_add(priv, sett_conn);
+        _candidates_idx_update(priv, sett_conn);
         priv->connections_len++;
         priv->connections_generation++;
 
@@ -1116,7 +1124,8 @@ _connection_changed_update(NMSettings                      *self,
                          NM_SETTINGS_CONNECTION_FLAGS_CHANGED,
                          G_CALLBACK(connection_flags_changed),
                          self);
-    }
+    } else if (connection_old)
+        _candidates_idx_update(priv, sett_conn);
 
     if (NM_FLAGS_HAS(update_reason, NM_SETTINGS_CONNECTION_UPDATE_REASON_BLOCK_AUTOCONNECT)) {
         nm_settings_connection_autoconnect_blocked_reason_set(
@@ -1224,6 +1233,8 @@ _connection_changed_delete(NMSettings           *self,
 
     _clear_connections_cached_list(priv);
     c_list_unlink(&sett_conn->_connections_lst);
+    c_rbnode_unlink(&sett_conn->_autoconnect_priority_node);
+    _candidates_idx_remove(sett_conn);
     priv->connections_len--;
     priv->connections_generation++;
 
@@ -3042,12 +3053,102 @@ impl_settings_reload_connections(NMDBusObject                      *obj,
 
 /*****************************************************************************/
 
+static int
+_autoconnect_priority_tree_cmp(CRBTree *tree, void *key, CRBNode *node)
+{
+    return nm_settings_connection_cmp_autoconnect_priority(
+        key,
+        c_rbnode_entry(node, NMSettingsConnection, _autoconnect_priority_node));
+}
+
+static void
+_autoconnect_priority_tree_add(NMSettingsPrivate *priv, NMSettingsConnection *sett_conn)
+{
+    CRBNode **slot;
+    CRBNode  *parent;
+
+    nm_assert(!c_rbnode_is_linked(&sett_conn->_autoconnect_priority_node));
+
+    slot = c_rbtree_find_slot(&priv->connections_autoconnect_priority_tree,
+                              _autoconnect_priority_tree_cmp,
+                              sett_conn,
+                              &parent);
+
+    /* the comparison falls back to the UUID and the pointer value. It never
+     * considers two different connections as equal. */
+    nm_assert(slot);
+
+    c_rbtree_add(&priv->connections_autoconnect_priority_tree,
+                 parent,
+                 slot,
+                 &sett_conn->_autoconnect_priority_node);
+}
+
+static void
+_clear_connections_cached_list_sorted_by_autoconnect_priority(NMSettingsPrivate *priv)
+{
+    if (!priv->connections_cached_list_sorted_by_autoconnect_priority)
+        return;
+
+    nm_assert(priv->connections_len
+              == NM_PTRARRAY_LEN(priv->connections_cached_list_sorted_by_autoconnect_priority));
+
+#if NM_MORE_ASSERTS
+    /* set the pointer to a bogus value. This makes it more apparent
+     * if somebody has a reference to the cached list and still uses
+     * it. That is a bug, this code just tries to make it blow up
+     * more eagerly. */
+    memset(priv->connections_cached_list_sorted_by_autoconnect_priority,
+           0x42,
+           sizeof(NMSettingsConnection *) * (priv->connections_len + 1));
+#endif
+
+    nm_clear_g_free(&priv->connections_cached_list_sorted_by_autoconnect_priority);
+}
+
 void
-_nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(NMSettings *self)
+_nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(NMSettings           *self,
+                                                                 NMSettingsConnection *sett_conn)
 {
-    NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE(self);
+    NMSettingsPrivate    *priv = NM_SETTINGS_GET_PRIVATE(self);
+    CRBNode              *node = &sett_conn->_autoconnect_priority_node;
+    NMSettingsConnection *sibling;
 
-    priv->sorted_by_autoconnect_priority_maybe_changed = TRUE;
+    if (!c_rbnode_is_linked(node)) {
+        /* not yet added. It gets sorted in when it gets added. */
+        return;
+    }
+
+    /* Only @sett_conn changed. If it still sorts between its neighbors,
+     * the tree is still sorted and there is nothing to do. */
+    sibling = c_rbnode_entry(c_rbnode_prev(node), NMSettingsConnection, _autoconnect_priority_node);
+    if (!sibling || nm_settings_connection_cmp_autoconnect_priority(sibling, sett_conn) < 0) {
+        sibling =
+            c_rbnode_entry(c_rbnode_next(node), NMSettingsConnection, _autoconnect_priority_node);
+        if (!sibling || nm_settings_connection_cmp_autoconnect_priority(sett_conn, sibling) < 0)
+            return;
+    }
+
+    /* Unlinking does not compare nodes, so it's fine that the position of
+     * @sett_conn is currently wrong. */
+    c_rbnode_unlink(node);
+    _autoconnect_priority_tree_add(priv, sett_conn);
+
+    _clear_connections_cached_list_sorted_by_autoconnect_priority(priv);
+}
+
+static void
+_candidates_idx_remove(NMSettingsConnection *sett_conn)
+{
+    nm_sett_util_candidates_remove(&sett_conn->_candidates_entry);
+}
+
+static void
+_candidates_idx_update(NMSettingsPrivate *priv, NMSettingsConnection *sett_conn)
+{
+    nm_sett_util_candidates_update(&priv->candidates,
+                                   &sett_conn->_candidates_entry,
+                                   nm_settings_connection_get_connection(sett_conn));
 }
 
 static void
@@ -3068,22 +3169,7 @@ _clear_connections_cached_list(NMSettingsPrivate *priv)
 
         nm_clear_g_free(&priv->connections_cached_list);
     }
-    if (priv->connections_cached_list_sorted_by_autoconnect_priority) {
-        nm_assert(priv->connections_len
-                  == NM_PTRARRAY_LEN(priv->connections_cached_list_sorted_by_autoconnect_priority));
-
-#if NM_MORE_ASSERTS
-        /* set the pointer to a bogus value. This makes it more apparent
-         * if somebody has a reference to the cached list and still uses
-         * it. That is a bug, this code just tries to make it blow up
-         * more eagerly. */
-        memset(priv->connections_cached_list_sorted_by_autoconnect_priority,
-               0x42,
-               sizeof(NMSettingsConnection *) * (priv->connections_len + 1));
-#endif
-
-        nm_clear_g_free(&priv->connections_cached_list_sorted_by_autoconnect_priority);
-    }
+    _clear_connections_cached_list_sorted_by_autoconnect_priority(priv);
 }
 
 static void
@@ -3225,62 +3311,57 @@ nm_settings_get_connections(NMSettings *self, guint *out_len)
 NMSettingsConnection *const *
 nm_settings_get_connections_sorted_by_autoconnect_priority(NMSettings *self, guint *out_len)
 {
-    NMSettingsPrivate *priv;
-    gboolean           needs_sort = FALSE;
+    NMSettingsPrivate     *priv;
+    NMSettingsConnection **v;
+    NMSettingsConnection  *con;
+    guint                  i;
 
     g_return_val_if_fail(NM_IS_SETTINGS(self), NULL);
 
     priv = NM_SETTINGS_GET_PRIVATE(self);
 
     nm_assert(priv->connections_len == c_list_length(&priv->connections_lst_head));
-    nm_assert(
-        !priv->connections_cached_list_sorted_by_autoconnect_priority
-        || (priv->connections_len
-            == NM_PTRARRAY_LEN(priv->connections_cached_list_sorted_by_autoconnect_priority)));
 
-    if (!priv->connections_cached_list_sorted_by_autoconnect_priority) {
-        NMSettingsConnection *const *list_cached;
-        guint                        len;
+    if (G_UNLIKELY(!priv->connections_cached_list_sorted_by_autoconnect_priority)) {
+        /* The tree is always sorted. We only need to flatten it. */
+        v = g_new(NMSettingsConnection *, priv->connections_len + 1);
 
-        list_cached = nm_settings_get_connections(self, &len);
-        priv->connections_cached_list_sorted_by_autoconnect_priority =
-            nm_memdup(list_cached, sizeof(NMSettingsConnection *) * (len + 1));
-        needs_sort = (len > 1);
-    } else if (priv->sorted_by_autoconnect_priority_maybe_changed) {
-        if (!nm_utils_ptrarray_is_sorted(
-                (gconstpointer *) priv->connections_cached_list_sorted_by_autoconnect_priority,
-                priv->connections_len,
-                FALSE,
-                nm_settings_connection_cmp_autoconnect_priority_with_data,
-                NULL)) {
-            /* We cache the sorted list, but we don't monitor all entries whether they
-             * get modified to invalidate the sort order. So every time we have to check
-             * whether the sort order is still correct. The vast majority of the time it
-             * is, and this check is faster than sorting anew. */
-            needs_sort = TRUE;
+        i = 0;
+        nm_settings_for_each_connection_by_autoconnect_priority (self, con) {
+            nm_assert(i < priv->connections_len);
+            v[i++] = con;
         }
-    } else {
-        nm_assert(nm_utils_ptrarray_is_sorted(
-            (gconstpointer *) priv->connections_cached_list_sorted_by_autoconnect_priority,
-            priv->connections_len,
-            TRUE,
-            nm_settings_connection_cmp_autoconnect_priority_with_data,
-            NULL));
-    }
+        nm_assert(i == priv->connections_len);
+        v[i] = NULL;
 
-    priv->sorted_by_autoconnect_priority_maybe_changed = FALSE;
-    if (needs_sort) {
-        g_qsort_with_data(priv->connections_cached_list_sorted_by_autoconnect_priority,
-                          priv->connections_len,
-                          sizeof(NMSettingsConnection *),
-                          nm_settings_connection_cmp_autoconnect_priority_p_with_data,
-                          NULL);
+        priv->connections_cached_list_sorted_by_autoconnect_priority = v;
     }
 
+    nm_assert(nm_utils_ptrarray_is_sorted(
+        (gconstpointer *) priv->connections_cached_list_sorted_by_autoconnect_priority,
+        priv->connections_len,
+        TRUE,
+        nm_settings_connection_cmp_autoconnect_priority_with_data,
+        NULL));
+
     NM_SET_OUT(out_len, priv->connections_len);
     return priv->connections_cached_list_sorted_by_autoconnect_priority;
 }
 
+NMSettingsConnection *
+nm_settings_get_first_connection_by_autoconnect_priority(NMSettings *self)
+{
+    NMSettingsPrivate *priv;
+
+    g_return_val_if_fail(NM_IS_SETTINGS(self), NULL);
+
+    priv = NM_SETTINGS_GET_PRIVATE(self);
+
+    return c_rbnode_entry(c_rbtree_first(&priv->connections_autoconnect_priority_tree),
+                          NMSettingsConnection,
+                          _autoconnect_priority_node);
+}
+
 /**
  * nm_settings_get_connections_clone:
  * @self: the #NMSetting
@@ -3343,6 +3424,69 @@ nm_settings_get_connections_clone(NMSettings                    *self,
     return list;
 }
 
+/**
+ * nm_settings_get_candidate_connections_clone:
+ * @self: the #NMSettings
+ * @iface: (nullable): the interface name of the device
+ * @hwaddr: (nullable): the permanent MAC address of the device
+ * @connection_types: (nullable): if set, the NULL terminated list of
+ *   connection.type values that the device is compatible with.
+ * @out_len: (optional): optional output argument
+ * @func: caller-supplied function for filtering connections
+ * @func_data: caller-supplied data passed to @func
+ *
+ * Like nm_settings_get_connections_clone(), but only returns the profiles that
+ * could be compatible with a device with the given properties. That excludes
+ * profiles bound to a different connection.interface-name or MAC address.
+ * The caller still needs to check whether the profiles are actually compatible.
+ *
+ * Returns: (transfer container) (element-type NMSettingsConnection):
+ *   a NULL terminated array of #NMSettingsConnection objects, sorted by
+ *   nm_settings_connection_cmp_autoconnect_priority().
+ */
+NMSettingsConnection **
+nm_settings_get_candidate_connections_clone(NMSettings                    *self,
+                                            const char                    *iface,
+                                            const char                    *hwaddr,
+                                            const char *const             *connection_types,
+                                            guint                         *out_len,
+                                            NMSettingsConnectionFilterFunc func,
+                                            gpointer                       func_data)
+{
+    NMSettingsPrivate *priv;
+    GPtrArray         *arr;
+    guint              i, j;
+
+    g_return_val_if_fail(NM_IS_SETTINGS(self), NULL);
+
+    priv = NM_SETTINGS_GET_PRIVATE(self);
+
+    arr = g_ptr_array_new();
+
+    nm_sett_util_candidates_collect(&priv->candidates, iface, hwaddr, connection_types, arr);
+
+    for (i = 0, j = 0; i < arr->len; i++) {
+        NMSettUtilCandidatesEntry *entry = arr->pdata[i];
+        NMSettingsConnection      *sett_conn;
+
+        sett_conn = c_list_entry(&entry->_lst, NMSettingsConnection, _candidates_entry._lst);
+
+        if (!func || func(self, sett_conn, func_data))
+            arr->pdata[j++] = sett_conn;
+    }
+    g_ptr_array_set_size(arr, j);
+
+    if (arr->len > 1) {
+        g_ptr_array_sort_with_data(arr,
+                                   nm_settings_connection_cmp_autoconnect_priority_p_with_data,
+                                   NULL);
+    }
+
+    NM_SET_OUT(out_len, arr->len);
+    g_ptr_array_add(arr, NULL);
+    return (NMSettingsConnection **) g_ptr_array_free(arr, FALSE);
+}
+
 NMSettingsConnection *
 nm_settings_get_connection_by_path(NMSettings *self, const char *path)
 {
@@ -4206,6 +4350,8 @@ nm_settings_init(NMSettings *self)
                                           NULL,
                                           (GDestroyNotify) _sett_conn_entry_free);
 
+    priv->candidates = (NMSettUtilCandidates) NM_SETT_UTIL_CANDIDATES_INIT;
+
     priv->config = g_object_ref(nm_config_get());
 
     priv->agent_mgr = g_object_ref(nm_agent_manager_get());
@@ -4277,12 +4423,15 @@ finalize(GObject *object)
     _clear_connections_cached_list(priv);
 
     nm_assert(c_list_is_empty(&priv->connections_lst_head));
+    nm_assert(c_rbtree_is_empty(&priv->connections_autoconnect_priority_tree));
 
     nm_assert(c_list_is_empty(&priv->sce_dirty_lst_head));
     nm_assert(g_hash_table_size(priv->sce_idx) == 0);
 
     nm_clear_pointer(&priv->sce_idx, g_hash_table_destroy);
 
+    nm_sett_util_candidates_clear(&priv->candidates);
+
     g_slist_free_full(priv->unmanaged_specs, g_free);
     g_slist_free_full(priv->unrecognized_specs, g_free);
 
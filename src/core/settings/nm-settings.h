@@ -85,6 +85,24 @@ NMSettingsConnection *const *nm_settings_get_connections(NMSettings *settings, g
 NMSettingsConnection *const *
 nm_settings_get_connections_sorted_by_autoconnect_priority(NMSettings *self, guint *out_len);
 
+NMSettingsConnection *nm_settings_get_first_connection_by_autoconnect_priority(NMSettings *self);
+
+static inline NMSettingsConnection *
+nm_settings_connection_get_next_by_autoconnect_priority(NMSettingsConnection *sett_conn)
+{
+    return c_rbnode_entry(c_rbnode_next(&sett_conn->_autoconnect_priority_node),
+                          NMSettingsConnection,
+                          _autoconnect_priority_node);
+}
+
+/* Iterates over all connections in the order of
+ * nm_settings_connection_cmp_autoconnect_priority(), without copying them
+ * into a list first. The settings must not be modified while iterating. */
+#define nm_settings_for_each_connection_by_autoconnect_priority(self, iter)       \
+    for ((iter) = nm_settings_get_first_connection_by_autoconnect_priority(self); \
+         (iter);                                                                  \
+         (iter) = nm_settings_connection_get_next_by_autoconnect_priority(iter))
+
 NMSettingsConnection **nm_settings_get_connections_clone(NMSettings                    *self,
                                                          guint                         *out_len,
                                                          NMSettingsConnectionFilterFunc func,
@@ -92,6 +110,15 @@ NMSettingsConnection **nm_settings_get_connections_clone(NMSettings
                                                          GCompareDataFunc sort_compare_func,
                                                          gpointer         sort_data);
 
+NMSettingsConnection **
+nm_settings_get_candidate_connections_clone(NMSettings                    *self,
+                                            const char                    *iface,
+                                            const char                    *hwaddr,
+                                            const char *const             *connection_types,
+                                            guint                         *out_len,
+                                            NMSettingsConnectionFilterFunc func,
+                                            gpointer                       func_data);
+
 gboolean nm_settings_add_connection(NMSettings                     *settings,
                                     const char                     *plugin,
                                     NMConnection                   *connection,
@@ -135,6 +162,8 @@ const char *nm_settings_get_startup_complete_blocked_reason(NMSettings *self,
 
 void nm_settings_kf_db_write(NMSettings *settings);
 
-void _nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(NMSettings *self);
+void _nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(
+    NMSettings           *self,
+    NMSettingsConnection *sett_conn);
 
 #endif /* __NM_SETTINGS_H__ */
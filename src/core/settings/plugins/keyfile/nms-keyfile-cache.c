@@ -0,0 +1,351 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ */
+
+#include "src/core/nm-default-daemon.h"
+
+#include "nms-keyfile-cache.h"
+
+#include <sys/stat.h>
+
+#include "libnm-glib-aux/nm-uuid.h"
+#include "libnm-glib-aux/nm-io-utils.h"
+#include "libnm-core-intern/nm-core-internal.h"
+#include "nms-keyfile-utils.h"
+
+/*****************************************************************************/
+
+/* The cache stores the profiles that were loaded from keyfiles, already
+ * normalized and serialized as GVariant. An entry is only used if the
+ * file's inode, size and modification time are unchanged.
+ *
+ * The cache is read by worker threads while loading the keyfiles (see
+ * _load_files() in "nms-keyfile-plugin.c"). After loading, it is immutable
+ * and lookups are thread-safe. */
+
+#define CACHE_FORMAT_VERSION 1
+
+#define CACHE_VARIANT_TYPE_ENTRY "(ttxxiiiimsa{sa{sv}})"
+#define CACHE_VARIANT_TYPE       "(ussa{s" CACHE_VARIANT_TYPE_ENTRY "})"
+
+struct _NMSKeyfileCache {
+    GVariant *data;
+
+    /* Indexes the entries of @data by the full filename of the keyfile. */
+    GHashTable *idx;
+};
+
+/*****************************************************************************/
+
+/**
+ * nms_keyfile_cache_load:
+ * @filename: the filename of the cache.
+ * @profile_dir: the profile directory of the keyfile plugin. A cache written
+ *   for a different directory is not used.
+ *
+ * Returns: (transfer full): the cache. If the cache file does not exist, is
+ *   outdated or is corrupt, the cache is empty. Lookups then always miss.
+ */
+NMSKeyfileCache *
+nms_keyfile_cache_load(const char *filename, const char *profile_dir)
+{
+    NMSKeyfileCache           *cache;
+    gs_free_error GError      *error       = NULL;
+    gs_unref_bytes GBytes     *bytes       = NULL;
+    gs_unref_variant GVariant *v_entries   = NULL;
+    GMappedFile               *mapped_file = NULL;
+    guint32                    format_version;
+    const char                *version;
+    const char                *cache_profile_dir;
+    gsize                      n;
+    gsize                      i;
+
+    cache  = g_slice_new(NMSKeyfileCache);
+    *cache = (NMSKeyfileCache){
+        .idx = g_hash_table_new_full(nm_str_hash,
+                                     g_str_equal,
+                                     g_free,
+                                     (GDestroyNotify) g_variant_unref),
+    };
+
+    /* The cache contains secrets. Accept it only with the same permissions
+     * that we require for keyfiles. */
+    if (!nms_keyfile_utils_check_file_permissions(NMS_KEYFILE_FILETYPE_KEYFILE,
+                                                  filename,
+                                                  NULL,
+                                                  &error)) {
+        nm_log_dbg(LOGD_SETTINGS,
+                   "keyfile: cache: not using \"%s\": %s",
+                   filename,
+                   error->message);
+        return cache;
+    }
+
+    mapped_file = g_mapped_file_new(filename, FALSE, &error);
+    if (!mapped_file) {
+        nm_log_dbg(LOGD_SETTINGS,
+                   "keyfile: cache: cannot map \"%s\": %s",
+                   filename,
+                   error->message);
+        return cache;
+    }
+    bytes = g_mapped_file_get_bytes(mapped_file);
+    g_mapped_file_unref(mapped_file);
+
+    /* The data is not trusted. GVariant handles data that is not in normal form
+     * gracefully, by returning default values. Such entries will not match. */
+    cache->data = g_variant_ref_sink(
+        g_variant_new_from_bytes(G_VARIANT_TYPE(CACHE_VARIANT_TYPE), bytes, FALSE));
+
+    g_variant_get(cache->data,
+                  "(u&s&s@a{s" CACHE_VARIANT_TYPE_ENTRY "})",
+                  &format_version,
+                  &version,
+                  &cache_profile_dir,
+                  &v_entries);
+
+    if (format_version != CACHE_FORMAT_VERSION || !nm_streq(version, VERSION)
+        || !nm_streq(cache_profile_dir, profile_dir ?: "")) {
+        nm_log_dbg(LOGD_SETTINGS, "keyfile: cache: ignore outdated \"%s\"", filename);
+        nm_clear_pointer(&cache->data, g_variant_unref);
+        return cache;
+    }
+
+    n = g_variant_n_children(v_entries);
+    for (i = 0; i < n; i++) {
+        const char *full_filename;
+        GVariant   *v_entry;
+
+        g_variant_get_child(v_entries,
+                            i,
+                            "{&s@" CACHE_VARIANT_TYPE_ENTRY "}",
+                            &full_filename,
+                            &v_entry);
+        if (full_filename[0] != '/') {
+            g_variant_unref(v_entry);
+            continue;
+        }
+        g_hash_table_replace(cache->idx, g_strdup(full_filename), v_entry);
+    }
+
+    nm_log_dbg(LOGD_SETTINGS,
+               "keyfile: cache: loaded \"%s\" with %u entries",
+               filename,
+               g_hash_table_size(cache->idx));
+    return cache;
+}
+
+void
+nms_keyfile_cache_free(NMSKeyfileCache *cache)
+{
+    if (!cache)
+        return;
+
+    g_hash_table_unref(cache->idx);
+    nm_g_variant_unref(cache->data);
+    nm_g_slice_free(cache);
+}
+
+guint
+nms_keyfile_cache_get_n_entries(const NMSKeyfileCache *cache)
+{
+    return g_hash_table_size(cache->idx);
+}
+
+/*****************************************************************************/
+
+static gboolean
+_ternary_from_int(gint32 v, NMTernary *out_val)
+{
+    if (!NM_IN_SET(v, NM_TERNARY_DEFAULT, NM_TERNARY_FALSE, NM_TERNARY_TRUE))
+        return FALSE;
+    *out_val = v;
+    return TRUE;
+}
+
+/**
+ * nms_keyfile_cache_lookup:
+ * @cache: the #NMSKeyfileCache
+ * @full_filename: the keyfile to look up.
+ * @st: the stat information of the keyfile, as it is on disk now.
+ * @out_is_nm_generated: (out): like for nms_keyfile_reader_from_file().
+ * @out_is_volatile: (out): like for nms_keyfile_reader_from_file().
+ * @out_is_external: (out): like for nms_keyfile_reader_from_file().
+ * @out_shadowed_storage: (out) (transfer full): like for nms_keyfile_reader_from_file().
+ * @out_shadowed_owned: (out): like for nms_keyfile_reader_from_file().
+ * @out_entry: (out) (transfer full): the cache entry, so that it can be
+ *   written to the cache again.
+ *
+ * This function is thread-safe.
+ *
+ * Returns: (transfer full): the normalized connection, or %NULL if the
+ *   cache has no valid entry for the file in its current state.
+ */
+NMConnection *
+nms_keyfile_cache_lookup(const NMSKeyfileCache *cache,
+                         const char            *full_filename,
+                         const struct stat     *st,
+                         NMTernary             *out_is_nm_generated,
+                         NMTernary             *out_is_volatile,
+                         NMTernary             *out_is_external,
+                         char                 **out_shadowed_storage,
+                         NMTernary             *out_shadowed_owned,
+                         GVariant             **out_entry)
+{
+    gs_unref_object NMConnection *connection   = NULL;
+    gs_unref_variant GVariant    *v_connection = NULL;
+    GVariant                     *v_entry;
+    guint64                       ino;
+    guint64                       size;
+    gint64                        mtime_sec;
+    gint64                        mtime_nsec;
+    gint32                        ternaries[4];
+    NMTernary                     is_nm_generated;
+    NMTernary                     is_volatile;
+    NMTernary                     is_external;
+    NMTernary                     shadowed_owned;
+    const char                   *shadowed_storage;
+
+    nm_assert(cache);
+    nm_assert(full_filename && full_filename[0] == '/');
+    nm_assert(st);
+    nm_assert(out_entry && !*out_entry);
+
+    v_entry = g_hash_table_lookup(cache->idx, full_filename);
+    if (!v_entry)
+        return NULL;
+
+    g_variant_get(v_entry,
+                  "(ttxxiiiim&s@a{sa{sv}})",
+                  &ino,
+                  &size,
+                  &mtime_sec,
+                  &mtime_nsec,
+                  &ternaries[0],
+                  &ternaries[1],
+                  &ternaries[2],
+                  &ternaries[3],
+                  &shadowed_storage,
+                  &v_connection);
+
+    if (ino != (guint64) st->st_ino || size != (guint64) st->st_size
+        || mtime_sec != (gint64) st->st_mtim.tv_sec || mtime_nsec != (gint64) st->st_mtim.tv_nsec)
+        return NULL;
+
+    if (!_ternary_from_int(ternaries[0], &is_nm_generated)
+        || !_ternary_from_int(ternaries[1], &is_volatile)
+        || !_ternary_from_int(ternaries[2], &is_external)
+        || !_ternary_from_int(ternaries[3], &shadowed_owned))
+        return NULL;
+
+    connection =
+        _nm_simple_connection_new_from_dbus(v_connection, NM_SETTING_PARSE_FLAGS_NONE, NULL);
+    if (!connection)
+        return NULL;
+
+    /* The connection was normalized when it was written to the cache. If it
+     * is not valid as is, the cache is corrupt (or libnm changed in a way that
+     * is not reflected by the version). Then the keyfile must be parsed. */
+    if (_nm_connection_verify(connection, NULL) != NM_SETTING_VERIFY_SUCCESS
+        || !nm_uuid_is_normalized(nm_connection_get_uuid(connection)))
+        return NULL;
+
+    NM_SET_OUT(out_is_nm_generated, is_nm_generated);
+    NM_SET_OUT(out_is_volatile, is_volatile);
+    NM_SET_OUT(out_is_external, is_external);
+    NM_SET_OUT(out_shadowed_storage, g_strdup(shadowed_storage));
+    NM_SET_OUT(out_shadowed_owned, shadowed_owned);
+    *out_entry = g_variant_ref(v_entry);
+    return g_steal_pointer(&connection);
+}
+
+/**
+ * nms_keyfile_cache_entry_new:
+ * @connection: the normalized connection, as read from the keyfile.
+ * @st: the stat information of the keyfile.
+ * @is_nm_generated: as returned by nms_keyfile_reader_from_file().
+ * @is_volatile: as returned by nms_keyfile_reader_from_file().
+ * @is_external: as returned by nms_keyfile_reader_from_file().
+ * @shadowed_storage: as returned by nms_keyfile_reader_from_file().
+ * @shadowed_owned: as returned by nms_keyfile_reader_from_file().
+ *
+ * This function is thread-safe.
+ *
+ * Returns: (transfer full): the entry for nms_keyfile_cache_write().
+ */
+GVariant *
+nms_keyfile_cache_entry_new(NMConnection      *connection,
+                            const struct stat *st,
+                            NMTernary          is_nm_generated,
+                            NMTernary          is_volatile,
+                            NMTernary          is_external,
+                            const char        *shadowed_storage,
+                            NMTernary          shadowed_owned)
+{
+    nm_assert(NM_IS_CONNECTION(connection));
+    nm_assert(st);
+
+    return g_variant_ref_sink(
+        g_variant_new("(ttxxiiiims@a{sa{sv}})",
+                      (guint64) st->st_ino,
+                      (guint64) st->st_size,
+                      (gint64) st->st_mtim.tv_sec,
+                      (gint64) st->st_mtim.tv_nsec,
+                      (gint32) is_nm_generated,
+                      (gint32) is_volatile,
+                      (gint32) is_external,
+                      (gint32) shadowed_owned,
+                      shadowed_storage,
+                      nm_connection_to_dbus(connection, NM_CONNECTION_SERIALIZE_ALL)));
+}
+
+/**
+ * nms_keyfile_cache_write:
+ * @filename: the filename of the cache.
+ * @profile_dir: the profile directory of the keyfile plugin.
+ * @full_filenames: the keyfiles.
+ * @entries: for each of @full_filenames the entry from nms_keyfile_cache_lookup()
+ *   or nms_keyfile_cache_entry_new().
+ * @n_entries: the number of entries.
+ * @error: (allow-none): the error.
+ *
+ * Atomically replaces the cache. As it contains secrets, the file
+ * is only readable by the owner.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+nms_keyfile_cache_write(const char        *filename,
+                        const char        *profile_dir,
+                        const char *const *full_filenames,
+                        GVariant *const   *entries,
+                        guint              n_entries,
+                        GError           **error)
+{
+    gs_unref_variant GVariant *data = NULL;
+    GVariantBuilder            builder;
+    guint                      i;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE("a{s" CACHE_VARIANT_TYPE_ENTRY "}"));
+    for (i = 0; i < n_entries; i++) {
+        g_variant_builder_add(&builder,
+                              "{s@" CACHE_VARIANT_TYPE_ENTRY "}",
+                              full_filenames[i],
+                              entries[i]);
+    }
+
+    data = g_variant_ref_sink(g_variant_new("(uss@a{s" CACHE_VARIANT_TYPE_ENTRY "})",
+                                            (guint32) CACHE_FORMAT_VERSION,
+                                            VERSION,
+                                            profile_dir ?: "",
+                                            g_variant_builder_end(&builder)));
+
+    return nm_utils_file_set_contents(filename,
+                                      g_variant_get_data(data),
+                                      g_variant_get_size(data),
+                                      0600,
+                                      NULL,
+                                      NULL,
+                                      error);
+}
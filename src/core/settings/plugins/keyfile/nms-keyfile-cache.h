@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026 Red Hat, Inc.
+ */
+
+#ifndef __NMS_KEYFILE_CACHE_H__
+#define __NMS_KEYFILE_CACHE_H__
+
+#include "nm-connection.h"
+
+#define NMS_KEYFILE_CACHE_FILENAME NMSTATEDIR "/keyfile-cache"
+
+typedef struct _NMSKeyfileCache NMSKeyfileCache;
+
+NMSKeyfileCache *nms_keyfile_cache_load(const char *filename, const char *profile_dir);
+
+void nms_keyfile_cache_free(NMSKeyfileCache *cache);
+
+NM_AUTO_DEFINE_FCN0(NMSKeyfileCache *, _nm_auto_free_keyfile_cache, nms_keyfile_cache_free);
+#define nm_auto_free_keyfile_cache nm_auto(_nm_auto_free_keyfile_cache)
+
+guint nms_keyfile_cache_get_n_entries(const NMSKeyfileCache *cache);
+
+struct stat;
+
+NMConnection *nms_keyfile_cache_lookup(const NMSKeyfileCache *cache,
+                                       const char            *full_filename,
+                                       const struct stat     *st,
+                                       NMTernary             *out_is_nm_generated,
+                                       NMTernary             *out_is_volatile,
+                                       NMTernary             *out_is_external,
+                                       char                 **out_shadowed_storage,
+                                       NMTernary             *out_shadowed_owned,
+                                       GVariant             **out_entry);
+
+GVariant *nms_keyfile_cache_entry_new(NMConnection      *connection,
+                                      const struct stat *st,
+                                      NMTernary          is_nm_generated,
+                                      NMTernary          is_volatile,
+                                      NMTernary          is_external,
+                                      const char        *shadowed_storage,
+                                      NMTernary          shadowed_owned);
+
+gboolean nms_keyfile_cache_write(const char        *filename,
+                                 const char        *profile_dir,
+                                 const char *const *full_filenames,
+                                 GVariant *const   *entries,
+                                 guint              n_entries,
+                                 GError           **error);
+
+#endif /* __NMS_KEYFILE_CACHE_H__ */
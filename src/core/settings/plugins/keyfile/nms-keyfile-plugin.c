@@ -9,6 +9,7 @@
 #include "nms-keyfile-plugin.h"
 
 #include <sys/stat.h>
+#include <sys/inotify.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/time.h>
@@ -30,6 +31,7 @@
 #include "settings/nm-settings-storage.h"
 #include "settings/nm-settings-utils.h"
 
+#include "nms-keyfile-cache.h"
 #include "nms-keyfile-storage.h"
 #include "nms-keyfile-writer.h"
 #include "nms-keyfile-reader.h"
@@ -59,6 +61,37 @@ typedef struct {
 
     NMSettUtilStorages storages;
 
+    /* An inotify watch on the keyfile directories. It collects the names of the
+     * files that changed since the last (full) reload, so that a reload only
+     * needs to re-read those. If @fd is -1, the next reload rescans all
+     * directories.
+     *
+     * inotify does not see everything (the targets of symlinks, changes on
+     * network filesystems or from other mount namespaces). Hence, @stamps
+     * remembers the stat of every file in the directories, and a reload also
+     * re-reads the files whose stat changed. */
+    struct {
+        GSource    *source;
+        GHashTable *dirty_filenames;
+        GHashTable *stamps;
+        /* dirname_run, dirname_etc and dirname_libs[0]. */
+        struct {
+            const char *dirname;
+            int         wd;
+        } dirs[3];
+        int fd;
+    } watch;
+
+    /* The file that caches the parsed profiles, or NULL to not use a cache. */
+    char *cache_filename;
+
+    /* For testing, the number of worker threads to load files with, regardless
+     * of the number of processors. Zero means to decide automatically. */
+    guint load_files_n_workers;
+
+    /* For testing, to compare the result of the parallel load with the serial one. */
+    bool load_files_serial : 1;
+
 } NMSKeyfilePluginPrivate;
 
 struct _NMSKeyfilePlugin {
@@ -291,113 +324,232 @@ _nm_assert_storage(gpointer plugin /* NMSKeyfilePlugin  */,
 
 /*****************************************************************************/
 
+/* Reading, parsing and normalizing keyfiles has no side effects on the plugin.
+ * When loading many files, that is done by worker threads (see _load_files()).
+ * Creating the storages happens afterwards on the main thread. */
+#define LOAD_FILES_PARALLEL_MIN_FILES   32
+#define LOAD_FILES_PARALLEL_MAX_WORKERS 16
+
+typedef struct {
+    const char           *dirname;
+    char                 *filename;
+    NMSKeyfileStorageType storage_type;
+    bool                  is_nmmeta : 1;
+    bool                  is_read : 1;
+    bool                  cache_hit : 1;
+
+    /* If set, the connection is looked up in the cache first. */
+    const NMSKeyfileCache *cache;
+
+    /* The result of _load_file_read(). */
+    char         *full_filename;
+    NMConnection *connection;
+    GError       *error;
+    char         *shadowed_storage;
+    GVariant     *cache_entry;
+    struct stat   st;
+    NMTernary     is_nm_generated_opt;
+    NMTernary     is_volatile_opt;
+    NMTernary     is_external_opt;
+    NMTernary     shadowed_owned_opt;
+} LoadFileData;
+
+static void
+_load_file_data_clear_result(LoadFileData *lfd)
+{
+    nm_clear_g_free(&lfd->full_filename);
+    g_clear_object(&lfd->connection);
+    g_clear_error(&lfd->error);
+    nm_clear_g_free(&lfd->shadowed_storage);
+    nm_clear_pointer(&lfd->cache_entry, g_variant_unref);
+}
+
+static void
+_load_file_data_clear(gpointer data)
+{
+    LoadFileData *lfd = data;
+
+    _load_file_data_clear_result(lfd);
+    nm_clear_g_free(&lfd->filename);
+}
+
 static NMSKeyfileStorage *
-_load_file(NMSKeyfilePlugin     *self,
-           const char           *dirname,
-           const char           *filename,
-           NMSKeyfileStorageType storage_type,
-           GError              **error)
+_load_file_nmmeta(NMSKeyfilePlugin     *self,
+                  const char           *dirname,
+                  const char           *filename,
+                  NMSKeyfileStorageType storage_type,
+                  GError              **error)
 {
-    NMSKeyfilePluginPrivate      *priv;
-    gs_unref_object NMConnection *connection = NULL;
-    NMTernary                     is_nm_generated_opt;
-    NMTernary                     is_volatile_opt;
-    NMTernary                     is_external_opt;
-    NMTernary                     shadowed_owned_opt;
-    gs_free char                 *shadowed_storage = NULL;
-    gs_free_error GError         *local            = NULL;
-    gs_free char                 *full_filename    = NULL;
-    struct stat                   st;
+    gs_free char *nmmeta                    = NULL;
+    gs_free char *loaded_path               = NULL;
+    gs_free char *shadowed_storage_filename = NULL;
+    gs_free char *full_filename             = NULL;
 
-    if (_ignore_filename(storage_type, filename)) {
-        gs_free char *nmmeta                    = NULL;
-        gs_free char *loaded_path               = NULL;
-        gs_free char *shadowed_storage_filename = NULL;
-
-        if (!nms_keyfile_nmmeta_check_filename(filename, NULL)) {
-            if (error)
-                nm_utils_error_set(error, NM_UTILS_ERROR_UNKNOWN, "skip due to invalid filename");
-            else
-                _LOGT("load: \"%s/%s\": skip file due to invalid filename", dirname, filename);
-            return NULL;
-        }
-        if (!nms_keyfile_nmmeta_read(dirname,
-                                     filename,
-                                     &full_filename,
-                                     &nmmeta,
-                                     &loaded_path,
-                                     &shadowed_storage_filename,
-                                     NULL)) {
-            if (error)
-                nm_utils_error_set(error, NM_UTILS_ERROR_UNKNOWN, "skip unreadable nmmeta file");
-            else
-                _LOGT("load: \"%s/%s\": skip unreadable nmmeta file", dirname, filename);
-            return NULL;
-        }
-        nm_assert(loaded_path);
-        if (!NM_IN_SET(storage_type, NMS_KEYFILE_STORAGE_TYPE_RUN, NMS_KEYFILE_STORAGE_TYPE_ETC)) {
-            if (error)
-                nm_utils_error_set(error,
-                                   NM_UTILS_ERROR_UNKNOWN,
-                                   "skip nmmeta file from read-only directory");
-            else
-                _LOGT("load: \"%s/%s\": skip nmmeta file from read-only directory",
-                      dirname,
-                      filename);
-            return NULL;
-        }
-        if (!nm_streq(loaded_path, NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL)) {
-            if (error)
-                nm_utils_error_set(error,
-                                   NM_UTILS_ERROR_UNKNOWN,
-                                   "skip nmmeta file not symlinking %s",
-                                   NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL);
-            else
-                _LOGT("load: \"%s/%s\": skip nmmeta file not symlinking to %s",
-                      dirname,
-                      filename,
-                      NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL);
-            return NULL;
+    if (!nms_keyfile_nmmeta_check_filename(filename, NULL)) {
+        if (error)
+            nm_utils_error_set(error, NM_UTILS_ERROR_UNKNOWN, "skip due to invalid filename");
+        else
+            _LOGT("load: \"%s/%s\": skip file due to invalid filename", dirname, filename);
+        return NULL;
+    }
+    if (!nms_keyfile_nmmeta_read(dirname,
+                                 filename,
+                                 &full_filename,
+                                 &nmmeta,
+                                 &loaded_path,
+                                 &shadowed_storage_filename,
+                                 NULL)) {
+        if (error)
+            nm_utils_error_set(error, NM_UTILS_ERROR_UNKNOWN, "skip unreadable nmmeta file");
+        else
+            _LOGT("load: \"%s/%s\": skip unreadable nmmeta file", dirname, filename);
+        return NULL;
+    }
+    nm_assert(loaded_path);
+    if (!NM_IN_SET(storage_type, NMS_KEYFILE_STORAGE_TYPE_RUN, NMS_KEYFILE_STORAGE_TYPE_ETC)) {
+        if (error)
+            nm_utils_error_set(error,
+                               NM_UTILS_ERROR_UNKNOWN,
+                               "skip nmmeta file from read-only directory");
+        else
+            _LOGT("load: \"%s/%s\": skip nmmeta file from read-only directory",
+                  dirname,
+                  filename);
+        return NULL;
+    }
+    if (!nm_streq(loaded_path, NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL)) {
+        if (error)
+            nm_utils_error_set(error,
+                               NM_UTILS_ERROR_UNKNOWN,
+                               "skip nmmeta file not symlinking %s",
+                               NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL);
+        else
+            _LOGT("load: \"%s/%s\": skip nmmeta file not symlinking to %s",
+                  dirname,
+                  filename,
+                  NM_KEYFILE_PATH_NMMETA_SYMLINK_NULL);
+        return NULL;
+    }
+
+    return nms_keyfile_storage_new_tombstone(self,
+                                             nmmeta,
+                                             full_filename,
+                                             storage_type,
+                                             shadowed_storage_filename);
+}
+
+/* This may run on a worker thread. It must not access the plugin instance. */
+static void
+_load_file_read(LoadFileData *lfd, const char *plugin_dir)
+{
+    nm_assert(!lfd->is_nmmeta);
+    nm_assert(!lfd->is_read);
+
+    lfd->is_read       = TRUE;
+    lfd->full_filename = g_build_filename(lfd->dirname, lfd->filename, NULL);
+
+    if (lfd->cache) {
+        /* The same check is done by nms_keyfile_reader_from_file(). It also
+         * gives us the stat information to validate the cache entry. */
+        if (!nms_keyfile_utils_check_file_permissions(NMS_KEYFILE_FILETYPE_KEYFILE,
+                                                      lfd->full_filename,
+                                                      &lfd->st,
+                                                      &lfd->error))
+            return;
+
+        lfd->connection = nms_keyfile_cache_lookup(lfd->cache,
+                                                   lfd->full_filename,
+                                                   &lfd->st,
+                                                   &lfd->is_nm_generated_opt,
+                                                   &lfd->is_volatile_opt,
+                                                   &lfd->is_external_opt,
+                                                   &lfd->shadowed_storage,
+                                                   &lfd->shadowed_owned_opt,
+                                                   &lfd->cache_entry);
+        if (lfd->connection) {
+            lfd->cache_hit = TRUE;
+            return;
         }
+    }
 
-        return nms_keyfile_storage_new_tombstone(self,
-                                                 nmmeta,
-                                                 full_filename,
-                                                 storage_type,
-                                                 shadowed_storage_filename);
+    lfd->connection = _read_from_file(lfd->full_filename,
+                                      plugin_dir,
+                                      &lfd->st,
+                                      &lfd->is_nm_generated_opt,
+                                      &lfd->is_volatile_opt,
+                                      &lfd->is_external_opt,
+                                      &lfd->shadowed_storage,
+                                      &lfd->shadowed_owned_opt,
+                                      &lfd->error);
+
+    if (lfd->cache && lfd->connection) {
+        lfd->cache_entry = nms_keyfile_cache_entry_new(lfd->connection,
+                                                       &lfd->st,
+                                                       lfd->is_nm_generated_opt,
+                                                       lfd->is_volatile_opt,
+                                                       lfd->is_external_opt,
+                                                       lfd->shadowed_storage,
+                                                       lfd->shadowed_owned_opt);
     }
+}
 
-    full_filename = g_build_filename(dirname, filename, NULL);
+static void
+_load_file_read_pool_fn(gpointer data, gpointer user_data)
+{
+    _load_file_read(data, user_data);
+}
 
-    priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+static NMSKeyfileStorage *
+_load_file_finish(NMSKeyfilePlugin *self, LoadFileData *lfd, GError **error)
+{
+    NMSKeyfileStorage *storage = NULL;
 
-    connection = _read_from_file(full_filename,
-                                 _get_plugin_dir(priv),
-                                 &st,
-                                 &is_nm_generated_opt,
-                                 &is_volatile_opt,
-                                 &is_external_opt,
-                                 &shadowed_storage,
-                                 &shadowed_owned_opt,
-                                 &local);
-    if (!connection) {
+    nm_assert(lfd->is_read);
+
+    if (!lfd->connection) {
         if (error)
-            g_propagate_error(error, g_steal_pointer(&local));
-        else
-            _LOGW("load: \"%s\": failed to load connection: %s", full_filename, local->message);
-        return NULL;
+            g_propagate_error(error, g_steal_pointer(&lfd->error));
+        else {
+            _LOGW("load: \"%s\": failed to load connection: %s",
+                  lfd->full_filename,
+                  lfd->error->message);
+        }
+    } else {
+        storage = nms_keyfile_storage_new_connection(self,
+                                                     g_steal_pointer(&lfd->connection),
+                                                     lfd->full_filename,
+                                                     lfd->storage_type,
+                                                     lfd->is_nm_generated_opt,
+                                                     lfd->is_volatile_opt,
+                                                     lfd->is_external_opt,
+                                                     lfd->shadowed_storage,
+                                                     lfd->shadowed_owned_opt,
+                                                     &lfd->st.st_mtim);
     }
 
-    return nms_keyfile_storage_new_connection(self,
-                                              g_steal_pointer(&connection),
-                                              full_filename,
-                                              storage_type,
-                                              is_nm_generated_opt,
-                                              is_volatile_opt,
-                                              is_external_opt,
-                                              shadowed_storage,
-                                              shadowed_owned_opt,
-                                              &st.st_mtim);
+    _load_file_data_clear_result(lfd);
+    return storage;
+}
+
+static NMSKeyfileStorage *
+_load_file(NMSKeyfilePlugin     *self,
+           const char           *dirname,
+           const char           *filename,
+           NMSKeyfileStorageType storage_type,
+           GError              **error)
+{
+    LoadFileData lfd;
+
+    if (_ignore_filename(storage_type, filename))
+        return _load_file_nmmeta(self, dirname, filename, storage_type, error);
+
+    lfd = (LoadFileData){
+        .dirname      = dirname,
+        .filename     = (char *) filename,
+        .storage_type = storage_type,
+    };
+    _load_file_read(&lfd, _get_plugin_dir(NMS_KEYFILE_PLUGIN_GET_PRIVATE(self)));
+    return _load_file_finish(self, &lfd, error);
 }
 
 static NMSKeyfileStorage *
@@ -419,37 +571,170 @@ _load_file_from_path(NMSKeyfilePlugin     *self,
 }
 
 static void
-_load_dir(NMSKeyfilePlugin     *self,
-          NMSKeyfileStorageType storage_type,
-          const char           *dirname,
-          NMSettUtilStorages   *storages)
+_load_dir(NMSKeyfileStorageType storage_type, const char *dirname, GArray *files)
 {
     const char                    *filename;
     GDir                          *dir;
+    gs_unref_ptrarray GPtrArray   *filenames      = NULL;
     gs_unref_hashtable GHashTable *dupl_filenames = NULL;
+    guint                          i;
 
     dir = g_dir_open(dirname, 0, NULL);
     if (!dir)
         return;
 
-    dupl_filenames = g_hash_table_new_full(nm_str_hash, g_str_equal, NULL, g_free);
+    filenames      = g_ptr_array_new();
+    dupl_filenames = g_hash_table_new(nm_str_hash, g_str_equal);
 
     while ((filename = g_dir_read_name(dir))) {
-        gs_unref_object NMSKeyfileStorage *storage = NULL;
-
         filename = g_strdup(filename);
-        if (!g_hash_table_add(dupl_filenames, (char *) filename))
+        if (!g_hash_table_add(dupl_filenames, (char *) filename)) {
+            g_free((char *) filename);
             continue;
+        }
+        g_ptr_array_add(filenames, (char *) filename);
+    }
+
+    g_dir_close(dir);
+
+    /* Load the files in a deterministic order, not in the order of readdir(). */
+    g_ptr_array_sort(filenames, nm_strcmp_p);
+
+    for (i = 0; i < filenames->len; i++) {
+        filename = filenames->pdata[i];
+        g_array_append_val(files,
+                           ((LoadFileData){
+                               .dirname      = dirname,
+                               .filename     = (char *) filename,
+                               .storage_type = storage_type,
+                               .is_nmmeta    = _ignore_filename(storage_type, filename),
+                           }));
+    }
+}
+
+static void
+_load_files_write_cache(NMSKeyfilePlugin      *self,
+                        const NMSKeyfileCache *cache,
+                        GArray                *files)
+{
+    NMSKeyfilePluginPrivate     *priv           = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    gs_unref_ptrarray GPtrArray *full_filenames = NULL;
+    gs_unref_ptrarray GPtrArray *entries        = NULL;
+    gs_free_error GError        *error          = NULL;
+    guint                        n_hits         = 0;
+    guint                        i;
+
+    full_filenames = g_ptr_array_new();
+    entries        = g_ptr_array_new();
+
+    for (i = 0; i < files->len; i++) {
+        const LoadFileData *lfd = &nm_g_array_index(files, LoadFileData, i);
+
+        if (!lfd->cache_entry || !lfd->connection)
+            continue;
+
+        g_ptr_array_add(full_filenames, lfd->full_filename);
+        g_ptr_array_add(entries, lfd->cache_entry);
+        if (lfd->cache_hit)
+            n_hits++;
+    }
+
+    _LOGD("load: %u of %u profiles loaded from cache", n_hits, entries->len);
+
+    if (n_hits == entries->len && n_hits == nms_keyfile_cache_get_n_entries(cache)) {
+        /* The cache is up to date. */
+        return;
+    }
+
+    if (!nms_keyfile_cache_write(priv->cache_filename,
+                                 _get_plugin_dir(priv),
+                                 (const char *const *) full_filenames->pdata,
+                                 (GVariant *const *) entries->pdata,
+                                 entries->len,
+                                 &error)) {
+        _LOGD("load: failure to write cache \"%s\": %s", priv->cache_filename, error->message);
+    }
+}
+
+static void
+_load_files(NMSKeyfilePlugin      *self,
+            GArray                *files,
+            const NMSKeyfileCache *cache,
+            NMSettUtilStorages    *storages)
+{
+    NMSKeyfilePluginPrivate *priv       = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    const char              *plugin_dir = _get_plugin_dir(priv);
+    guint                    n_keyfiles = 0;
+    guint                    n_workers;
+    guint                    i;
+
+    for (i = 0; i < files->len; i++) {
+        LoadFileData *lfd = &nm_g_array_index(files, LoadFileData, i);
+
+        if (lfd->is_nmmeta)
+            continue;
+
+        /* Profiles in /run are not persisted to the cache. They might contain
+         * secrets that must not hit the disk. */
+        if (lfd->storage_type != NMS_KEYFILE_STORAGE_TYPE_RUN)
+            lfd->cache = cache;
+
+        n_keyfiles++;
+    }
+
+    if (priv->load_files_n_workers > 0)
+        n_workers = priv->load_files_n_workers;
+    else
+        n_workers = NM_MIN((guint) g_get_num_processors(), (guint) LOAD_FILES_PARALLEL_MAX_WORKERS);
+
+    if (n_keyfiles >= LOAD_FILES_PARALLEL_MIN_FILES && n_workers > 1 && !priv->load_files_serial) {
+        GThreadPool *pool;
+
+        _LOGT("load: read %u files with %u worker threads", n_keyfiles, n_workers);
+
+        pool = g_thread_pool_new(_load_file_read_pool_fn,
+                                 (gpointer) plugin_dir,
+                                 n_workers,
+                                 FALSE,
+                                 NULL);
+        for (i = 0; i < files->len; i++) {
+            LoadFileData *lfd = &nm_g_array_index(files, LoadFileData, i);
+
+            if (!lfd->is_nmmeta)
+                g_thread_pool_push(pool, lfd, NULL);
+        }
+
+        /* Wait until all files are read. */
+        g_thread_pool_free(pool, FALSE, TRUE);
+    }
+
+    for (i = 0; i < files->len; i++) {
+        LoadFileData *lfd = &nm_g_array_index(files, LoadFileData, i);
+
+        if (!lfd->is_nmmeta && !lfd->is_read)
+            _load_file_read(lfd, plugin_dir);
+    }
+
+    if (cache)
+        _load_files_write_cache(self, cache, files);
+
+    /* Create the storages in the order of @files, regardless of the order in
+     * which the workers completed. */
+    for (i = 0; i < files->len; i++) {
+        LoadFileData                      *lfd     = &nm_g_array_index(files, LoadFileData, i);
+        gs_unref_object NMSKeyfileStorage *storage = NULL;
+
+        if (lfd->is_nmmeta)
+            storage = _load_file_nmmeta(self, lfd->dirname, lfd->filename, lfd->storage_type, NULL);
+        else
+            storage = _load_file_finish(self, lfd, NULL);
 
-        storage = _load_file(self, dirname, filename, storage_type, NULL);
         if (!storage)
             continue;
 
         nm_sett_util_storages_add_take(storages, g_steal_pointer(&storage));
     }
 
-    g_dir_close(dir);
-
 #if NM_MORE_ASSERTS
     {
         NMSKeyfileStorage *storage;
@@ -573,6 +858,331 @@ _storages_consolidate(NMSKeyfilePlugin                      *self,
     }
 }
 
+static void load_connections(NMSettingsPlugin                      *plugin,
+                             NMSettingsPluginConnectionLoadEntry   *entries,
+                             gsize                                  n_entries,
+                             NMSettingsPluginConnectionLoadCallback callback,
+                             gpointer                               user_data);
+
+typedef struct {
+    dev_t           dev;
+    ino_t           ino;
+    mode_t          mode;
+    off_t           size;
+    struct timespec mtime;
+    struct timespec ctime;
+} WatchStamp;
+
+static gboolean
+_watch_stamp_equal(const WatchStamp *a, const WatchStamp *b)
+{
+    return a->dev == b->dev && a->ino == b->ino && a->mode == b->mode && a->size == b->size
+           && a->mtime.tv_sec == b->mtime.tv_sec && a->mtime.tv_nsec == b->mtime.tv_nsec
+           && a->ctime.tv_sec == b->ctime.tv_sec && a->ctime.tv_nsec == b->ctime.tv_nsec;
+}
+
+static void
+_watch_stamps_scan_dir(GHashTable *stamps, const char *dirname)
+{
+    const char *filename;
+    GDir       *dir;
+
+    dir = g_dir_open(dirname, 0, NULL);
+    if (!dir)
+        return;
+
+    while ((filename = g_dir_read_name(dir))) {
+        gs_free char *full_filename = g_build_filename(dirname, filename, NULL);
+        WatchStamp   *stamp;
+        struct stat   st;
+
+        /* Follow symlinks, so that we notice when their target changes. For
+         * dangling symlinks (like .nmmeta files), take the link itself. */
+        if (stat(full_filename, &st) != 0 && lstat(full_filename, &st) != 0)
+            continue;
+
+        stamp  = g_new(WatchStamp, 1);
+        *stamp = (WatchStamp){
+            .dev   = st.st_dev,
+            .ino   = st.st_ino,
+            .mode  = st.st_mode,
+            .size  = st.st_size,
+            .mtime = st.st_mtim,
+            .ctime = st.st_ctim,
+        };
+        g_hash_table_insert(stamps, g_steal_pointer(&full_filename), stamp);
+    }
+
+    g_dir_close(dir);
+}
+
+static GHashTable *
+_watch_stamps_scan(NMSKeyfilePlugin *self)
+{
+    NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    GHashTable              *stamps;
+    guint                    i;
+
+    stamps = g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, g_free);
+    for (i = 0; i < G_N_ELEMENTS(priv->watch.dirs); i++) {
+        if (priv->watch.dirs[i].dirname)
+            _watch_stamps_scan_dir(stamps, priv->watch.dirs[i].dirname);
+    }
+    return stamps;
+}
+
+static void
+_watch_stop(NMSKeyfilePlugin *self)
+{
+    NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+
+    nm_clear_g_source_inst(&priv->watch.source);
+    nm_clear_fd(&priv->watch.fd);
+    nm_clear_pointer(&priv->watch.dirty_filenames, g_hash_table_destroy);
+    nm_clear_pointer(&priv->watch.stamps, g_hash_table_destroy);
+}
+
+static gboolean
+_watch_handle_event(NMSKeyfilePlugin *self, const struct inotify_event *event)
+{
+    NMSKeyfilePluginPrivate *priv    = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    const char              *dirname = NULL;
+    guint                    i;
+
+    if (event->mask & IN_Q_OVERFLOW)
+        return FALSE;
+
+    for (i = 0; i < G_N_ELEMENTS(priv->watch.dirs); i++) {
+        if (priv->watch.dirs[i].wd >= 0 && priv->watch.dirs[i].wd == event->wd) {
+            dirname = priv->watch.dirs[i].dirname;
+            break;
+        }
+    }
+    if (!dirname)
+        return TRUE;
+
+    if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT)) {
+        /* the directory itself is gone. */
+        return FALSE;
+    }
+
+    if (event->len == 0 || event->name[0] == '\0' || (event->mask & IN_ISDIR))
+        return TRUE;
+
+    g_hash_table_add(priv->watch.dirty_filenames, g_build_filename(dirname, event->name, NULL));
+    return TRUE;
+}
+
+static void
+_watch_handle_events(NMSKeyfilePlugin *self)
+{
+    NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    char                     buf[4096] _nm_alignas(struct inotify_event);
+
+    while (priv->watch.fd >= 0) {
+        const struct inotify_event *event;
+        gssize                      n;
+        gsize                       offset;
+        int                         errsv;
+
+        n = read(priv->watch.fd, buf, sizeof(buf));
+        if (n < 0) {
+            errsv = errno;
+            if (errsv == EINTR)
+                continue;
+            if (errsv == EAGAIN)
+                return;
+            _LOGD("watch: failure to read inotify events (%s). Rescan on next reload",
+                  nm_strerror_native(errsv));
+            _watch_stop(self);
+            return;
+        }
+
+        for (offset = 0; offset < (gsize) n; offset += sizeof(*event) + event->len) {
+            event = (const struct inotify_event *) &buf[offset];
+            if (!_watch_handle_event(self, event)) {
+                _LOGD("watch: lost track of changes (wd %d, mask 0x%x). Rescan on next reload",
+                      event->wd,
+                      (guint) event->mask);
+                _watch_stop(self);
+                return;
+            }
+        }
+    }
+}
+
+static gboolean
+_watch_cb(int fd, GIOCondition condition, gpointer user_data)
+{
+    NMSKeyfilePlugin        *self = user_data;
+    NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+
+    /* Reading the events early keeps the kernel queue from overflowing.
+     * The files are only re-read on the next reload. */
+    _watch_handle_events(self);
+
+    if (priv->watch.fd < 0)
+        return G_SOURCE_REMOVE;
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+_watch_start(NMSKeyfilePlugin *self)
+{
+    NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    guint                    i;
+
+    _watch_stop(self);
+
+    priv->watch.dirs[0].dirname = priv->dirname_run;
+    priv->watch.dirs[1].dirname = priv->dirname_etc;
+    priv->watch.dirs[2].dirname = priv->dirname_libs[0];
+
+    priv->watch.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (priv->watch.fd < 0) {
+        _LOGD("watch: failure to create inotify instance (%s)", nm_strerror_native(errno));
+        return;
+    }
+
+    for (i = 0; i < G_N_ELEMENTS(priv->watch.dirs); i++) {
+        int errsv;
+
+        priv->watch.dirs[i].wd = -1;
+        if (!priv->watch.dirs[i].dirname)
+            continue;
+
+        priv->watch.dirs[i].wd = inotify_add_watch(priv->watch.fd,
+                                                   priv->watch.dirs[i].dirname,
+                                                   IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB
+                                                       | IN_CREATE | IN_DELETE | IN_MOVED_FROM
+                                                       | IN_MOVED_TO | IN_DELETE_SELF
+                                                       | IN_MOVE_SELF | IN_ONLYDIR);
+        if (priv->watch.dirs[i].wd >= 0)
+            continue;
+
+        errsv = errno;
+        if (errsv == ENOENT) {
+            /* The directory does not exist (yet). _watch_check_missing_dirs()
+             * notices when it appears. */
+            continue;
+        }
+
+        _LOGD("watch: failure to watch \"%s\" (%s)",
+              priv->watch.dirs[i].dirname,
+              nm_strerror_native(errsv));
+        _watch_stop(self);
+        return;
+    }
+
+    priv->watch.dirty_filenames = g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, NULL);
+    priv->watch.stamps          = _watch_stamps_scan(self);
+    priv->watch.source          = nm_g_unix_fd_add_source(priv->watch.fd, G_IO_IN, _watch_cb, self);
+}
+
+static void
+_watch_check_stamps(NMSKeyfilePlugin *self)
+{
+    NMSKeyfilePluginPrivate       *priv       = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    gs_unref_hashtable GHashTable *stamps_old = NULL;
+    GHashTableIter                 h_iter;
+    const char                    *full_filename;
+    const WatchStamp              *stamp;
+    const WatchStamp              *stamp_old;
+
+    stamps_old         = g_steal_pointer(&priv->watch.stamps);
+    priv->watch.stamps = _watch_stamps_scan(self);
+
+    g_hash_table_iter_init(&h_iter, priv->watch.stamps);
+    while (g_hash_table_iter_next(&h_iter, (gpointer *) &full_filename, (gpointer *) &stamp)) {
+        stamp_old = g_hash_table_lookup(stamps_old, full_filename);
+        if (stamp_old && _watch_stamp_equal(stamp, stamp_old))
+            continue;
+        if (g_hash_table_add(priv->watch.dirty_filenames, g_strdup(full_filename)))
+            _LOGT("watch: \"%s\" %s", full_filename, stamp_old ? "changed" : "appeared");
+    }
+
+    g_hash_table_iter_init(&h_iter, stamps_old);
+    while (g_hash_table_iter_next(&h_iter, (gpointer *) &full_filename, NULL)) {
+        if (g_hash_table_contains(priv->watch.stamps, full_filename))
+            continue;
+        if (g_hash_table_add(priv->watch.dirty_filenames, g_strdup(full_filename)))
+            _LOGT("watch: \"%s\" disappeared", full_filename);
+    }
+}
+
+static void
+_watch_check_missing_dirs(NMSKeyfilePlugin *self)
+{
+    NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    guint                    i;
+
+    if (priv->watch.fd < 0)
+        return;
+
+    for (i = 0; i < G_N_ELEMENTS(priv->watch.dirs); i++) {
+        if (!priv->watch.dirs[i].dirname || priv->watch.dirs[i].wd >= 0)
+            continue;
+        if (nm_utils_file_stat(priv->watch.dirs[i].dirname, NULL) != -ENOENT) {
+            _LOGT("watch: directory \"%s\" appeared. Rescan", priv->watch.dirs[i].dirname);
+            _watch_stop(self);
+            return;
+        }
+    }
+}
+
+static gboolean
+_reload_connections_dirty(NMSKeyfilePlugin                      *self,
+                          NMSettingsPluginConnectionLoadCallback callback,
+                          gpointer                               user_data)
+{
+    NMSKeyfilePluginPrivate                     *priv      = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    gs_unref_hashtable GHashTable               *dirty     = NULL;
+    gs_free const char                         **filenames = NULL;
+    gs_free NMSettingsPluginConnectionLoadEntry *entries   = NULL;
+    gsize                                        n_entries;
+    gsize                                        i;
+
+    /* Pick up the events that are still queued. The kernel queues them
+     * synchronously with the file modification, so anything written before
+     * the reload request is accounted for. */
+    _watch_handle_events(self);
+    _watch_check_missing_dirs(self);
+
+    if (priv->watch.fd < 0)
+        return FALSE;
+
+    /* A reload is an explicit request by the user. Don't trust inotify alone,
+     * but also check the stat of all files. That is still much cheaper than
+     * parsing all of them. */
+    _watch_check_stamps(self);
+
+    if (g_hash_table_size(priv->watch.dirty_filenames) == 0) {
+        _LOGT("reload: no files changed");
+        return TRUE;
+    }
+
+    dirty = g_steal_pointer(&priv->watch.dirty_filenames);
+    priv->watch.dirty_filenames = g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, NULL);
+
+    filenames = nm_strdict_get_keys(dirty, TRUE, NULL);
+    entries   = nm_settings_plugin_create_connection_load_entries(filenames, &n_entries);
+
+    _LOGT("reload: re-read %zu changed files", n_entries);
+
+    load_connections(NM_SETTINGS_PLUGIN(self), entries, n_entries, callback, user_data);
+
+    for (i = 0; i < n_entries; i++) {
+        if (entries[i].error) {
+            _LOGT("reload: failure to load \"%s\": %s",
+                  entries[i].filename,
+                  entries[i].error->message);
+            g_clear_error(&entries[i].error);
+        }
+    }
+
+    return TRUE;
+}
+
 static void
 reload_connections(NMSettingsPlugin                      *plugin,
                    NMSettingsPluginConnectionLoadCallback callback,
@@ -582,13 +1192,30 @@ reload_connections(NMSettingsPlugin                      *plugin,
     NMSKeyfilePluginPrivate                            *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
     nm_auto_clear_sett_util_storages NMSettUtilStorages storages_new =
         NM_SETT_UTIL_STORAGES_INIT(storages_new, nms_keyfile_storage_destroy);
-    int i;
+    nm_auto_free_keyfile_cache NMSKeyfileCache *cache = NULL;
+    gs_unref_array GArray                      *files = NULL;
+    int                                         i;
+
+    if (_reload_connections_dirty(self, callback, user_data))
+        return;
+
+    /* Start watching before scanning the directories, so that no change
+     * gets lost in between. */
+    _watch_start(self);
+
+    files = g_array_new(FALSE, FALSE, sizeof(LoadFileData));
+    g_array_set_clear_func(files, _load_file_data_clear);
 
-    _load_dir(self, NMS_KEYFILE_STORAGE_TYPE_RUN, priv->dirname_run, &storages_new);
+    _load_dir(NMS_KEYFILE_STORAGE_TYPE_RUN, priv->dirname_run, files);
     if (priv->dirname_etc)
-        _load_dir(self, NMS_KEYFILE_STORAGE_TYPE_ETC, priv->dirname_etc, &storages_new);
+        _load_dir(NMS_KEYFILE_STORAGE_TYPE_ETC, priv->dirname_etc, files);
     for (i = 0; priv->dirname_libs[i]; i++)
-        _load_dir(self, NMS_KEYFILE_STORAGE_TYPE_LIB(i), priv->dirname_libs[i], &storages_new);
+        _load_dir(NMS_KEYFILE_STORAGE_TYPE_LIB(i), priv->dirname_libs[i], files);
+
+    if (priv->cache_filename)
+        cache = nms_keyfile_cache_load(priv->cache_filename, _get_plugin_dir(priv));
+
+    _load_files(self, files, cache, &storages_new);
 
     _storages_consolidate(self, &storages_new, TRUE, NULL, callback, user_data);
 }
@@ -1277,6 +1904,12 @@ nms_keyfile_plugin_init(NMSKeyfilePlugin *plugin)
 
     priv->config = g_object_ref(nm_config_get());
 
+    priv->watch.fd = -1;
+
+    /* Unit tests must not use the cache of the system. */
+    if (!nm_utils_get_testing())
+        priv->cache_filename = g_strdup(NMS_KEYFILE_CACHE_FILENAME);
+
     priv->storages = (NMSettUtilStorages) NM_SETT_UTIL_STORAGES_INIT(priv->storages,
                                                                      nms_keyfile_storage_destroy);
 
@@ -1345,6 +1978,62 @@ nms_keyfile_plugin_new(void)
     return g_object_new(NMS_TYPE_KEYFILE_PLUGIN, NULL);
 }
 
+NMSKeyfilePlugin *
+nms_keyfile_plugin_new_for_testing(const char *dirname_lib,
+                                   const char *dirname_etc,
+                                   const char *dirname_run)
+{
+    NMSKeyfilePlugin        *self;
+    NMSKeyfilePluginPrivate *priv;
+
+    g_return_val_if_fail(nm_utils_get_testing(), NULL);
+    g_return_val_if_fail(!dirname_lib || dirname_lib[0] == '/', NULL);
+    g_return_val_if_fail(!dirname_etc || dirname_etc[0] == '/', NULL);
+    g_return_val_if_fail(dirname_run && dirname_run[0] == '/', NULL);
+
+    self = nms_keyfile_plugin_new();
+    priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+
+    /* Don't touch the directories of the system. */
+    g_free(priv->dirname_libs[0]);
+    g_free(priv->dirname_etc);
+    g_free(priv->dirname_run);
+    priv->dirname_libs[0] = dirname_lib ? nm_path_simplify(g_strdup(dirname_lib)) : NULL;
+    priv->dirname_etc     = dirname_etc ? nm_path_simplify(g_strdup(dirname_etc)) : NULL;
+    priv->dirname_run     = nm_path_simplify(g_strdup(dirname_run));
+    return self;
+}
+
+void
+nms_keyfile_plugin_set_load_serial_for_testing(NMSKeyfilePlugin *self, gboolean load_serial)
+{
+    g_return_if_fail(nm_utils_get_testing());
+
+    NMS_KEYFILE_PLUGIN_GET_PRIVATE(self)->load_files_serial = load_serial;
+}
+
+void
+nms_keyfile_plugin_set_load_workers_for_testing(NMSKeyfilePlugin *self, guint n_workers)
+{
+    g_return_if_fail(nm_utils_get_testing());
+
+    NMS_KEYFILE_PLUGIN_GET_PRIVATE(self)->load_files_n_workers = n_workers;
+}
+
+void
+nms_keyfile_plugin_set_cache_filename_for_testing(NMSKeyfilePlugin *self,
+                                                  const char       *cache_filename)
+{
+    NMSKeyfilePluginPrivate *priv;
+
+    g_return_if_fail(nm_utils_get_testing());
+    g_return_if_fail(!cache_filename || cache_filename[0] == '/');
+
+    priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE(self);
+    g_free(priv->cache_filename);
+    priv->cache_filename = g_strdup(cache_filename);
+}
+
 static void
 dispose(GObject *object)
 {
@@ -1354,11 +2043,14 @@ dispose(GObject *object)
     if (priv->config)
         g_signal_handlers_disconnect_by_func(priv->config, config_changed_cb, object);
 
+    _watch_stop(self);
+
     nm_sett_util_storages_clear(&priv->storages);
 
     nm_clear_g_free(&priv->dirname_libs[0]);
     nm_clear_g_free(&priv->dirname_etc);
     nm_clear_g_free(&priv->dirname_run);
+    nm_clear_g_free(&priv->cache_filename);
 
     g_clear_object(&priv->config);
 
@@ -30,6 +30,17 @@ GType nms_keyfile_plugin_get_type(void);
 
 NMSKeyfilePlugin *nms_keyfile_plugin_new(void);
 
+NMSKeyfilePlugin *nms_keyfile_plugin_new_for_testing(const char *dirname_lib,
+                                                     const char *dirname_etc,
+                                                     const char *dirname_run);
+
+void nms_keyfile_plugin_set_load_serial_for_testing(NMSKeyfilePlugin *self, gboolean load_serial);
+
+void nms_keyfile_plugin_set_load_workers_for_testing(NMSKeyfilePlugin *self, guint n_workers);
+
+void nms_keyfile_plugin_set_cache_filename_for_testing(NMSKeyfilePlugin *self,
+                                                       const char       *cache_filename);
+
 gboolean nms_keyfile_plugin_add_connection(NMSKeyfilePlugin   *self,
                                            NMConnection       *connection,
                                            gboolean            in_memory,
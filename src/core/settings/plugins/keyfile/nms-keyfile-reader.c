@@ -16,6 +16,13 @@
 
 /*****************************************************************************/
 
+/* nms_keyfile_reader_from_file() is also called by worker threads while the
+ * keyfile plugin loads many files. Hence, logging requires locking. */
+#undef NM_THREAD_SAFE_ON_MAIN_THREAD
+#define NM_THREAD_SAFE_ON_MAIN_THREAD 0
+
+/*****************************************************************************/
+
 static const char *
 _fmt_warn(const NMKeyfileHandlerData *handler_data, char **out_message)
 {
@@ -8,6 +8,8 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/socket.h>
@@ -16,8 +18,13 @@
 #include <linux/if_infiniband.h>
 
 #include "libnm-glib-aux/nm-uuid.h"
+#include "libnm-glib-aux/nm-io-utils.h"
 #include "libnm-core-intern/nm-core-internal.h"
 
+#include "nm-config.h"
+#include "settings/plugins/keyfile/nms-keyfile-cache.h"
+#include "settings/plugins/keyfile/nms-keyfile-plugin.h"
+#include "settings/plugins/keyfile/nms-keyfile-storage.h"
 #include "settings/plugins/keyfile/nms-keyfile-reader.h"
 #include "settings/plugins/keyfile/nms-keyfile-writer.h"
 #include "settings/plugins/keyfile/nms-keyfile-utils.h"
@@ -2834,6 +2841,655 @@ test_nmmeta(void)
 
 /*****************************************************************************/
 
+#define TEST_CACHE_PROFILE_DIR "/etc/NetworkManager/system-connections"
+
+static void
+test_cache(void)
+{
+    const char                   *profile_dir      = TEST_CACHE_PROFILE_DIR;
+    const char                   *full_filename    = TEST_CACHE_PROFILE_DIR "/cache.nmconnection";
+    gs_free char                 *cache_filename   = NULL;
+    gs_unref_object NMConnection *connection       = NULL;
+    gs_unref_object NMConnection *connection2      = NULL;
+    gs_unref_variant GVariant    *entry            = NULL;
+    gs_unref_variant GVariant    *entry2           = NULL;
+    gs_free char                 *shadowed_storage = NULL;
+    gs_free_error GError         *error            = NULL;
+    NMTernary                     is_nm_generated;
+    NMTernary                     is_volatile;
+    NMTernary                     is_external;
+    NMTernary                     shadowed_owned;
+    struct stat                   st;
+    gboolean                      success;
+
+    cache_filename = g_strdup_printf("%s/test-cache", TEST_SCRATCH_DIR);
+
+    st = (struct stat){
+        .st_ino  = 42,
+        .st_size = 100,
+        .st_mtim = {.tv_sec = 1000, .tv_nsec = 5},
+    };
+
+    connection =
+        nmtst_create_minimal_connection("test-cache", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+    nmtst_connection_normalize(connection);
+
+    entry = nms_keyfile_cache_entry_new(connection,
+                                        &st,
+                                        NM_TERNARY_TRUE,
+                                        NM_TERNARY_DEFAULT,
+                                        NM_TERNARY_FALSE,
+                                        "/run/shadowed",
+                                        NM_TERNARY_TRUE);
+
+    success =
+        nms_keyfile_cache_write(cache_filename, profile_dir, &full_filename, &entry, 1, &error);
+    nmtst_assert_success(success, error);
+
+    {
+        nm_auto_free_keyfile_cache NMSKeyfileCache *cache = NULL;
+
+        cache = nms_keyfile_cache_load(cache_filename, profile_dir);
+        g_assert_cmpint(nms_keyfile_cache_get_n_entries(cache), ==, 1);
+
+        connection2 = nms_keyfile_cache_lookup(cache,
+                                               full_filename,
+                                               &st,
+                                               &is_nm_generated,
+                                               &is_volatile,
+                                               &is_external,
+                                               &shadowed_storage,
+                                               &shadowed_owned,
+                                               &entry2);
+        g_assert(connection2);
+        g_assert(entry2);
+        nmtst_assert_connection_equals(connection, FALSE, connection2, FALSE);
+        g_assert_cmpint(is_nm_generated, ==, NM_TERNARY_TRUE);
+        g_assert_cmpint(is_volatile, ==, NM_TERNARY_DEFAULT);
+        g_assert_cmpint(is_external, ==, NM_TERNARY_FALSE);
+        g_assert_cmpint(shadowed_owned, ==, NM_TERNARY_TRUE);
+        g_assert_cmpstr(shadowed_storage, ==, "/run/shadowed");
+        nm_clear_pointer(&entry2, g_variant_unref);
+
+        /* A modified file does not match. */
+        st.st_mtim.tv_nsec++;
+        g_assert(!nms_keyfile_cache_lookup(cache,
+                                           full_filename,
+                                           &st,
+                                           NULL,
+                                           NULL,
+                                           NULL,
+                                           NULL,
+                                           NULL,
+                                           &entry2));
+        g_assert(!entry2);
+    }
+
+    {
+        nm_auto_free_keyfile_cache NMSKeyfileCache *cache = NULL;
+
+        /* The cache is not used for another profile directory. */
+        cache = nms_keyfile_cache_load(cache_filename, "/some/other/dir");
+        g_assert_cmpint(nms_keyfile_cache_get_n_entries(cache), ==, 0);
+    }
+
+    {
+        nm_auto_free_keyfile_cache NMSKeyfileCache *cache = NULL;
+
+        /* A corrupt cache is empty. */
+        success =
+            nm_utils_file_set_contents(cache_filename, "corrupt", -1, 0600, NULL, NULL, &error);
+        nmtst_assert_success(success, error);
+        cache = nms_keyfile_cache_load(cache_filename, profile_dir);
+        g_assert_cmpint(nms_keyfile_cache_get_n_entries(cache), ==, 0);
+    }
+
+    {
+        nm_auto_free_keyfile_cache NMSKeyfileCache *cache = NULL;
+
+        /* A missing cache is empty. */
+        g_assert_cmpint(unlink(cache_filename), ==, 0);
+        cache = nms_keyfile_cache_load(cache_filename, profile_dir);
+        g_assert_cmpint(nms_keyfile_cache_get_n_entries(cache), ==, 0);
+    }
+}
+
+/*****************************************************************************/
+
+#define TEST_PLUGIN_DIR     TEST_SCRATCH_DIR "/plugin"
+#define TEST_PLUGIN_DIR_LIB TEST_PLUGIN_DIR "/lib"
+#define TEST_PLUGIN_DIR_ETC TEST_PLUGIN_DIR "/etc"
+#define TEST_PLUGIN_DIR_RUN TEST_PLUGIN_DIR "/run"
+
+#define TEST_PLUGIN_UUID_A "0d4c1b1e-5c5e-4b5b-8f3a-6c1a3f2b7e01"
+#define TEST_PLUGIN_UUID_B "0d4c1b1e-5c5e-4b5b-8f3a-6c1a3f2b7e02"
+#define TEST_PLUGIN_UUID_C "0d4c1b1e-5c5e-4b5b-8f3a-6c1a3f2b7e03"
+#define TEST_PLUGIN_UUID_D "0d4c1b1e-5c5e-4b5b-8f3a-6c1a3f2b7e04"
+
+static void
+_plugin_config_setup(void)
+{
+    gs_free_error GError   *error = NULL;
+    NMConfigCmdLineOptions *cli;
+    GOptionContext         *context;
+    NMConfig               *config;
+    gboolean                success;
+    char                  **argv;
+    int                     argc;
+
+    const char *args[] = {
+        "test-keyfile-settings",
+        "--config",
+        TEST_SCRATCH_DIR "/NetworkManager.conf",
+        "--config-dir",
+        TEST_SCRATCH_DIR "/conf.d",
+        "--system-config-dir",
+        TEST_SCRATCH_DIR "/conf.d",
+        "--intern-config",
+        TEST_SCRATCH_DIR "/NetworkManager-intern.conf",
+        "--state-file",
+        TEST_SCRATCH_DIR "/NetworkManager.state",
+        "--no-auto-default",
+        TEST_SCRATCH_DIR "/no-auto-default.state",
+    };
+
+    /* The plugin requires the NMConfig singleton. */
+    success = g_file_set_contents(TEST_SCRATCH_DIR "/NetworkManager.conf", "[main]\n", -1, &error);
+    nmtst_assert_success(success, error);
+
+    argv = (char **) args;
+    argc = G_N_ELEMENTS(args);
+
+    cli     = nm_config_cmd_line_options_new(FALSE);
+    context = g_option_context_new(NULL);
+    nm_config_cmd_line_options_add_to_entries(cli, context);
+    success = g_option_context_parse(context, &argc, &argv, &error);
+    nmtst_assert_success(success, error);
+    g_option_context_free(context);
+
+    config = nm_config_setup(cli, NULL, &error);
+    nmtst_assert_success(config, error);
+    nm_config_cmd_line_options_free(cli);
+}
+
+static void
+_plugin_dir_remove(const char *dirname)
+{
+    const char *filename;
+    GDir       *dir;
+
+    dir = g_dir_open(dirname, 0, NULL);
+    if (!dir)
+        return;
+
+    while ((filename = g_dir_read_name(dir))) {
+        gs_free char *full_filename = g_build_filename(dirname, filename, NULL);
+
+        if (g_file_test(full_filename, G_FILE_TEST_IS_DIR)
+            && !g_file_test(full_filename, G_FILE_TEST_IS_SYMLINK))
+            _plugin_dir_remove(full_filename);
+        else
+            g_assert_cmpint(unlink(full_filename), ==, 0);
+    }
+
+    g_dir_close(dir);
+    g_assert_cmpint(rmdir(dirname), ==, 0);
+}
+
+static void
+_plugin_dirs_setup(void)
+{
+    _plugin_dir_remove(TEST_PLUGIN_DIR);
+    g_assert_cmpint(g_mkdir_with_parents(TEST_PLUGIN_DIR_ETC, 0755), ==, 0);
+    g_assert_cmpint(g_mkdir_with_parents(TEST_PLUGIN_DIR_RUN, 0755), ==, 0);
+}
+
+static void
+_plugin_write_keyfile(const char *full_filename, const char *id, const char *uuid)
+{
+    gs_free char         *contents = NULL;
+    gs_free_error GError *error    = NULL;
+    gboolean              success;
+
+    contents = g_strdup_printf("[connection]\n"
+                               "id=%s\n"
+                               "uuid=%s\n"
+                               "type=ethernet\n",
+                               id,
+                               uuid);
+    success = nm_utils_file_set_contents(full_filename, contents, -1, 0600, NULL, NULL, &error);
+    nmtst_assert_success(success, error);
+}
+
+static void
+_plugin_load_cb(NMSettingsPlugin  *plugin,
+                NMSettingsStorage *storage,
+                NMConnection      *connection,
+                gpointer           user_data)
+{
+    GHashTable *loaded = user_data;
+
+    g_assert(NMS_IS_KEYFILE_STORAGE(storage));
+    g_assert(!connection || NM_IS_CONNECTION(connection));
+
+    g_hash_table_insert(loaded,
+                        g_strdup(nms_keyfile_storage_get_filename(NMS_KEYFILE_STORAGE(storage))),
+                        connection ? g_object_ref(connection) : NULL);
+}
+
+static GHashTable *
+_plugin_reload(NMSKeyfilePlugin *plugin)
+{
+    GHashTable *loaded;
+
+    loaded = g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, nm_g_object_unref);
+    nm_settings_plugin_reload_connections(NM_SETTINGS_PLUGIN(plugin), _plugin_load_cb, loaded);
+    return loaded;
+}
+
+static void
+_plugin_assert_loaded(GHashTable *loaded, const char *full_filename, const char *id)
+{
+    NMConnection *connection;
+
+    g_assert(g_hash_table_lookup_extended(loaded, full_filename, NULL, (gpointer *) &connection));
+    if (!id)
+        g_assert(!connection);
+    else
+        g_assert_cmpstr(nm_connection_get_id(connection), ==, id);
+}
+
+static void
+test_plugin_reload_dirty(void)
+{
+    const char *const                 file_a = TEST_PLUGIN_DIR_ETC "/a.nmconnection";
+    const char *const                 file_b = TEST_PLUGIN_DIR_ETC "/b.nmconnection";
+    const char *const                 file_c = TEST_PLUGIN_DIR_ETC "/c.nmconnection";
+    const char *const                 file_l = TEST_PLUGIN_DIR_ETC "/l.nmconnection";
+    const char *const                 target = TEST_PLUGIN_DIR "/target.nmconnection";
+    gs_unref_object NMSKeyfilePlugin *plugin = NULL;
+    gs_unref_hashtable GHashTable    *loaded = NULL;
+
+    _plugin_dirs_setup();
+    _plugin_write_keyfile(file_a, "a", TEST_PLUGIN_UUID_A);
+    _plugin_write_keyfile(file_b, "b", TEST_PLUGIN_UUID_B);
+    _plugin_write_keyfile(file_c, "c", TEST_PLUGIN_UUID_C);
+    _plugin_write_keyfile(target, "l", TEST_PLUGIN_UUID_D);
+    g_assert_cmpint(symlink(target, file_l), ==, 0);
+
+    plugin = nms_keyfile_plugin_new_for_testing(NULL, TEST_PLUGIN_DIR_ETC, TEST_PLUGIN_DIR_RUN);
+
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 4);
+    _plugin_assert_loaded(loaded, file_a, "a");
+    _plugin_assert_loaded(loaded, file_b, "b");
+    _plugin_assert_loaded(loaded, file_c, "c");
+    _plugin_assert_loaded(loaded, file_l, "l");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+
+    /* Nothing changed, nothing gets re-read. */
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 0);
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+
+    _plugin_write_keyfile(file_b, "b2", TEST_PLUGIN_UUID_B);
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 1);
+    _plugin_assert_loaded(loaded, file_b, "b2");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+
+    /* inotify does not see the change of the symlink's target. The stat
+     * check on reload does. */
+    _plugin_write_keyfile(target, "l2", TEST_PLUGIN_UUID_D);
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 1);
+    _plugin_assert_loaded(loaded, file_l, "l2");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+
+    g_assert_cmpint(unlink(file_c), ==, 0);
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 1);
+    _plugin_assert_loaded(loaded, file_c, NULL);
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+}
+
+static void
+test_plugin_reload_overflow(void)
+{
+    const char *const                 file_a            = TEST_PLUGIN_DIR_ETC "/a.nmconnection";
+    const char *const                 file_b            = TEST_PLUGIN_DIR_ETC "/b.nmconnection";
+    const char *const                 file_c            = TEST_PLUGIN_DIR_ETC "/c.nmconnection";
+    gs_unref_object NMSKeyfilePlugin *plugin            = NULL;
+    gs_unref_hashtable GHashTable    *loaded            = NULL;
+    gs_free char                     *max_queued_events = NULL;
+    gint64                            n_events;
+    gint64                            i;
+
+    if (!g_file_get_contents("/proc/sys/fs/inotify/max_queued_events",
+                             &max_queued_events,
+                             NULL,
+                             NULL)) {
+        g_test_skip("cannot read the size of the inotify queue");
+        return;
+    }
+    n_events = _nm_utils_ascii_str_to_int64(g_strstrip(max_queued_events), 10, 1, 1000000, -1);
+    if (n_events < 0) {
+        g_test_skip("the inotify queue is too large to overflow");
+        return;
+    }
+
+    _plugin_dirs_setup();
+    _plugin_write_keyfile(file_a, "a", TEST_PLUGIN_UUID_A);
+    _plugin_write_keyfile(file_b, "b", TEST_PLUGIN_UUID_B);
+    _plugin_write_keyfile(file_c, "c", TEST_PLUGIN_UUID_C);
+
+    plugin = nms_keyfile_plugin_new_for_testing(NULL, TEST_PLUGIN_DIR_ETC, TEST_PLUGIN_DIR_RUN);
+
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 3);
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+
+    /* Alternate between two files, so that the kernel cannot merge the
+     * events. Without the overflow, only these two files would be re-read. */
+    for (i = 0; i <= n_events; i++)
+        g_assert_cmpint(chmod((i % 2) ? file_a : file_b, 0600), ==, 0);
+
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 3);
+    _plugin_assert_loaded(loaded, file_a, "a");
+    _plugin_assert_loaded(loaded, file_b, "b");
+    _plugin_assert_loaded(loaded, file_c, "c");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+
+    /* The full rescan set up the watch again. */
+    _plugin_write_keyfile(file_a, "a2", TEST_PLUGIN_UUID_A);
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 1);
+    _plugin_assert_loaded(loaded, file_a, "a2");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+}
+
+static void
+test_plugin_reload_dir_created(void)
+{
+    const char *const                 file_a = TEST_PLUGIN_DIR_ETC "/a.nmconnection";
+    const char *const                 file_d = TEST_PLUGIN_DIR_LIB "/d.nmconnection";
+    gs_unref_object NMSKeyfilePlugin *plugin = NULL;
+    gs_unref_hashtable GHashTable    *loaded = NULL;
+
+    _plugin_dirs_setup();
+    _plugin_write_keyfile(file_a, "a", TEST_PLUGIN_UUID_A);
+
+    plugin = nms_keyfile_plugin_new_for_testing(TEST_PLUGIN_DIR_LIB,
+                                                TEST_PLUGIN_DIR_ETC,
+                                                TEST_PLUGIN_DIR_RUN);
+
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 1);
+    _plugin_assert_loaded(loaded, file_a, "a");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+
+    g_assert_cmpint(g_mkdir_with_parents(TEST_PLUGIN_DIR_LIB, 0755), ==, 0);
+    _plugin_write_keyfile(file_d, "d", TEST_PLUGIN_UUID_D);
+
+    loaded = _plugin_reload(plugin);
+    _plugin_assert_loaded(loaded, file_d, "d");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+
+    /* Now the new directory is watched too. */
+    _plugin_write_keyfile(file_d, "d2", TEST_PLUGIN_UUID_D);
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 1);
+    _plugin_assert_loaded(loaded, file_d, "d2");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+}
+
+static void
+_plugin_load_order_cb(NMSettingsPlugin  *plugin,
+                      NMSettingsStorage *storage,
+                      NMConnection      *connection,
+                      gpointer           user_data)
+{
+    GPtrArray *order = user_data;
+
+    g_ptr_array_add(order,
+                    g_strdup_printf("%s %s",
+                                    nms_keyfile_storage_get_filename(NMS_KEYFILE_STORAGE(storage)),
+                                    connection ? nm_connection_get_uuid(connection) : "(none)"));
+}
+
+static void
+_plugin_load_parallel_write(const char *dirname, const char *name, guint idx, gint64 mtime)
+{
+    gs_free char         *full_filename = g_strdup_printf("%s/%s.nmconnection", dirname, name);
+    gs_free char         *contents      = NULL;
+    gs_free_error GError *error         = NULL;
+    struct timespec       times[2];
+    gboolean              success;
+
+    /* Every third profile uses 802.1x with blobs. Verifying them initializes
+     * the crypto library, which now happens on the worker threads. */
+    contents = g_strdup_printf("[connection]\n"
+                               "id=%s-%s\n"
+                               "uuid=a7d2c6f0-1b2c-4d3e-8f40-%012u\n"
+                               "type=ethernet\n"
+                               "%s",
+                               dirname,
+                               name,
+                               idx,
+                               (idx % 3) == 0 ? "\n"
+                                                "[802-1x]\n"
+                                                "eap=tls;\n"
+                                                "identity=Bill Smith\n"
+                                                "client-cert=data:;base64,Y2xpZW50LWNlcnQ=\n"
+                                                "private-key=data:;base64,cHJpdmF0ZS1rZXk=\n"
+                                                "private-key-password=12345testing\n"
+                                              : "");
+
+    times[0] = (struct timespec){.tv_sec = mtime};
+    times[1] = (struct timespec){.tv_sec = mtime};
+    success  = nm_utils_file_set_contents(full_filename, contents, -1, 0600, times, NULL, &error);
+    nmtst_assert_success(success, error);
+}
+
+static void
+test_plugin_load_parallel(void)
+{
+    gs_unref_object NMSKeyfilePlugin *plugin_parallel = NULL;
+    gs_unref_object NMSKeyfilePlugin *plugin_serial   = NULL;
+    gs_unref_hashtable GHashTable    *loaded_parallel = NULL;
+    gs_unref_hashtable GHashTable    *loaded_serial   = NULL;
+    gs_unref_ptrarray GPtrArray      *order_parallel  = NULL;
+    gs_unref_ptrarray GPtrArray      *order_serial    = NULL;
+    GHashTableIter                    h_iter;
+    const char                       *full_filename;
+    NMConnection                     *connection;
+    char                              name[64];
+    guint                             i;
+
+    _plugin_dirs_setup();
+    g_assert_cmpint(g_mkdir_with_parents(TEST_PLUGIN_DIR_LIB, 0755), ==, 0);
+
+    /* Enough files for the parallel path, with profiles in /usr/lib shadowed
+     * by /etc, profiles in /etc shadowed by /run, and several files with the
+     * same UUID and different timestamps in /etc. */
+    for (i = 0; i < 24; i++) {
+        nm_sprintf_buf(name, "p%02u", i);
+        _plugin_load_parallel_write(TEST_PLUGIN_DIR_ETC, name, i, 1000 + i);
+    }
+    for (i = 0; i < 8; i++) {
+        nm_sprintf_buf(name, "p%02u", i);
+        _plugin_load_parallel_write(TEST_PLUGIN_DIR_LIB, name, i, 2000 + i);
+        _plugin_load_parallel_write(TEST_PLUGIN_DIR_RUN, name, i + 4, 500 + i);
+    }
+    for (i = 0; i < 4; i++) {
+        nm_sprintf_buf(name, "dup%02u", i);
+        _plugin_load_parallel_write(TEST_PLUGIN_DIR_ETC,
+                                    name,
+                                    8 + i,
+                                    (i % 2) ? 900 + i : 1100 + i);
+    }
+    g_assert_cmpint(symlink("/dev/null",
+                            TEST_PLUGIN_DIR_ETC "/a7d2c6f0-1b2c-4d3e-8f40-000000000020.nmmeta"),
+                    ==,
+                    0);
+
+    plugin_parallel = nms_keyfile_plugin_new_for_testing(TEST_PLUGIN_DIR_LIB,
+                                                         TEST_PLUGIN_DIR_ETC,
+                                                         TEST_PLUGIN_DIR_RUN);
+    plugin_serial   = nms_keyfile_plugin_new_for_testing(TEST_PLUGIN_DIR_LIB,
+                                                       TEST_PLUGIN_DIR_ETC,
+                                                       TEST_PLUGIN_DIR_RUN);
+    nms_keyfile_plugin_set_load_serial_for_testing(plugin_serial, TRUE);
+
+    /* Use the thread pool, even if there is only one processor. */
+    nms_keyfile_plugin_set_load_workers_for_testing(plugin_parallel, 4);
+
+    order_parallel = g_ptr_array_new_with_free_func(g_free);
+    nm_settings_plugin_reload_connections(NM_SETTINGS_PLUGIN(plugin_parallel),
+                                          _plugin_load_order_cb,
+                                          order_parallel);
+    order_serial = g_ptr_array_new_with_free_func(g_free);
+    nm_settings_plugin_reload_connections(NM_SETTINGS_PLUGIN(plugin_serial),
+                                          _plugin_load_order_cb,
+                                          order_serial);
+
+    /* The storages are reported in the same order. */
+    g_assert_cmpint(order_parallel->len, ==, 24 + 8 + 8 + 4 + 1);
+    g_assert_cmpint(order_parallel->len, ==, order_serial->len);
+    for (i = 0; i < order_parallel->len; i++)
+        g_assert_cmpstr(order_parallel->pdata[i], ==, order_serial->pdata[i]);
+
+    /* And the profiles are the same. Force a full reload, so that the
+     * profiles are reported again. */
+    g_clear_object(&plugin_parallel);
+    g_clear_object(&plugin_serial);
+    plugin_parallel = nms_keyfile_plugin_new_for_testing(TEST_PLUGIN_DIR_LIB,
+                                                         TEST_PLUGIN_DIR_ETC,
+                                                         TEST_PLUGIN_DIR_RUN);
+    plugin_serial   = nms_keyfile_plugin_new_for_testing(TEST_PLUGIN_DIR_LIB,
+                                                       TEST_PLUGIN_DIR_ETC,
+                                                       TEST_PLUGIN_DIR_RUN);
+    nms_keyfile_plugin_set_load_serial_for_testing(plugin_serial, TRUE);
+    nms_keyfile_plugin_set_load_workers_for_testing(plugin_parallel, 4);
+
+    loaded_parallel = _plugin_reload(plugin_parallel);
+    loaded_serial   = _plugin_reload(plugin_serial);
+    g_assert_cmpint(g_hash_table_size(loaded_parallel), ==, order_parallel->len);
+    g_assert_cmpint(g_hash_table_size(loaded_parallel), ==, g_hash_table_size(loaded_serial));
+
+    g_hash_table_iter_init(&h_iter, loaded_parallel);
+    while (g_hash_table_iter_next(&h_iter, (gpointer *) &full_filename, (gpointer *) &connection)) {
+        NMConnection *connection_serial;
+
+        g_assert(g_hash_table_lookup_extended(loaded_serial,
+                                              full_filename,
+                                              NULL,
+                                              (gpointer *) &connection_serial));
+        if (!connection)
+            g_assert(!connection_serial);
+        else
+            nmtst_assert_connection_equals(connection, FALSE, connection_serial, FALSE);
+    }
+}
+
+static void
+_plugin_rewrite_keyfile_in_place(const char *full_filename, const char *id, const char *uuid)
+{
+    gs_free char   *contents = NULL;
+    struct stat     st_before;
+    struct stat     st_after;
+    struct timespec times[2];
+    int             fd;
+
+    /* Change the content, but keep inode, size and mtime. Only a stale
+     * cache entry can return the previous content. */
+    g_assert_cmpint(stat(full_filename, &st_before), ==, 0);
+
+    contents = g_strdup_printf("[connection]\n"
+                               "id=%s\n"
+                               "uuid=%s\n"
+                               "type=ethernet\n",
+                               id,
+                               uuid);
+    g_assert_cmpint(strlen(contents), ==, st_before.st_size);
+
+    fd = open(full_filename, O_WRONLY | O_CLOEXEC);
+    g_assert_cmpint(fd, >=, 0);
+    g_assert_cmpint(pwrite(fd, contents, strlen(contents), 0), ==, strlen(contents));
+    times[0] = st_before.st_atim;
+    times[1] = st_before.st_mtim;
+    g_assert_cmpint(futimens(fd, times), ==, 0);
+    nm_close(fd);
+
+    g_assert_cmpint(stat(full_filename, &st_after), ==, 0);
+    g_assert_cmpint(st_after.st_ino, ==, st_before.st_ino);
+    g_assert_cmpint(st_after.st_size, ==, st_before.st_size);
+    g_assert_cmpint(st_after.st_mtim.tv_sec, ==, st_before.st_mtim.tv_sec);
+    g_assert_cmpint(st_after.st_mtim.tv_nsec, ==, st_before.st_mtim.tv_nsec);
+}
+
+static void
+test_plugin_load_cache(void)
+{
+    const char *const                 cache  = TEST_PLUGIN_DIR "/keyfile-cache";
+    const char *const                 file_a = TEST_PLUGIN_DIR_ETC "/a.nmconnection";
+    const char *const                 file_b = TEST_PLUGIN_DIR_ETC "/b.nmconnection";
+    const char *const                 file_c = TEST_PLUGIN_DIR_ETC "/c.nmconnection";
+    const char *const                 file_d = TEST_PLUGIN_DIR_RUN "/d.nmconnection";
+    gs_unref_object NMSKeyfilePlugin *plugin = NULL;
+    gs_unref_hashtable GHashTable    *loaded = NULL;
+
+    _plugin_dirs_setup();
+    _plugin_write_keyfile(file_a, "a", TEST_PLUGIN_UUID_A);
+    _plugin_write_keyfile(file_b, "b", TEST_PLUGIN_UUID_B);
+    _plugin_write_keyfile(file_c, "c", TEST_PLUGIN_UUID_C);
+    _plugin_write_keyfile(file_d, "d", TEST_PLUGIN_UUID_D);
+
+    plugin = nms_keyfile_plugin_new_for_testing(NULL, TEST_PLUGIN_DIR_ETC, TEST_PLUGIN_DIR_RUN);
+    nms_keyfile_plugin_set_cache_filename_for_testing(plugin, cache);
+
+    g_assert(!g_file_test(cache, G_FILE_TEST_EXISTS));
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 4);
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+    g_assert(g_file_test(cache, G_FILE_TEST_IS_REGULAR));
+
+    /* @file_a changes. @file_b and @file_d change in a way that the cache
+     * cannot detect. */
+    _plugin_write_keyfile(file_a, "a2", TEST_PLUGIN_UUID_A);
+    _plugin_rewrite_keyfile_in_place(file_b, "B", TEST_PLUGIN_UUID_B);
+    _plugin_rewrite_keyfile_in_place(file_d, "D", TEST_PLUGIN_UUID_D);
+
+    /* A new instance does a full load. The changed file gets parsed again,
+     * the others come from the cache. Files in /run are never cached. */
+    g_clear_object(&plugin);
+    plugin = nms_keyfile_plugin_new_for_testing(NULL, TEST_PLUGIN_DIR_ETC, TEST_PLUGIN_DIR_RUN);
+    nms_keyfile_plugin_set_cache_filename_for_testing(plugin, cache);
+
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 4);
+    _plugin_assert_loaded(loaded, file_a, "a2");
+    _plugin_assert_loaded(loaded, file_b, "b");
+    _plugin_assert_loaded(loaded, file_c, "c");
+    _plugin_assert_loaded(loaded, file_d, "D");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+
+    /* Without cache, all files get parsed. */
+    g_clear_object(&plugin);
+    plugin = nms_keyfile_plugin_new_for_testing(NULL, TEST_PLUGIN_DIR_ETC, TEST_PLUGIN_DIR_RUN);
+
+    loaded = _plugin_reload(plugin);
+    g_assert_cmpint(g_hash_table_size(loaded), ==, 4);
+    _plugin_assert_loaded(loaded, file_a, "a2");
+    _plugin_assert_loaded(loaded, file_b, "B");
+    _plugin_assert_loaded(loaded, file_c, "c");
+    _plugin_assert_loaded(loaded, file_d, "D");
+    nm_clear_pointer(&loaded, g_hash_table_unref);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE();
 
 int
@@ -2935,6 +3591,14 @@ main(int argc, char **argv)
                     test_nm_keyfile_plugin_utils_escape_filename);
 
     g_test_add_func("/keyfile/test_nmmeta", test_nmmeta);
+    g_test_add_func("/keyfile/test_cache", test_cache);
+
+    _plugin_config_setup();
+    g_test_add_func("/keyfile/plugin/reload-dirty", test_plugin_reload_dirty);
+    g_test_add_func("/keyfile/plugin/reload-overflow", test_plugin_reload_overflow);
+    g_test_add_func("/keyfile/plugin/reload-dir-created", test_plugin_reload_dir_created);
+    g_test_add_func("/keyfile/plugin/load-parallel", test_plugin_load_parallel);
+    g_test_add_func("/keyfile/plugin/load-cache", test_plugin_load_cache);
 
     return g_test_run();
 }
@@ -16,9 +16,13 @@
 #include "libnm-core-intern/nm-core-internal.h"
 #include "nm-core-utils.h"
 
+#include "devices/nm-device-ethernet.h"
+#include "devices/nm-device-veth.h"
+#include "devices/nm-device-vlan.h"
 #include "dns/nm-dns-manager.h"
 #include "nm-connectivity.h"
 #include "nm-firewall-utils.h"
+#include "settings/nm-settings-utils.h"
 
 #include "nm-test-utils-core.h"
 
@@ -1236,6 +1240,228 @@ test_connection_sort_autoconnect_priority(void)
 
 /*****************************************************************************/
 
+typedef struct {
+    NMSettUtilCandidatesEntry entry;
+    NMConnection             *connection;
+} TestCandidate;
+
+static TestCandidate *
+_test_candidate_new(const char *id,
+                    const char *type,
+                    const char *interface_name,
+                    const char *mac_address,
+                    gboolean    s390)
+{
+    TestCandidate       *candidate;
+    NMSettingConnection *s_con;
+
+    candidate             = g_slice_new(TestCandidate);
+    candidate->connection = nmtst_create_minimal_connection(id, NULL, type, &s_con);
+    nm_sett_util_candidates_entry_init(&candidate->entry);
+
+    if (interface_name)
+        g_object_set(s_con, NM_SETTING_CONNECTION_INTERFACE_NAME, interface_name, NULL);
+
+    if (nm_streq(type, NM_SETTING_WIRED_SETTING_NAME)) {
+        NMSettingWired *s_wired = nm_connection_get_setting_wired(candidate->connection);
+
+        g_object_set(s_wired, NM_SETTING_WIRED_MAC_ADDRESS, mac_address, NULL);
+        if (s390) {
+            const char *const subchannels[] = {"0.0.8000", "0.0.8001", "0.0.8002", NULL};
+
+            g_object_set(s_wired, NM_SETTING_WIRED_S390_SUBCHANNELS, subchannels, NULL);
+        }
+    } else if (nm_streq(type, NM_SETTING_WIRELESS_SETTING_NAME)) {
+        g_object_set(nm_connection_get_setting_wireless(candidate->connection),
+                     NM_SETTING_WIRELESS_MAC_ADDRESS,
+                     mac_address,
+                     NULL);
+    } else
+        g_assert(!mac_address);
+
+    return candidate;
+}
+
+static void
+_test_candidate_free(TestCandidate *candidate)
+{
+    g_assert(!nm_sett_util_candidates_entry_is_linked(&candidate->entry));
+    g_object_unref(candidate->connection);
+    g_slice_free(TestCandidate, candidate);
+}
+
+static char *
+_test_candidates_collect(const NMSettUtilCandidates *candidates,
+                         const char                 *iface,
+                         const char                 *hwaddr,
+                         const char *const          *connection_types)
+{
+    gs_unref_ptrarray GPtrArray *arr = g_ptr_array_new();
+    gs_free const char         **ids = NULL;
+    guint                        i;
+
+    nm_sett_util_candidates_collect(candidates, iface, hwaddr, connection_types, arr);
+
+    ids = g_new(const char *, arr->len + 1);
+    for (i = 0; i < arr->len; i++) {
+        NMSettUtilCandidatesEntry *entry = arr->pdata[i];
+        TestCandidate             *candidate;
+
+        candidate = c_list_entry(&entry->_lst, TestCandidate, entry._lst);
+        ids[i]    = nm_connection_get_id(candidate->connection);
+    }
+    ids[i] = NULL;
+
+    nm_strv_sort(ids, -1);
+    return g_strjoinv(",", (char **) ids);
+}
+
+#define _assert_candidates(candidates, iface, hwaddr, connection_types, expected)            \
+    G_STMT_START                                                                             \
+    {                                                                                        \
+        gs_free char *_ids = _test_candidates_collect((candidates),                          \
+                                                      (iface),                               \
+                                                      (hwaddr),                              \
+                                                      (connection_types));                   \
+                                                                                             \
+        g_assert_cmpstr(_ids, ==, (expected));                                               \
+    }                                                                                        \
+    G_STMT_END
+
+static void
+test_settings_candidates(void)
+{
+    nm_auto_unref_gtypeclass NMDeviceClass *klass_ethernet = NULL;
+    nm_auto_unref_gtypeclass NMDeviceClass *klass_veth     = NULL;
+    nm_auto_unref_gtypeclass NMDeviceClass *klass_vlan     = NULL;
+    NMSettUtilCandidates                    candidates     = NM_SETT_UTIL_CANDIDATES_INIT;
+    TestCandidate                          *c[9];
+    gs_free char                           *hwaddr = NULL;
+    const char *const                      *types_ethernet;
+    const char *const                      *types_veth;
+    const char                             *types_vlan[2];
+    const char *const                       types_bond[] = {NM_SETTING_BOND_SETTING_NAME, NULL};
+    guint                                   i;
+
+    klass_ethernet = g_type_class_ref(NM_TYPE_DEVICE_ETHERNET);
+    klass_veth     = g_type_class_ref(NM_TYPE_DEVICE_VETH);
+    klass_vlan     = g_type_class_ref(NM_TYPE_DEVICE_VLAN);
+
+    /* NMDeviceEthernet handles wired and pppoe profiles, and NMDeviceVeth
+     * also veth profiles. They list the types instead of restricting the
+     * candidates to one type. */
+    g_assert_cmpstr(klass_ethernet->connection_type_check_compatible, ==, NULL);
+    g_assert_cmpstr(klass_veth->connection_type_check_compatible, ==, NULL);
+    types_ethernet = klass_ethernet->connection_types_check_compatible;
+    types_veth     = klass_veth->connection_types_check_compatible;
+    g_assert(types_ethernet);
+    g_assert(types_veth);
+    g_assert(nm_strv_contains(types_ethernet, -1, NM_SETTING_PPPOE_SETTING_NAME));
+    g_assert(!nm_strv_contains(types_ethernet, -1, NM_SETTING_VETH_SETTING_NAME));
+    g_assert(nm_strv_contains(types_veth, -1, NM_SETTING_VETH_SETTING_NAME));
+
+    types_vlan[0] = klass_vlan->connection_type_check_compatible;
+    types_vlan[1] = NULL;
+    g_assert_cmpstr(types_vlan[0], ==, NM_SETTING_VLAN_SETTING_NAME);
+
+    c[0] = _test_candidate_new("eth", "802-3-ethernet", NULL, NULL, FALSE);
+    c[1] = _test_candidate_new("eth-mac", "802-3-ethernet", NULL, "aa:bb:cc:dd:ee:01", FALSE);
+    c[2] = _test_candidate_new("eth-s390", "802-3-ethernet", NULL, "aa:bb:cc:dd:ee:09", TRUE);
+    c[3] = _test_candidate_new("eth-eth1", "802-3-ethernet", "eth1", NULL, FALSE);
+    c[4] = _test_candidate_new("wifi-mac", "802-11-wireless", NULL, "aa:bb:cc:dd:ee:02", FALSE);
+    c[5] = _test_candidate_new("pppoe", "pppoe", NULL, NULL, FALSE);
+    c[6] = _test_candidate_new("veth", "veth", NULL, NULL, FALSE);
+    c[7] = _test_candidate_new("vlan", "vlan", NULL, NULL, FALSE);
+    c[8] = _test_candidate_new("vlan-eth0", "vlan", "eth0", NULL, FALSE);
+
+    for (i = 0; i < G_N_ELEMENTS(c); i++)
+        nm_sett_util_candidates_update(&candidates, &c[i]->entry, c[i]->connection);
+
+    hwaddr = nm_sett_util_candidates_get_hwaddr(c[1]->connection);
+    g_assert_cmpstr(hwaddr, ==, "AA:BB:CC:DD:EE:01");
+    nm_clear_g_free(&hwaddr);
+    g_assert_cmpstr(nm_sett_util_candidates_get_hwaddr(c[0]->connection), ==, NULL);
+    g_assert_cmpstr(nm_sett_util_candidates_get_hwaddr(c[2]->connection), ==, NULL);
+    g_assert_cmpstr(nm_sett_util_candidates_get_hwaddr(c[3]->connection), ==, NULL);
+    hwaddr = nm_sett_util_candidates_get_hwaddr(c[4]->connection);
+    g_assert_cmpstr(hwaddr, ==, "AA:BB:CC:DD:EE:02");
+    nm_clear_g_free(&hwaddr);
+
+    /* An ethernet device with the MAC address of "eth-mac". The profiles
+     * with s390 subchannels are not bound to the MAC address. */
+    _assert_candidates(&candidates,
+                       "eth0",
+                       "AA:BB:CC:DD:EE:01",
+                       types_ethernet,
+                       "eth,eth-mac,eth-s390,pppoe");
+    _assert_candidates(&candidates,
+                       "eth0",
+                       "aa:bb:cc:dd:ee:09",
+                       types_ethernet,
+                       "eth,eth-s390,pppoe");
+
+    /* The interface name differs from "eth-eth1". */
+    _assert_candidates(&candidates,
+                       "eth1",
+                       "AA:BB:CC:DD:EE:03",
+                       types_ethernet,
+                       "eth,eth-eth1,eth-s390,pppoe");
+
+    /* A veth device also gets the veth profiles. */
+    _assert_candidates(&candidates, "veth0", NULL, types_veth, "eth,eth-s390,pppoe,veth");
+
+    /* A wifi device bound by MAC address. */
+    _assert_candidates(&candidates,
+                       "wlan0",
+                       "aa:bb:cc:dd:ee:02",
+                       NULL,
+                       "eth,eth-s390,pppoe,veth,vlan,wifi-mac");
+
+    /* A device class that is only compatible with one type. */
+    _assert_candidates(&candidates, "eth0", NULL, types_vlan, "vlan,vlan-eth0");
+    _assert_candidates(&candidates, "eth1", NULL, types_vlan, "vlan");
+
+    /* Changing the interface name moves the profile to another bucket. */
+    g_object_set(nm_connection_get_setting_connection(c[3]->connection),
+                 NM_SETTING_CONNECTION_INTERFACE_NAME,
+                 "eth0",
+                 NULL);
+    nm_sett_util_candidates_update(&candidates, &c[3]->entry, c[3]->connection);
+    _assert_candidates(&candidates, "eth1", NULL, types_ethernet, "eth,eth-s390,pppoe");
+    _assert_candidates(&candidates, "eth0", NULL, types_ethernet, "eth,eth-eth1,eth-s390,pppoe");
+
+    g_object_set(nm_connection_get_setting_connection(c[3]->connection),
+                 NM_SETTING_CONNECTION_INTERFACE_NAME,
+                 NULL,
+                 NULL);
+    nm_sett_util_candidates_update(&candidates, &c[3]->entry, c[3]->connection);
+    _assert_candidates(&candidates, "eth1", NULL, types_ethernet, "eth,eth-eth1,eth-s390,pppoe");
+
+    /* Changing the type moves the profile too, also for profiles in the
+     * bucket of an interface name. */
+    g_object_set(nm_connection_get_setting_connection(c[7]->connection),
+                 NM_SETTING_CONNECTION_TYPE,
+                 NM_SETTING_BOND_SETTING_NAME,
+                 NULL);
+    nm_sett_util_candidates_update(&candidates, &c[7]->entry, c[7]->connection);
+    g_object_set(nm_connection_get_setting_connection(c[8]->connection),
+                 NM_SETTING_CONNECTION_TYPE,
+                 NM_SETTING_BOND_SETTING_NAME,
+                 NULL);
+    nm_sett_util_candidates_update(&candidates, &c[8]->entry, c[8]->connection);
+    _assert_candidates(&candidates, "eth0", NULL, types_vlan, "");
+    _assert_candidates(&candidates, "eth0", NULL, types_bond, "vlan,vlan-eth0");
+
+    for (i = 0; i < G_N_ELEMENTS(c); i++) {
+        nm_sett_util_candidates_remove(&c[i]->entry);
+        _test_candidate_free(c[i]);
+    }
+    _assert_candidates(&candidates, "eth0", "AA:BB:CC:DD:EE:01", NULL, "");
+    nm_sett_util_candidates_clear(&candidates);
+}
+
+/*****************************************************************************/
+
 #define MATCH_S390   "S390:"
 #define MATCH_DRIVER "DRIVER:"
 
@@ -2817,6 +3043,7 @@ main(int argc, char **argv)
 
     g_test_add_func("/general/connection-sort/autoconnect-priority",
                     test_connection_sort_autoconnect_priority);
+    g_test_add_func("/general/settings-candidates", test_settings_candidates);
 
     g_test_add_func("/general/match-spec/device", test_match_spec_device);
     g_test_add_func("/general/match-spec/config", test_match_spec_config);
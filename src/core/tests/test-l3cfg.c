@@ -1074,6 +1074,332 @@ test_l3_ipv6ll(gconstpointer test_data)
 
 /*****************************************************************************/
 
+static const NML3ConfigData *
+_l3cd_content_hash_create(NMDedupMultiIndex *multi_idx, int ifindex, guint32 mtu)
+{
+    NML3ConfigData *l3cd;
+
+    l3cd = nm_l3_config_data_new(multi_idx, ifindex, NM_IP_CONFIG_SOURCE_DHCP);
+    nm_l3_config_data_add_address_4(
+        l3cd,
+        NM_PLATFORM_IP4_ADDRESS_INIT(.address      = nmtst_inet4_from_string("192.168.133.45"),
+                                     .peer_address = nmtst_inet4_from_string("192.168.133.45"),
+                                     .plen         = 24, ));
+    nm_l3_config_data_add_nameserver(l3cd, AF_INET, "192.168.133.1");
+    nm_l3_config_data_set_mtu(l3cd, mtu);
+    return nm_l3_config_data_seal(l3cd);
+}
+
+static void
+test_l3cd_content_hash(void)
+{
+    nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = nm_dedup_multi_index_new();
+    nm_auto_unref_l3cd const NML3ConfigData           *l3cd_a    = NULL;
+    nm_auto_unref_l3cd const NML3ConfigData           *l3cd_b    = NULL;
+    nm_auto_unref_l3cd const NML3ConfigData           *l3cd_c    = NULL;
+
+    l3cd_a = _l3cd_content_hash_create(multi_idx, 1, 1400);
+    l3cd_b = _l3cd_content_hash_create(multi_idx, 1, 1400);
+    l3cd_c = _l3cd_content_hash_create(multi_idx, 1, 1500);
+
+    g_assert(l3cd_a != l3cd_b);
+    g_assert_cmpuint(nm_l3_config_data_get_content_hash(l3cd_a),
+                     ==,
+                     nm_l3_config_data_get_content_hash(l3cd_b));
+    g_assert(nm_l3_config_data_equal(l3cd_a, l3cd_b));
+
+    g_assert_cmpuint(nm_l3_config_data_get_content_hash(l3cd_a),
+                     !=,
+                     nm_l3_config_data_get_content_hash(l3cd_c));
+    g_assert(!nm_l3_config_data_equal(l3cd_a, l3cd_c));
+    g_assert(nm_l3_config_data_cmp(l3cd_a, l3cd_c) != 0);
+}
+
+/*****************************************************************************/
+
+static const NML3ConfigData *
+_l3cfg_merge_l3cd_new(const TestFixture1 *f, const char *addr, const char *network, guint32 mss)
+{
+    NML3ConfigData *l3cd;
+
+    l3cd = nm_l3_config_data_new(f->multiidx, f->ifindex0, NM_IP_CONFIG_SOURCE_USER);
+    nm_l3_config_data_add_address_4(
+        l3cd,
+        NM_PLATFORM_IP4_ADDRESS_INIT(.address      = nmtst_inet4_from_string(addr),
+                                     .peer_address = nmtst_inet4_from_string(addr),
+                                     .plen         = 24, ));
+    nm_l3_config_data_add_route_4(
+        l3cd,
+        NM_PLATFORM_IP4_ROUTE_INIT(.ifindex   = f->ifindex0,
+                                   .rt_source = NM_IP_CONFIG_SOURCE_USER,
+                                   .network   = nmtst_inet4_from_string(network),
+                                   .plen      = 24,
+                                   .metric    = 100,
+                                   .mss       = mss, ));
+    return nm_l3_config_data_seal(l3cd);
+}
+
+static void
+_l3cfg_merge_add(NML3Cfg              *l3cfg,
+                 char                  tag,
+                 const NML3ConfigData *l3cd,
+                 int                   priority,
+                 guint32               acd_timeout_msec)
+{
+    nm_l3cfg_add_config(l3cfg,
+                        GINT_TO_POINTER(tag),
+                        TRUE,
+                        l3cd,
+                        priority,
+                        0,
+                        0,
+                        NM_PLATFORM_ROUTE_METRIC_DEFAULT_IP4,
+                        NM_PLATFORM_ROUTE_METRIC_DEFAULT_IP6,
+                        0,
+                        0,
+                        NM_DNS_PRIORITY_DEFAULT_NORMAL,
+                        NM_DNS_PRIORITY_DEFAULT_NORMAL,
+                        NM_L3_ACD_DEFEND_TYPE_NEVER,
+                        acd_timeout_msec,
+                        NM_L3CFG_CONFIG_FLAGS_NONE,
+                        NM_L3_CONFIG_MERGE_FLAGS_NONE);
+}
+
+static void
+_l3cfg_merge_assert_full(NML3Cfg *l3cfg, gboolean to_commit)
+{
+    nm_auto_unref_l3cd const NML3ConfigData *l3cd = NULL;
+
+    /* The combined l3cd is merged incrementally, resuming after the cached
+     * prefix. Merging all l3cds from scratch must give the same result. */
+    if (to_commit)
+        nm_l3cfg_commit(l3cfg, NM_L3_CFG_COMMIT_TYPE_UPDATE);
+    l3cd = nm_l3_config_data_ref(nm_l3cfg_get_combined_l3cd(l3cfg, to_commit));
+    g_assert(l3cd);
+
+    _nmtst_l3cfg_merge_cache_clear(l3cfg);
+    if (to_commit)
+        nm_l3cfg_commit(l3cfg, NM_L3_CFG_COMMIT_TYPE_UPDATE);
+    g_assert(nm_l3_config_data_equal(l3cd, nm_l3cfg_get_combined_l3cd(l3cfg, to_commit)));
+}
+
+static void
+test_l3cfg_merge_incremental(void)
+{
+    nm_auto(_test_fixture_1_teardown) TestFixture1 test_fixture = {};
+    const TestFixture1                            *f;
+    gs_unref_object NML3Cfg                       *l3cfg0      = NULL;
+    NML3CfgCommitTypeHandle                       *commit_type = NULL;
+    nm_auto_unref_l3cd const NML3ConfigData       *l3cd_a      = NULL;
+    nm_auto_unref_l3cd const NML3ConfigData       *l3cd_b      = NULL;
+    nm_auto_unref_l3cd const NML3ConfigData       *l3cd_b2     = NULL;
+    nm_auto_unref_l3cd const NML3ConfigData       *l3cd_c      = NULL;
+    in_addr_t                                      addr_b;
+
+    f = _test_fixture_1_setup(&test_fixture, 6);
+
+    l3cfg0 = _netns_access_l3cfg(f->netns, f->ifindex0);
+
+    commit_type = nm_l3cfg_commit_type_register(l3cfg0, NM_L3_CFG_COMMIT_TYPE_UPDATE, NULL, "test");
+
+    /* 'a' and 'c' have a route with the same ID. The one of 'a' is merged first
+     * and wins, until 'a' gets removed. */
+    l3cd_a  = _l3cfg_merge_l3cd_new(f, "192.168.133.45", "10.1.0.0", 1400);
+    l3cd_b  = _l3cfg_merge_l3cd_new(f, "192.168.133.46", "10.2.0.0", 0);
+    l3cd_b2 = _l3cfg_merge_l3cd_new(f, "192.168.133.47", "10.3.0.0", 0);
+    l3cd_c  = _l3cfg_merge_l3cd_new(f, "192.168.133.48", "10.1.0.0", 1300);
+    addr_b  = nmtst_inet4_from_string("192.168.133.46");
+
+    /* The address of 'b' must pass ACD before it gets configured. */
+    _l3cfg_merge_add(l3cfg0, 'a', l3cd_a, 3, 0);
+    _l3cfg_merge_add(l3cfg0, 'b', l3cd_b, 2, 300);
+    _l3cfg_merge_add(l3cfg0, 'c', l3cd_c, 1, 0);
+    _l3cfg_merge_assert_full(l3cfg0, TRUE);
+    g_assert(!nm_l3_config_data_lookup_address_4(nm_l3cfg_get_combined_l3cd(l3cfg0, TRUE),
+                                                 addr_b,
+                                                 24,
+                                                 addr_b));
+
+    /* ACD completes. That bumps the ACD generation, the cached prefix is stale. */
+    nmtst_main_context_iterate_until_assert(
+        NULL,
+        3000,
+        nm_l3_config_data_lookup_address_4(nm_l3cfg_get_combined_l3cd(l3cfg0, TRUE),
+                                           addr_b,
+                                           24,
+                                           addr_b));
+    _l3cfg_merge_assert_full(l3cfg0, TRUE);
+
+    /* Change the middle entry, and merge without committing. The cached prefix
+     * was merged for a commit. */
+    _l3cfg_merge_add(l3cfg0, 'b', l3cd_b2, 2, 0);
+    _l3cfg_merge_assert_full(l3cfg0, FALSE);
+    _l3cfg_merge_assert_full(l3cfg0, TRUE);
+
+    /* Remove the middle entry. */
+    g_assert(nm_l3cfg_remove_config_all(l3cfg0, GINT_TO_POINTER('b')));
+    _l3cfg_merge_assert_full(l3cfg0, TRUE);
+    _l3cfg_merge_assert_full(l3cfg0, FALSE);
+
+    /* Remove the first entry. Now the route of 'c' gets merged. */
+    g_assert(nm_l3cfg_remove_config_all(l3cfg0, GINT_TO_POINTER('a')));
+    _l3cfg_merge_assert_full(l3cfg0, FALSE);
+    _l3cfg_merge_assert_full(l3cfg0, TRUE);
+
+    g_assert(nm_l3cfg_remove_config_all(l3cfg0, GINT_TO_POINTER('c')));
+    nm_l3cfg_commit(l3cfg0, NM_L3_CFG_COMMIT_TYPE_UPDATE);
+    nm_l3cfg_commit_type_unregister(l3cfg0, commit_type);
+}
+
+/*****************************************************************************/
+
+#define COMMIT_BATCH_N 3
+
+static const char *const _commit_batch_nets[COMMIT_BATCH_N] = {
+    "10.4.0.0",
+    "10.5.0.0",
+    "10.6.0.0",
+};
+
+typedef struct {
+    NML3Cfg *l3cfgs[COMMIT_BATCH_N];
+    guint    pre_commit_count[COMMIT_BATCH_N];
+    guint    post_commit_count[COMMIT_BATCH_N];
+    bool     sync_commit_done;
+} TestCommitBatchData;
+
+static void
+_test_commit_batch_signal_notify(NML3Cfg                    *l3cfg,
+                                 const NML3ConfigNotifyData *notify_data,
+                                 TestCommitBatchData        *tdata)
+{
+    guint i;
+
+    for (i = 0; i < COMMIT_BATCH_N; i++) {
+        if (tdata->l3cfgs[i] == l3cfg)
+            break;
+    }
+    g_assert_cmpint(i, <, COMMIT_BATCH_N);
+
+    if (notify_data->notify_type == NM_L3_CONFIG_NOTIFY_TYPE_POST_COMMIT) {
+        tdata->post_commit_count[i]++;
+        return;
+    }
+
+    if (notify_data->notify_type != NM_L3_CONFIG_NOTIFY_TYPE_PRE_COMMIT)
+        return;
+
+    tdata->pre_commit_count[i]++;
+
+    if (i == 0 && !tdata->sync_commit_done) {
+        /* The first instance of the batch began its commit. Commit the second
+         * one synchronously, while it is still queued. The batch must skip it
+         * and continue with the others. */
+        tdata->sync_commit_done = TRUE;
+        g_assert(nm_l3cfg_commit_on_idle_is_scheduled(tdata->l3cfgs[1]));
+        nm_l3cfg_commit(tdata->l3cfgs[1], NM_L3_CFG_COMMIT_TYPE_AUTO);
+        g_assert(!nm_l3cfg_commit_on_idle_is_scheduled(tdata->l3cfgs[1]));
+        g_assert_cmpint(tdata->post_commit_count[1], ==, 1);
+        g_assert_cmpint(tdata->post_commit_count[0], ==, 0);
+    }
+}
+
+static void
+test_l3cfg_commit_batch(void)
+{
+    nm_auto(_test_fixture_1_teardown) TestFixture1 test_fixture = {};
+    const TestFixture1                            *f;
+    const char *const                              IFNAME_DUMMY = "nm-test-dummy0";
+    NML3CfgCommitTypeHandle                       *commit_types[COMMIT_BATCH_N];
+    TestCommitBatchData                            tdata = {};
+    int                                            ifindexes[COMMIT_BATCH_N];
+    guint                                          i;
+
+    f = _test_fixture_1_setup(&test_fixture, 7);
+
+    ifindexes[0] = f->ifindex0;
+    ifindexes[1] = f->ifindex1;
+    ifindexes[2] = nmtstp_link_dummy_add(f->platform, -1, IFNAME_DUMMY)->ifindex;
+    g_assert(nm_platform_link_change_flags(f->platform, ifindexes[2], IFF_UP, TRUE) >= 0);
+
+    for (i = 0; i < COMMIT_BATCH_N; i++) {
+        nm_auto_unref_l3cd_init NML3ConfigData *l3cd = NULL;
+
+        tdata.l3cfgs[i] = _netns_access_l3cfg(f->netns, ifindexes[i]);
+        g_signal_connect(tdata.l3cfgs[i],
+                         NM_L3CFG_SIGNAL_NOTIFY,
+                         G_CALLBACK(_test_commit_batch_signal_notify),
+                         &tdata);
+        commit_types[i] = nm_l3cfg_commit_type_register(tdata.l3cfgs[i],
+                                                        NM_L3_CFG_COMMIT_TYPE_UPDATE,
+                                                        NULL,
+                                                        "test");
+
+        l3cd = nm_l3_config_data_new(f->multiidx, ifindexes[i], NM_IP_CONFIG_SOURCE_USER);
+        nm_l3_config_data_add_route_4(
+            l3cd,
+            NM_PLATFORM_IP4_ROUTE_INIT(.ifindex   = ifindexes[i],
+                                       .rt_source = NM_IP_CONFIG_SOURCE_USER,
+                                       .network   = nmtst_inet4_from_string(_commit_batch_nets[i]),
+                                       .plen      = 24,
+                                       .metric    = 100, ));
+        nm_l3cfg_add_config(tdata.l3cfgs[i],
+                            GINT_TO_POINTER('a'),
+                            TRUE,
+                            l3cd,
+                            'a',
+                            0,
+                            0,
+                            NM_PLATFORM_ROUTE_METRIC_DEFAULT_IP4,
+                            NM_PLATFORM_ROUTE_METRIC_DEFAULT_IP6,
+                            0,
+                            0,
+                            NM_DNS_PRIORITY_DEFAULT_NORMAL,
+                            NM_DNS_PRIORITY_DEFAULT_NORMAL,
+                            NM_L3_ACD_DEFEND_TYPE_NEVER,
+                            0,
+                            NM_L3CFG_CONFIG_FLAGS_NONE,
+                            NM_L3_CONFIG_MERGE_FLAGS_NONE);
+    }
+
+    /* All instances get committed together, by one idle handler of NMNetns. */
+    for (i = 0; i < COMMIT_BATCH_N; i++) {
+        nm_l3cfg_commit_on_idle_schedule(tdata.l3cfgs[i], NM_L3_CFG_COMMIT_TYPE_AUTO);
+        g_assert(nm_l3cfg_commit_on_idle_is_scheduled(tdata.l3cfgs[i]));
+    }
+
+    nmtst_main_context_iterate_until_assert(NULL,
+                                            2000,
+                                            tdata.post_commit_count[0] > 0
+                                                && tdata.post_commit_count[2] > 0);
+
+    g_assert(tdata.sync_commit_done);
+    for (i = 0; i < COMMIT_BATCH_N; i++) {
+        g_assert_cmpint(tdata.pre_commit_count[i], ==, 1);
+        g_assert_cmpint(tdata.post_commit_count[i], ==, 1);
+        g_assert(nmtstp_ip4_route_get(f->platform,
+                                      ifindexes[i],
+                                      nmtst_inet4_from_string(_commit_batch_nets[i]),
+                                      24,
+                                      100,
+                                      0));
+    }
+
+    for (i = 0; i < COMMIT_BATCH_N; i++) {
+        g_signal_handlers_disconnect_by_func(tdata.l3cfgs[i],
+                                             G_CALLBACK(_test_commit_batch_signal_notify),
+                                             &tdata);
+        nm_l3cfg_remove_config_all(tdata.l3cfgs[i], GINT_TO_POINTER('a'));
+        nm_l3cfg_commit(tdata.l3cfgs[i], NM_L3_CFG_COMMIT_TYPE_UPDATE);
+        nm_l3cfg_commit_type_unregister(tdata.l3cfgs[i], commit_types[i]);
+        g_object_unref(tdata.l3cfgs[i]);
+    }
+
+    nmtstp_link_delete(f->platform, -1, ifindexes[2], IFNAME_DUMMY, TRUE);
+}
+
+/*****************************************************************************/
+
 NMTstpSetupFunc const _nmtstp_setup_platform_func = nm_linux_platform_setup;
 
 void
@@ -1085,6 +1411,9 @@ _nmtstp_init_tests(int *argc, char ***argv)
 void
 _nmtstp_setup_tests(void)
 {
+    g_test_add_func("/l3cfg/l3cd-content-hash", test_l3cd_content_hash);
+    g_test_add_func("/l3cfg/merge-incremental", test_l3cfg_merge_incremental);
+    g_test_add_func("/l3cfg/commit-batch", test_l3cfg_commit_batch);
     g_test_add_data_func("/l3cfg/1", GINT_TO_POINTER(1), test_l3cfg);
     g_test_add_data_func("/l3cfg/2", GINT_TO_POINTER(2), test_l3cfg);
     g_test_add_data_func("/l3cfg/3", GINT_TO_POINTER(3), test_l3cfg);
@@ -17,6 +17,7 @@
 #define NM_CONFIG_KEYFILE_GROUP_KEYFILE      "keyfile"
 #define NM_CONFIG_KEYFILE_GROUP_IFUPDOWN     "ifupdown"
 #define NM_CONFIG_KEYFILE_GROUP_GLOBAL_DNS   "global-dns"
+#define NM_CONFIG_KEYFILE_GROUP_PLATFORM     "platform"
 #define NM_CONFIG_KEYFILE_GROUP_CONFIG       ".config"
 
 #define NM_CONFIG_KEYFILE_KEY_MAIN_ASSUME_IPV6LL_ONLY          "assume-ipv6ll-only"
@@ -55,6 +56,9 @@
 
 #define NM_CONFIG_KEYFILE_KEY_IFUPDOWN_MANAGED "managed"
 
+#define NM_CONFIG_KEYFILE_KEY_PLATFORM_ROUTE_TABLES   "route-tables"
+#define NM_CONFIG_KEYFILE_KEY_PLATFORM_NETLINK_THREAD "netlink-thread"
+
 #define NM_CONFIG_KEYFILE_KEY_GLOBAL_DNS_SEARCHES "searches"
 #define NM_CONFIG_KEYFILE_KEY_GLOBAL_DNS_OPTIONS  "options"
 
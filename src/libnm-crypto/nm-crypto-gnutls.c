@@ -42,14 +42,9 @@ _get_cipher_info(NMCryptoCipherType cipher, int *out_cipher_mech, guint8 *out_re
 
 /*****************************************************************************/
 
-gboolean
-_nm_crypto_init(GError **error)
+static gboolean
+_crypto_init_locked(GError **error)
 {
-    static gboolean initialized = FALSE;
-
-    if (initialized)
-        return TRUE;
-
     if (gnutls_global_init() != 0) {
         gnutls_global_deinit();
         g_set_error_literal(error,
@@ -59,10 +54,30 @@ _nm_crypto_init(GError **error)
         return FALSE;
     }
 
-    initialized = TRUE;
     return TRUE;
 }
 
+gboolean
+_nm_crypto_init(GError **error)
+{
+    static GMutex lock;
+    static int    initialized = FALSE;
+    gboolean      success;
+
+    if (g_atomic_int_get(&initialized))
+        return TRUE;
+
+    /* We might get called from multiple threads at the same time (for example,
+     * when the keyfile plugin loads profiles on worker threads). */
+    g_mutex_lock(&lock);
+    success = initialized || _crypto_init_locked(error);
+    if (success)
+        g_atomic_int_set(&initialized, TRUE);
+    g_mutex_unlock(&lock);
+
+    return success;
+}
+
 /*****************************************************************************/
 
 guint8 *
@@ -52,14 +52,10 @@ _get_cipher_info(NMCryptoCipherType cipher,
 
 /*****************************************************************************/
 
-gboolean
-_nm_crypto_init(GError **error)
+static gboolean
+_crypto_init_locked(GError **error)
 {
-    static gboolean initialized = FALSE;
-    SECStatus       ret;
-
-    if (initialized)
-        return TRUE;
+    SECStatus ret;
 
     PR_Init(PR_USER_THREAD, PR_PRIORITY_NORMAL, 1);
     ret = NSS_NoDB_Init(NULL);
@@ -81,10 +77,31 @@ _nm_crypto_init(GError **error)
     SEC_PKCS12EnableCipher(PKCS12_DES_EDE3_168, 1);
     SEC_PKCS12SetPreferredCipher(PKCS12_DES_EDE3_168, 1);
 
-    initialized = TRUE;
     return TRUE;
 }
 
+gboolean
+_nm_crypto_init(GError **error)
+{
+    static GMutex lock;
+    static int    initialized = FALSE;
+    gboolean      success;
+
+    if (g_atomic_int_get(&initialized))
+        return TRUE;
+
+    /* We might get called from multiple threads at the same time (for example,
+     * when the keyfile plugin loads profiles on worker threads). NSS_NoDB_Init()
+     * must not run concurrently. */
+    g_mutex_lock(&lock);
+    success = initialized || _crypto_init_locked(error);
+    if (success)
+        g_atomic_int_set(&initialized, TRUE);
+    g_mutex_unlock(&lock);
+
+    return success;
+}
+
 guint8 *
 _nmtst_crypto_decrypt(NMCryptoCipherType cipher,
                       const guint8      *data,
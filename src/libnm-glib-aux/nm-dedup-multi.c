@@ -9,6 +9,7 @@
 
 #include "nm-hash-utils.h"
 #include "nm-c-list.h"
+#include "nm-ohash.h"
 
 /*****************************************************************************/
 
@@ -27,9 +28,9 @@ typedef struct {
 } LookupEntry;
 
 struct _NMDedupMultiIndex {
-    int         ref_count;
-    GHashTable *idx_entries;
-    GHashTable *idx_objs;
+    int     ref_count;
+    NMOHash idx_entries;
+    NMOHash idx_objs;
 };
 
 /*****************************************************************************/
@@ -76,7 +77,7 @@ _entry_lookup_obj(const NMDedupMultiIndex   *self,
     };
 
     ASSERT_idx_type(idx_type);
-    return g_hash_table_lookup(self->idx_entries, &stack_entry);
+    return nm_ohash_lookup(&self->idx_entries, &stack_entry);
 }
 
 static NMDedupMultiHeadEntry *
@@ -100,11 +101,11 @@ _entry_lookup_head(const NMDedupMultiIndex   *self,
             nm_assert(c_list_length_is(&idx_type->lst_idx_head, 1));
             head_entry = c_list_entry(idx_type->lst_idx_head.next, NMDedupMultiHeadEntry, lst_idx);
         }
-        nm_assert(head_entry == g_hash_table_lookup(self->idx_entries, &stack_entry));
+        nm_assert(head_entry == nm_ohash_lookup(&self->idx_entries, &stack_entry));
         return head_entry;
     }
 
-    return g_hash_table_lookup(self->idx_entries, &stack_entry);
+    return nm_ohash_lookup(&self->idx_entries, &stack_entry);
 }
 
 static void
@@ -353,10 +354,10 @@ _add(NMDedupMultiIndex        *self,
     idx_type->len++;
     head_entry->len++;
 
-    if (add_head_entry && !g_hash_table_add(self->idx_entries, head_entry))
+    if (add_head_entry && !nm_ohash_add(&self->idx_entries, head_entry))
         nm_assert_not_reached();
 
-    if (!g_hash_table_add(self->idx_entries, entry))
+    if (!nm_ohash_add(&self->idx_entries, entry))
         nm_assert_not_reached();
 
     NM_SET_OUT(out_entry, entry);
@@ -479,14 +480,14 @@ _remove_entry(NMDedupMultiIndex *self, NMDedupMultiEntry *entry, gboolean *out_h
     nm_assert(entry->obj);
     nm_assert(entry->head);
     nm_assert(!c_list_is_empty(&entry->lst_entries));
-    nm_assert(g_hash_table_lookup(self->idx_entries, entry) == entry);
+    nm_assert(nm_ohash_lookup(&self->idx_entries, entry) == entry);
 
     head_entry = (NMDedupMultiHeadEntry *) entry->head;
     obj        = entry->obj;
 
     nm_assert(head_entry);
     nm_assert(head_entry->len > 0);
-    nm_assert(g_hash_table_lookup(self->idx_entries, head_entry) == head_entry);
+    nm_assert(nm_ohash_lookup(&self->idx_entries, head_entry) == head_entry);
 
     idx_type = (NMDedupMultiIdxType *) head_entry->idx_type;
     ASSERT_idx_type(idx_type);
@@ -500,10 +501,10 @@ _remove_entry(NMDedupMultiIndex *self, NMDedupMultiEntry *entry, gboolean *out_h
 
     NM_SET_OUT(out_head_entry_removed, head_entry != NULL);
 
-    if (!g_hash_table_remove(self->idx_entries, entry))
+    if (!nm_ohash_remove(&self->idx_entries, entry))
         nm_assert_not_reached();
 
-    if (head_entry && !g_hash_table_remove(self->idx_entries, head_entry))
+    if (head_entry && !nm_ohash_remove(&self->idx_entries, head_entry))
         nm_assert_not_reached();
 
     c_list_unlink_stale(&entry->lst_entries);
@@ -532,7 +533,7 @@ _remove_head(NMDedupMultiIndex     *self,
     nm_assert(head_entry);
     nm_assert(head_entry->len > 0);
     nm_assert(head_entry->len == c_list_length(&head_entry->lst_entries_head));
-    nm_assert(g_hash_table_lookup(self->idx_entries, head_entry) == head_entry);
+    nm_assert(nm_ohash_lookup(&self->idx_entries, head_entry) == head_entry);
 
     n = 0;
     c_list_for_each_safe (iter_entry, iter_entry_safe, &head_entry->lst_entries_head) {
@@ -775,11 +776,12 @@ nm_dedup_multi_index_obj_release(NMDedupMultiIndex                          *sel
 {
     nm_assert(self);
     nm_assert(obj);
-    nm_assert(g_hash_table_lookup(self->idx_objs, obj) == obj);
+    nm_assert(nm_ohash_lookup(&self->idx_objs, obj) == obj);
     nm_assert(((const NMDedupMultiObj *) obj)->_multi_idx == self);
 
     ((NMDedupMultiObj *) obj)->_multi_idx = NULL;
-    if (!g_hash_table_remove(self->idx_objs, obj))
+    ((NMDedupMultiObj *) obj)->_id_hash   = 0;
+    if (!nm_ohash_remove(&self->idx_objs, obj))
         nm_assert_not_reached();
 }
 
@@ -790,7 +792,7 @@ nm_dedup_multi_index_obj_find(NMDedupMultiIndex                          *self,
     g_return_val_if_fail(self, NULL);
     g_return_val_if_fail(obj, NULL);
 
-    return g_hash_table_lookup(self->idx_objs, obj);
+    return nm_ohash_lookup(&self->idx_objs, obj);
 }
 
 gconstpointer
@@ -804,12 +806,12 @@ nm_dedup_multi_index_obj_intern(NMDedupMultiIndex                          *self
     nm_assert(obj_new);
 
     if (obj_new->_multi_idx == self) {
-        nm_assert(g_hash_table_lookup(self->idx_objs, obj_new) == obj_new);
+        nm_assert(nm_ohash_lookup(&self->idx_objs, obj_new) == obj_new);
         nm_dedup_multi_obj_ref(obj_new);
         return obj_new;
     }
 
-    obj_old = g_hash_table_lookup(self->idx_objs, obj_new);
+    obj_old = nm_ohash_lookup(&self->idx_objs, obj_new);
     nm_assert(obj_old != obj_new);
 
     if (obj_old) {
@@ -826,7 +828,7 @@ nm_dedup_multi_index_obj_intern(NMDedupMultiIndex                          *self
     nm_assert(obj_new);
     nm_assert(!obj_new->_multi_idx);
 
-    if (!g_hash_table_add(self->idx_objs, (gpointer) obj_new))
+    if (!nm_ohash_add(&self->idx_objs, (gpointer) obj_new))
         nm_assert_not_reached();
 
     ((NMDedupMultiObj *) obj_new)->_multi_idx = self;
@@ -1006,12 +1008,14 @@ nm_dedup_multi_index_new(void)
 
     self  = g_slice_new(NMDedupMultiIndex);
     *self = (NMDedupMultiIndex) {
-        .ref_count   = 1,
-        .idx_entries = g_hash_table_new((GHashFunc) _dict_idx_entries_hash,
-                                        (GEqualFunc) _dict_idx_entries_equal),
-        .idx_objs =
-            g_hash_table_new((GHashFunc) _dict_idx_objs_hash, (GEqualFunc) _dict_idx_objs_equal),
+        .ref_count = 1,
     };
+    nm_ohash_init(&self->idx_entries,
+                  (GHashFunc) _dict_idx_entries_hash,
+                  (GEqualFunc) _dict_idx_entries_equal);
+    nm_ohash_init(&self->idx_objs,
+                  (GHashFunc) _dict_idx_objs_hash,
+                  (GEqualFunc) _dict_idx_objs_equal);
     return self;
 }
 
@@ -1029,7 +1033,7 @@ nm_dedup_multi_index_ref(NMDedupMultiIndex *self)
 NMDedupMultiIndex *
 nm_dedup_multi_index_unref(NMDedupMultiIndex *self)
 {
-    GHashTableIter             iter;
+    NMOHashIter                iter;
     const NMDedupMultiIdxType *idx_type;
     NMDedupMultiEntry         *entry;
     const NMDedupMultiObj     *obj;
@@ -1041,8 +1045,8 @@ nm_dedup_multi_index_unref(NMDedupMultiIndex *self)
         return NULL;
 
 more:
-    g_hash_table_iter_init(&iter, self->idx_entries);
-    while (g_hash_table_iter_next(&iter, (gpointer *) &entry, NULL)) {
+    nm_ohash_iter_init(&iter, &self->idx_entries);
+    while (nm_ohash_iter_next(&iter, (gpointer *) &entry)) {
         if (entry->is_head)
             idx_type = ((NMDedupMultiHeadEntry *) entry)->idx_type;
         else
@@ -1051,17 +1055,17 @@ more:
         goto more;
     }
 
-    nm_assert(g_hash_table_size(self->idx_entries) == 0);
+    nm_assert(nm_ohash_size(&self->idx_entries) == 0);
 
-    g_hash_table_iter_init(&iter, self->idx_objs);
-    while (g_hash_table_iter_next(&iter, (gpointer *) &obj, NULL)) {
+    nm_ohash_iter_init(&iter, &self->idx_objs);
+    while (nm_ohash_iter_next(&iter, (gpointer *) &obj)) {
         nm_assert(obj->_multi_idx == self);
         ((NMDedupMultiObj *) obj)->_multi_idx = NULL;
+        ((NMDedupMultiObj *) obj)->_id_hash   = 0;
     }
-    g_hash_table_remove_all(self->idx_objs);
 
-    g_hash_table_unref(self->idx_entries);
-    g_hash_table_unref(self->idx_objs);
+    nm_ohash_destroy(&self->idx_entries);
+    nm_ohash_destroy(&self->idx_objs);
 
     g_slice_free(NMDedupMultiIndex, self);
     return NULL;
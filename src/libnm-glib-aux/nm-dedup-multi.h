@@ -46,6 +46,11 @@ struct _NMDedupMultiObj {
     };
     NMDedupMultiIndex *_multi_idx;
     guint              _ref_count;
+
+    /* A cache for the hash of the object's identity, for use by the
+     * implementation. Zero means not cached. It may only be set while the object
+     * is immutable, that is, while it is interned in a NMDedupMultiIndex. */
+    guint _id_hash;
 } _nm_align(_NMDedupMultiObj_Align);
 
 struct _NMDedupMultiObjClass {
@@ -0,0 +1,299 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+/*
+ * An open addressing hash set, using Robin Hood hashing with linear probing.
+ *
+ * Each slot contains the key pointer and the full hash value of the key.
+ * The hash value gives the ideal position of the key, and thereby the
+ * distance by which the key was displaced by collisions. On insert, a key
+ * that is further away from its ideal position takes the slot of a key that
+ * is closer to its own ("take from the rich"). That keeps the variance of
+ * the probe lengths small, and allows a lookup for a missing key to stop as
+ * soon as it encounters a key that is closer to its ideal position than the
+ * searched one would be.
+ *
+ * On removal, the following keys get shifted back by one slot, so that no
+ * tombstones are needed.
+ */
+
+#include "libnm-glib-aux/nm-default-glib-i18n-lib.h"
+
+#include "nm-ohash.h"
+
+/*****************************************************************************/
+
+typedef struct _NMOHashSlot {
+    gpointer key;
+    guint    hash;
+} Slot;
+
+/* The table gets grown when it becomes 7/8th full, and shrunk when it
+ * becomes less than 1/8th full. */
+#define OHASH_SIZE_MIN     8u
+#define OHASH_IS_FULL(h)   ((((gsize) (h)->_priv.size) + 1u) * 8u > _n_buckets(h) * 7u)
+#define OHASH_IS_SPARSE(h) \
+    (_n_buckets(h) > OHASH_SIZE_MIN && (((gsize) (h)->_priv.size) * 8u) < _n_buckets(h))
+
+/*****************************************************************************/
+
+static inline gsize
+_n_buckets(const NMOHash *h)
+{
+    return h->_priv.slots ? ((gsize) h->_priv.mask) + 1u : 0u;
+}
+
+static inline guint
+_slot_dist(const NMOHash *h, guint idx, guint hash)
+{
+    return (idx - hash) & h->_priv.mask;
+}
+
+static inline guint
+_hash(const NMOHash *h, gconstpointer key)
+{
+    return h->_priv.hash_func(key);
+}
+
+/*****************************************************************************/
+
+void
+nm_ohash_init(NMOHash *h, GHashFunc hash_func, GEqualFunc equal_func)
+{
+    nm_assert(h);
+    nm_assert(hash_func);
+    nm_assert(equal_func);
+
+    *h = (NMOHash) {
+        ._priv =
+            {
+                .hash_func  = hash_func,
+                .equal_func = equal_func,
+                .slots      = NULL,
+                .mask       = 0,
+                .size       = 0,
+            },
+    };
+}
+
+void
+nm_ohash_destroy(NMOHash *h)
+{
+    nm_assert(h);
+
+    nm_clear_g_free(&h->_priv.slots);
+    h->_priv.mask = 0;
+    h->_priv.size = 0;
+}
+
+/*****************************************************************************/
+
+static void
+_insert_new(NMOHash *h, gpointer key, guint hash, guint idx, guint dist)
+{
+    Slot cur = {
+        .key  = key,
+        .hash = hash,
+    };
+
+    /* Insert a key that is known not to be in the table yet. Start searching at
+     * @idx, which is at distance @dist from the ideal position of @key. */
+    for (;; idx = (idx + 1u) & h->_priv.mask, dist++) {
+        Slot *slot = &h->_priv.slots[idx];
+        guint slot_dist;
+
+        if (!slot->key) {
+            *slot = cur;
+            h->_priv.size++;
+            return;
+        }
+
+        slot_dist = _slot_dist(h, idx, slot->hash);
+        if (slot_dist < dist) {
+            NM_SWAP(slot, &cur);
+            dist = slot_dist;
+        }
+    }
+}
+
+static void
+_resize(NMOHash *h, gsize n_buckets)
+{
+    gs_free Slot *old_slots = h->_priv.slots;
+    gsize         old_n_buckets;
+    gsize         i;
+
+    nm_assert(n_buckets >= OHASH_SIZE_MIN);
+    nm_assert(nm_utils_is_power_of_two(n_buckets));
+    nm_assert(n_buckets <= ((gsize) G_MAXUINT) + 1u);
+    nm_assert(h->_priv.size < n_buckets);
+
+    old_n_buckets = _n_buckets(h);
+
+    h->_priv.slots = g_new0(Slot, n_buckets);
+    h->_priv.mask  = n_buckets - 1u;
+    h->_priv.size  = 0;
+
+    /* The cached hash values are reused. The hash function is not called again. */
+    for (i = 0; i < old_n_buckets; i++) {
+        const Slot *slot = &old_slots[i];
+
+        if (slot->key)
+            _insert_new(h, slot->key, slot->hash, slot->hash & h->_priv.mask, 0);
+    }
+}
+
+static gboolean
+_lookup_idx(const NMOHash *h, gconstpointer key, guint hash, guint *out_idx)
+{
+    guint idx;
+    guint dist;
+
+    nm_assert(h->_priv.slots);
+
+    for (idx = hash & h->_priv.mask, dist = 0;; idx = (idx + 1u) & h->_priv.mask, dist++) {
+        const Slot *slot = &h->_priv.slots[idx];
+
+        if (!slot->key || _slot_dist(h, idx, slot->hash) < dist) {
+            /* Had @key been in the table, we would have found it by now.
+             * Return the position where it would get inserted. */
+            *out_idx = idx;
+            return FALSE;
+        }
+
+        if (slot->hash == hash && (slot->key == key || h->_priv.equal_func(slot->key, key))) {
+            *out_idx = idx;
+            return TRUE;
+        }
+    }
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_ohash_lookup:
+ * @h: the #NMOHash
+ * @key: the key to look up
+ *
+ * Returns: the key in @h that compares equal to @key, or %NULL.
+ */
+gpointer
+nm_ohash_lookup(const NMOHash *h, gconstpointer key)
+{
+    guint idx;
+
+    nm_assert(h);
+    nm_assert(key);
+
+    if (!h->_priv.slots)
+        return NULL;
+
+    if (!_lookup_idx(h, key, _hash(h, key), &idx))
+        return NULL;
+
+    return h->_priv.slots[idx].key;
+}
+
+/**
+ * nm_ohash_add:
+ * @h: the #NMOHash
+ * @key: the key to add. It must not be %NULL.
+ *
+ * Contrary to g_hash_table_add(), an existing key is not replaced.
+ *
+ * Returns: %TRUE if @key was added and %FALSE if an equal key was
+ *   already in the table.
+ */
+gboolean
+nm_ohash_add(NMOHash *h, gpointer key)
+{
+    guint hash;
+    guint idx;
+
+    nm_assert(h);
+    nm_assert(key);
+
+    hash = _hash(h, key);
+
+    if (!h->_priv.slots) {
+        _resize(h, OHASH_SIZE_MIN);
+        idx = hash & h->_priv.mask;
+    } else {
+        if (_lookup_idx(h, key, hash, &idx))
+            return FALSE;
+        if (OHASH_IS_FULL(h)) {
+            _resize(h, _n_buckets(h) * 2u);
+            idx = hash & h->_priv.mask;
+        }
+    }
+
+    _insert_new(h, key, hash, idx, _slot_dist(h, idx, hash));
+    return TRUE;
+}
+
+/**
+ * nm_ohash_remove:
+ * @h: the #NMOHash
+ * @key: the key to remove
+ *
+ * Returns: %TRUE if a key equal to @key was found and removed.
+ */
+gboolean
+nm_ohash_remove(NMOHash *h, gconstpointer key)
+{
+    guint idx;
+    guint idx_next;
+
+    nm_assert(h);
+    nm_assert(key);
+
+    if (!h->_priv.slots)
+        return FALSE;
+
+    if (!_lookup_idx(h, key, _hash(h, key), &idx))
+        return FALSE;
+
+    /* Shift the following keys back, until reaching an empty slot or a key
+     * that is at its ideal position. */
+    for (;; idx = idx_next) {
+        const Slot *slot_next;
+
+        idx_next  = (idx + 1u) & h->_priv.mask;
+        slot_next = &h->_priv.slots[idx_next];
+        if (!slot_next->key || _slot_dist(h, idx_next, slot_next->hash) == 0)
+            break;
+        h->_priv.slots[idx] = *slot_next;
+    }
+    h->_priv.slots[idx] = (Slot) {};
+    h->_priv.size--;
+
+    if (OHASH_IS_SPARSE(h))
+        _resize(h, _n_buckets(h) / 2u);
+
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+gboolean
+nm_ohash_iter_next(NMOHashIter *iter, gpointer *out_key)
+{
+    const NMOHash *h;
+    gsize          n_buckets;
+
+    nm_assert(iter);
+
+    h         = iter->_h;
+    n_buckets = _n_buckets(h);
+
+    while (iter->_idx < n_buckets) {
+        const Slot *slot = &h->_priv.slots[iter->_idx++];
+
+        if (slot->key) {
+            NM_SET_OUT(out_key, slot->key);
+            return TRUE;
+        }
+    }
+
+    NM_SET_OUT(out_key, NULL);
+    return FALSE;
+}
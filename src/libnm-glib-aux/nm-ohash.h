@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#ifndef __NM_OHASH_H__
+#define __NM_OHASH_H__
+
+/*****************************************************************************/
+
+struct _NMOHashSlot;
+
+/* NMOHash is a set of pointers, like a GHashTable that is only used with
+ * g_hash_table_add(). It uses open addressing with Robin Hood hashing and
+ * keeps the hash value of each key next to the key pointer. That way, a
+ * lookup usually touches only one cache line of the table and calls the
+ * equal function only for keys with the same hash. Also, rehashing on
+ * resize does not call the hash function again.
+ *
+ * The struct is supposed to be embedded in the owner, to save an indirection. */
+typedef struct {
+    struct {
+        GHashFunc  hash_func;
+        GEqualFunc equal_func;
+
+        struct _NMOHashSlot *slots;
+
+        guint mask;
+        guint size;
+    } _priv;
+} NMOHash;
+
+void nm_ohash_init(NMOHash *h, GHashFunc hash_func, GEqualFunc equal_func);
+
+void nm_ohash_destroy(NMOHash *h);
+
+#define nm_auto_ohash nm_auto(nm_ohash_destroy)
+
+gpointer nm_ohash_lookup(const NMOHash *h, gconstpointer key);
+
+gboolean nm_ohash_add(NMOHash *h, gpointer key);
+
+gboolean nm_ohash_remove(NMOHash *h, gconstpointer key);
+
+_nm_pure static inline guint
+nm_ohash_size(const NMOHash *h)
+{
+    nm_assert(h);
+    return h->_priv.size;
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    const NMOHash *_h;
+    guint          _idx;
+} NMOHashIter;
+
+static inline void
+nm_ohash_iter_init(NMOHashIter *iter, const NMOHash *h)
+{
+    nm_assert(iter);
+    nm_assert(h);
+
+    *iter = (NMOHashIter) {
+        ._h   = h,
+        ._idx = 0,
+    };
+}
+
+/* The table must not be modified while iterating. */
+gboolean nm_ohash_iter_next(NMOHashIter *iter, gpointer *out_key);
+
+#endif /* __NM_OHASH_H__ */
@@ -0,0 +1,232 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+/*
+ * A simple slab allocator for many small objects of the same size.
+ *
+ * Compared to malloc(), this saves the per-allocation overhead and keeps
+ * objects of the same type close together, which reduces fragmentation of
+ * the heap. It is intended for objects that exist in large numbers, like
+ * the routes in the platform cache.
+ *
+ * Each slab is a NM_SLAB_SIZE sized chunk of memory aligned to its size. It
+ * starts with a SlabHeader followed by the chunks. Free chunks are tracked in
+ * a per-slab freelist. Chunks that were never used are handed out by a bump
+ * pointer, so that a new slab does not need to be initialized upfront.
+ */
+
+#include "libnm-glib-aux/nm-default-glib-i18n-lib.h"
+
+#include "nm-slab.h"
+
+#include <stdlib.h>
+
+/*****************************************************************************/
+
+typedef struct _SlabChunkFree {
+    struct _SlabChunkFree *next;
+} SlabChunkFree;
+
+typedef struct {
+    CList          lst;
+    NMSlab        *owner;
+    SlabChunkFree *freelist;
+    guint          n_used;
+    guint          n_fresh;
+} SlabHeader;
+
+#define SLAB_CHUNK_ALIGN        ((gsize) 8u)
+#define SLAB_HEADER_SIZE        NM_ALIGN_TO(sizeof(SlabHeader), SLAB_CHUNK_ALIGN)
+#define SLAB_FROM_CHUNK(_chunk) ((SlabHeader *) (((uintptr_t) (_chunk)) & ~(NM_SLAB_SIZE - 1u)))
+
+/*****************************************************************************/
+
+static void
+_slab_init(NMSlab *slab)
+{
+    nm_assert(slab->_priv.chunk_size > 0);
+
+    if (slab->_priv.slabs_partial.next)
+        return;
+
+    c_list_init(&slab->_priv.slabs_partial);
+    c_list_init(&slab->_priv.slabs_full);
+    c_list_init(&slab->_priv.slabs_empty);
+
+    slab->_priv.chunk_size = NM_ALIGN_TO(slab->_priv.chunk_size, SLAB_CHUNK_ALIGN);
+    slab->_priv.chunks_per_slab = (NM_SLAB_SIZE - SLAB_HEADER_SIZE) / slab->_priv.chunk_size;
+    nm_assert(slab->_priv.chunks_per_slab > 1);
+}
+
+static gpointer
+_slab_chunk_at(NMSlab *slab, SlabHeader *hdr, guint idx)
+{
+    return ((char *) hdr) + SLAB_HEADER_SIZE + (slab->_priv.chunk_size * idx);
+}
+
+static SlabHeader *
+_slab_new(NMSlab *slab)
+{
+    SlabHeader *hdr;
+    gpointer    mem;
+
+    if (posix_memalign(&mem, NM_SLAB_SIZE, NM_SLAB_SIZE) != 0)
+        g_error("%s: failed to allocate %zu bytes", G_STRLOC, NM_SLAB_SIZE);
+
+    hdr  = mem;
+    *hdr = (SlabHeader) {
+        .owner = slab,
+    };
+    slab->_priv.n_slabs++;
+    return hdr;
+}
+
+static void
+_slab_destroy(NMSlab *slab, SlabHeader *hdr)
+{
+    nm_assert(hdr->n_used == 0);
+
+    c_list_unlink_stale(&hdr->lst);
+    slab->_priv.n_slabs--;
+    free(hdr);
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_slab_alloc0:
+ * @slab: the slab allocator
+ *
+ * Returns: a new, zero-initialized chunk of memory with the chunk size
+ *   of @slab. Release it with nm_slab_free().
+ */
+gpointer
+nm_slab_alloc0(NMSlab *slab)
+{
+    SlabHeader *hdr;
+    gpointer    chunk;
+
+    g_mutex_lock(&slab->_priv.lock);
+
+    _slab_init(slab);
+
+    hdr = c_list_first_entry(&slab->_priv.slabs_partial, SlabHeader, lst);
+    if (!hdr) {
+        hdr = c_list_first_entry(&slab->_priv.slabs_empty, SlabHeader, lst);
+        if (hdr) {
+            slab->_priv.n_slabs_empty--;
+            c_list_unlink_stale(&hdr->lst);
+        } else
+            hdr = _slab_new(slab);
+        c_list_link_front(&slab->_priv.slabs_partial, &hdr->lst);
+    }
+
+    if (hdr->freelist) {
+        chunk         = hdr->freelist;
+        hdr->freelist = hdr->freelist->next;
+    } else {
+        nm_assert(hdr->n_fresh < slab->_priv.chunks_per_slab);
+        chunk = _slab_chunk_at(slab, hdr, hdr->n_fresh++);
+    }
+
+    hdr->n_used++;
+    slab->_priv.n_chunks++;
+
+    if (hdr->n_used == slab->_priv.chunks_per_slab)
+        nm_c_list_move_tail(&slab->_priv.slabs_full, &hdr->lst);
+
+    g_mutex_unlock(&slab->_priv.lock);
+
+    memset(chunk, 0, slab->_priv.chunk_size);
+    return chunk;
+}
+
+/**
+ * nm_slab_free:
+ * @slab: the slab allocator
+ * @chunk: (nullable): the chunk to release.
+ *
+ * Releases @chunk, which was allocated by nm_slab_alloc0() from the same
+ * @slab. Empty slabs are released, except for a few that are kept
+ * for reuse (see nm_slab_trim()).
+ */
+void
+nm_slab_free(NMSlab *slab, gpointer chunk)
+{
+    SlabHeader    *hdr;
+    SlabChunkFree *c;
+
+    if (!chunk)
+        return;
+
+    hdr = SLAB_FROM_CHUNK(chunk);
+
+    nm_assert(hdr->owner == slab);
+    nm_assert(hdr->n_used > 0);
+
+    g_mutex_lock(&slab->_priv.lock);
+
+    c             = chunk;
+    c->next       = hdr->freelist;
+    hdr->freelist = c;
+
+    slab->_priv.n_chunks--;
+    hdr->n_used--;
+
+    if (hdr->n_used == 0) {
+        if (slab->_priv.n_slabs_empty >= NM_SLAB_KEEP_EMPTY)
+            _slab_destroy(slab, hdr);
+        else {
+            /* Reset the slab, so that it gets again filled in order. */
+            hdr->freelist = NULL;
+            hdr->n_fresh  = 0;
+            nm_c_list_move_tail(&slab->_priv.slabs_empty, &hdr->lst);
+            slab->_priv.n_slabs_empty++;
+        }
+    } else if (hdr->n_used == slab->_priv.chunks_per_slab - 1u) {
+        /* The slab was full. Now it has a free chunk. Prefer the
+         * slabs with many used chunks, so that the sparse ones have a
+         * chance to become empty. */
+        nm_c_list_move_front(&slab->_priv.slabs_partial, &hdr->lst);
+    }
+
+    g_mutex_unlock(&slab->_priv.lock);
+}
+
+/**
+ * nm_slab_trim:
+ * @slab: the slab allocator
+ *
+ * Releases the empty slabs that are kept for reuse. Call this after
+ * releasing many chunks at once.
+ */
+void
+nm_slab_trim(NMSlab *slab)
+{
+    SlabHeader *hdr;
+
+    g_mutex_lock(&slab->_priv.lock);
+
+    if (slab->_priv.slabs_empty.next) {
+        while ((hdr = c_list_first_entry(&slab->_priv.slabs_empty, SlabHeader, lst))) {
+            slab->_priv.n_slabs_empty--;
+            _slab_destroy(slab, hdr);
+        }
+    }
+
+    nm_assert(slab->_priv.n_slabs_empty == 0);
+
+    g_mutex_unlock(&slab->_priv.lock);
+}
+
+void
+nm_slab_get_stats(NMSlab *slab, NMSlabStats *out_stats)
+{
+    g_mutex_lock(&slab->_priv.lock);
+    *out_stats = (NMSlabStats) {
+        .chunk_size    = NM_ALIGN_TO(slab->_priv.chunk_size, SLAB_CHUNK_ALIGN),
+        .n_chunks      = slab->_priv.n_chunks,
+        .n_slabs       = slab->_priv.n_slabs,
+        .n_slabs_empty = slab->_priv.n_slabs_empty,
+    };
+    g_mutex_unlock(&slab->_priv.lock);
+}
@@ -0,0 +1,66 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#ifndef __NM_SLAB_H__
+#define __NM_SLAB_H__
+
+#include "nm-c-list.h"
+
+/*****************************************************************************/
+
+/* The size of one slab. Slabs are aligned to their size, so that the slab
+ * of a chunk can be found by masking the pointer. */
+#define NM_SLAB_SIZE ((gsize) (64u * 1024u))
+
+/* The number of empty slabs that are kept for reuse. Others are released
+ * immediately. */
+#define NM_SLAB_KEEP_EMPTY 2u
+
+typedef struct {
+    struct {
+        GMutex lock;
+
+        /* slabs with free chunks, full slabs and empty slabs. */
+        CList slabs_partial;
+        CList slabs_full;
+        CList slabs_empty;
+
+        gsize chunk_size;
+        guint chunks_per_slab;
+
+        guint n_slabs;
+        guint n_slabs_empty;
+        gsize n_chunks;
+    } _priv;
+} NMSlab;
+
+/**
+ * NM_SLAB_INIT:
+ * @_chunk_size: the size of the chunks that are allocated.
+ *
+ * Static initializer for an #NMSlab. The instance gets lazily initialized on
+ * first use, so that it can be used for static variables. The allocator is
+ * thread-safe.
+ */
+#define NM_SLAB_INIT(_chunk_size)        \
+    {                                    \
+        ._priv = {                       \
+            .chunk_size = (_chunk_size), \
+        },                               \
+    }
+
+gpointer nm_slab_alloc0(NMSlab *slab);
+
+void nm_slab_free(NMSlab *slab, gpointer chunk);
+
+void nm_slab_trim(NMSlab *slab);
+
+typedef struct {
+    gsize chunk_size;
+    gsize n_chunks;
+    guint n_slabs;
+    guint n_slabs_empty;
+} NMSlabStats;
+
+void nm_slab_get_stats(NMSlab *slab, NMSlabStats *out_stats);
+
+#endif /* __NM_SLAB_H__ */
@@ -14,6 +14,7 @@
 #include "libnm-glib-aux/nm-ref-string.h"
 #include "libnm-glib-aux/nm-io-utils.h"
 #include "libnm-glib-aux/nm-prioq.h"
+#include "libnm-glib-aux/nm-ohash.h"
 
 #include "libnm-glib-aux/nm-test-utils.h"
 
@@ -2596,6 +2597,137 @@ test_nm_prioq(void)
 
 /*****************************************************************************/
 
+static guint
+_ohash_bad_hash(gconstpointer p)
+{
+    /* A poor hash function, to get long probe sequences. */
+    return *((const guint32 *) p) % 7u;
+}
+
+static void
+test_nm_ohash(void)
+{
+    nm_auto_ohash NMOHash         h     = {};
+    gs_unref_hashtable GHashTable *h_ref = NULL;
+    guint32                        data[1000];
+    guint                          n_data;
+    guint                          i;
+    guint                          n;
+    NMOHashIter                    iter;
+    gpointer                       key;
+
+    n_data = 1 + (nmtst_get_rand_uint32() % G_N_ELEMENTS(data));
+    for (i = 0; i < n_data; i++)
+        data[i] = i;
+
+    nm_ohash_init(&h, nmtst_get_rand_bool() ? nm_puint32_hash : _ohash_bad_hash, nm_puint32_equal);
+    h_ref = g_hash_table_new(nm_puint32_hash, nm_puint32_equal);
+
+    g_assert(!nm_ohash_lookup(&h, &data[0]));
+    g_assert(!nm_ohash_remove(&h, &data[0]));
+
+    for (n = 0; n < 10 * n_data; n++) {
+        guint32 k = nmtst_get_rand_uint32() % n_data;
+
+        switch (nmtst_get_rand_uint32() % 3) {
+        case 0:
+            g_assert_cmpint(nm_ohash_add(&h, &data[k]), ==, g_hash_table_add(h_ref, &data[k]));
+            break;
+        case 1:
+            g_assert(nm_ohash_lookup(&h, &k) == g_hash_table_lookup(h_ref, &k));
+            break;
+        case 2:
+            g_assert_cmpint(nm_ohash_remove(&h, &k), ==, g_hash_table_remove(h_ref, &k));
+            break;
+        }
+        g_assert_cmpint(nm_ohash_size(&h), ==, g_hash_table_size(h_ref));
+    }
+
+    n = 0;
+    nm_ohash_iter_init(&iter, &h);
+    while (nm_ohash_iter_next(&iter, &key)) {
+        g_assert(g_hash_table_contains(h_ref, key));
+        n++;
+    }
+    g_assert_cmpint(n, ==, g_hash_table_size(h_ref));
+
+    if (nmtst_get_rand_bool()) {
+        for (i = 0; i < n_data; i++) {
+            g_assert_cmpint(nm_ohash_remove(&h, &data[i]),
+                            ==,
+                            g_hash_table_remove(h_ref, &data[i]));
+        }
+        g_assert_cmpint(nm_ohash_size(&h), ==, 0);
+    }
+}
+
+/*****************************************************************************/
+
+static gint64
+_ohash_bench_done(const char *what, guint n, gint64 t_start)
+{
+    gint64 now = nm_utils_get_monotonic_timestamp_nsec();
+
+    g_test_message("ohash-benchmark: %-18s %8u entries: %6" G_GINT64_FORMAT " msec",
+                   what,
+                   n,
+                   (now - t_start) / NM_UTILS_NSEC_PER_MSEC);
+    return nm_utils_get_monotonic_timestamp_nsec();
+}
+
+static void
+test_nm_ohash_benchmark(void)
+{
+    nm_auto_ohash NMOHash         h     = {};
+    gs_unref_hashtable GHashTable *h_ref = NULL;
+    gs_free guint32               *data  = NULL;
+    guint                          n_data;
+    guint                          i;
+    gint64                         t;
+
+    /* Not a real test. It compares NMOHash with GHashTable, which is what
+     * NMDedupMultiIndex used before. Run with "--verbose" to see the result. */
+
+    n_data = nmtst_test_quick() ? 10000u : 1000000u;
+
+    data = g_new(guint32, n_data);
+    for (i = 0; i < n_data; i++)
+        data[i] = nmtst_get_rand_uint32();
+
+    nm_ohash_init(&h, nm_puint32_hash, nm_puint32_equal);
+    h_ref = g_hash_table_new(nm_puint32_hash, nm_puint32_equal);
+
+    t = nm_utils_get_monotonic_timestamp_nsec();
+    for (i = 0; i < n_data; i++)
+        g_hash_table_add(h_ref, &data[i]);
+    t = _ohash_bench_done("GHashTable insert", n_data, t);
+    for (i = 0; i < n_data; i++)
+        nm_ohash_add(&h, &data[i]);
+    t = _ohash_bench_done("NMOHash insert", n_data, t);
+
+    g_assert_cmpint(nm_ohash_size(&h), ==, g_hash_table_size(h_ref));
+
+    t = nm_utils_get_monotonic_timestamp_nsec();
+    for (i = 0; i < n_data; i++)
+        g_assert(g_hash_table_lookup(h_ref, &data[i]));
+    t = _ohash_bench_done("GHashTable lookup", n_data, t);
+    for (i = 0; i < n_data; i++)
+        g_assert(nm_ohash_lookup(&h, &data[i]));
+    t = _ohash_bench_done("NMOHash lookup", n_data, t);
+
+    for (i = 0; i < n_data; i++)
+        g_hash_table_remove(h_ref, &data[i]);
+    t = _ohash_bench_done("GHashTable remove", n_data, t);
+    for (i = 0; i < n_data; i++)
+        nm_ohash_remove(&h, &data[i]);
+    _ohash_bench_done("NMOHash remove", n_data, t);
+
+    g_assert_cmpint(nm_ohash_size(&h), ==, 0);
+    g_assert_cmpint(g_hash_table_size(h_ref), ==, 0);
+}
+
+/*****************************************************************************/
+
 static const char *
 _getpwuid_name(uid_t uid)
 {
@@ -2898,6 +3030,8 @@ main(int argc, char **argv)
     g_test_add_func("/general/test_inet_parse_ip4_legacy", test_inet_parse_ip4_legacy);
     g_test_add_func("/general/test_garray", test_garray);
     g_test_add_func("/general/test_nm_prioq", test_nm_prioq);
+    g_test_add_func("/general/test_nm_ohash", test_nm_ohash);
+    g_test_add_func("/general/test_nm_ohash_benchmark", test_nm_ohash_benchmark);
     g_test_add_func("/general/test_nm_random", test_nm_random);
     g_test_add_func("/general/test_uid_to_name", test_uid_to_name);
 
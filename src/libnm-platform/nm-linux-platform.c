@@ -28,6 +28,7 @@
 #include <netinet/in.h>
 #include <net/if_arp.h>
 #include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/statvfs.h>
@@ -35,6 +36,7 @@
 
 #include "libnm-glib-aux/nm-c-list.h"
 #include "libnm-glib-aux/nm-io-utils.h"
+#include "libnm-glib-aux/nm-ohash.h"
 #include "libnm-glib-aux/nm-secret-utils.h"
 #include "libnm-glib-aux/nm-time-utils.h"
 #include "libnm-log-core/nm-logging.h"
@@ -361,8 +363,30 @@ struct _ifla_vf_vlan_info {
 
 /*****************************************************************************/
 
-#define RESYNC_RETRIES         50
-#define RESYNC_BACKOFF_SECONDS 1
+#define RESYNC_RETRIES 50
+
+/* After pruning at least this many objects, release the memory of
+ * empty slabs (see nmp_object_slab_trim()). */
+#define CACHE_PRUNE_SLAB_TRIM_THRESHOLD 1000u
+
+/* After a receive buffer overflow (ENOBUFS), we wait before starting the
+ * resync. The backoff doubles on repeated overflows within
+ * RESYNC_OVERFLOW_WINDOW_MSEC. */
+#define RESYNC_BACKOFF_MSEC_MIN     1000u
+#define RESYNC_BACKOFF_MSEC_MAX     16000u
+#define RESYNC_OVERFLOW_WINDOW_MSEC 60000
+
+/* The delay between the refresh of the object types during a resync. */
+#define RESYNC_STEP_MSEC 200u
+
+/* After changing the peers of a WireGuard link with
+ * NM_PLATFORM_WIREGUARD_CHANGE_FLAG_SYNC_PEERS, the cache gets updated with
+ * what was sent. Reading the link back from the kernel is postponed by this
+ * delay, so that repeated changes only cause one dump of all peers. */
+#define WIREGUARD_REFRESH_DELAY_MSEC 5000u
+
+#define NETLINK_RCVBUF_SIZE_INITIAL (8u * 1024u * 1024u)
+#define NETLINK_RCVBUF_SIZE_MAX     (64u * 1024u * 1024u)
 
 /*****************************************************************************/
 
@@ -420,6 +444,27 @@ typedef struct {
     gint8 addr_family_for_dump;
 } RefreshAllInfo;
 
+/* Describes a subset of the objects of one type (addresses or routes), that
+ * can be requested from kernel with a filtered dump (NETLINK_GET_STRICT_CHK).
+ * This allows to resync the cache for one interface, without dumping all
+ * objects of the netns.
+ *
+ * There is no scope by route protocol. Every route dump is already filtered
+ * by rtm_protocol, one dump per protocol in IP_ROUTE_TRACKED_PROTOCOLS. And
+ * the events that require a partial resync (a link going down, an
+ * RTM_NEWROUTE that replaced an unknown route) affect routes of any
+ * protocol, so a resync limited to one protocol would leave stale routes of
+ * the other ones in the cache. */
+typedef struct {
+    NMPObjectType obj_type;
+
+    /* If positive, only objects on this interface. */
+    int ifindex;
+
+    /* For routes, if not RT_TABLE_UNSPEC, only routes in this table. */
+    guint32 table;
+} RefreshScope;
+
 typedef enum _nm_packed {
     DELAYED_ACTION_TYPE_NONE = 0,
 
@@ -447,6 +492,7 @@ typedef enum _nm_packed {
     DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_GENL = 1 << 13,
     DELAYED_ACTION_TYPE_REFRESH_LINK           = 1 << 14,
     DELAYED_ACTION_TYPE_CONTROLLER_CONNECTED   = 1 << 15,
+    DELAYED_ACTION_TYPE_REFRESH_SCOPED         = 1 << 16,
 
     __DELAYED_ACTION_TYPE_MAX,
 
@@ -521,6 +567,7 @@ typedef struct {
         NMPObject **out_route_get;
         gpointer    out_data;
     } response;
+    gint64                             start_nsec;
     gint64                             timeout_abs_nsec;
     guint32                            seq_number;
     WaitForNlResponseResult            seq_result;
@@ -534,6 +581,47 @@ typedef struct {
     guint32 nlh_seq_last_seen;
 } NetlinkProtocolPrivData;
 
+typedef struct {
+    /* The refresh-all actions that are still pending to recover from a
+     * receive buffer overflow. They get scheduled one priority group at
+     * a time (see resync_priority_groups). */
+    DelayedActionType pending;
+
+    GSource *timeout_source;
+    gint64   last_overflow_msec;
+    guint    backoff_msec;
+
+    /* The receive buffer size that we requested last. The kernel reports
+     * (in stats.rcvbuf_size) twice that value. */
+    guint32 rcvbuf_requested;
+
+    NMPlatformNetlinkStats stats;
+} NetlinkResyncData;
+
+/* The maximum number of received rtnetlink datagrams that were handed to the
+ * parse worker and not yet applied to the cache. When the main thread falls
+ * behind, it stops reading and first applies the pending batches. */
+#define PARSE_WORKER_MAX_PENDING 256u
+
+typedef struct {
+    /* A copy of one datagram received from the rtnetlink socket. A batch
+     * with a %NULL buffer asks the worker thread to quit. */
+    unsigned char     *buf;
+    int                len;
+    struct sockaddr_nl nla;
+    struct ucred       creds;
+
+    /* The objects that the worker parsed from the messages for which
+     * _parse_worker_msg_type() is TRUE. The objects of each message are
+     * followed by a %NULL entry. */
+    GPtrArray *objs;
+    guint      objs_idx;
+
+    /* The route tables that were tracked when the datagram was received.
+     * See nm_platform_route_table_filter_ref(). */
+    GArray *route_table_filter;
+} ParseWorkerBatch;
+
 typedef struct {
     struct nl_sock *sk_genl_sync;
 
@@ -556,12 +644,68 @@ typedef struct {
         NetlinkProtocolPrivData proto_data_x[_NMP_NETLINK_NUM];
     };
 
+    NetlinkResyncData resync_x[_NMP_NETLINK_NUM];
+
+    /* Optionally, rtnetlink messages are parsed on a worker thread. The main
+     * thread still reads the socket, but hands the datagrams to the worker and
+     * applies the parsed objects to the cache in batches, from @event_source. */
+    struct {
+        GThread     *thread;
+        GAsyncQueue *queue_in;
+        GAsyncQueue *queue_out;
+        GSource     *event_source;
+        int          eventfd;
+        guint        n_pending;
+    } parse_worker;
+
+    /* Counters and time totals of the netlink hot paths. See netlink_stats_get(). */
+    struct {
+        NMPlatformNetlinkMsgStats msg_kinds[_NM_PLATFORM_NETLINK_MSG_KIND_NUM];
+        guint64                   refresh_all;
+        guint64                   dumps_completed;
+        guint64                   dumps_nsec;
+        guint64                   dumps_max_nsec;
+    } hotpath_stats;
+
+    /* WireGuard links whose cached peers were patched after a change with
+     * NM_PLATFORM_WIREGUARD_CHANGE_FLAG_SYNC_PEERS. They get re-read from the
+     * kernel later, all at once from @source. */
+    struct {
+        GArray  *ifindexes;
+        GSource *source;
+    } wireguard_refresh;
+
+    /* The links whose statistics were requested by the last link_refresh_stats().
+     * RTM_NEWSTATS messages for other links are ignored. */
+    GHashTable *link_stats_ifindexes;
+
     guint32 pruning[_REFRESH_ALL_TYPE_NUM];
 
+    /* RefreshScope instances for which a filtered dump is in progress. Once
+     * the dump completes, the remaining dirty objects in the scope are pruned. */
+    GArray *pruning_scoped;
+
     GHashTable *sysctl_get_prev_values;
     CList       sysctl_list;
     CList       sysctl_clear_cache_lst;
 
+    /* Coalescing of sysctl writes. See sysctl_set() and sysctl_set_async(). */
+    struct {
+        /* The /proc/sys values that were written in this main loop iteration,
+         * by path. They are forgotten from @clear_source, and when a link
+         * gets added, removed, renamed or changes its MTU. */
+        GHashTable *written;
+        GSource    *clear_source;
+
+        /* The SysctlAsyncInfo of this main loop iteration, by path. They are
+         * handed to @pool from @flush_source. */
+        GHashTable  *pending;
+        GSource     *flush_source;
+        GThreadPool *pool;
+
+        NMPlatformSysctlStats stats;
+    } sysctl_writes;
+
     NMUdevClient *udev_client;
 
     struct {
@@ -575,6 +719,7 @@ typedef struct {
 
         GPtrArray *list_controller_connected;
         GPtrArray *list_refresh_link;
+        GArray    *list_refresh_scoped;
         union {
             struct {
                 GArray *list_wait_for_response_genl;
@@ -706,11 +851,16 @@ delayed_action_schedule(NMPlatform *platform, DelayedActionType action_type, gpo
 static gboolean delayed_action_handle_all(NMPlatform *platform);
 static void do_request_link_no_delayed_actions(NMPlatform *platform, int ifindex, const char *name);
 static void do_request_all_no_delayed_actions(NMPlatform *platform, DelayedActionType action_type);
+static void do_request_scoped_no_delayed_actions(NMPlatform *platform, const RefreshScope *scope);
 static void cache_on_change(NMPlatform      *platform,
                             NMPCacheOpsType  cache_op,
                             const NMPObject *obj_old,
                             const NMPObject *obj_new);
 static void cache_prune_all(NMPlatform *platform);
+static int  routing_rule_add(NMPlatform                  *platform,
+                             NMPNlmFlags                  flags,
+                             const NMPlatformRoutingRule *routing_rule);
+static gboolean _parse_worker_apply(NMPlatform *platform, gboolean wait);
 static gboolean event_handler_read_netlink(NMPlatform        *platform,
                                            NMPNetlinkProtocol netlink_protocol,
                                            gboolean           wait_for_acks);
@@ -1414,6 +1564,10 @@ typedef struct {
      * the parsing as long as this flag stays TRUE and an object gets returned. */
     bool iter_more;
 
+    /* Without a platform instance (on the parse worker thread), the route
+     * tables to track. See nm_platform_route_table_filter_ref(). */
+    const GArray *route_table_filter;
+
     union {
         struct {
             guint next_multihop;
@@ -1421,6 +1575,13 @@ typedef struct {
     };
 } ParseNlmsgIter;
 
+typedef struct {
+    /* The objects that the parse worker created for one netlink message. */
+    NMPObject *const *objs;
+    guint             len;
+    guint             idx;
+} ParsedObjs;
+
 #define NLMSG_TAIL(nmsg) \
     NM_CAST_ALIGN(struct rtattr, ((char *) (nmsg)) + NLMSG_ALIGN((nmsg)->nlmsg_len))
 
@@ -3048,15 +3209,48 @@ nla_put_failure:
 }
 
 static const NMPObject *
-_wireguard_refresh_link(NMPlatform *platform, guint16 wireguard_family_id, int ifindex)
+_wireguard_cache_update_lnk(NMPlatform *platform, const NMPObject *plink, const NMPObject *lnk_new)
 {
-    NMLinuxPlatformPrivate         *priv    = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
     nm_auto_nmpobj const NMPObject *obj_old = NULL;
     nm_auto_nmpobj const NMPObject *obj_new = NULL;
-    nm_auto_nmpobj const NMPObject *lnk_new = NULL;
+    nm_auto_nmpobj NMPObject       *obj     = NULL;
     NMPCacheOpsType                 cache_op;
-    const NMPObject                *plink = NULL;
-    nm_auto_nmpobj NMPObject       *obj   = NULL;
+
+    if (plink->_link.netlink.lnk == lnk_new)
+        return plink;
+
+    /* we use nmp_cache_update_netlink() to re-inject the new object into the cache.
+     * For that, we need to clone it, and tweak it so that it's suitable. It's a bit
+     * of a hack, in particular that we need to clear driver and udev-device. */
+    obj = nmp_object_clone(plink, FALSE);
+    nmp_object_unref(obj->_link.netlink.lnk);
+    obj->_link.netlink.lnk = nmp_object_ref(lnk_new);
+    obj->link.driver       = NULL;
+    nm_clear_pointer(&obj->_link.udev.device, udev_device_unref);
+
+    cache_op =
+        nmp_cache_update_netlink(nm_platform_get_cache(platform), obj, FALSE, &obj_old, &obj_new);
+    nm_assert(NM_IN_SET(cache_op, NMP_CACHE_OPS_UPDATED));
+    if (cache_op != NMP_CACHE_OPS_UNCHANGED) {
+        cache_on_change(platform, cache_op, obj_old, obj_new);
+        nm_platform_cache_update_emit_signal(platform, cache_op, obj_old, obj_new);
+    }
+
+    nm_assert(!obj_new
+              || (NMP_OBJECT_GET_TYPE(obj_new) == NMP_OBJECT_TYPE_LINK
+                  && obj_new->link.type == NM_LINK_TYPE_WIREGUARD
+                  && (!obj_new->_link.netlink.lnk
+                      || NMP_OBJECT_GET_TYPE(obj_new->_link.netlink.lnk)
+                             == NMP_OBJECT_TYPE_LNK_WIREGUARD)));
+    return obj_new;
+}
+
+static const NMPObject *
+_wireguard_refresh_link(NMPlatform *platform, guint16 wireguard_family_id, int ifindex)
+{
+    NMLinuxPlatformPrivate         *priv    = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    nm_auto_nmpobj const NMPObject *lnk_new = NULL;
+    const NMPObject                *plink   = NULL;
 
     nm_assert(wireguard_family_id > 0);
     nm_assert(ifindex > 0);
@@ -3083,33 +3277,358 @@ _wireguard_refresh_link(NMPlatform *platform, guint16 wireguard_family_id, int i
         }
     }
 
-    if (plink->_link.netlink.lnk == lnk_new)
-        return plink;
+    return _wireguard_cache_update_lnk(platform, plink, lnk_new);
+}
 
-    /* we use nmp_cache_update_netlink() to re-inject the new object into the cache.
-     * For that, we need to clone it, and tweak it so that it's suitable. It's a bit
-     * of a hack, in particular that we need to clear driver and udev-device. */
-    obj = nmp_object_clone(plink, FALSE);
-    nmp_object_unref(obj->_link.netlink.lnk);
-    obj->_link.netlink.lnk = g_steal_pointer(&lnk_new);
-    obj->link.driver       = NULL;
-    nm_clear_pointer(&obj->_link.udev.device, udev_device_unref);
+static gboolean
+_wireguard_refresh_timeout_cb(gpointer user_data)
+{
+    NMPlatform             *platform  = user_data;
+    NMLinuxPlatformPrivate *priv      = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    gs_unref_array GArray  *ifindexes = g_steal_pointer(&priv->wireguard_refresh.ifindexes);
+    guint16                 wireguard_family_id;
+    guint                   i;
 
-    cache_op =
-        nmp_cache_update_netlink(nm_platform_get_cache(platform), obj, FALSE, &obj_old, &obj_new);
-    nm_assert(NM_IN_SET(cache_op, NMP_CACHE_OPS_UPDATED));
-    if (cache_op != NMP_CACHE_OPS_UNCHANGED) {
-        cache_on_change(platform, cache_op, obj_old, obj_new);
-        nm_platform_cache_update_emit_signal(platform, cache_op, obj_old, obj_new);
+    nm_clear_g_source_inst(&priv->wireguard_refresh.source);
+
+    wireguard_family_id = nm_platform_genl_get_family_id(platform, NMP_GENL_FAMILY_TYPE_WIREGUARD);
+    if (wireguard_family_id == 0 || !ifindexes)
+        return G_SOURCE_CONTINUE;
+
+    for (i = 0; i < ifindexes->len; i++)
+        _wireguard_refresh_link(platform, wireguard_family_id, nm_g_array_index(ifindexes, int, i));
+
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+_wireguard_refresh_schedule(NMPlatform *platform, int ifindex)
+{
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    guint                   i;
+
+    if (!priv->wireguard_refresh.ifindexes)
+        priv->wireguard_refresh.ifindexes = g_array_new(FALSE, FALSE, sizeof(int));
+
+    for (i = 0; i < priv->wireguard_refresh.ifindexes->len; i++) {
+        if (nm_g_array_index(priv->wireguard_refresh.ifindexes, int, i) == ifindex)
+            break;
     }
+    if (i == priv->wireguard_refresh.ifindexes->len)
+        g_array_append_val(priv->wireguard_refresh.ifindexes, ifindex);
 
-    nm_assert(!obj_new
-              || (NMP_OBJECT_GET_TYPE(obj_new) == NMP_OBJECT_TYPE_LINK
-                  && obj_new->link.type == NM_LINK_TYPE_WIREGUARD
-                  && (!obj_new->_link.netlink.lnk
-                      || NMP_OBJECT_GET_TYPE(obj_new->_link.netlink.lnk)
-                             == NMP_OBJECT_TYPE_LNK_WIREGUARD)));
-    return obj_new;
+    /* Don't postpone an already scheduled refresh. That limits the rate
+     * of refreshes, while the interface gets reconfigured repeatedly. */
+    if (!priv->wireguard_refresh.source) {
+        priv->wireguard_refresh.source = nm_g_timeout_add_source(WIREGUARD_REFRESH_DELAY_MSEC,
+                                                                 _wireguard_refresh_timeout_cb,
+                                                                 platform);
+    }
+}
+
+/*****************************************************************************/
+
+static guint
+_wireguard_peer_public_key_hash(gconstpointer ptr)
+{
+    const NMPWireGuardPeer *peer = ptr;
+
+    return nm_hash_mem(1836489053u, peer->public_key, sizeof(peer->public_key));
+}
+
+static gboolean
+_wireguard_peer_public_key_equal(gconstpointer a, gconstpointer b)
+{
+    const NMPWireGuardPeer *peer_a = a;
+    const NMPWireGuardPeer *peer_b = b;
+
+    return memcmp(peer_a->public_key, peer_b->public_key, sizeof(peer_a->public_key)) == 0;
+}
+
+static gboolean
+_wireguard_allowed_ips_contains(const NMPWireGuardAllowedIP *allowed_ips,
+                                guint                        allowed_ips_len,
+                                const NMPWireGuardAllowedIP *aip)
+{
+    NMIPAddr addr;
+    guint    i;
+
+    /* The kernel clears the host part of the address. Compare the
+     * addresses like that. */
+    nm_ip_addr_clear_host_address(aip->family, &addr, &aip->addr, aip->mask);
+
+    for (i = 0; i < allowed_ips_len; i++) {
+        const NMPWireGuardAllowedIP *a = &allowed_ips[i];
+        NMIPAddr                     a_addr;
+
+        if (a->family != aip->family || a->mask != aip->mask)
+            continue;
+        nm_ip_addr_clear_host_address(a->family, &a_addr, &a->addr, a->mask);
+        if (nm_ip_addr_equal(aip->family, &a_addr, &addr))
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static gboolean
+_wireguard_peer_is_synced(const NMPWireGuardPeer            *peer,
+                          NMPlatformWireGuardChangePeerFlags peer_flags,
+                          const NMPWireGuardPeer            *peer_cached)
+{
+    guint i;
+
+    if (NM_FLAGS_HAS(peer_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_PRESHARED_KEY)
+        && memcmp(peer->preshared_key, peer_cached->preshared_key, sizeof(peer->preshared_key))
+               != 0)
+        return FALSE;
+
+    if (NM_FLAGS_HAS(peer_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_KEEPALIVE_INTERVAL)
+        && peer->persistent_keepalive_interval != peer_cached->persistent_keepalive_interval)
+        return FALSE;
+
+    if (NM_FLAGS_HAS(peer_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ENDPOINT)
+        && peer->endpoint.sa.sa_family != AF_UNSPEC
+        && nm_sock_addr_union_cmp(&peer->endpoint, &peer_cached->endpoint) != 0)
+        return FALSE;
+
+    if (!NM_FLAGS_HAS(peer_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ALLOWEDIPS)) {
+        return !NM_FLAGS_HAS(peer_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REPLACE_ALLOWEDIPS)
+               || peer_cached->allowed_ips_len == 0;
+    }
+
+    /* The allowed-ips are a set. The kernel may return them in a
+     * different order. */
+    for (i = 0; i < peer->allowed_ips_len; i++) {
+        if (!_wireguard_allowed_ips_contains(peer_cached->allowed_ips,
+                                             peer_cached->allowed_ips_len,
+                                             &peer->allowed_ips[i]))
+            return FALSE;
+    }
+    if (NM_FLAGS_HAS(peer_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REPLACE_ALLOWEDIPS)) {
+        for (i = 0; i < peer_cached->allowed_ips_len; i++) {
+            if (!_wireguard_allowed_ips_contains(peer->allowed_ips,
+                                                 peer->allowed_ips_len,
+                                                 &peer_cached->allowed_ips[i]))
+                return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * _wireguard_sync_peers:
+ * @lnk_cached: the cached NMP_OBJECT_TYPE_LNK_WIREGUARD object
+ * @peers: the requested peers
+ * @peer_flags: (nullable): the flags for @peers
+ * @peers_len: the number of @peers
+ * @out_peers: (out): the peers to send
+ * @out_peer_flags: (out): the flags for @out_peers
+ * @out_cached_idx: (out): for each of @out_peers, the index of the peer
+ *   in @lnk_cached, or G_MAXUINT for a new peer.
+ *
+ * Finds the peers that differ from @lnk_cached, using an index by
+ * public key. The cached peers that are not in @peers are returned with
+ * NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REMOVE_ME. The returned peers are
+ * shallow copies that reference the allowed-ips of @peers.
+ *
+ * Returns: the number of peers in @out_peers.
+ */
+static guint
+_wireguard_sync_peers(const NMPObject                          *lnk_cached,
+                      const NMPWireGuardPeer                   *peers,
+                      const NMPlatformWireGuardChangePeerFlags *peer_flags,
+                      guint                                     peers_len,
+                      NMPWireGuardPeer                        **out_peers,
+                      NMPlatformWireGuardChangePeerFlags      **out_peer_flags,
+                      guint                                   **out_cached_idx)
+{
+    const NMPObjectLnkWireGuard        *lnk = &lnk_cached->_lnk_wireguard;
+    nm_auto_ohash NMOHash               idx_public_key;
+    gs_free bool                       *cached_seen = NULL;
+    NMPWireGuardPeer                   *s_peers;
+    NMPlatformWireGuardChangePeerFlags *s_flags;
+    guint                              *s_cached_idx;
+    guint                               n;
+    guint                               i;
+
+    nm_ohash_init(&idx_public_key,
+                  _wireguard_peer_public_key_hash,
+                  _wireguard_peer_public_key_equal);
+    for (i = 0; i < lnk->peers_len; i++)
+        nm_ohash_add(&idx_public_key, (gpointer) &lnk->peers[i]);
+
+    cached_seen  = g_new0(bool, lnk->peers_len + 1u);
+    s_peers      = g_new(NMPWireGuardPeer, peers_len + lnk->peers_len + 1u);
+    s_flags      = g_new(NMPlatformWireGuardChangePeerFlags, peers_len + lnk->peers_len + 1u);
+    s_cached_idx = g_new(guint, peers_len + lnk->peers_len + 1u);
+
+    n = 0;
+    for (i = 0; i < peers_len; i++) {
+        const NMPWireGuardPeer            *peer = &peers[i];
+        NMPlatformWireGuardChangePeerFlags p_flags;
+        const NMPWireGuardPeer            *peer_cached;
+        guint                              cached_idx = G_MAXUINT;
+
+        p_flags = peer_flags ? peer_flags[i] : NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_DEFAULT;
+
+        peer_cached = nm_ohash_lookup(&idx_public_key, peer);
+        if (peer_cached) {
+            cached_idx              = peer_cached - lnk->peers;
+            cached_seen[cached_idx] = TRUE;
+        }
+
+        if (p_flags == NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_NONE)
+            continue;
+
+        if (NM_FLAGS_HAS(p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REMOVE_ME)) {
+            if (!peer_cached)
+                continue;
+        } else if (peer_cached && _wireguard_peer_is_synced(peer, p_flags, peer_cached))
+            continue;
+
+        s_peers[n]      = *peer;
+        s_flags[n]      = p_flags;
+        s_cached_idx[n] = cached_idx;
+        n++;
+    }
+
+    for (i = 0; i < lnk->peers_len; i++) {
+        if (cached_seen[i])
+            continue;
+
+        s_peers[n] = (NMPWireGuardPeer) {};
+        memcpy(s_peers[n].public_key, lnk->peers[i].public_key, sizeof(s_peers[n].public_key));
+        s_flags[n]      = NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REMOVE_ME;
+        s_cached_idx[n] = i;
+        n++;
+    }
+
+    *out_peers      = s_peers;
+    *out_peer_flags = s_flags;
+    *out_cached_idx = s_cached_idx;
+    return n;
+}
+
+typedef struct {
+    NMPWireGuardPeer             peer;
+    const NMPWireGuardAllowedIP *allowed_ips_add;
+    guint                        allowed_ips_add_len;
+    bool                         removed;
+} WireGuardPeerPatch;
+
+/* Returns a copy of @lnk_cached, with the changes that were sent to the
+ * kernel for the peers from _wireguard_sync_peers() applied. That is what
+ * the kernel has now, except for statistics and the ordering of the
+ * allowed-ips. */
+static NMPObject *
+_wireguard_lnk_patch(const NMPObject                          *lnk_cached,
+                     const NMPWireGuardPeer                   *peers,
+                     const NMPlatformWireGuardChangePeerFlags *peer_flags,
+                     const guint                              *cached_idx,
+                     guint                                     peers_len)
+{
+    const NMPObjectLnkWireGuard *lnk     = &lnk_cached->_lnk_wireguard;
+    gs_free WireGuardPeerPatch  *patches = NULL;
+    NMPWireGuardAllowedIP       *allowed_ips_buf;
+    NMPObject                   *obj;
+    guint                        n_patches;
+    guint                        n_peers;
+    guint                        n_allowed_ips;
+    guint                        i;
+    guint                        j;
+    guint                        k;
+
+    n_patches = lnk->peers_len;
+    patches   = g_new0(WireGuardPeerPatch, lnk->peers_len + peers_len + 1u);
+    for (i = 0; i < lnk->peers_len; i++)
+        patches[i].peer = lnk->peers[i];
+
+    for (i = 0; i < peers_len; i++) {
+        const NMPWireGuardPeer            *peer    = &peers[i];
+        NMPlatformWireGuardChangePeerFlags p_flags = peer_flags[i];
+        WireGuardPeerPatch                *patch;
+
+        if (cached_idx[i] == G_MAXUINT) {
+            patch = &patches[n_patches++];
+            memcpy(patch->peer.public_key, peer->public_key, sizeof(peer->public_key));
+        } else
+            patch = &patches[cached_idx[i]];
+
+        if (NM_FLAGS_HAS(p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REMOVE_ME)) {
+            patch->removed = TRUE;
+            continue;
+        }
+        if (NM_FLAGS_HAS(p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_PRESHARED_KEY)) {
+            memcpy(patch->peer.preshared_key,
+                   peer->preshared_key,
+                   sizeof(patch->peer.preshared_key));
+        }
+        if (NM_FLAGS_HAS(p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_KEEPALIVE_INTERVAL))
+            patch->peer.persistent_keepalive_interval = peer->persistent_keepalive_interval;
+        if (NM_FLAGS_HAS(p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ENDPOINT)
+            && peer->endpoint.sa.sa_family != AF_UNSPEC)
+            patch->peer.endpoint = peer->endpoint;
+        if (NM_FLAGS_HAS(p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_REPLACE_ALLOWEDIPS)) {
+            patch->peer.allowed_ips     = NULL;
+            patch->peer.allowed_ips_len = 0;
+        }
+        if (NM_FLAGS_HAS(p_flags, NM_PLATFORM_WIREGUARD_CHANGE_PEER_FLAG_HAS_ALLOWEDIPS)) {
+            patch->allowed_ips_add     = peer->allowed_ips;
+            patch->allowed_ips_add_len = peer->allowed_ips_len;
+        }
+    }
+
+    n_peers       = 0;
+    n_allowed_ips = 0;
+    for (i = 0; i < n_patches; i++) {
+        if (patches[i].removed)
+            continue;
+        n_peers++;
+        n_allowed_ips += patches[i].peer.allowed_ips_len + patches[i].allowed_ips_add_len;
+    }
+
+    obj = nmp_object_new(NMP_OBJECT_TYPE_LNK_WIREGUARD, &lnk_cached->lnk_wireguard);
+    obj->_lnk_wireguard.peers_len = n_peers;
+    obj->_lnk_wireguard.peers     = n_peers > 0 ? g_new(NMPWireGuardPeer, n_peers) : NULL;
+    obj->_lnk_wireguard._allowed_ips_buf_len = n_allowed_ips;
+    allowed_ips_buf = n_allowed_ips > 0 ? g_new(NMPWireGuardAllowedIP, n_allowed_ips) : NULL;
+    obj->_lnk_wireguard._allowed_ips_buf = allowed_ips_buf;
+
+    for (i = 0, j = 0, k = 0; i < n_patches; i++) {
+        const WireGuardPeerPatch *patch = &patches[i];
+        NMPWireGuardPeer         *peer;
+
+        if (patch->removed)
+            continue;
+
+        peer  = (NMPWireGuardPeer *) &obj->_lnk_wireguard.peers[j++];
+        *peer = patch->peer;
+
+        peer->allowed_ips_len = patch->peer.allowed_ips_len + patch->allowed_ips_add_len;
+        if (peer->allowed_ips_len == 0) {
+            peer->allowed_ips = NULL;
+            continue;
+        }
+
+        if (patch->peer.allowed_ips_len > 0) {
+            memcpy(&allowed_ips_buf[k],
+                   patch->peer.allowed_ips,
+                   sizeof(NMPWireGuardAllowedIP) * patch->peer.allowed_ips_len);
+        }
+        if (patch->allowed_ips_add_len > 0) {
+            memcpy(&allowed_ips_buf[k + patch->peer.allowed_ips_len],
+                   patch->allowed_ips_add,
+                   sizeof(NMPWireGuardAllowedIP) * patch->allowed_ips_add_len);
+        }
+        peer->allowed_ips = &allowed_ips_buf[k];
+        k += peer->allowed_ips_len;
+    }
+
+    nm_assert(j == n_peers);
+    nm_assert(k == n_allowed_ips);
+
+    nm_explicit_bzero(patches, sizeof(WireGuardPeerPatch) * (lnk->peers_len + peers_len + 1u));
+    return obj;
 }
 
 static int
@@ -3345,16 +3864,73 @@ link_wireguard_change(NMPlatform                               *platform,
                       guint                                     peers_len,
                       NMPlatformWireGuardChangeFlags            change_flags)
 {
-    NMLinuxPlatformPrivate      *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
-    gs_unref_ptrarray GPtrArray *msgs = NULL;
-    guint16                      wireguard_family_id;
-    guint                        i;
-    int                          r;
+    NMLinuxPlatformPrivate                     *priv;
+    gs_unref_ptrarray GPtrArray                *msgs         = NULL;
+    nm_auto_nmpobj const NMPObject             *plink        = NULL;
+    const NMPObject                            *lnk_cached   = NULL;
+    gs_free NMPWireGuardPeer                   *s_peers      = NULL;
+    gs_free NMPlatformWireGuardChangePeerFlags *s_peer_flags = NULL;
+    gs_free guint                              *s_cached_idx = NULL;
+    guint                                       s_peers_len  = 0;
+    guint16                                     wireguard_family_id;
+    guint                                       i;
+    int                                         r;
 
     wireguard_family_id = nm_platform_genl_get_family_id(platform, NMP_GENL_FAMILY_TYPE_WIREGUARD);
     if (wireguard_family_id == 0)
         return -NME_PL_NO_FIRMWARE;
 
+    priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+
+    if (NM_FLAGS_HAS(change_flags, NM_PLATFORM_WIREGUARD_CHANGE_FLAG_SYNC_PEERS)
+        && !NM_FLAGS_HAS(change_flags, NM_PLATFORM_WIREGUARD_CHANGE_FLAG_REPLACE_PEERS)) {
+        plink = nmp_object_ref(nm_platform_link_get_obj(platform, ifindex, TRUE));
+        if (plink
+            && NMP_OBJECT_GET_TYPE(plink->_link.netlink.lnk) == NMP_OBJECT_TYPE_LNK_WIREGUARD)
+            lnk_cached = plink->_link.netlink.lnk;
+
+        if (!lnk_cached) {
+            /* We don't know the current peers. Replace them all. */
+            change_flags |= NM_PLATFORM_WIREGUARD_CHANGE_FLAG_REPLACE_PEERS;
+        } else {
+            const NMPlatformLnkWireGuard *l = &lnk_cached->lnk_wireguard;
+
+            if (NM_FLAGS_HAS(change_flags, NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_PRIVATE_KEY)
+                && memcmp(l->private_key, lnk_wireguard->private_key, sizeof(l->private_key))
+                       == 0)
+                change_flags &= ~NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_PRIVATE_KEY;
+            if (NM_FLAGS_HAS(change_flags, NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT)
+                && l->listen_port == lnk_wireguard->listen_port)
+                change_flags &= ~NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT;
+            if (NM_FLAGS_HAS(change_flags, NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK)
+                && l->fwmark == lnk_wireguard->fwmark)
+                change_flags &= ~NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK;
+
+            s_peers_len = _wireguard_sync_peers(lnk_cached,
+                                                peers,
+                                                peer_flags,
+                                                peers_len,
+                                                &s_peers,
+                                                &s_peer_flags,
+                                                &s_cached_idx);
+
+            _LOGT("wireguard: set-device, %u of %u peers differ from the cache",
+                  s_peers_len,
+                  peers_len);
+
+            if (s_peers_len == 0
+                && !NM_FLAGS_ANY(change_flags,
+                                 NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_PRIVATE_KEY
+                                     | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT
+                                     | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK))
+                return 0;
+
+            peers      = s_peers;
+            peer_flags = s_peer_flags;
+            peers_len  = s_peers_len;
+        }
+    }
+
     r = _wireguard_create_change_nlmsgs(platform,
                                         ifindex,
                                         wireguard_family_id,
@@ -3366,14 +3942,14 @@ link_wireguard_change(NMPlatform                               *platform,
                                         &msgs);
     if (r < 0) {
         _LOGW("wireguard: set-device, cannot construct netlink message: %s", nm_strerror(r));
-        return r;
+        goto out;
     }
 
     for (i = 0; i < msgs->len; i++) {
         r = nl_send_auto(priv->sk_genl_sync, msgs->pdata[i]);
         if (r < 0) {
             _LOGW("wireguard: set-device, send netlink message #%u failed: %s", i, nm_strerror(r));
-            return r;
+            goto out;
         }
 
         do {
@@ -3381,15 +3957,40 @@ link_wireguard_change(NMPlatform                               *platform,
         } while (r == -EAGAIN);
         if (r < 0) {
             _LOGW("wireguard: set-device, message #%u was rejected: %s", i, nm_strerror(r));
-            return r;
+            goto out;
         }
 
         _LOGT("wireguard: set-device, message #%u sent and confirmed", i);
     }
 
-    _wireguard_refresh_link(platform, wireguard_family_id, ifindex);
+    if (lnk_cached
+        && !NM_FLAGS_ANY(change_flags,
+                         NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_PRIVATE_KEY
+                             | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT
+                             | NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK)) {
+        nm_auto_nmpobj NMPObject *lnk_new = NULL;
+
+        /* Only peers changed. Instead of dumping all peers again, update the cache
+         * with what we sent, and read it back later. When the private key changed, we
+         * would have to calculate the public key. Just refresh in that case. */
+        lnk_new =
+            _wireguard_lnk_patch(lnk_cached, peers, peer_flags, s_cached_idx, s_peers_len);
+        _wireguard_cache_update_lnk(platform, plink, lnk_new);
+        _wireguard_refresh_schedule(platform, ifindex);
+    } else
+        _wireguard_refresh_link(platform, wireguard_family_id, ifindex);
 
-    return 0;
+    r = 0;
+
+out:
+    if (r < 0 && lnk_cached) {
+        /* Some of the messages might have been applied. The cache is
+         * still used for the next sync, so re-read it. */
+        _wireguard_refresh_schedule(platform, ifindex);
+    }
+    if (s_peers)
+        nm_explicit_bzero(s_peers, sizeof(NMPWireGuardPeer) * s_peers_len);
+    return r;
 }
 
 /*****************************************************************************/
@@ -3997,7 +4598,10 @@ ip_route_is_tracked(guint8 proto, guint8 type)
 
 /* Copied and heavily modified from libnl3's rtnl_route_parse() and parse_multipath(). */
 static NMPObject *
-_new_from_nl_route(const struct nlmsghdr *nlh, gboolean id_only, ParseNlmsgIter *parse_nlmsg_iter)
+_new_from_nl_route(NMPlatform            *platform,
+                   const struct nlmsghdr *nlh,
+                   gboolean               id_only,
+                   ParseNlmsgIter        *parse_nlmsg_iter)
 {
     static const struct nla_policy policy[] = {
         [RTA_TABLE]     = {.type = NLA_U32},
@@ -4013,6 +4617,7 @@ _new_from_nl_route(const struct nlmsghdr *nlh, gboolean id_only, ParseNlmsgIter
     guint                     multihop_idx;
     const struct rtmsg       *rtm;
     struct nlattr            *tb[G_N_ELEMENTS(policy)];
+    guint32                   table;
     int                       addr_family;
     gboolean                  IS_IPv4;
     nm_auto_nmpobj NMPObject *obj = NULL;
@@ -4077,6 +4682,18 @@ _new_from_nl_route(const struct nlmsghdr *nlh, gboolean id_only, ParseNlmsgIter
     if (nlmsg_parse_arr(nlh, sizeof(struct rtmsg), tb, policy) < 0)
         return NULL;
 
+    /* Routes of tables that are excluded by configuration are not tracked either.
+     * Unlike with rtm_protocol, this also applies to NLM_F_REPLACE messages, as
+     * a route can only replace another route of the same table.
+     *
+     * On the parse worker thread, @platform is %NULL and the worker passes the
+     * tracked tables from when the message was received. */
+    table = tb[RTA_TABLE] ? nla_get_u32(tb[RTA_TABLE]) : (guint32) rtm->rtm_table;
+    if (platform ? !nm_platform_route_table_is_tracked(platform, table)
+                 : !nm_platform_route_table_filter_has(parse_nlmsg_iter->route_table_filter,
+                                                       table))
+        return NULL;
+
     /*****************************************************************/
 
     addr_len = nm_utils_addr_family_to_size(addr_family);
@@ -4297,8 +4914,7 @@ rta_multipath_done:
     obj = nmp_object_new(IS_IPv4 ? NMP_OBJECT_TYPE_IP4_ROUTE : NMP_OBJECT_TYPE_IP6_ROUTE, NULL);
 
     obj->ip_route.type_coerced  = nm_platform_route_type_coerce(rtm->rtm_type);
-    obj->ip_route.table_coerced = nm_platform_route_table_coerce(
-        tb[RTA_TABLE] ? nla_get_u32(tb[RTA_TABLE]) : (guint32) rtm->rtm_table);
+    obj->ip_route.table_coerced = nm_platform_route_table_coerce(table);
 
     obj->ip_route.ifindex = nh.ifindex;
 
@@ -4773,11 +5389,75 @@ _new_from_nl_qdisc(NMPlatform *platform, const struct nlmsghdr *nlh, gboolean id
     return g_steal_pointer(&obj);
 }
 
+/* Parses the first action of a "matchall" tfilter, the way _nl_msg_new_tfilter()
+ * encodes it. Other actions are ignored. */
+static void
+_nl_parse_tfilter_action(NMPlatformAction *action, struct nlattr *act_tab)
+{
+    static const struct nla_policy prio_policy[] = {
+        [1] = {.type = NLA_NESTED},
+    };
+    static const struct nla_policy act_policy[] = {
+        [TCA_ACT_KIND]    = {.type = NLA_STRING},
+        [TCA_ACT_OPTIONS] = {.type = NLA_NESTED},
+    };
+    struct nlattr *prio_tb[G_N_ELEMENTS(prio_policy)];
+    struct nlattr *act_tb[G_N_ELEMENTS(act_policy)];
+    const char    *kind;
+
+    if (nla_parse_nested_arr(prio_tb, act_tab, prio_policy) < 0 || !prio_tb[1])
+        return;
+    if (nla_parse_nested_arr(act_tb, prio_tb[1], act_policy) < 0 || !act_tb[TCA_ACT_KIND])
+        return;
+
+    kind = nla_get_string(act_tb[TCA_ACT_KIND]);
+
+    if (nm_streq(kind, NM_PLATFORM_ACTION_KIND_SIMPLE)) {
+        static const struct nla_policy def_policy[] = {
+            [TCA_DEF_DATA] = {.type = NLA_STRING},
+        };
+        struct nlattr *def_tb[G_N_ELEMENTS(def_policy)];
+
+        action->kind = NM_PLATFORM_ACTION_KIND_SIMPLE;
+        if (act_tb[TCA_ACT_OPTIONS]
+            && nla_parse_nested_arr(def_tb, act_tb[TCA_ACT_OPTIONS], def_policy) >= 0
+            && def_tb[TCA_DEF_DATA]) {
+            nla_strlcpy(action->simple.sdata,
+                        def_tb[TCA_DEF_DATA],
+                        sizeof(action->simple.sdata));
+        }
+    } else if (nm_streq(kind, NM_PLATFORM_ACTION_KIND_MIRRED)) {
+        static const struct nla_policy mirred_policy[] = {
+            [TCA_MIRRED_PARMS] = {.minlen = sizeof(struct tc_mirred)},
+        };
+        struct nlattr   *mirred_tb[G_N_ELEMENTS(mirred_policy)];
+        struct tc_mirred sel;
+
+        action->kind = NM_PLATFORM_ACTION_KIND_MIRRED;
+        if (act_tb[TCA_ACT_OPTIONS]
+            && nla_parse_nested_arr(mirred_tb, act_tb[TCA_ACT_OPTIONS], mirred_policy) >= 0
+            && mirred_tb[TCA_MIRRED_PARMS]) {
+            nla_memcpy_checked_size(&sel, mirred_tb[TCA_MIRRED_PARMS], sizeof(sel));
+            action->mirred.ifindex = sel.ifindex;
+            action->mirred.egress =
+                NM_IN_SET(sel.eaction, TCA_EGRESS_REDIR, TCA_EGRESS_MIRROR);
+            action->mirred.ingress =
+                NM_IN_SET(sel.eaction, TCA_INGRESS_REDIR, TCA_INGRESS_MIRROR);
+            action->mirred.redirect =
+                NM_IN_SET(sel.eaction, TCA_EGRESS_REDIR, TCA_INGRESS_REDIR);
+            action->mirred.mirror =
+                NM_IN_SET(sel.eaction, TCA_EGRESS_MIRROR, TCA_INGRESS_MIRROR);
+        }
+    } else
+        action->kind = g_intern_string(kind);
+}
+
 static NMPObject *
 _new_from_nl_tfilter(NMPlatform *platform, const struct nlmsghdr *nlh, gboolean id_only)
 {
     static const struct nla_policy policy[] = {
-        [TCA_KIND] = {.type = NLA_STRING},
+        [TCA_KIND]    = {.type = NLA_STRING},
+        [TCA_OPTIONS] = {.type = NLA_NESTED},
     };
     struct nlattr      *tb[G_N_ELEMENTS(policy)];
     NMPObject          *obj = NULL;
@@ -4803,6 +5483,17 @@ _new_from_nl_tfilter(NMPlatform *platform, const struct nlmsghdr *nlh, gboolean
     obj->tfilter.parent      = tcm->tcm_parent;
     obj->tfilter.info        = tcm->tcm_info;
 
+    if (tb[TCA_OPTIONS] && nm_streq(obj->tfilter.kind, "matchall")) {
+        static const struct nla_policy matchall_policy[] = {
+            [TCA_MATCHALL_ACT] = {.type = NLA_NESTED},
+        };
+        struct nlattr *matchall_tb[G_N_ELEMENTS(matchall_policy)];
+
+        if (nla_parse_nested_arr(matchall_tb, tb[TCA_OPTIONS], matchall_policy) >= 0
+            && matchall_tb[TCA_MATCHALL_ACT])
+            _nl_parse_tfilter_action(&obj->tfilter.action, matchall_tb[TCA_MATCHALL_ACT]);
+    }
+
     return obj;
 }
 
@@ -4844,7 +5535,7 @@ nmp_object_new_from_nl(NMPlatform               *platform,
     case RTM_NEWROUTE:
     case RTM_DELROUTE:
     case RTM_GETROUTE:
-        return _new_from_nl_route(msghdr, id_only, parse_nlmsg_iter);
+        return _new_from_nl_route(platform, msghdr, id_only, parse_nlmsg_iter);
     case RTM_NEWRULE:
     case RTM_DELRULE:
     case RTM_GETRULE:
@@ -6117,10 +6808,30 @@ nla_put_failure:
     g_return_val_if_reached(NULL);
 }
 
-/*****************************************************************************/
+static struct nl_msg *
+_nl_msg_new_tc_delete(uint16_t nlmsg_type, int ifindex, guint32 parent)
+{
+    nm_auto_nlmsg struct nl_msg *msg = NULL;
+    const struct tcmsg           tcm = {
+                  .tcm_ifindex = ifindex,
+                  .tcm_parent  = parent,
+    };
 
-#define ASSERT_SYSCTL_ARGS(pathid, dirfd, path)                                                   \
-    G_STMT_START                                                                                  \
+    msg = nlmsg_alloc_new(0, nlmsg_type, NMP_NLM_FLAG_F_ECHO);
+
+    if (nlmsg_append_struct(msg, &tcm) < 0)
+        goto nla_put_failure;
+
+    return g_steal_pointer(&msg);
+
+nla_put_failure:
+    g_return_val_if_reached(NULL);
+}
+
+/*****************************************************************************/
+
+#define ASSERT_SYSCTL_ARGS(pathid, dirfd, path)                                                   \
+    G_STMT_START                                                                                  \
     {                                                                                             \
         const char *const _pathid = (pathid);                                                     \
         const int         _dirfd  = (dirfd);                                                      \
@@ -6326,24 +7037,118 @@ sysctl_set_internal(NMPlatform *platform,
 
 /*****************************************************************************/
 
+static void
+_sysctl_written_clear(NMLinuxPlatformPrivate *priv)
+{
+    nm_clear_g_source_inst(&priv->sysctl_writes.clear_source);
+    if (priv->sysctl_writes.written)
+        g_hash_table_remove_all(priv->sysctl_writes.written);
+}
+
+static gboolean
+_sysctl_written_clear_cb(gpointer user_data)
+{
+    _sysctl_written_clear(NM_LINUX_PLATFORM_GET_PRIVATE(user_data));
+    return G_SOURCE_CONTINUE;
+}
+
+/* Whether writing @path lets the kernel change other sysctl values too. For
+ * example, net.ipv4.ip_forward and net.ipv6.conf.all.forwarding set the
+ * forwarding of all interfaces. */
+static gboolean
+_sysctl_path_propagates(const char *path)
+{
+    const char *s;
+
+    if (nm_streq(path, "/proc/sys/net/ipv4/ip_forward"))
+        return TRUE;
+
+    /* "/proc/sys/net/$PROTO/conf/{all,default}/$KEY" */
+    s = NM_STR_HAS_PREFIX(path, "/proc/sys/net/") ? &path[NM_STRLEN("/proc/sys/net/")] : NULL;
+    if (!s || !(s = strchr(s, '/')))
+        return FALSE;
+    s++;
+    if (!NM_STR_HAS_PREFIX(s, "conf/"))
+        return FALSE;
+    s += NM_STRLEN("conf/");
+    return NM_STR_HAS_PREFIX(s, "all/") || NM_STR_HAS_PREFIX(s, "default/");
+}
+
+static void
+_sysctl_written_forget(NMLinuxPlatformPrivate *priv, const char *path)
+{
+    if (!priv->sysctl_writes.written)
+        return;
+
+    /* The kernel might have changed other values too, that we remember to
+     * have written. */
+    if (_sysctl_path_propagates(path))
+        g_hash_table_remove_all(priv->sysctl_writes.written);
+    else
+        g_hash_table_remove(priv->sysctl_writes.written, path);
+}
+
 static gboolean
 sysctl_set(NMPlatform *platform, const char *pathid, int dirfd, const char *path, const char *value)
 {
+    NMLinuxPlatformPrivate     *priv  = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
     nm_auto_pop_netns NMPNetns *netns = NULL;
+    gboolean                    cacheable;
+    int                         errsv;
 
     g_return_val_if_fail(path, FALSE);
     g_return_val_if_fail(value, FALSE);
 
     ASSERT_SYSCTL_ARGS(pathid, dirfd, path);
 
+    /* Only remember plain sysctl settings. Writing to sysfs attributes may have
+     * side effects, so writing the same value again may be intended. */
+    cacheable = dirfd < 0 && NM_STR_HAS_PREFIX(path, "/proc/sys/");
+
+    if (cacheable && priv->sysctl_writes.written
+        && nm_streq0(g_hash_table_lookup(priv->sysctl_writes.written, path), value)) {
+        priv->sysctl_writes.stats.write_hits++;
+        _LOGT("sysctl: skip setting '%s' to '%s' (already set)", path, value);
+        return TRUE;
+    }
+
     if (dirfd < 0 && !nm_platform_netns_push(platform, &netns)) {
         errno = ENETDOWN;
         return FALSE;
     }
 
-    return sysctl_set_internal(platform, pathid, dirfd, path, value);
+    priv->sysctl_writes.stats.writes++;
+
+    if (!sysctl_set_internal(platform, pathid, dirfd, path, value)) {
+        errsv = errno;
+        if (cacheable)
+            _sysctl_written_forget(priv, path);
+        errno = errsv;
+        return FALSE;
+    }
+
+    if (cacheable) {
+        _sysctl_written_forget(priv, path);
+        if (!priv->sysctl_writes.written) {
+            priv->sysctl_writes.written =
+                g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, g_free);
+        }
+        g_hash_table_insert(priv->sysctl_writes.written, g_strdup(path), g_strdup(value));
+        if (!priv->sysctl_writes.clear_source) {
+            /* Use a high priority, so that the values are forgotten at the
+             * next main loop iteration, before other events get dispatched. */
+            priv->sysctl_writes.clear_source = nm_g_source_attach(
+                nm_g_idle_source_new(G_PRIORITY_HIGH, _sysctl_written_clear_cb, platform, NULL),
+                NULL);
+        }
+    }
+
+    return TRUE;
 }
 
+/* The number of threads that execute sysctl_set_async() requests. */
+#define SYSCTL_ASYNC_MAX_THREADS 4
+
 typedef struct {
     NMPlatform             *platform;
     char                   *pathid;
@@ -6353,8 +7158,31 @@ typedef struct {
     GCancellable           *cancellable;
     NMPlatformAsyncCallback callback;
     gpointer                callback_data;
+
+    /* The earlier requests for the same file, that were superseded by this
+     * one. They complete with the result of this one. */
+    GArray *superseded;
+
+    /* The values that were actually written, set by the worker thread. */
+    char **values_written;
 } SysctlAsyncInfo;
 
+typedef struct {
+    char                  **values;
+    GCancellable           *cancellable;
+    NMPlatformAsyncCallback callback;
+    gpointer                callback_data;
+} SysctlAsyncSuperseded;
+
+static void
+_sysctl_async_superseded_clear(gpointer data)
+{
+    SysctlAsyncSuperseded *superseded = data;
+
+    g_strfreev(superseded->values);
+    g_object_unref(superseded->cancellable);
+}
+
 static void
 sysctl_async_info_free(SysctlAsyncInfo *info)
 {
@@ -6365,6 +7193,7 @@ sysctl_async_info_free(SysctlAsyncInfo *info)
     g_free(info->path);
     g_strfreev(info->values);
     g_object_unref(info->cancellable);
+    nm_clear_pointer(&info->superseded, g_array_unref);
     g_slice_free(SysctlAsyncInfo, info);
 }
 
@@ -6376,6 +7205,7 @@ sysctl_async_cb(GObject *object, GAsyncResult *res, gpointer user_data)
     SysctlAsyncInfo      *info;
     gs_free_error GError *error      = NULL;
     gs_free char         *values_str = NULL;
+    guint                 i;
 
     info = g_task_get_task_data(task);
 
@@ -6383,11 +7213,26 @@ sysctl_async_cb(GObject *object, GAsyncResult *res, gpointer user_data)
         platform = info->platform;
         _LOGD("sysctl: successfully set-async '%s' to values '%s'",
               info->pathid ?: info->path,
-              (values_str = g_strjoinv(", ", info->values)));
+              (values_str = g_strjoinv(", ", info->values_written)));
+    }
+
+    for (i = 0; info->superseded && i < info->superseded->len; i++) {
+        const SysctlAsyncSuperseded *superseded =
+            &nm_g_array_index(info->superseded, SysctlAsyncSuperseded, i);
+        gs_free_error GError *cancelled_error = NULL;
+
+        if (!superseded->callback)
+            continue;
+        g_cancellable_set_error_if_cancelled(superseded->cancellable, &cancelled_error);
+        superseded->callback(cancelled_error ?: error, superseded->callback_data);
     }
 
-    if (info->callback)
-        info->callback(error, info->callback_data);
+    if (info->callback) {
+        gs_free_error GError *cancelled_error = NULL;
+
+        g_cancellable_set_error_if_cancelled(info->cancellable, &cancelled_error);
+        info->callback(cancelled_error ?: error, info->callback_data);
+    }
 }
 
 static void
@@ -6396,13 +7241,36 @@ sysctl_async_thread_fn(GTask        *task,
                        gpointer      task_data,
                        GCancellable *cancellable)
 {
-    nm_auto_pop_netns NMPNetns *netns = NULL;
-    SysctlAsyncInfo            *info  = task_data;
-    GError                     *error = NULL;
+    nm_auto_pop_netns NMPNetns *netns  = NULL;
+    SysctlAsyncInfo            *info   = task_data;
+    GError                     *error  = NULL;
+    char                      **values = info->values;
     char                      **value;
+    guint                       i;
+
+    /* The task itself has no cancellable. If the last request got cancelled,
+     * the newest superseded request that is still alive determines the value
+     * of the file instead. */
+    cancellable = info->cancellable;
+    if (g_cancellable_is_cancelled(cancellable) && info->superseded) {
+        for (i = info->superseded->len; i > 0; i--) {
+            const SysctlAsyncSuperseded *superseded =
+                &nm_g_array_index(info->superseded, SysctlAsyncSuperseded, i - 1);
+
+            if (!g_cancellable_is_cancelled(superseded->cancellable)) {
+                cancellable = superseded->cancellable;
+                values      = superseded->values;
+                break;
+            }
+        }
+    }
 
-    if (g_task_return_error_if_cancelled(task))
+    if (g_cancellable_set_error_if_cancelled(cancellable, &error)) {
+        g_task_return_error(task, error);
         return;
+    }
+
+    info->values_written = values;
 
     if (info->dirfd < 0 && !nm_platform_netns_push(info->platform, &netns)) {
         g_set_error_literal(&error,
@@ -6413,7 +7281,7 @@ sysctl_async_thread_fn(GTask        *task,
         return;
     }
 
-    for (value = info->values; *value; value++) {
+    for (value = values; *value; value++) {
         if (!sysctl_set_internal(info->platform, info->pathid, info->dirfd, info->path, *value)) {
             g_set_error(&error,
                         NM_UTILS_ERROR,
@@ -6425,12 +7293,59 @@ sysctl_async_thread_fn(GTask        *task,
             g_task_return_error(task, error);
             return;
         }
-        if (g_task_return_error_if_cancelled(task))
+        if (g_cancellable_set_error_if_cancelled(cancellable, &error)) {
+            g_task_return_error(task, error);
             return;
+        }
     }
     g_task_return_boolean(task, TRUE);
 }
 
+static void
+sysctl_async_pool_fn(gpointer data, gpointer user_data)
+{
+    gs_unref_object GTask *task = data;
+
+    sysctl_async_thread_fn(task,
+                           g_task_get_source_object(task),
+                           g_task_get_task_data(task),
+                           g_task_get_cancellable(task));
+}
+
+static gboolean
+_sysctl_async_flush_cb(gpointer user_data)
+{
+    NMPlatform             *platform = user_data;
+    NMLinuxPlatformPrivate *priv     = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    GHashTableIter          iter;
+    SysctlAsyncInfo        *info;
+
+    nm_clear_g_source_inst(&priv->sysctl_writes.flush_source);
+
+    if (!priv->sysctl_writes.pool) {
+        priv->sysctl_writes.pool =
+            g_thread_pool_new(sysctl_async_pool_fn, NULL, SYSCTL_ASYNC_MAX_THREADS, FALSE, NULL);
+    }
+
+    g_hash_table_iter_init(&iter, priv->sysctl_writes.pending);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &info)) {
+        GTask *task;
+
+        g_hash_table_iter_steal(&iter);
+
+        priv->sysctl_writes.stats.writes += NM_PTRARRAY_LEN(info->values);
+
+        /* The task has no cancellable, sysctl_async_thread_fn() checks the
+         * cancellables of the coalesced requests itself. */
+        task = g_task_new(platform, NULL, sysctl_async_cb, NULL);
+        g_task_set_task_data(task, info, (GDestroyNotify) sysctl_async_info_free);
+        g_task_set_return_on_cancel(task, FALSE);
+        g_thread_pool_push(priv->sysctl_writes.pool, task, NULL);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
 static void
 sysctl_set_async_return_idle(gpointer user_data, GCancellable *cancellable)
 {
@@ -6455,11 +7370,12 @@ sysctl_set_async(NMPlatform             *platform,
                  gpointer                data,
                  GCancellable           *cancellable)
 {
-    SysctlAsyncInfo *info;
-    GTask           *task;
-    int              dirfd_dup, errsv;
-    gpointer         packed;
-    GError          *error = NULL;
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    SysctlAsyncInfo        *info;
+    SysctlAsyncInfo        *info_old;
+    int                     dirfd_dup, errsv;
+    gpointer                packed;
+    GError                 *error = NULL;
 
     g_return_if_fail(platform);
     g_return_if_fail(path);
@@ -6497,11 +7413,46 @@ sysctl_set_async(NMPlatform             *platform,
     info->callback_data = data;
     info->cancellable   = g_object_ref(cancellable);
 
-    task = g_task_new(platform, cancellable, sysctl_async_cb, NULL);
-    g_task_set_task_data(task, info, (GDestroyNotify) sysctl_async_info_free);
-    g_task_set_return_on_cancel(task, FALSE);
-    g_task_run_in_thread(task, sysctl_async_thread_fn);
-    g_object_unref(task);
+    /* The file gets changed behind the back of sysctl_set(). */
+    _sysctl_written_forget(priv, path);
+
+    if (!priv->sysctl_writes.pending) {
+        priv->sysctl_writes.pending =
+            g_hash_table_new_full(nm_str_hash,
+                                  g_str_equal,
+                                  NULL,
+                                  (GDestroyNotify) sysctl_async_info_free);
+    }
+
+    /* Requests are collected during the main loop iteration and only the
+     * last request for a file gets executed, the values of the earlier ones
+     * would be overwritten anyway. The earlier ones complete together with
+     * the last one, with its result. If the last one gets cancelled, the
+     * newest earlier one that is not cancelled gets executed instead. */
+    info_old = g_hash_table_lookup(priv->sysctl_writes.pending, info->pathid ?: info->path);
+    if (info_old) {
+        priv->sysctl_writes.stats.async_coalesced++;
+        _LOGD("sysctl: set-async '%s' is superseded by a later request",
+              info_old->pathid ?: info_old->path);
+        info->superseded = g_steal_pointer(&info_old->superseded);
+        if (!info->superseded) {
+            info->superseded = g_array_new(FALSE, FALSE, sizeof(SysctlAsyncSuperseded));
+            g_array_set_clear_func(info->superseded, _sysctl_async_superseded_clear);
+        }
+        /* Keep the values too. If this request gets cancelled, the newest
+         * superseded request that is still alive gets written instead. */
+        g_array_append_val(info->superseded,
+                           ((SysctlAsyncSuperseded){
+                               .values        = g_steal_pointer(&info_old->values),
+                               .cancellable   = g_object_ref(info_old->cancellable),
+                               .callback      = info_old->callback,
+                               .callback_data = info_old->callback_data,
+                           }));
+    }
+    g_hash_table_replace(priv->sysctl_writes.pending, info->pathid ?: info->path, info);
+
+    if (!priv->sysctl_writes.flush_source)
+        priv->sysctl_writes.flush_source = nm_g_idle_add_source(_sysctl_async_flush_cb, platform);
 }
 
 static CList  sysctl_clear_cache_lst_head = C_LIST_INIT(sysctl_clear_cache_lst_head);
@@ -6689,6 +7640,10 @@ process_events(NMPlatform *platform)
                             DELAYED_ACTION_TYPE_READ_RTNL | DELAYED_ACTION_TYPE_READ_GENL,
                             NULL);
     delayed_action_handle_all(platform);
+
+    /* The caller expects the cache to be up to date when we return. */
+    if (_parse_worker_apply(platform, TRUE))
+        delayed_action_handle_all(platform);
 }
 
 /*****************************************************************************/
@@ -6830,6 +7785,59 @@ delayed_action_refresh_from_needle_object(const NMPObject *obj_needle)
         refresh_all_type_from_needle_object(obj_needle));
 }
 
+static RefreshAllType
+refresh_scope_get_refresh_all_type(const RefreshScope *scope)
+{
+    switch (scope->obj_type) {
+    case NMP_OBJECT_TYPE_IP4_ADDRESS:
+        return REFRESH_ALL_TYPE_RTNL_IP4_ADDRESSES;
+    case NMP_OBJECT_TYPE_IP6_ADDRESS:
+        return REFRESH_ALL_TYPE_RTNL_IP6_ADDRESSES;
+    case NMP_OBJECT_TYPE_IP4_ROUTE:
+        return REFRESH_ALL_TYPE_RTNL_IP4_ROUTES;
+    case NMP_OBJECT_TYPE_IP6_ROUTE:
+        return REFRESH_ALL_TYPE_RTNL_IP6_ROUTES;
+    default:
+        nm_assert_not_reached();
+        return 0;
+    }
+}
+
+static gboolean
+refresh_scope_equal(const RefreshScope *a, const RefreshScope *b)
+{
+    return a->obj_type == b->obj_type && a->ifindex == b->ifindex && a->table == b->table;
+}
+
+static const NMPLookup *
+refresh_scope_init_lookup(const RefreshScope *scope, NMPLookup *lookup)
+{
+    if (scope->ifindex > 0)
+        return nmp_lookup_init_object_by_ifindex(lookup, scope->obj_type, scope->ifindex);
+    return nmp_lookup_init_obj_type(lookup, scope->obj_type);
+}
+
+static gboolean
+refresh_scope_match(const RefreshScope *scope, const NMPObject *obj)
+{
+    const NMPlatformIPRoute *route;
+
+    nm_assert(NMP_OBJECT_GET_TYPE(obj) == scope->obj_type);
+
+    if (scope->ifindex > 0 && NMP_OBJECT_CAST_OBJ_WITH_IFINDEX(obj)->ifindex != scope->ifindex)
+        return FALSE;
+
+    if (!NM_IN_SET(scope->obj_type, NMP_OBJECT_TYPE_IP4_ROUTE, NMP_OBJECT_TYPE_IP6_ROUTE))
+        return TRUE;
+
+    route = NMP_OBJECT_CAST_IP_ROUTE(obj);
+    if (scope->table != RT_TABLE_UNSPEC
+        && nm_platform_route_table_uncoerce(route->table_coerced, TRUE) != scope->table)
+        return FALSE;
+
+    return TRUE;
+}
+
 static NM_UTILS_LOOKUP_STR_DEFINE(
     delayed_action_to_string,
     DelayedActionType,
@@ -6854,6 +7862,7 @@ static NM_UTILS_LOOKUP_STR_DEFINE(
     NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_REFRESH_ALL_GENL_FAMILIES,
                              "refresh-all-genl-families"),
     NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_REFRESH_LINK, "refresh-link"),
+    NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_REFRESH_SCOPED, "refresh-scoped"),
     NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_CONTROLLER_CONNECTED, "controller-connected"),
     NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_READ_RTNL, "read-rtnl"),
     NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_READ_GENL, "read-genl"),
@@ -6888,6 +7897,19 @@ delayed_action_to_string_full(DelayedActionType action_type,
     case DELAYED_ACTION_TYPE_REFRESH_LINK:
         nm_strbuf_append(&buf, &buf_size, " (ifindex %d)", GPOINTER_TO_INT(user_data));
         break;
+    case DELAYED_ACTION_TYPE_REFRESH_SCOPED:
+        if (user_data) {
+            const RefreshScope *scope = user_data;
+
+            nm_strbuf_append(&buf,
+                             &buf_size,
+                             " (%s, ifindex %d, table %u)",
+                             nmp_class_from_type(scope->obj_type)->obj_type_name,
+                             scope->ifindex,
+                             scope->table);
+        } else
+            nm_strbuf_append_str(&buf, &buf_size, " (any)");
+        break;
     case DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_RTNL:
     case DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_GENL:
         data = user_data;
@@ -6933,6 +7955,79 @@ delayed_action_to_string_full(DelayedActionType action_type,
 
 /*****************************************************************************/
 
+static NMPlatformNetlinkMsgKind
+_netlink_msg_kind_from_nlmsg_type(NMPNetlinkProtocol netlink_protocol, guint16 nlmsg_type)
+{
+    if (netlink_protocol == NMP_NETLINK_GENERIC)
+        return NM_PLATFORM_NETLINK_MSG_KIND_GENL;
+
+    switch (nlmsg_type) {
+    case RTM_NEWLINK:
+    case RTM_DELLINK:
+    case RTM_GETLINK:
+    case RTM_SETLINK:
+    case RTM_NEWSTATS:
+        return NM_PLATFORM_NETLINK_MSG_KIND_LINK;
+    case RTM_NEWADDR:
+    case RTM_DELADDR:
+        return NM_PLATFORM_NETLINK_MSG_KIND_ADDRESS;
+    case RTM_NEWROUTE:
+    case RTM_DELROUTE:
+        return NM_PLATFORM_NETLINK_MSG_KIND_ROUTE;
+    case RTM_NEWRULE:
+    case RTM_DELRULE:
+        return NM_PLATFORM_NETLINK_MSG_KIND_RULE;
+    case RTM_NEWQDISC:
+    case RTM_DELQDISC:
+        return NM_PLATFORM_NETLINK_MSG_KIND_QDISC;
+    case RTM_NEWTFILTER:
+    case RTM_DELTFILTER:
+        return NM_PLATFORM_NETLINK_MSG_KIND_TFILTER;
+    default:
+        return NM_PLATFORM_NETLINK_MSG_KIND_OTHER;
+    }
+}
+
+static NMPlatformNetlinkMsgKind
+_netlink_msg_kind_from_obj_type(NMPObjectType obj_type)
+{
+    switch (obj_type) {
+    case NMP_OBJECT_TYPE_LINK:
+        return NM_PLATFORM_NETLINK_MSG_KIND_LINK;
+    case NMP_OBJECT_TYPE_IP4_ADDRESS:
+    case NMP_OBJECT_TYPE_IP6_ADDRESS:
+        return NM_PLATFORM_NETLINK_MSG_KIND_ADDRESS;
+    case NMP_OBJECT_TYPE_IP4_ROUTE:
+    case NMP_OBJECT_TYPE_IP6_ROUTE:
+        return NM_PLATFORM_NETLINK_MSG_KIND_ROUTE;
+    case NMP_OBJECT_TYPE_ROUTING_RULE:
+        return NM_PLATFORM_NETLINK_MSG_KIND_RULE;
+    case NMP_OBJECT_TYPE_QDISC:
+        return NM_PLATFORM_NETLINK_MSG_KIND_QDISC;
+    case NMP_OBJECT_TYPE_TFILTER:
+        return NM_PLATFORM_NETLINK_MSG_KIND_TFILTER;
+    default:
+        return NM_PLATFORM_NETLINK_MSG_KIND_OTHER;
+    }
+}
+
+static void
+_hotpath_stats_dump_complete(NMLinuxPlatformPrivate                   *priv,
+                             const DelayedActionWaitForNlResponseData *data)
+{
+    guint64 duration_nsec;
+
+    nm_assert(data->response_type == DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS);
+
+    duration_nsec = NM_MAX(nm_utils_get_monotonic_timestamp_nsec() - data->start_nsec, 0);
+
+    priv->hotpath_stats.dumps_completed++;
+    priv->hotpath_stats.dumps_nsec += duration_nsec;
+    priv->hotpath_stats.dumps_max_nsec = NM_MAX(priv->hotpath_stats.dumps_max_nsec, duration_nsec);
+}
+
+/*****************************************************************************/
+
 static gboolean
 delayed_action_refresh_all_in_progress(NMPlatform *platform, DelayedActionType action_type)
 {
@@ -6981,6 +8076,8 @@ delayed_action_wait_for_response_complete(NMPlatform             *platform,
             nm_assert(*data->response.out_refresh_all_in_progress > 0);
             *data->response.out_refresh_all_in_progress -= 1;
             data->response.out_refresh_all_in_progress = NULL;
+            if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
+                _hotpath_stats_dump_complete(priv, data);
         }
         break;
     case DELAYED_ACTION_RESPONSE_TYPE_ROUTE_GET:
@@ -7086,6 +8183,12 @@ delayed_action_handle_REFRESH_LINK(NMPlatform *platform, int ifindex)
     do_request_link_no_delayed_actions(platform, ifindex, NULL);
 }
 
+static void
+delayed_action_handle_REFRESH_SCOPED(NMPlatform *platform, const RefreshScope *scope)
+{
+    do_request_scoped_no_delayed_actions(platform, scope);
+}
+
 static void
 delayed_action_handle_REFRESH_ALL(NMPlatform *platform, DelayedActionType flags)
 {
@@ -7200,6 +8303,23 @@ delayed_action_handle_one(NMPlatform *platform)
         return TRUE;
     }
 
+    if (NM_FLAGS_HAS(priv->delayed_action.flags, DELAYED_ACTION_TYPE_REFRESH_SCOPED)) {
+        RefreshScope scope;
+
+        nm_assert(priv->delayed_action.list_refresh_scoped->len > 0);
+
+        scope = nm_g_array_index(priv->delayed_action.list_refresh_scoped, RefreshScope, 0);
+        g_array_remove_index_fast(priv->delayed_action.list_refresh_scoped, 0);
+        if (priv->delayed_action.list_refresh_scoped->len == 0)
+            priv->delayed_action.flags &= ~DELAYED_ACTION_TYPE_REFRESH_SCOPED;
+
+        _LOGt_delayed_action(DELAYED_ACTION_TYPE_REFRESH_SCOPED, &scope, "handle");
+
+        delayed_action_handle_REFRESH_SCOPED(platform, &scope);
+
+        return TRUE;
+    }
+
     for (netlink_protocol = _NMP_NETLINK_FIRST; netlink_protocol < _NMP_NETLINK_NUM;
          netlink_protocol++) {
         const DelayedActionType ACTION_TYPE =
@@ -7251,6 +8371,21 @@ delayed_action_schedule(NMPlatform *platform, DelayedActionType action_type, gpo
             < 0)
             g_ptr_array_add(priv->delayed_action.list_refresh_link, user_data);
         break;
+    case DELAYED_ACTION_TYPE_REFRESH_SCOPED:
+    {
+        const RefreshScope *scope = user_data;
+        guint               i;
+
+        for (i = 0; i < priv->delayed_action.list_refresh_scoped->len; i++) {
+            if (refresh_scope_equal(
+                    scope,
+                    &nm_g_array_index(priv->delayed_action.list_refresh_scoped, RefreshScope, i)))
+                break;
+        }
+        if (i == priv->delayed_action.list_refresh_scoped->len)
+            g_array_append_vals(priv->delayed_action.list_refresh_scoped, scope, 1);
+        break;
+    }
     case DELAYED_ACTION_TYPE_CONTROLLER_CONNECTED:
         if (nm_utils_ptrarray_find_first(
                 (gconstpointer *) priv->delayed_action.list_controller_connected->pdata,
@@ -7271,6 +8406,7 @@ delayed_action_schedule(NMPlatform *platform, DelayedActionType action_type, gpo
         nm_assert(!user_data);
         nm_assert(!NM_FLAGS_ANY(action_type,
                                 DELAYED_ACTION_TYPE_REFRESH_LINK
+                                    | DELAYED_ACTION_TYPE_REFRESH_SCOPED
                                     | DELAYED_ACTION_TYPE_CONTROLLER_CONNECTED
                                     | DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_RTNL
                                     | DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_GENL));
@@ -7286,7 +8422,22 @@ delayed_action_schedule(NMPlatform *platform, DelayedActionType action_type, gpo
 }
 
 static void
-delayed_action_schedule_refresh_all(NMPlatform *platform, NMPNetlinkProtocol netlink_protocol)
+delayed_action_schedule_REFRESH_SCOPED(NMPlatform   *platform,
+                                       NMPObjectType obj_type,
+                                       int           ifindex,
+                                       guint32       table)
+{
+    const RefreshScope scope = {
+        .obj_type = obj_type,
+        .ifindex  = ifindex,
+        .table    = table,
+    };
+
+    delayed_action_schedule(platform, DELAYED_ACTION_TYPE_REFRESH_SCOPED, (gpointer) &scope);
+}
+
+static DelayedActionType
+delayed_action_refresh_all_flags(NMPlatform *platform, NMPNetlinkProtocol netlink_protocol)
 {
     DelayedActionType action_type;
 
@@ -7306,7 +8457,15 @@ delayed_action_schedule_refresh_all(NMPlatform *platform, NMPNetlinkProtocol net
         action_type = DELAYED_ACTION_TYPE_REFRESH_ALL_GENL_FAMILIES;
     }
 
-    delayed_action_schedule(platform, action_type, NULL);
+    return action_type;
+}
+
+static void
+delayed_action_schedule_refresh_all(NMPlatform *platform, NMPNetlinkProtocol netlink_protocol)
+{
+    delayed_action_schedule(platform,
+                            delayed_action_refresh_all_flags(platform, netlink_protocol),
+                            NULL);
 }
 
 static void
@@ -7319,15 +8478,16 @@ delayed_action_schedule_WAIT_FOR_RESPONSE(NMPlatform                        *pla
                                           gpointer                           response_out_data)
 {
     DelayedActionWaitForNlResponseData data = {
-        .seq_number = seq_number,
-        .timeout_abs_nsec =
-            nm_utils_get_monotonic_timestamp_nsec() + (200 * (NM_UTILS_NSEC_PER_SEC / 1000)),
+        .seq_number        = seq_number,
+        .start_nsec        = nm_utils_get_monotonic_timestamp_nsec(),
         .out_seq_result    = out_seq_result,
         .out_extack_msg    = out_extack_msg,
         .response_type     = response_type,
         .response.out_data = response_out_data,
     };
 
+    data.timeout_abs_nsec = data.start_nsec + (200 * (NM_UTILS_NSEC_PER_SEC / 1000));
+
     nm_assert(!out_seq_result || *out_seq_result == WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN);
 
     delayed_action_schedule(
@@ -7338,13 +8498,14 @@ delayed_action_schedule_WAIT_FOR_RESPONSE(NMPlatform                        *pla
 
 /*****************************************************************************/
 
-static void
-cache_prune_one_type(NMPlatform *platform, const NMPLookup *lookup)
+static guint
+cache_prune_one_type(NMPlatform *platform, const NMPLookup *lookup, const RefreshScope *scope)
 {
     NMDedupMultiIter iter;
     const NMPObject *obj;
     NMPCacheOpsType  cache_op;
-    NMPCache        *cache = nm_platform_get_cache(platform);
+    NMPCache        *cache    = nm_platform_get_cache(platform);
+    guint            n_pruned = 0;
 
     nm_dedup_multi_iter_init(&iter, nmp_cache_lookup(cache, lookup));
     while (nm_dedup_multi_iter_next(&iter)) {
@@ -7359,6 +8520,9 @@ cache_prune_one_type(NMPlatform *platform, const NMPLookup *lookup)
 
         obj = main_entry->obj;
 
+        if (scope && !refresh_scope_match(scope, obj))
+            continue;
+
         if (NMP_OBJECT_GET_TYPE(obj) == NMP_OBJECT_TYPE_IP6_ADDRESS) {
             const NMPlatformIP6Address *pladdr = NMP_OBJECT_CAST_IP6_ADDRESS(obj);
 
@@ -7378,14 +8542,19 @@ cache_prune_one_type(NMPlatform *platform, const NMPLookup *lookup)
             cache_on_change(platform, cache_op, obj_old, NULL);
             nm_platform_cache_update_emit_signal(platform, cache_op, obj_old, NULL);
         }
+        n_pruned++;
     }
+
+    return n_pruned;
 }
 
 static void
 cache_prune_all(NMPlatform *platform)
 {
-    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    NMLinuxPlatformPrivate *priv     = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    guint                   n_pruned = 0;
     RefreshAllType          refresh_all_type;
+    guint                   i;
 
     for (refresh_all_type = _REFRESH_ALL_TYPE_FIRST; refresh_all_type < _REFRESH_ALL_TYPE_NUM;
          refresh_all_type++) {
@@ -7400,7 +8569,28 @@ cache_prune_all(NMPlatform *platform)
         if (priv->pruning[refresh_all_type] > 0)
             continue;
         refresh_all_type_init_lookup(refresh_all_type, &lookup);
-        cache_prune_one_type(platform, &lookup);
+        n_pruned += cache_prune_one_type(platform, &lookup, NULL);
+    }
+
+    for (i = 0; i < priv->pruning_scoped->len;) {
+        RefreshScope scope = nm_g_array_index(priv->pruning_scoped, RefreshScope, i);
+        NMPLookup    lookup;
+
+        refresh_all_type = refresh_scope_get_refresh_all_type(&scope);
+        if (priv->delayed_action.refresh_all_in_progress[refresh_all_type] > 0) {
+            /* the filtered dump is not yet complete. */
+            i++;
+            continue;
+        }
+
+        g_array_remove_index_fast(priv->pruning_scoped, i);
+        refresh_scope_init_lookup(&scope, &lookup);
+        n_pruned += cache_prune_one_type(platform, &lookup, &scope);
+    }
+
+    if (n_pruned >= CACHE_PRUNE_SLAB_TRIM_THRESHOLD) {
+        /* After a mass prune, return the memory of the empty slabs. */
+        nmp_object_slab_trim();
     }
 }
 
@@ -7410,10 +8600,12 @@ cache_on_change(NMPlatform      *platform,
                 const NMPObject *obj_old,
                 const NMPObject *obj_new)
 {
-    const NMPClass *klass;
-    char            str_buf[NM_UTILS_TO_STRING_BUFFER_SIZE];
-    char            str_buf2[NM_UTILS_TO_STRING_BUFFER_SIZE];
-    NMPCache       *cache = nm_platform_get_cache(platform);
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    const NMPClass         *klass;
+    char                    str_buf[NM_UTILS_TO_STRING_BUFFER_SIZE];
+    char                    str_buf2[NM_UTILS_TO_STRING_BUFFER_SIZE];
+    NMPCache               *cache      = nm_platform_get_cache(platform);
+    const gint64            start_nsec = nm_utils_get_monotonic_timestamp_nsec();
 
     ASSERT_nmp_cache_ops(cache, cache_op, obj_old, obj_new);
     nm_assert(cache_op != NMP_CACHE_OPS_UNCHANGED);
@@ -7438,6 +8630,12 @@ cache_on_change(NMPlatform      *platform,
     switch (klass->obj_type) {
     case NMP_OBJECT_TYPE_LINK:
     {
+        /* Kernel resets sysctl values of a link, for example when it gets re-created,
+         * or the IPv6 MTU when the MTU of the link changes. Forget what we wrote. */
+        if (cache_op != NMP_CACHE_OPS_UPDATED || obj_old->link.mtu != obj_new->link.mtu
+            || !nm_streq(obj_old->link.name, obj_new->link.name))
+            _sysctl_written_clear(priv);
+
         /* check whether changing a port link can cause a controller link (bridge or bond) to go up/down */
         if (obj_old
             && nmp_cache_link_connected_needs_toggle_by_ifindex(cache,
@@ -7536,11 +8734,18 @@ cache_on_change(NMPlatform      *platform,
                         && !NM_FLAGS_HAS(obj_new->link.n_ifi_flags, IFF_LOWER_UP)))) {
                 /* FIXME: I suspect that IFF_LOWER_UP must not be considered, and I
                  * think kernel does send RTM_DELROUTE events for IPv6 routes, so
-                 * we might not need to refresh IPv6 routes. */
-                delayed_action_schedule(platform,
-                                        DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_IP4_ROUTES
-                                            | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_IP6_ROUTES,
-                                        NULL);
+                 * we might not need to refresh IPv6 routes.
+                 *
+                 * Kernel silently removes the routes of the interface. Only
+                 * dump the routes of this interface, not all routes. */
+                delayed_action_schedule_REFRESH_SCOPED(platform,
+                                                       NMP_OBJECT_TYPE_IP4_ROUTE,
+                                                       obj_new->link.ifindex,
+                                                       RT_TABLE_UNSPEC);
+                delayed_action_schedule_REFRESH_SCOPED(platform,
+                                                       NMP_OBJECT_TYPE_IP6_ROUTE,
+                                                       obj_new->link.ifindex,
+                                                       RT_TABLE_UNSPEC);
             }
         }
         if (NM_IN_SET(cache_op, NMP_CACHE_OPS_ADDED, NMP_CACHE_OPS_UPDATED)
@@ -7655,6 +8860,9 @@ cache_on_change(NMPlatform      *platform,
     default:
         break;
     }
+
+    priv->hotpath_stats.msg_kinds[_netlink_msg_kind_from_obj_type(klass->obj_type)].cache_nsec +=
+        nm_utils_get_monotonic_timestamp_nsec() - start_nsec;
 }
 
 /*****************************************************************************/
@@ -7670,11 +8878,68 @@ _nlh_seq_next_get(NMLinuxPlatformPrivate *priv, NMPNetlinkProtocol netlink_proto
     return (++(*p)) ?: (++(*p));
 }
 
-/**
- * _nl_send_nlmsghdr:
- * @platform:
- * @nlhdr:
- * @out_seq_result:
+/* The size of the buffer into which ip_route_batch() and link_set_sriov_vfs()
+ * pack the netlink requests for one sendmsg() call. */
+#define RTNL_BATCH_SEND_BUF_SIZE (32u * 1024u)
+
+static gboolean
+_rtnl_batch_send(NMPlatform *platform, const guint8 *buf, gsize len)
+{
+    NMLinuxPlatformPrivate *priv      = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    struct sockaddr_nl      nladdr    = {.nl_family = AF_NETLINK};
+    struct iovec            iov       = {.iov_base = (gpointer) buf, .iov_len = len};
+    int                     try_count = 0;
+    struct msghdr           msg;
+    int                     errsv;
+
+    msg = (struct msghdr){
+        .msg_name    = &nladdr,
+        .msg_namelen = sizeof(nladdr),
+        .msg_iov     = &iov,
+        .msg_iovlen  = 1,
+    };
+
+again:
+    if (sendmsg(nl_socket_get_fd(priv->sk_rtnl), &msg, 0) < 0) {
+        errsv = errno;
+        if (errsv == EINTR && try_count++ < 100)
+            goto again;
+        _LOGI("netlink: batch: failed sending %zu bytes: %s (%d)",
+              len,
+              nm_strerror_native(errsv),
+              errsv);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static guint32
+_rtnl_batch_append(NMLinuxPlatformPrivate *priv,
+                   guint8                 *buf,
+                   gsize                  *buf_len,
+                   struct nlmsghdr        *nlhdr)
+{
+    guint32 seq;
+
+    nm_assert(*buf_len + NLMSG_ALIGN(nlhdr->nlmsg_len) <= RTNL_BATCH_SEND_BUF_SIZE);
+
+    seq                = _nlh_seq_next_get(priv, NMP_NETLINK_ROUTE);
+    nlhdr->nlmsg_seq   = seq;
+    nlhdr->nlmsg_pid   = nl_socket_get_local_port(priv->sk_rtnl);
+    nlhdr->nlmsg_flags |= (NLM_F_REQUEST | NLM_F_ACK);
+    memcpy(&buf[*buf_len], nlhdr, nlhdr->nlmsg_len);
+    memset(&buf[*buf_len + nlhdr->nlmsg_len],
+           0,
+           NLMSG_ALIGN(nlhdr->nlmsg_len) - nlhdr->nlmsg_len);
+    *buf_len += NLMSG_ALIGN(nlhdr->nlmsg_len);
+    return seq;
+}
+
+/**
+ * _nl_send_nlmsghdr:
+ * @platform:
+ * @nlhdr:
+ * @out_seq_result:
  * @response_type:
  * @response_out_data:
  *
@@ -7839,7 +9104,7 @@ do_request_link(NMPlatform *platform, int ifindex, const char *name)
 }
 
 static struct nl_msg *
-_nl_msg_new_dump_rtnl(NMPObjectType obj_type, int preferred_addr_family)
+_nl_msg_new_dump_rtnl(NMPObjectType obj_type, int preferred_addr_family, int ifindex)
 {
     nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
     const NMPClass              *klass;
@@ -7849,6 +9114,10 @@ _nl_msg_new_dump_rtnl(NMPObjectType obj_type, int preferred_addr_family)
     nm_assert(klass);
     nm_assert(klass->rtm_gettype > 0);
 
+    /* filtering by ifindex is only implemented for addresses. */
+    nm_assert(ifindex <= 0
+              || NM_IN_SET(obj_type, NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS));
+
     nlmsg = nlmsg_alloc_new(0, klass->rtm_gettype, NLM_F_DUMP);
 
     if (klass->addr_family != AF_UNSPEC) {
@@ -7881,6 +9150,7 @@ _nl_msg_new_dump_rtnl(NMPObjectType obj_type, int preferred_addr_family)
     {
         struct ifaddrmsg ifm = {
             .ifa_family = preferred_addr_family,
+            .ifa_index  = NM_MAX(ifindex, 0),
         };
 
         if (nlmsg_append_struct(nlmsg, &ifm) < 0)
@@ -7934,6 +9204,101 @@ _nl_msg_new_dump_genl_families(void)
     return g_steal_pointer(&nlmsg);
 }
 
+/**
+ * _do_request_dump_routes:
+ * @platform: the platform instance
+ * @addr_family: the address family of the routes to dump.
+ * @scope: (nullable): if given, only request the routes of this scope.
+ * @out_refresh_all_in_progress: the in-progress counter for the dump.
+ *
+ * Routes are handled specially because we want to request only routes
+ * for protocols we track. The reason is that there might be millions of
+ * BGP routes we don't track and it would be very inefficient to dump them
+ * all. Therefore, perform separate dumps, each for a specific protocol we
+ * track.
+ *
+ * With @scope, the request also asks kernel to filter by outgoing interface
+ * and table (this requires NETLINK_GET_STRICT_CHK, which we enable on the socket).
+ * Kernels that don't support filtering return more routes than requested,
+ * which is not a problem.
+ *
+ * Returns: %TRUE, if all requests were sent successfully.
+ */
+static gboolean
+_do_request_dump_routes(NMPlatform         *platform,
+                        int                 addr_family,
+                        const RefreshScope *scope,
+                        int                *out_refresh_all_in_progress)
+{
+    gboolean success     = TRUE;
+    guint    retry_count = 0;
+    guint    i;
+
+    for (i = 0; i < G_N_ELEMENTS(ip_route_tracked_protocols); i++) {
+        nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+        struct rtmsg                 rtm   = {
+                              .rtm_family = addr_family,
+        };
+
+        if (retry_count > 0) {
+            /* Try again previous protocol */
+            i--;
+        }
+
+        rtm.rtm_protocol = ip_route_tracked_protocols[i];
+
+        if (scope && scope->table != RT_TABLE_UNSPEC)
+            rtm.rtm_table = scope->table < 256u ? scope->table : RT_TABLE_COMPAT;
+
+        /* If we try to request a new dump while the previous is still
+         * in progress, kernel returns -EBUSY. Complete the previous
+         * dump by reading from the socket. */
+        event_handler_read_netlink(platform, NMP_NETLINK_ROUTE, FALSE);
+
+        nlmsg = nlmsg_alloc_new(0, RTM_GETROUTE, NLM_F_DUMP);
+
+        if (nlmsg_append_struct(nlmsg, &rtm) < 0)
+            goto nla_put_failure;
+
+        if (scope) {
+            if (scope->table != RT_TABLE_UNSPEC)
+                NLA_PUT_U32(nlmsg, RTA_TABLE, scope->table);
+            if (scope->ifindex > 0)
+                NLA_PUT_U32(nlmsg, RTA_OIF, scope->ifindex);
+        }
+
+        *out_refresh_all_in_progress += 1;
+
+        if (_netlink_send_nlmsg(platform,
+                                NMP_NETLINK_ROUTE,
+                                nlmsg,
+                                NULL,
+                                NULL,
+                                DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS,
+                                out_refresh_all_in_progress)
+            < 0) {
+            *out_refresh_all_in_progress -= 1;
+            retry_count++;
+            if (retry_count > 4) {
+                _LOGE("failed dumping IPv%c routes with protocol %u, cache might be "
+                      "inconsistent",
+                      nm_utils_addr_family_to_char(rtm.rtm_family),
+                      rtm.rtm_protocol);
+                retry_count = 0;
+                success     = FALSE;
+                /* Give up and try the next protocol */
+            }
+        } else {
+            retry_count = 0;
+        }
+    }
+
+    return success;
+
+nla_put_failure:
+    g_return_val_if_reached(FALSE);
+}
+
 static void
 do_request_all_no_delayed_actions(NMPlatform *platform, DelayedActionType action_type)
 {
@@ -7989,6 +9354,8 @@ do_request_all_no_delayed_actions(NMPlatform *platform, DelayedActionType action
         priv->delayed_action.flags &= ~iflags;
         _LOGt_delayed_action(iflags, NULL, "handle (do-request-all)");
 
+        priv->hotpath_stats.refresh_all++;
+
         if (refresh_all_type == REFRESH_ALL_TYPE_RTNL_LINKS) {
             nm_assert(
                 (priv->delayed_action.list_refresh_link->len > 0)
@@ -8002,66 +9369,13 @@ do_request_all_no_delayed_actions(NMPlatform *platform, DelayedActionType action
             }
         }
 
-        /* Routes are handled specially because we want to request only routes
-         * for protocols we track. The reason is that there might be millions of
-         * BGP routes we don't track and it would be very inefficient to dump them
-         * all. Therefore, perform separate dumps, each for a specific protocol we
-         * track. */
         if (NM_IN_SET(refresh_all_type,
                       REFRESH_ALL_TYPE_RTNL_IP4_ROUTES,
                       REFRESH_ALL_TYPE_RTNL_IP6_ROUTES)) {
-            struct rtmsg rtm = {
-                .rtm_family = refresh_all_info->addr_family_for_dump,
-            };
-            guint retry_count = 0;
-            guint i;
-
-            for (i = 0; i < G_N_ELEMENTS(ip_route_tracked_protocols); i++) {
-                nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
-
-                if (retry_count > 0) {
-                    /* Try again previous protocol */
-                    i--;
-                }
-
-                /* If we try to request a new dump while the previous is still
-                 * in progress, kernel returns -EBUSY. Complete the previous
-                 * dump by reading from the socket. */
-                event_handler_read_netlink(platform, refresh_all_info->protocol, FALSE);
-
-                nlmsg = nlmsg_alloc_new(0, RTM_GETROUTE, NLM_F_DUMP);
-                if (!nlmsg)
-                    goto next_after_fail;
-
-                rtm.rtm_protocol = ip_route_tracked_protocols[i];
-
-                if (nlmsg_append_struct(nlmsg, &rtm) < 0)
-                    g_return_if_fail(FALSE);
-
-                *out_refresh_all_in_progress += 1;
-
-                if (_netlink_send_nlmsg(platform,
-                                        refresh_all_info->protocol,
-                                        nlmsg,
-                                        NULL,
-                                        NULL,
-                                        DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS,
-                                        out_refresh_all_in_progress)
-                    < 0) {
-                    *out_refresh_all_in_progress -= 1;
-                    retry_count++;
-                    if (retry_count > 4) {
-                        _LOGE("failed dumping IPv%c routes with protocol %u, cache might be "
-                              "inconsistent",
-                              nm_utils_addr_family_to_char(rtm.rtm_family),
-                              rtm.rtm_protocol);
-                        retry_count = 0;
-                        /* Give up and try the next protocol */
-                    }
-                } else {
-                    retry_count = 0;
-                }
-            }
+            _do_request_dump_routes(platform,
+                                    refresh_all_info->addr_family_for_dump,
+                                    NULL,
+                                    out_refresh_all_in_progress);
         } else {
             nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
 
@@ -8070,7 +9384,8 @@ do_request_all_no_delayed_actions(NMPlatform *platform, DelayedActionType action
 
             if (refresh_all_info->protocol == NMP_NETLINK_ROUTE) {
                 nlmsg = _nl_msg_new_dump_rtnl(refresh_all_info->obj_type,
-                                              refresh_all_info->addr_family_for_dump);
+                                              refresh_all_info->addr_family_for_dump,
+                                              0);
             } else {
                 nm_assert(refresh_all_type == REFRESH_ALL_TYPE_GENL_FAMILIES);
                 nlmsg = _nl_msg_new_dump_genl_families();
@@ -8097,11 +9412,128 @@ next_after_fail:
     }
 }
 
+/**
+ * do_request_scoped_no_delayed_actions:
+ * @platform: the platform instance
+ * @scope: the subset of objects to refresh.
+ *
+ * Like do_request_all_no_delayed_actions(), but only requests a filtered
+ * dump for the objects in @scope. The objects in the scope are marked as
+ * dirty, and the ones that are still dirty after the dump completed get
+ * pruned by cache_prune_all(). Objects outside the scope are not touched.
+ */
+static void
+do_request_scoped_no_delayed_actions(NMPlatform *platform, const RefreshScope *scope)
+{
+    NMLinuxPlatformPrivate *priv             = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    NMPCache               *cache            = nm_platform_get_cache(platform);
+    const RefreshAllType    refresh_all_type = refresh_scope_get_refresh_all_type(scope);
+    const DelayedActionType action_type =
+        delayed_action_type_from_refresh_all_type(refresh_all_type);
+    int *out_refresh_all_in_progress;
+    NMDedupMultiIter        iter;
+    NMPLookup               lookup;
+    gboolean                success;
+
+    if (NM_FLAGS_ANY(priv->delayed_action.flags, action_type)
+        || priv->pruning[refresh_all_type] > 0) {
+        /* A full refresh of this type is pending or in progress. It covers
+         * the scope too. */
+        _LOGt_delayed_action(DELAYED_ACTION_TYPE_REFRESH_SCOPED,
+                             (gpointer) scope,
+                             "skip (refresh-all pending)");
+        return;
+    }
+
+    refresh_scope_init_lookup(scope, &lookup);
+    nm_dedup_multi_iter_init(&iter, nmp_cache_lookup(cache, &lookup));
+    while (nm_dedup_multi_iter_next(&iter)) {
+        const NMDedupMultiEntry *main_entry;
+
+        main_entry = nmp_cache_reresolve_main_entry(cache, iter.current, &lookup);
+        if (refresh_scope_match(scope, main_entry->obj))
+            nm_dedup_multi_entry_set_dirty(main_entry, TRUE);
+    }
+
+    out_refresh_all_in_progress = &priv->delayed_action.refresh_all_in_progress[refresh_all_type];
+
+    if (NM_IN_SET(scope->obj_type, NMP_OBJECT_TYPE_IP4_ROUTE, NMP_OBJECT_TYPE_IP6_ROUTE)) {
+        const RefreshAllInfo *refresh_all_info = refresh_all_type_get_info(refresh_all_type);
+
+        success = _do_request_dump_routes(platform,
+                                          refresh_all_info->addr_family_for_dump,
+                                          scope,
+                                          out_refresh_all_in_progress);
+    } else {
+        nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+
+        nm_assert(scope->table == RT_TABLE_UNSPEC);
+
+        event_handler_read_netlink(platform, NMP_NETLINK_ROUTE, FALSE);
+
+        nlmsg = _nl_msg_new_dump_rtnl(scope->obj_type, AF_UNSPEC, scope->ifindex);
+
+        *out_refresh_all_in_progress += 1;
+        success = nlmsg
+                  && _netlink_send_nlmsg(platform,
+                                         NMP_NETLINK_ROUTE,
+                                         nlmsg,
+                                         NULL,
+                                         NULL,
+                                         DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS,
+                                         out_refresh_all_in_progress)
+                         >= 0;
+        if (!success)
+            *out_refresh_all_in_progress -= 1;
+    }
+
+    if (!success) {
+        /* We cannot prune the scope, because we don't know which objects
+         * still exist. Fallback to a full refresh, which also takes care
+         * of the dirty flags that we just set. */
+        delayed_action_schedule(platform, action_type, NULL);
+        return;
+    }
+
+    g_array_append_vals(priv->pruning_scoped, scope, 1);
+}
+
 static void
 do_request_one_type_by_needle_object(NMPlatform *platform, const NMPObject *obj_needle)
 {
-    do_request_all_no_delayed_actions(platform,
-                                      delayed_action_refresh_from_needle_object(obj_needle));
+    if (NM_IN_SET(NMP_OBJECT_GET_TYPE(obj_needle),
+                  NMP_OBJECT_TYPE_IP4_ADDRESS,
+                  NMP_OBJECT_TYPE_IP6_ADDRESS)
+        && NMP_OBJECT_CAST_OBJ_WITH_IFINDEX(obj_needle)->ifindex > 0) {
+        const RefreshScope scope = {
+            .obj_type = NMP_OBJECT_GET_TYPE(obj_needle),
+            .ifindex  = NMP_OBJECT_CAST_OBJ_WITH_IFINDEX(obj_needle)->ifindex,
+        };
+
+        do_request_scoped_no_delayed_actions(platform, &scope);
+    } else {
+        do_request_all_no_delayed_actions(platform,
+                                          delayed_action_refresh_from_needle_object(obj_needle));
+    }
+    delayed_action_handle_all(platform);
+}
+
+static void
+refresh_all(NMPlatform *platform, NMPObjectType obj_type)
+{
+    const RefreshScope scope = {
+        .obj_type = obj_type,
+    };
+
+    g_return_if_fail(NM_IN_SET(obj_type,
+                               NMP_OBJECT_TYPE_IP4_ADDRESS,
+                               NMP_OBJECT_TYPE_IP6_ADDRESS,
+                               NMP_OBJECT_TYPE_IP4_ROUTE,
+                               NMP_OBJECT_TYPE_IP6_ROUTE));
+
+    do_request_all_no_delayed_actions(
+        platform,
+        delayed_action_type_from_refresh_all_type(refresh_scope_get_refresh_all_type(&scope)));
     delayed_action_handle_all(platform);
 }
 
@@ -8132,6 +9564,7 @@ event_seq_check_refresh_all(NMPlatform        *platform,
             && data->seq_number == priv->proto_data_x[netlink_protocol].nlh_seq_last_seen) {
             *data->response.out_refresh_all_in_progress -= 1;
             data->response.out_refresh_all_in_progress = NULL;
+            _hotpath_stats_dump_complete(priv, data);
             break;
         }
     }
@@ -8183,8 +9616,121 @@ event_seq_check(NMPlatform             *platform,
     }
 }
 
+/* Whether the messages of this type are parsed by the parse worker thread. Links
+ * are not, because parsing them requires the cache. Qdiscs and tfilters are rare. */
+static gboolean
+_parse_worker_msg_type(guint16 nlmsg_type)
+{
+    return NM_IN_SET(nlmsg_type,
+                     RTM_NEWADDR,
+                     RTM_DELADDR,
+                     RTM_NEWROUTE,
+                     RTM_DELROUTE,
+                     RTM_NEWRULE,
+                     RTM_DELRULE);
+}
+
+static NMPObject *
+_parsed_objs_next(NMPlatform *platform, ParsedObjs *parsed, ParseNlmsgIter *parse_nlmsg_iter)
+{
+    NMPObject *obj;
+
+    if (parsed->idx >= parsed->len) {
+        parse_nlmsg_iter->iter_more = FALSE;
+        return NULL;
+    }
+
+    obj = parsed->objs[parsed->idx++];
+
+    if (NM_IN_SET(NMP_OBJECT_GET_TYPE(obj), NMP_OBJECT_TYPE_IP4_ROUTE, NMP_OBJECT_TYPE_IP6_ROUTE)
+        && !nm_platform_route_table_is_tracked(
+            platform,
+            nm_platform_route_table_uncoerce(obj->ip_route.table_coerced, FALSE))) {
+        /* The worker thread already dropped the routes of tables that were not
+         * tracked when the message was received. This only catches the rare
+         * case that the tracked tables changed since. All objects of one
+         * message belong to the same table, so skip them all. */
+        parsed->idx                 = parsed->len;
+        parse_nlmsg_iter->iter_more = FALSE;
+        return NULL;
+    }
+
+    parse_nlmsg_iter->iter_more = (parsed->idx < parsed->len);
+    return (NMPObject *) nmp_object_ref(obj);
+}
+
+static NMPObject *
+_rtnl_handle_msg_new_obj(NMPlatform               *platform,
+                         const NMPCache           *cache,
+                         const struct nl_msg_lite *msg,
+                         gboolean                  is_del,
+                         ParseNlmsgIter           *parse_nlmsg_iter,
+                         ParsedObjs               *parsed)
+{
+    NMLinuxPlatformPrivate *priv       = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    const gint64            start_nsec = nm_utils_get_monotonic_timestamp_nsec();
+    NMPObject              *obj;
+
+    /* With the parse worker, this only accounts for merging the parsed objects. */
+    if (parsed)
+        obj = _parsed_objs_next(platform, parsed, parse_nlmsg_iter);
+    else
+        obj = nmp_object_new_from_nl(platform, cache, msg, is_del, parse_nlmsg_iter);
+
+    priv->hotpath_stats
+        .msg_kinds[_netlink_msg_kind_from_nlmsg_type(NMP_NETLINK_ROUTE, msg->nm_nlh->nlmsg_type)]
+        .parse_nsec += nm_utils_get_monotonic_timestamp_nsec() - start_nsec;
+    return obj;
+}
+
+static void
+_rtnl_handle_msg_stats(NMPlatform *platform, const struct nl_msg_lite *msg)
+{
+    static const struct nla_policy policy[] = {
+        [IFLA_STATS_LINK_64] = {.minlen = nm_offsetofend(struct rtnl_link_stats64, tx_bytes)},
+    };
+    NMLinuxPlatformPrivate         *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    const struct nlmsghdr          *nlh  = msg->nm_nlh;
+    nm_auto_nmpobj const NMPObject *obj_old = NULL;
+    nm_auto_nmpobj const NMPObject *obj_new = NULL;
+    const struct if_stats_msg      *ifsm;
+    struct nlattr                  *tb[G_N_ELEMENTS(policy)];
+    const char                     *stats;
+    NMPCacheOpsType                 cache_op;
+
+    if (!nlmsg_valid_hdr(nlh, sizeof(*ifsm)))
+        return;
+    ifsm = nlmsg_data(nlh);
+
+    if (!priv->link_stats_ifindexes
+        || !g_hash_table_contains(priv->link_stats_ifindexes, GINT_TO_POINTER(ifsm->ifindex)))
+        return;
+
+    if (nlmsg_parse_arr(nlh, sizeof(*ifsm), tb, policy) < 0)
+        return;
+    if (!tb[IFLA_STATS_LINK_64])
+        return;
+
+    stats = nla_data(tb[IFLA_STATS_LINK_64]);
+
+    cache_op = nmp_cache_update_link_stats(
+        nm_platform_get_cache(platform),
+        ifsm->ifindex,
+        unaligned_read_ne64(&stats[G_STRUCT_OFFSET(struct rtnl_link_stats64, rx_packets)]),
+        unaligned_read_ne64(&stats[G_STRUCT_OFFSET(struct rtnl_link_stats64, rx_bytes)]),
+        unaligned_read_ne64(&stats[G_STRUCT_OFFSET(struct rtnl_link_stats64, tx_packets)]),
+        unaligned_read_ne64(&stats[G_STRUCT_OFFSET(struct rtnl_link_stats64, tx_bytes)]),
+        &obj_old,
+        &obj_new);
+    if (cache_op == NMP_CACHE_OPS_UNCHANGED)
+        return;
+
+    cache_on_change(platform, cache_op, obj_old, obj_new);
+    nm_platform_cache_update_emit_signal(platform, cache_op, obj_old, obj_new);
+}
+
 static void
-_rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg)
+_rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg, ParsedObjs *parsed)
 {
     char                      sbuf1[NM_UTILS_TO_STRING_BUFFER_SIZE];
     NMLinuxPlatformPrivate   *priv;
@@ -8199,6 +9745,12 @@ _rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg)
 
     msghdr = msg->nm_nlh;
 
+    if (msghdr->nlmsg_type == RTM_NEWSTATS) {
+        /* Statistics are no object of their own. They update the cached link. */
+        _rtnl_handle_msg_stats(platform, msg);
+        return;
+    }
+
     if (NM_IN_SET(msghdr->nlmsg_type,
                   RTM_DELLINK,
                   RTM_DELADDR,
@@ -8215,7 +9767,7 @@ _rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg)
         .iter_more = FALSE,
     };
 
-    obj = nmp_object_new_from_nl(platform, cache, msg, is_del, &parse_nlmsg_iter);
+    obj = _rtnl_handle_msg_new_obj(platform, cache, msg, is_del, &parse_nlmsg_iter, parsed);
     if (!obj) {
         _LOGT("event-notification: %s: ignore",
               nl_nlmsghdr_to_str(NETLINK_ROUTE, 0, msghdr, buf_nlmsghdr, sizeof(buf_nlmsghdr)));
@@ -8347,9 +9899,14 @@ _rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg)
                 /* we'd like to avoid such resyncs as they are expensive and we should only rely on the
                  * netlink events. This needs investigation. */
                 _LOGT("schedule resync of routes after RTM_NEWROUTE");
-                delayed_action_schedule(platform,
-                                        delayed_action_refresh_from_needle_object(obj),
-                                        NULL);
+
+                /* The weak-id of routes includes the table. It suffices to refresh
+                 * the routes of that table. */
+                delayed_action_schedule_REFRESH_SCOPED(
+                    platform,
+                    NMP_OBJECT_GET_TYPE(obj),
+                    0,
+                    nm_platform_route_table_uncoerce(obj->ip_route.table_coerced, TRUE));
                 /* We are done here. */
                 return;
             }
@@ -8394,7 +9951,7 @@ _rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg)
 
         nm_clear_pointer(&obj, nmp_object_unref);
 
-        obj = nmp_object_new_from_nl(platform, cache, msg, is_del, &parse_nlmsg_iter);
+        obj = _rtnl_handle_msg_new_obj(platform, cache, msg, is_del, &parse_nlmsg_iter, parsed);
         if (!obj) {
             /* we are done. Usually we don't expect this, because we were told that
              * there would be another object to collect, but there isn't one. Something
@@ -8528,6 +10085,36 @@ do_add_addrroute(NMPlatform      *platform,
     return wait_for_nl_response_to_nmerr(seq_result);
 }
 
+static gboolean
+do_delete_object_check_result(const NMPObject        *obj_id,
+                              WaitForNlResponseResult seq_result,
+                              const char            **out_log_detail)
+{
+    const char *log_detail = "";
+    gboolean    success    = TRUE;
+
+    if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
+        /* ok */
+    } else if (NM_IN_SET(-((int) seq_result), ESRCH, ENOENT))
+        log_detail = ", meaning the object was already removed";
+    else if (NM_IN_SET(-((int) seq_result), ENXIO)
+             && NM_IN_SET(NMP_OBJECT_GET_TYPE(obj_id), NMP_OBJECT_TYPE_IP6_ADDRESS)) {
+        /* On RHEL7 kernel, deleting a non existing address fails with ENXIO */
+        log_detail = ", meaning the address was already removed";
+    } else if (NM_IN_SET(-((int) seq_result), ENODEV)) {
+        log_detail = ", meaning the device was already removed";
+    } else if (NM_IN_SET(-((int) seq_result), EADDRNOTAVAIL)
+               && NM_IN_SET(NMP_OBJECT_GET_TYPE(obj_id),
+                            NMP_OBJECT_TYPE_IP4_ADDRESS,
+                            NMP_OBJECT_TYPE_IP6_ADDRESS))
+        log_detail = ", meaning the address was already removed";
+    else
+        success = FALSE;
+
+    *out_log_detail = log_detail;
+    return success;
+}
+
 static gboolean
 do_delete_object(NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *nlmsg)
 {
@@ -8558,24 +10145,7 @@ do_delete_object(NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *n
 
         nm_assert(seq_result != WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN);
 
-        success = TRUE;
-        if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
-            /* ok */
-        } else if (NM_IN_SET(-((int) seq_result), ESRCH, ENOENT))
-            log_detail = ", meaning the object was already removed";
-        else if (NM_IN_SET(-((int) seq_result), ENXIO)
-                 && NM_IN_SET(NMP_OBJECT_GET_TYPE(obj_id), NMP_OBJECT_TYPE_IP6_ADDRESS)) {
-            /* On RHEL7 kernel, deleting a non existing address fails with ENXIO */
-            log_detail = ", meaning the address was already removed";
-        } else if (NM_IN_SET(-((int) seq_result), ENODEV)) {
-            log_detail = ", meaning the device was already removed";
-        } else if (NM_IN_SET(-((int) seq_result), EADDRNOTAVAIL)
-                   && NM_IN_SET(NMP_OBJECT_GET_TYPE(obj_id),
-                                NMP_OBJECT_TYPE_IP4_ADDRESS,
-                                NMP_OBJECT_TYPE_IP6_ADDRESS))
-            log_detail = ", meaning the address was already removed";
-        else
-            success = FALSE;
+        success = do_delete_object_check_result(obj_id, seq_result, &log_detail);
 
         _NMLOG(success ? LOGL_DEBUG : LOGL_WARN,
                "do-delete-%s[%s]: %s%s",
@@ -8868,6 +10438,56 @@ link_refresh(NMPlatform *platform, int ifindex)
     return !!nm_platform_link_get_obj(platform, ifindex, TRUE);
 }
 
+/* Unlike link_refresh(), this only requests the 64 bit statistics of the links
+ * (RTM_GETSTATS), which is much cheaper for the kernel and for us than a full
+ * RTM_GETLINK. For more than one link, it dumps the statistics of all links
+ * with one request. */
+static void
+link_refresh_stats(NMPlatform *platform, const int *ifindexes, guint n_ifindexes)
+{
+    NMLinuxPlatformPrivate      *priv  = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+    WaitForNlResponseResult      seq_result;
+    struct if_stats_msg          ifsm;
+    int                          nle;
+    guint                        i;
+
+    nm_assert(n_ifindexes > 0);
+
+    if (!priv->link_stats_ifindexes)
+        priv->link_stats_ifindexes = g_hash_table_new(nm_direct_hash, NULL);
+    else
+        g_hash_table_remove_all(priv->link_stats_ifindexes);
+    for (i = 0; i < n_ifindexes; i++)
+        g_hash_table_add(priv->link_stats_ifindexes, GINT_TO_POINTER(ifindexes[i]));
+
+    ifsm = (struct if_stats_msg) {
+        .family      = AF_UNSPEC,
+        .ifindex     = n_ifindexes == 1 ? ifindexes[0] : 0,
+        .filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64),
+    };
+
+    nlmsg = nlmsg_alloc_new(0, RTM_GETSTATS, n_ifindexes == 1 ? 0 : NLM_F_DUMP);
+
+    if (nlmsg_append_struct(nlmsg, &ifsm) < 0)
+        g_return_if_reached();
+
+    _LOGD("do-request-link-stats: %u links%s", n_ifindexes, n_ifindexes == 1 ? "" : " (dump)");
+
+    event_handler_read_netlink(platform, NMP_NETLINK_ROUTE, FALSE);
+
+    seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+    nle        = _netlink_send_nlmsg_rtnl(platform, nlmsg, &seq_result, NULL);
+    if (nle < 0) {
+        _LOGE("do-request-link-stats: failed sending netlink request \"%s\" (%d)",
+              nm_strerror(nle),
+              -nle);
+        return;
+    }
+
+    delayed_action_handle_all(platform);
+}
+
 static gboolean
 link_set_netns(NMPlatform *platform, int ifindex, int netns_fd)
 {
@@ -9149,12 +10769,33 @@ typedef struct _SriovAsyncState {
     int                   ifindex;
     NMPlatformSriovParams sriov_params;
     void (*steps[_SRIOV_ASYNC_MAX_STEPS])(struct _SriovAsyncState *);
+    const char             *step_names[_SRIOV_ASYNC_MAX_STEPS];
     int                     current_step;
     NMPlatformAsyncCallback callback;
     gpointer                data;
     GCancellable           *cancellable;
+
+    /* The time spent in each step, to see where the time goes on devices
+     * that are slow to create VFs. */
+    gint64 start_nsec;
+    gint64 step_start_nsec;
+    gint64 prepare_nsec;
+    gint64 step_nsec[_SRIOV_ASYNC_MAX_STEPS];
 } SriovAsyncState;
 
+static void
+sriov_async_step_done(SriovAsyncState *async_state)
+{
+    gint64 now_nsec = nm_utils_get_monotonic_timestamp_nsec();
+    gint64 duration = now_nsec - async_state->step_start_nsec;
+
+    if (async_state->current_step < 0)
+        async_state->prepare_nsec = duration;
+    else
+        async_state->step_nsec[async_state->current_step] = duration;
+    async_state->step_start_nsec = now_nsec;
+}
+
 static void
 sriov_async_invoke_callback(gpointer user_data, GCancellable *cancellable)
 {
@@ -9173,7 +10814,29 @@ sriov_async_finish_err(SriovAsyncState *async_state, GError *error)
 {
     NMPlatform *platform = async_state->platform;
 
-    _LOGD("finished configuring SR-IOV, error: %s", error ? error->message : "none");
+    sriov_async_step_done(async_state);
+
+    if (_LOGD_ENABLED()) {
+        char  sbuf[200];
+        char *b = sbuf;
+        gsize l = sizeof(sbuf);
+        int   i;
+
+        nm_strbuf_append(&b, &l, "prepare %.3f", async_state->prepare_nsec / 1e6);
+        for (i = 0; i <= async_state->current_step && i < _SRIOV_ASYNC_MAX_STEPS; i++) {
+            if (!async_state->step_names[i])
+                continue;
+            nm_strbuf_append(&b,
+                             &l,
+                             ", %s %.3f",
+                             async_state->step_names[i],
+                             async_state->step_nsec[i] / 1e6);
+        }
+        _LOGD("finished configuring SR-IOV in %.3f msec (%s msec), error: %s",
+              (nm_utils_get_monotonic_timestamp_nsec() - async_state->start_nsec) / 1e6,
+              sbuf,
+              error ? error->message : "none");
+    }
 
     if (async_state->callback) {
         /* nm_platform_link_set_sriov_params() promises to always call the callback,
@@ -9202,6 +10865,7 @@ sriov_async_call_next_step(SriovAsyncState *async_state)
         return;
     }
 
+    sriov_async_step_done(async_state);
     async_state->current_step++;
 
     nm_assert(async_state->current_step >= 0);
@@ -9371,14 +11035,16 @@ link_set_sriov_params_async(NMPlatform             *platform,
     g_return_if_fail(callback || !data);
     g_return_if_fail(cancellable);
 
-    async_state               = g_new0(SriovAsyncState, 1);
-    async_state->platform     = g_object_ref(platform);
-    async_state->ifindex      = ifindex;
-    async_state->sriov_params = sriov_params;
-    async_state->current_step = -1;
-    async_state->callback     = callback;
-    async_state->data         = data;
-    async_state->cancellable  = g_object_ref(cancellable);
+    async_state                  = g_new0(SriovAsyncState, 1);
+    async_state->platform        = g_object_ref(platform);
+    async_state->ifindex         = ifindex;
+    async_state->sriov_params    = sriov_params;
+    async_state->current_step    = -1;
+    async_state->callback        = callback;
+    async_state->data            = data;
+    async_state->cancellable     = g_object_ref(cancellable);
+    async_state->start_nsec      = nm_utils_get_monotonic_timestamp_nsec();
+    async_state->step_start_nsec = async_state->start_nsec;
 
     if (!nm_platform_netns_push(platform, &netns)) {
         g_set_error_literal(&error,
@@ -9448,12 +11114,18 @@ link_set_sriov_params_async(NMPlatform             *platform,
     need_create_vfs  = (current_num_vfs == 0 || need_destroy_vfs) && sriov_params.num_vfs > 0;
 
     i = 0;
-    if (need_destroy_vfs)
-        async_state->steps[i++] = sriov_async_step1_destroy_vfs;
-    if (need_change_eswitch_params)
-        async_state->steps[i++] = sriov_async_step2_set_eswitch_mode;
-    if (need_create_vfs)
-        async_state->steps[i++] = sriov_async_step3_create_vfs;
+    if (need_destroy_vfs) {
+        async_state->step_names[i] = "destroy-vfs";
+        async_state->steps[i++]    = sriov_async_step1_destroy_vfs;
+    }
+    if (need_change_eswitch_params) {
+        async_state->step_names[i] = "set-eswitch-mode";
+        async_state->steps[i++]    = sriov_async_step2_set_eswitch_mode;
+    }
+    if (need_create_vfs) {
+        async_state->step_names[i] = "create-vfs";
+        async_state->steps[i++]    = sriov_async_step3_create_vfs;
+    }
 
     nm_assert(i < _SRIOV_ASYNC_MAX_STEPS);
 
@@ -9462,28 +11134,28 @@ link_set_sriov_params_async(NMPlatform             *platform,
     sriov_async_call_next_step(async_state);
 }
 
-static gboolean
-link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const *vfs)
+static struct nl_msg *
+_nl_msg_new_sriov_vfs(uint16_t                   nlmsg_type,
+                      int                        ifindex,
+                      const NMPlatformVF *const *vfs,
+                      guint                      num,
+                      gboolean                   with_trust)
 {
     nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
     struct nlattr               *list, *info, *vlan_list;
-    guint                        i      = 0;
-    guint                        num    = 0;
-    size_t                       buflen = 0;
-
-    while (vfs[num])
-        num++;
+    guint                        i;
+    size_t                       buflen;
 
     /* A single IFLA_VF_INFO shouldn't take more than 200 bytes. */
     buflen = (num + 1) * 200;
-    nlmsg  = _nl_msg_new_link_full(RTM_NEWLINK, 0, ifindex, NULL, AF_UNSPEC, 0, 0, buflen);
+    nlmsg  = _nl_msg_new_link_full(nlmsg_type, 0, ifindex, NULL, AF_UNSPEC, 0, 0, buflen);
     if (!nlmsg)
-        g_return_val_if_reached(-NME_BUG);
+        g_return_val_if_reached(NULL);
 
     if (!(list = nla_nest_start(nlmsg, IFLA_VFINFO_LIST)))
         goto nla_put_failure;
 
-    for (; vfs[i]; i++) {
+    for (i = 0; i < num; i++) {
         const NMPlatformVF *vf = vfs[i];
 
         if (!(info = nla_nest_start(nlmsg, IFLA_VF_INFO)))
@@ -9497,7 +11169,7 @@ link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const
             NLA_PUT(nlmsg, IFLA_VF_SPOOFCHK, sizeof(ivs), &ivs);
         }
 
-        if (vf->trust >= 0) {
+        if (with_trust && vf->trust >= 0) {
             struct _ifla_vf_setting ivs = {0};
 
             ivs.vf      = vf->index;
@@ -9526,10 +11198,8 @@ link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const
          * changes in the future, we need to figure out how to
          * clear existing VLANs and set new ones in one message
          * with the new API.*/
-        if (vf->num_vlans > 1) {
-            _LOGW("multiple VLANs per VF are not supported at the moment");
-            return FALSE;
-        } else {
+        nm_assert(vf->num_vlans <= 1);
+        {
             struct _ifla_vf_vlan_info ivvi = {0};
 
             if (!(vlan_list = nla_nest_start(nlmsg, IFLA_VF_VLAN_LIST)))
@@ -9554,38 +11224,265 @@ link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const
     }
     nla_nest_end(nlmsg, list);
 
-    return (do_change_link(platform, CHANGE_LINK_TYPE_UNSPEC, ifindex, nlmsg, NULL) >= 0);
+    return g_steal_pointer(&nlmsg);
+
 nla_put_failure:
     _LOGE("error building SR-IOV VFs netlink message: used %u/%zu bytes for %u/%u VFs",
           nlmsg_hdr(nlmsg)->nlmsg_len,
           buflen,
           i,
           num);
-    g_return_val_if_reached(FALSE);
+    g_return_val_if_reached(NULL);
 }
 
+/*
+ * Set only the trust mode of @vf, to find out whether the driver supports it.
+ * Drivers without ndo_set_vf_trust() reject it with EOPNOTSUPP.
+ */
 static gboolean
-link_set_bridge_vlans(NMPlatform                 *platform,
-                      int                         ifindex,
-                      gboolean                    on_controller,
-                      const NMPlatformBridgeVlan *vlans,
-                      guint                       num_vlans)
+_link_set_sriov_vf_trust_supported(NMPlatform *platform, int ifindex, const NMPlatformVF *vf)
 {
+    nm_auto_pop_netns NMPNetns  *netns = NULL;
     nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+    struct _ifla_vf_setting      ivs   = {0};
     struct nlattr               *list;
-    struct bridge_vlan_info      vinfo = {};
-    guint                        i;
+    struct nlattr               *info;
+    WaitForNlResponseResult      seq_result;
 
-    nm_assert(num_vlans == 0 || vlans);
+    nm_assert(vf->trust >= 0);
 
-    nlmsg = _nl_msg_new_link_full(num_vlans > 0 ? RTM_SETLINK : RTM_DELLINK,
-                                  0,
-                                  ifindex,
+    if (!nm_platform_netns_push(platform, &netns))
+        return TRUE;
+
+    nlmsg = _nl_msg_new_link(RTM_SETLINK, 0, ifindex, NULL);
+    if (!nlmsg)
+        g_return_val_if_reached(TRUE);
+
+    if (!(list = nla_nest_start(nlmsg, IFLA_VFINFO_LIST)))
+        goto nla_put_failure;
+    if (!(info = nla_nest_start(nlmsg, IFLA_VF_INFO)))
+        goto nla_put_failure;
+    ivs.vf      = vf->index;
+    ivs.setting = vf->trust;
+    NLA_PUT(nlmsg, IFLA_VF_TRUST, sizeof(ivs), &ivs);
+    nla_nest_end(nlmsg, info);
+    nla_nest_end(nlmsg, list);
+
+    seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+    if (_netlink_send_nlmsg_rtnl(platform, nlmsg, &seq_result, NULL) < 0)
+        return TRUE;
+
+    delayed_action_handle_all(platform);
+
+    return seq_result != -EOPNOTSUPP;
+
+nla_put_failure:
+    g_return_val_if_reached(TRUE);
+}
+
+/*
+ * Configure each VF with its own RTM_SETLINK request. The requests are
+ * pipelined: they are packed into as few sendmsg() calls as possible, and
+ * only then we wait for the ACKs. That way, a VF that the kernel rejects does
+ * not prevent the configuration of the other VFs, and we still don't need a
+ * round trip for each VF.
+ *
+ * Without @with_trust, the trust mode of the VFs is not set.
+ *
+ * Returns: the number of VFs that failed.
+ */
+static guint
+_link_set_sriov_vfs_pipelined(NMPlatform                *platform,
+                              int                        ifindex,
+                              const NMPlatformVF *const *vfs,
+                              gboolean                   with_trust)
+{
+    NMLinuxPlatformPrivate          *priv        = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    nm_auto_pop_netns NMPNetns      *netns       = NULL;
+    gs_free WaitForNlResponseResult *seq_results = NULL;
+    gs_free guint32                 *seqs        = NULL;
+    gs_free char                   **extack_msgs = NULL;
+    gs_free guint8                  *buf         = NULL;
+    gsize                            buf_len     = 0;
+    guint                            i_buf_start = 0;
+    guint                            n_failed    = 0;
+    guint                            num         = 0;
+    guint                            i;
+
+    while (vfs[num])
+        num++;
+
+    if (!nm_platform_netns_push(platform, &netns))
+        return num;
+
+    seq_results = g_new0(WaitForNlResponseResult, num);
+    seqs        = g_new0(guint32, num);
+    extack_msgs = g_new0(char *, num);
+    buf         = g_malloc(RTNL_BATCH_SEND_BUF_SIZE);
+
+    event_handler_read_netlink(platform, NMP_NETLINK_ROUTE, FALSE);
+
+    for (i = 0; i <= num; i++) {
+        nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+        struct nlmsghdr             *nlhdr = NULL;
+        guint                        j;
+
+        if (i < num) {
+            nlmsg = _nl_msg_new_sriov_vfs(RTM_SETLINK, ifindex, &vfs[i], 1, with_trust);
+            if (!nlmsg)
+                continue;
+            nlhdr = nlmsg_hdr(nlmsg);
+            nm_assert(NLMSG_ALIGN(nlhdr->nlmsg_len) <= RTNL_BATCH_SEND_BUF_SIZE);
+
+            if (buf_len + NLMSG_ALIGN(nlhdr->nlmsg_len) <= RTNL_BATCH_SEND_BUF_SIZE)
+                goto append;
+        }
+
+        if (buf_len > 0) {
+            gboolean sent = _rtnl_batch_send(platform, buf, buf_len);
+
+            for (j = i_buf_start; j < i; j++) {
+                if (seqs[j] == 0)
+                    continue;
+                if (!sent) {
+                    seqs[j] = 0;
+                    continue;
+                }
+                delayed_action_schedule_WAIT_FOR_RESPONSE(platform,
+                                                          NMP_NETLINK_ROUTE,
+                                                          seqs[j],
+                                                          &seq_results[j],
+                                                          &extack_msgs[j],
+                                                          DELAYED_ACTION_RESPONSE_TYPE_VOID,
+                                                          NULL);
+            }
+            buf_len = 0;
+        }
+        i_buf_start = i;
+
+        if (i == num)
+            break;
+
+append:
+        seqs[i] = _rtnl_batch_append(priv, buf, &buf_len, nlhdr);
+    }
+
+    delayed_action_schedule(platform, DELAYED_ACTION_TYPE_REFRESH_LINK, GINT_TO_POINTER(ifindex));
+    delayed_action_handle_all(platform);
+
+    for (i = 0; i < num; i++) {
+        char s_buf[256];
+
+        if (seqs[i] != 0 && seq_results[i] == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
+            continue;
+
+        n_failed++;
+        _LOGW("set-sriov-vfs[%d]: failure configuring VF %u: %s",
+              ifindex,
+              vfs[i]->index,
+              seqs[i] != 0 ? wait_for_nl_response_to_string(seq_results[i],
+                                                            extack_msgs[i],
+                                                            s_buf,
+                                                            sizeof(s_buf))
+                           : "failure sending request");
+    }
+
+    for (i = 0; i < num; i++)
+        g_free(extack_msgs[i]);
+
+    return n_failed;
+}
+
+static gboolean
+link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const *vfs)
+{
+    nm_auto_nlmsg struct nl_msg *nlmsg      = NULL;
+    gboolean                     with_trust = TRUE;
+    gint64                       start_nsec;
+    guint                        n_failed;
+    guint                        num;
+    guint                        i;
+    int                          r;
+
+    for (num = 0; vfs[num]; num++) {
+        if (vfs[num]->num_vlans > 1) {
+            _LOGW("multiple VLANs per VF are not supported at the moment");
+            return FALSE;
+        }
+    }
+
+    start_nsec = nm_utils_get_monotonic_timestamp_nsec();
+
+    /* First try to configure all VFs with a single request. That is the
+     * fastest way, but the kernel stops at the first VF attribute that fails
+     * (for example, because the driver doesn't support trust mode), and leaves
+     * the remaining VFs unconfigured. */
+    nlmsg = _nl_msg_new_sriov_vfs(RTM_NEWLINK, ifindex, vfs, num, TRUE);
+    if (!nlmsg)
+        return FALSE;
+
+    r = do_change_link(platform, CHANGE_LINK_TYPE_UNSPEC, ifindex, nlmsg, NULL);
+    if (r >= 0 || r == -NME_PL_NOT_FOUND || num <= 1) {
+        _LOGD("set-sriov-vfs[%d]: configured %u VFs with one request in %.3f msec%s",
+              ifindex,
+              num,
+              (nm_utils_get_monotonic_timestamp_nsec() - start_nsec) / 1e6,
+              r >= 0 ? "" : " (failed)");
+        return r >= 0;
+    }
+
+    /* The most common reason for the failure is a driver that doesn't support
+     * trust mode. Then, setting it would fail again for every single VF. Find
+     * out with one request, and leave it out. */
+    for (i = 0; i < num; i++) {
+        if (vfs[i]->trust >= 0)
+            break;
+    }
+    if (i < num && !_link_set_sriov_vf_trust_supported(platform, ifindex, vfs[i])) {
+        _LOGW("set-sriov-vfs[%d]: the driver does not support VF trust mode, configure the VFs "
+              "without it",
+              ifindex);
+        with_trust = FALSE;
+    }
+
+    n_failed = _link_set_sriov_vfs_pipelined(platform, ifindex, vfs, with_trust);
+
+    _LOGD("set-sriov-vfs[%d]: configured %u VFs with pipelined requests in %.3f msec, %u failed",
+          ifindex,
+          num,
+          (nm_utils_get_monotonic_timestamp_nsec() - start_nsec) / 1e6,
+          n_failed);
+    return n_failed == 0;
+}
+
+static gboolean
+_link_change_bridge_vlans(NMPlatform                 *platform,
+                          uint16_t                    nlmsg_type,
+                          int                         ifindex,
+                          gboolean                    on_controller,
+                          const NMPlatformBridgeVlan *vlans,
+                          guint                       num_vlans)
+{
+    nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+    struct nlattr               *list;
+    struct bridge_vlan_info      vinfo = {};
+    guint                        i;
+
+    nm_assert(NM_IN_SET(nlmsg_type, RTM_SETLINK, RTM_DELLINK));
+    nm_assert(num_vlans == 0 || vlans);
+
+    /* Each VLAN needs at most two attributes. With thousands of single VLANs
+     * the message does not fit into the default buffer size. */
+    nlmsg = _nl_msg_new_link_full(nlmsg_type,
+                                  0,
+                                  ifindex,
                                   NULL,
                                   AF_BRIDGE,
                                   0,
                                   0,
-                                  0);
+                                  256u
+                                      + ((gsize) NM_MAX(num_vlans, 1u)) * 2u
+                                            * nla_total_size(sizeof(vinfo)));
     if (!nlmsg)
         g_return_val_if_reached(-NME_BUG);
 
@@ -9597,7 +11494,7 @@ link_set_bridge_vlans(NMPlatform                 *platform,
                 on_controller ? BRIDGE_FLAGS_CONTROLLER : BRIDGE_FLAGS_SELF);
 
     if (num_vlans > 0) {
-        /* Add VLANs */
+        /* Add or delete VLANs */
         for (i = 0; i < num_vlans; i++) {
             const NMPlatformBridgeVlan *vlan     = &vlans[i];
             gboolean                    is_range = vlan->vid_start != vlan->vid_end;
@@ -9620,6 +11517,8 @@ link_set_bridge_vlans(NMPlatform                 *platform,
         }
     } else {
         /* Flush existing VLANs */
+        nm_assert(nlmsg_type == RTM_DELLINK);
+
         vinfo.vid   = 1;
         vinfo.flags = BRIDGE_VLAN_INFO_RANGE_BEGIN;
         NLA_PUT(nlmsg, IFLA_BRIDGE_VLAN_INFO, sizeof(vinfo), &vinfo);
@@ -9636,6 +11535,50 @@ nla_put_failure:
     g_return_val_if_reached(FALSE);
 }
 
+static gboolean
+link_set_bridge_vlans(NMPlatform                 *platform,
+                      int                         ifindex,
+                      gboolean                    on_controller,
+                      const NMPlatformBridgeVlan *vlans,
+                      guint                       num_vlans)
+{
+    gs_free NMPlatformBridgeVlan *vlans_normalized = NULL;
+
+    if (num_vlans == 0)
+        return _link_change_bridge_vlans(platform, RTM_DELLINK, ifindex, on_controller, NULL, 0);
+
+    /* Send contiguous VLANs with the same flags as one range. */
+    if (num_vlans > 1) {
+        vlans_normalized = nm_memdup(vlans, sizeof(NMPlatformBridgeVlan) * num_vlans);
+        nmp_utils_bridge_vlan_normalize(vlans_normalized, &num_vlans);
+        vlans = vlans_normalized;
+    }
+
+    return _link_change_bridge_vlans(platform,
+                                     RTM_SETLINK,
+                                     ifindex,
+                                     on_controller,
+                                     vlans,
+                                     num_vlans);
+}
+
+static gboolean
+link_del_bridge_vlans(NMPlatform                 *platform,
+                      int                         ifindex,
+                      gboolean                    on_controller,
+                      const NMPlatformBridgeVlan *vlans,
+                      guint                       num_vlans)
+{
+    g_return_val_if_fail(num_vlans > 0, FALSE);
+
+    return _link_change_bridge_vlans(platform,
+                                     RTM_DELLINK,
+                                     ifindex,
+                                     on_controller,
+                                     vlans,
+                                     num_vlans);
+}
+
 typedef struct {
     int     ifindex;
     GArray *vlans;
@@ -10550,6 +12493,184 @@ ip_route_add(NMPlatform *platform, NMPNlmFlags flags, NMPObject *obj_stack, char
                             out_extack_msg);
 }
 
+static struct nl_msg *
+_nl_msg_new_route_batch_op(const NMPlatformIPRouteBatchOp *op)
+{
+    const NMPNlmFlags flags = op->is_delete ? 0 : (op->flags & NMP_NLM_FLAG_FMASK);
+
+    if (NMP_OBJECT_GET_TYPE(op->obj) == NMP_OBJECT_TYPE_ROUTING_RULE) {
+        return _nl_msg_new_routing_rule(op->is_delete ? RTM_DELRULE : RTM_NEWRULE,
+                                        flags,
+                                        NMP_OBJECT_CAST_ROUTING_RULE(op->obj));
+    }
+    return _nl_msg_new_route(op->is_delete ? RTM_DELROUTE : RTM_NEWROUTE, flags, op->obj);
+}
+
+/**
+ * ip_route_batch:
+ * @platform: the platform instance
+ * @ops: the route operations.
+ * @n_ops: the number of operations in @ops.
+ *
+ * Packs the RTM_NEWROUTE/RTM_DELROUTE requests for all @ops into as few
+ * sendmsg() calls as possible. Each sendmsg() carries at most
+ * %RTNL_BATCH_SEND_BUF_SIZE bytes of requests, and their ACKs are read before
+ * sending the next chunk. Kernel processes the requests in order and
+ * acknowledges each of them individually (by sequence number), so the result
+ * is the same as when sending one request after the other, but without a
+ * round trip per route.
+ *
+ * This also implements routing_rule_batch(), in which case @ops contains
+ * routing rules and RTM_NEWRULE/RTM_DELRULE requests are sent.
+ *
+ * Requests whose result got lost due to a resync of the socket are retried
+ * individually.
+ */
+static void
+ip_route_batch(NMPlatform *platform, NMPlatformIPRouteBatchOp *ops, guint n_ops)
+{
+    NMLinuxPlatformPrivate           *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    gs_free WaitForNlResponseResult *seq_results = g_new0(WaitForNlResponseResult, n_ops);
+    gs_free guint32                 *seqs        = g_new0(guint32, n_ops);
+    gs_free guint8                  *buf         = g_malloc(RTNL_BATCH_SEND_BUF_SIZE);
+    gsize                            buf_len     = 0;
+    guint                            i_buf_start = 0;
+    guint                            i;
+
+    event_handler_read_netlink(platform, NMP_NETLINK_ROUTE, FALSE);
+
+    for (i = 0; i <= n_ops; i++) {
+        nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+        struct nlmsghdr             *nlhdr = NULL;
+        guint                        j;
+
+        if (i < n_ops) {
+            NMPlatformIPRouteBatchOp *op = &ops[i];
+
+            nm_assert(NM_IN_SET(NMP_OBJECT_GET_TYPE(op->obj),
+                                NMP_OBJECT_TYPE_IP4_ROUTE,
+                                NMP_OBJECT_TYPE_IP6_ROUTE,
+                                NMP_OBJECT_TYPE_ROUTING_RULE));
+            nm_assert(NMP_OBJECT_GET_TYPE(op->obj) == NMP_OBJECT_GET_TYPE(ops[0].obj));
+
+            nlmsg = _nl_msg_new_route_batch_op(op);
+            if (!nlmsg) {
+                op->result = -NME_BUG;
+                continue;
+            }
+            nlhdr = nlmsg_hdr(nlmsg);
+            nm_assert(NLMSG_ALIGN(nlhdr->nlmsg_len) <= RTNL_BATCH_SEND_BUF_SIZE);
+
+            if (buf_len + NLMSG_ALIGN(nlhdr->nlmsg_len) <= RTNL_BATCH_SEND_BUF_SIZE) {
+                /* there is still space in the buffer. */
+                goto append;
+            }
+        }
+
+        /* Flush the buffer. Only after the send succeeded, we register the
+         * sequence numbers to wait for. */
+        if (buf_len > 0) {
+            gboolean sent = _rtnl_batch_send(platform, buf, buf_len);
+
+            for (j = i_buf_start; j < i; j++) {
+                if (seqs[j] == 0)
+                    continue;
+                if (!sent) {
+                    ops[j].result = -NME_PL_NETLINK;
+                    seqs[j]       = 0;
+                    continue;
+                }
+                delayed_action_schedule_WAIT_FOR_RESPONSE(platform,
+                                                          NMP_NETLINK_ROUTE,
+                                                          seqs[j],
+                                                          &seq_results[j],
+                                                          &ops[j].extack_msg,
+                                                          DELAYED_ACTION_RESPONSE_TYPE_VOID,
+                                                          NULL);
+            }
+            buf_len = 0;
+
+            /* Read the ACKs of this chunk before sending the next one. With
+             * too many requests in flight, the ACKs and the notifications about
+             * the changes overflow the receive buffer of the socket (ENOBUFS),
+             * which forces a resync and a retry of the requests one by one. */
+            if (sent && i < n_ops)
+                event_handler_read_netlink(platform, NMP_NETLINK_ROUTE, TRUE);
+        }
+        i_buf_start = i;
+
+        if (i == n_ops)
+            break;
+
+append:
+        seqs[i] = _rtnl_batch_append(priv, buf, &buf_len, nlhdr);
+    }
+
+    delayed_action_handle_all(platform);
+
+    for (i = 0; i < n_ops; i++) {
+        NMPlatformIPRouteBatchOp *op = &ops[i];
+        char                      sbuf1[NM_UTILS_TO_STRING_BUFFER_SIZE];
+        char                      s_buf[256];
+        const char               *log_detail = "";
+        gboolean                  success;
+
+        if (seqs[i] == 0) {
+            /* we failed to create or send the request. */
+            nm_assert(op->result < 0);
+            continue;
+        }
+
+        nm_assert(seq_results[i] != WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN);
+
+        if (seq_results[i] == WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC) {
+            nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+
+            /* We lost the response. Retry with a plain request. */
+            nm_clear_g_free(&op->extack_msg);
+            if (!op->is_delete
+                && NMP_OBJECT_GET_TYPE(op->obj) == NMP_OBJECT_TYPE_ROUTING_RULE) {
+                op->result =
+                    routing_rule_add(platform, op->flags, NMP_OBJECT_CAST_ROUTING_RULE(op->obj));
+                continue;
+            }
+            nlmsg = _nl_msg_new_route_batch_op(op);
+            if (op->is_delete)
+                op->result = do_delete_object(platform, op->obj, nlmsg) ? 0 : -NME_PL_NETLINK;
+            else {
+                op->result = do_add_addrroute(
+                    platform,
+                    op->obj,
+                    nlmsg,
+                    NM_FLAGS_HAS(op->flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE),
+                    &op->extack_msg);
+            }
+            continue;
+        }
+
+        if (op->is_delete) {
+            success    = do_delete_object_check_result(op->obj, seq_results[i], &log_detail);
+            op->result = success ? 0 : wait_for_nl_response_to_nmerr(seq_results[i]);
+        } else {
+            op->result = wait_for_nl_response_to_nmerr(seq_results[i]);
+            success    = (seq_results[i] == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
+                       || (NM_FLAGS_HAS(op->flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE)
+                           && seq_results[i] < 0));
+        }
+
+        _NMLOG(success ? LOGL_DEBUG : LOGL_WARN,
+               "do-%s-%s[%s]: %s%s",
+               op->is_delete ? "delete" : "add",
+               NMP_OBJECT_GET_CLASS(op->obj)->obj_type_name,
+               nmp_object_to_string(op->obj, NMP_OBJECT_TO_STRING_ID, sbuf1, sizeof(sbuf1)),
+               wait_for_nl_response_to_string(seq_results[i],
+                                              op->extack_msg,
+                                              s_buf,
+                                              sizeof(s_buf)),
+               log_detail);
+    }
+}
+
 static gboolean
 object_delete(NMPlatform *platform, const NMPObject *obj)
 {
@@ -10779,12 +12900,8 @@ tc_delete(NMPlatform *platform,
     int                          nle;
     char                         s_buf[256];
     const char                  *log_tag;
-    nm_auto_nlmsg struct nl_msg *msg = NULL;
-    const struct tcmsg           tcm = {
-                  .tcm_ifindex = ifindex,
-                  .tcm_parent  = parent,
-    };
-    int try_count = 0;
+    nm_auto_nlmsg struct nl_msg *msg       = NULL;
+    int                          try_count = 0;
 
     switch (nlmsg_type) {
     case RTM_DELQDISC:
@@ -10798,10 +12915,9 @@ tc_delete(NMPlatform *platform,
         log_tag = "do-delete-tc";
     }
 
-    msg = nlmsg_alloc_new(0, nlmsg_type, NMP_NLM_FLAG_F_ECHO);
-
-    if (nlmsg_append_struct(msg, &tcm) < 0)
-        goto nla_put_failure;
+    msg = _nl_msg_new_tc_delete(nlmsg_type, ifindex, parent);
+    if (!msg)
+        return -NME_UNSPEC;
 
     event_handler_read_netlink(platform, NMP_NETLINK_ROUTE, FALSE);
 
@@ -10835,9 +12951,6 @@ tc_delete(NMPlatform *platform,
     if (seq_result < 0)
         return seq_result;
     return -NME_UNSPEC;
-
-nla_put_failure:
-    g_return_val_if_reached(-NME_UNSPEC);
 }
 
 static int
@@ -10896,6 +13009,134 @@ tfilter_delete(NMPlatform *platform, int ifindex, guint32 parent, gboolean log_e
     return tc_delete(platform, RTM_DELTFILTER, ifindex, parent, log_error);
 }
 
+static struct nl_msg *
+_nl_msg_new_tc_batch_op(int ifindex, const NMPlatformTcBatchOp *op)
+{
+    if (!op->obj) {
+        return _nl_msg_new_tc_delete(op->del_obj_type == NMP_OBJECT_TYPE_QDISC ? RTM_DELQDISC
+                                                                                : RTM_DELTFILTER,
+                                     ifindex,
+                                     op->del_parent);
+    }
+    if (NMP_OBJECT_GET_TYPE(op->obj) == NMP_OBJECT_TYPE_QDISC)
+        return _nl_msg_new_qdisc(RTM_NEWQDISC, op->flags, NMP_OBJECT_CAST_QDISC(op->obj));
+    return _nl_msg_new_tfilter(RTM_NEWTFILTER, op->flags, NMP_OBJECT_CAST_TFILTER(op->obj));
+}
+
+/*
+ * Like ip_route_batch(), send all tc requests before waiting for the
+ * ACKs. Kernel processes them in order, so this is the same as sending
+ * one request after the other.
+ */
+static void
+tc_batch(NMPlatform *platform, int ifindex, NMPlatformTcBatchOp *ops, guint n_ops)
+{
+    NMLinuxPlatformPrivate           *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    gs_free WaitForNlResponseResult *seq_results = g_new0(WaitForNlResponseResult, n_ops);
+    gs_free guint32                 *seqs        = g_new0(guint32, n_ops);
+    gs_free guint8                  *buf         = g_malloc(RTNL_BATCH_SEND_BUF_SIZE);
+    gsize                            buf_len     = 0;
+    guint                            i_buf_start = 0;
+    guint                            i;
+
+    event_handler_read_netlink(platform, NMP_NETLINK_ROUTE, FALSE);
+
+    for (i = 0; i <= n_ops; i++) {
+        nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+        struct nlmsghdr             *nlhdr = NULL;
+        guint                        j;
+
+        if (i < n_ops) {
+            nlmsg = _nl_msg_new_tc_batch_op(ifindex, &ops[i]);
+            if (!nlmsg) {
+                ops[i].result = -NME_BUG;
+                continue;
+            }
+            nlhdr = nlmsg_hdr(nlmsg);
+            nm_assert(NLMSG_ALIGN(nlhdr->nlmsg_len) <= RTNL_BATCH_SEND_BUF_SIZE);
+
+            if (buf_len + NLMSG_ALIGN(nlhdr->nlmsg_len) <= RTNL_BATCH_SEND_BUF_SIZE)
+                goto append;
+        }
+
+        if (buf_len > 0) {
+            gboolean sent = _rtnl_batch_send(platform, buf, buf_len);
+
+            for (j = i_buf_start; j < i; j++) {
+                if (seqs[j] == 0)
+                    continue;
+                if (!sent) {
+                    ops[j].result = -NME_PL_NETLINK;
+                    seqs[j]       = 0;
+                    continue;
+                }
+                delayed_action_schedule_WAIT_FOR_RESPONSE(platform,
+                                                          NMP_NETLINK_ROUTE,
+                                                          seqs[j],
+                                                          &seq_results[j],
+                                                          NULL,
+                                                          DELAYED_ACTION_RESPONSE_TYPE_VOID,
+                                                          NULL);
+            }
+            buf_len = 0;
+        }
+        i_buf_start = i;
+
+        if (i == n_ops)
+            break;
+
+append:
+        seqs[i] = _rtnl_batch_append(priv, buf, &buf_len, nlhdr);
+    }
+
+    delayed_action_handle_all(platform);
+
+    for (i = 0; i < n_ops; i++) {
+        NMPlatformTcBatchOp *op = &ops[i];
+        char                 sbuf[NM_UTILS_TO_STRING_BUFFER_SIZE];
+        char                 s_buf[256];
+
+        if (seqs[i] == 0) {
+            nm_assert(op->result < 0);
+            continue;
+        }
+
+        nm_assert(seq_results[i] != WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN);
+
+        if (seq_results[i] == WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC) {
+            /* We lost the response. Retry with a plain request. */
+            if (!op->obj) {
+                op->result = tc_delete(platform,
+                                       op->del_obj_type == NMP_OBJECT_TYPE_QDISC ? RTM_DELQDISC
+                                                                                 : RTM_DELTFILTER,
+                                       ifindex,
+                                       op->del_parent,
+                                       FALSE);
+            } else if (NMP_OBJECT_GET_TYPE(op->obj) == NMP_OBJECT_TYPE_QDISC)
+                op->result = qdisc_add(platform, op->flags, NMP_OBJECT_CAST_QDISC(op->obj));
+            else
+                op->result = tfilter_add(platform, op->flags, NMP_OBJECT_CAST_TFILTER(op->obj));
+            continue;
+        }
+
+        op->result = wait_for_nl_response_to_nmerr(seq_results[i]);
+
+        if (!op->obj) {
+            _LOGD("do-delete-%s: parent 0x%08x: %s",
+                  op->del_obj_type == NMP_OBJECT_TYPE_QDISC ? "qdisc" : "tfilter",
+                  op->del_parent,
+                  wait_for_nl_response_to_string(seq_results[i], NULL, s_buf, sizeof(s_buf)));
+            continue;
+        }
+
+        _NMLOG(op->result >= 0 ? LOGL_DEBUG : LOGL_WARN,
+               "do-add-%s[%s]: %s",
+               NMP_OBJECT_GET_CLASS(op->obj)->obj_type_name,
+               nmp_object_to_string(op->obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof(sbuf)),
+               wait_for_nl_response_to_string(seq_results[i], NULL, s_buf, sizeof(s_buf)));
+    }
+}
+
 /*****************************************************************************/
 
 static gboolean
@@ -11034,47 +13275,23 @@ _nl_event_handler_rtnl(int fd, GIOCondition io_condition, gpointer user_data)
 /*****************************************************************************/
 
 static int
-_netlink_recv_handle(NMPlatform        *platform,
-                     NMPNetlinkProtocol netlink_protocol,
-                     gboolean           handle_events)
-{
-    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
-    int                     n;
-    int                     retval      = 0;
-    gboolean                multipart   = 0;
-    gboolean                interrupted = FALSE;
-    struct nlmsghdr        *hdr;
-    struct sockaddr_nl      nla;
-    struct ucred            creds;
-    gboolean                creds_has;
-    guint32                 pktinfo_group = 0;
-    gboolean                pktinfo_has   = FALSE;
-    const char *const       log_prefix    = nmp_netlink_protocol_info(netlink_protocol)->name;
-
-continue_reading:
-
-    n = _netlink_recv(platform,
-                      priv->sk_x[netlink_protocol],
-                      &nla,
-                      &creds,
-                      &creds_has,
-                      &pktinfo_group,
-                      netlink_protocol == NMP_NETLINK_GENERIC ? &pktinfo_has : NULL);
-    if (n < 0) {
-        if (n == -NME_NL_MSG_TRUNC && !handle_events)
-            goto continue_reading;
-        return n;
-    }
-
-    if (!creds_has || creds.pid) {
-        if (!creds_has)
-            _LOGT("%s: recvmsg: received message without credentials", log_prefix);
-        else
-            _LOGT("%s: recvmsg: received non-kernel message (pid %d)", log_prefix, creds.pid);
-        goto stop;
-    }
-
-    hdr = NM_CAST_ALIGN(struct nlmsghdr, priv->netlink_recv_buf.buf);
+_netlink_handle_buf(NMPlatform         *platform,
+                    NMPNetlinkProtocol  netlink_protocol,
+                    unsigned char      *buf,
+                    int                 n,
+                    struct sockaddr_nl *nla,
+                    struct ucred       *creds,
+                    guint32             pktinfo_group,
+                    gboolean            handle_events,
+                    ParseWorkerBatch   *batch,
+                    gboolean           *inout_multipart,
+                    gboolean           *inout_interrupted)
+{
+    int               retval     = 0;
+    const char *const log_prefix = nmp_netlink_protocol_info(netlink_protocol)->name;
+    struct nlmsghdr  *hdr;
+
+    hdr = NM_CAST_ALIGN(struct nlmsghdr, buf);
     while (nlmsg_ok(hdr, n)) {
         WaitForNlResponseResult  seq_result;
         gboolean                 process_valid_msg = FALSE;
@@ -11082,8 +13299,8 @@ continue_reading:
         const char              *extack_msg = NULL;
         const struct nl_msg_lite msg        = {
                    .nm_protocol = nmp_netlink_protocol_info(netlink_protocol)->netlink_protocol,
-                   .nm_src      = &nla,
-                   .nm_creds    = &creds,
+                   .nm_src      = nla,
+                   .nm_creds    = creds,
                    .nm_size     = NLMSG_ALIGN(hdr->nlmsg_len),
                    .nm_nlh      = hdr,
         };
@@ -11100,7 +13317,7 @@ continue_reading:
                                  sizeof(buf_nlmsghdr)));
 
         if (msg.nm_nlh->nlmsg_flags & NLM_F_MULTI)
-            multipart = TRUE;
+            *inout_multipart = TRUE;
 
         if (msg.nm_nlh->nlmsg_flags & NLM_F_DUMP_INTR) {
             /*
@@ -11108,7 +13325,7 @@ continue_reading:
              * all messages until a NLMSG_DONE is
              * received and report the inconsistency.
              */
-            interrupted = TRUE;
+            *inout_interrupted = TRUE;
         }
 
         if (msg.nm_nlh->nlmsg_flags & NLM_F_ACK) {
@@ -11122,8 +13339,8 @@ continue_reading:
              * usually the end of a message and therefore we slip
              * out of the loop by default. the user may overrule
              * this action by skipping this packet. */
-            multipart  = FALSE;
-            seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
+            *inout_multipart = FALSE;
+            seq_result       = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
         } else if (msg.nm_nlh->nlmsg_type == NLMSG_NOOP) {
             /* Message to be ignored, the default action is to
              * skip this message if no callback is specified. The
@@ -11170,11 +13387,27 @@ continue_reading:
 
         if (process_valid_msg) {
             if (handle_events) {
+                NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+
+                priv->hotpath_stats
+                    .msg_kinds[_netlink_msg_kind_from_nlmsg_type(netlink_protocol,
+                                                                 msg.nm_nlh->nlmsg_type)]
+                    .msgs++;
+
                 /* Valid message (not checking for MULTIPART bit to
                  * get along with broken kernels. NL_SKIP has no
                  * effect on this.  */
                 if (netlink_protocol == NMP_NETLINK_ROUTE) {
-                    _rtnl_handle_msg(platform, &msg);
+                    if (batch && _parse_worker_msg_type(msg.nm_nlh->nlmsg_type)) {
+                        ParsedObjs parsed = {
+                            .objs = (NMPObject *const *) &batch->objs->pdata[batch->objs_idx],
+                        };
+
+                        while (batch->objs->pdata[batch->objs_idx++])
+                            parsed.len++;
+                        _rtnl_handle_msg(platform, &msg, &parsed);
+                    } else
+                        _rtnl_handle_msg(platform, &msg, NULL);
                 } else {
                     _genl_handle_msg(platform, pktinfo_group, &msg);
                 }
@@ -11185,10 +13418,356 @@ continue_reading:
         event_seq_check(platform, netlink_protocol, seq_number, seq_result, extack_msg);
 
         if (retval != 0)
-            goto stop;
+            break;
+
+        hdr = nlmsg_next(hdr, &n);
+    }
+
+    return retval;
+}
+
+/*****************************************************************************/
+
+static void
+_parse_worker_batch_free(ParseWorkerBatch *batch)
+{
+    nm_clear_pointer(&batch->objs, g_ptr_array_unref);
+    nm_clear_pointer(&batch->route_table_filter, g_array_unref);
+    g_free(batch->buf);
+    nm_g_slice_free(batch);
+}
 
+static void
+_parse_worker_batch_parse(ParseWorkerBatch *batch)
+{
+    struct nlmsghdr *hdr;
+    int              n = batch->len;
+
+    batch->objs = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+
+    hdr = NM_CAST_ALIGN(struct nlmsghdr, batch->buf);
+    while (nlmsg_ok(hdr, n)) {
+        if (_parse_worker_msg_type(hdr->nlmsg_type)) {
+            const struct nl_msg_lite msg = {
+                .nm_protocol = NETLINK_ROUTE,
+                .nm_src      = &batch->nla,
+                .nm_creds    = &batch->creds,
+                .nm_size     = NLMSG_ALIGN(hdr->nlmsg_len),
+                .nm_nlh      = hdr,
+            };
+            ParseNlmsgIter parse_nlmsg_iter = {
+                .iter_more          = FALSE,
+                .route_table_filter = batch->route_table_filter,
+            };
+            gboolean   is_del = NM_IN_SET(hdr->nlmsg_type, RTM_DELADDR, RTM_DELROUTE, RTM_DELRULE);
+            NMPObject *obj;
+
+            /* Without platform and cache, parsing does not touch any state that
+             * is shared with the main thread. */
+            do {
+                obj = nmp_object_new_from_nl(NULL, NULL, &msg, is_del, &parse_nlmsg_iter);
+                if (!obj)
+                    break;
+                g_ptr_array_add(batch->objs, obj);
+            } while (parse_nlmsg_iter.iter_more);
+
+            g_ptr_array_add(batch->objs, NULL);
+        }
         hdr = nlmsg_next(hdr, &n);
     }
+}
+
+static gpointer
+_parse_worker_thread(gpointer user_data)
+{
+    NMLinuxPlatformPrivate *priv = user_data;
+
+    /* The worker only accesses the queues and the eventfd, which don't
+     * change while the thread is running. */
+    for (;;) {
+        ParseWorkerBatch *batch;
+        const guint64     one = 1;
+
+        batch = g_async_queue_pop(priv->parse_worker.queue_in);
+        if (!batch->buf) {
+            _parse_worker_batch_free(batch);
+            return NULL;
+        }
+
+        _parse_worker_batch_parse(batch);
+
+        g_async_queue_push(priv->parse_worker.queue_out, batch);
+        if (write(priv->parse_worker.eventfd, &one, sizeof(one)) < 0) {
+            /* The counter cannot overflow. The main thread would also find
+             * the batch on the next wakeup. */
+        }
+    }
+}
+
+static gboolean
+_parse_worker_is_active(NMPlatform *platform, NMPNetlinkProtocol netlink_protocol)
+{
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+
+    /* While we wait for the response to a request, messages are handled
+     * synchronously. That is simpler, and the caller is blocked anyway. */
+    return netlink_protocol == NMP_NETLINK_ROUTE && priv->parse_worker.thread
+           && !NM_FLAGS_HAS(priv->delayed_action.flags,
+                            DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_RTNL);
+}
+
+/**
+ * _parse_worker_apply:
+ * @platform: the platform instance
+ * @wait: whether to wait for all pending batches. Otherwise, only
+ *   one batch that is already parsed is applied.
+ *
+ * Applies the batches parsed by the worker thread to the cache, in the
+ * order in which they were received.
+ *
+ * Returns: whether any batch was applied.
+ */
+static gboolean
+_parse_worker_apply(NMPlatform *platform, gboolean wait)
+{
+    NMLinuxPlatformPrivate *priv    = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    gboolean                applied = FALSE;
+
+    while (priv->parse_worker.n_pending > 0) {
+        ParseWorkerBatch *batch;
+        gboolean          multipart   = FALSE;
+        gboolean          interrupted = FALSE;
+        int               nle;
+
+        if (wait)
+            batch = g_async_queue_pop(priv->parse_worker.queue_out);
+        else {
+            batch = g_async_queue_try_pop(priv->parse_worker.queue_out);
+            if (!batch)
+                break;
+        }
+
+        priv->parse_worker.n_pending--;
+        applied = TRUE;
+
+        nle = _netlink_handle_buf(platform,
+                                  NMP_NETLINK_ROUTE,
+                                  batch->buf,
+                                  batch->len,
+                                  &batch->nla,
+                                  &batch->creds,
+                                  0,
+                                  TRUE,
+                                  batch,
+                                  &multipart,
+                                  &interrupted);
+        if (nle < 0) {
+            _LOGD("netlink[%s]: failed to handle parsed events: %s (%d)",
+                  nmp_netlink_protocol_info(NMP_NETLINK_ROUTE)->name,
+                  nm_strerror(nle),
+                  nle);
+        }
+
+        _parse_worker_batch_free(batch);
+
+        if (!wait)
+            break;
+    }
+
+    return applied;
+}
+
+static gboolean
+_parse_worker_event_handler(int fd, GIOCondition io_condition, gpointer user_data)
+{
+    NMPlatform *platform = user_data;
+    guint64     counter;
+
+    /* The eventfd is in semaphore mode. Each wakeup applies one batch, so
+     * that other sources of the main loop get dispatched in between. */
+    if (read(fd, &counter, sizeof(counter)) < 0) {
+        /* Nothing to read. The batch was already applied synchronously. */
+    }
+
+    if (_parse_worker_apply(platform, FALSE))
+        delayed_action_handle_all(platform);
+
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+_parse_worker_enqueue(NMPlatform         *platform,
+                      NMPNetlinkProtocol  netlink_protocol,
+                      int                 n,
+                      struct sockaddr_nl *nla,
+                      struct ucred       *creds)
+{
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    ParseWorkerBatch       *batch;
+
+    if (!_parse_worker_is_active(platform, netlink_protocol))
+        return FALSE;
+
+    if (priv->parse_worker.n_pending >= PARSE_WORKER_MAX_PENDING) {
+        /* We don't keep up with applying the batches. Don't let the queue grow
+         * without bound. */
+        _parse_worker_apply(platform, TRUE);
+    }
+
+    batch  = g_slice_new(ParseWorkerBatch);
+    *batch = (ParseWorkerBatch) {
+        .buf                = nm_memdup(priv->netlink_recv_buf.buf, n),
+        .len                = n,
+        .nla                = *nla,
+        .creds              = *creds,
+        .route_table_filter = nm_platform_route_table_filter_ref(platform),
+    };
+
+    priv->parse_worker.n_pending++;
+    g_async_queue_push(priv->parse_worker.queue_in, batch);
+    return TRUE;
+}
+
+static void
+_parse_worker_stop(NMPlatform *platform, gboolean apply_pending)
+{
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    ParseWorkerBatch       *batch;
+
+    if (!priv->parse_worker.thread)
+        return;
+
+    _LOGD("netlink: stop parse worker thread");
+
+    batch  = g_slice_new(ParseWorkerBatch);
+    *batch = (ParseWorkerBatch) {};
+    g_async_queue_push(priv->parse_worker.queue_in, batch);
+    g_thread_join(g_steal_pointer(&priv->parse_worker.thread));
+
+    /* All batches were parsed before the worker quit. */
+    nm_assert(g_async_queue_length(priv->parse_worker.queue_in) == 0);
+    nm_assert(g_async_queue_length(priv->parse_worker.queue_out)
+              == (int) priv->parse_worker.n_pending);
+
+    if (apply_pending)
+        _parse_worker_apply(platform, TRUE);
+    else {
+        while ((batch = g_async_queue_try_pop(priv->parse_worker.queue_out)))
+            _parse_worker_batch_free(batch);
+        priv->parse_worker.n_pending = 0;
+    }
+
+    nm_assert(priv->parse_worker.n_pending == 0);
+
+    nm_clear_g_source_inst(&priv->parse_worker.event_source);
+    nm_clear_fd(&priv->parse_worker.eventfd);
+    nm_clear_pointer(&priv->parse_worker.queue_in, g_async_queue_unref);
+    nm_clear_pointer(&priv->parse_worker.queue_out, g_async_queue_unref);
+}
+
+static void
+netlink_set_parse_thread(NMPlatform *platform, gboolean enabled)
+{
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    int                     fd;
+
+    if (!enabled) {
+        _parse_worker_stop(platform, TRUE);
+        return;
+    }
+
+    if (priv->parse_worker.thread)
+        return;
+
+    fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+    if (fd < 0) {
+        _LOGW("netlink: failed to create eventfd for parse worker thread: %s",
+              nm_strerror_native(errno));
+        return;
+    }
+
+    _LOGD("netlink: start parse worker thread");
+
+    priv->parse_worker.eventfd      = fd;
+    priv->parse_worker.queue_in     = g_async_queue_new();
+    priv->parse_worker.queue_out    = g_async_queue_new();
+    priv->parse_worker.event_source = nm_g_unix_fd_add_source(fd,
+                                                              G_IO_IN,
+                                                              _parse_worker_event_handler,
+                                                              platform);
+    priv->parse_worker.thread =
+        g_thread_new("nm-netlink-parse", _parse_worker_thread, priv);
+}
+
+/*****************************************************************************/
+
+static int
+_netlink_recv_handle(NMPlatform        *platform,
+                     NMPNetlinkProtocol netlink_protocol,
+                     gboolean           handle_events)
+{
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    int                     n;
+    int                     retval      = 0;
+    gboolean                multipart   = 0;
+    gboolean                interrupted = FALSE;
+    struct sockaddr_nl      nla;
+    struct ucred            creds;
+    gboolean                creds_has;
+    guint32                 pktinfo_group = 0;
+    gboolean                pktinfo_has   = FALSE;
+    const char *const       log_prefix    = nmp_netlink_protocol_info(netlink_protocol)->name;
+
+    if (netlink_protocol == NMP_NETLINK_ROUTE && priv->parse_worker.n_pending > 0
+        && !(handle_events && _parse_worker_is_active(platform, netlink_protocol))) {
+        /* We are about to handle messages synchronously. First apply the ones
+         * that were received earlier and are with the parse worker. */
+        _parse_worker_apply(platform, TRUE);
+    }
+
+continue_reading:
+
+    n = _netlink_recv(platform,
+                      priv->sk_x[netlink_protocol],
+                      &nla,
+                      &creds,
+                      &creds_has,
+                      &pktinfo_group,
+                      netlink_protocol == NMP_NETLINK_GENERIC ? &pktinfo_has : NULL);
+    if (n < 0) {
+        if (n == -NME_NL_MSG_TRUNC && !handle_events)
+            goto continue_reading;
+        return n;
+    }
+
+    if (!creds_has || creds.pid) {
+        if (!creds_has)
+            _LOGT("%s: recvmsg: received message without credentials", log_prefix);
+        else
+            _LOGT("%s: recvmsg: received non-kernel message (pid %d)", log_prefix, creds.pid);
+        goto stop;
+    }
+
+    if (handle_events && _parse_worker_enqueue(platform, netlink_protocol, n, &nla, &creds)) {
+        /* The datagram gets parsed by the worker thread and handled later. The
+         * caller reads until EAGAIN anyway, so multipart messages get
+         * completed too. */
+        return 0;
+    }
+
+    retval = _netlink_handle_buf(platform,
+                                 netlink_protocol,
+                                 priv->netlink_recv_buf.buf,
+                                 n,
+                                 &nla,
+                                 &creds,
+                                 pktinfo_group,
+                                 handle_events,
+                                 NULL,
+                                 &multipart,
+                                 &interrupted);
+    if (retval != 0)
+        goto stop;
 
     if (multipart) {
         /* Multipart message not yet complete, continue reading */
@@ -11210,6 +13789,228 @@ stop:
 
 /*****************************************************************************/
 
+/* The order in which the object types get refreshed after an overflow. Links
+ * come first, because everything else refers to them. Routes come late, because
+ * they are the most expensive to dump and most likely the cause of the
+ * overflow. */
+static const DelayedActionType resync_priority_groups[] = {
+    DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_LINKS,
+    DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_IP4_ADDRESSES
+        | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_IP6_ADDRESSES,
+    DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_ROUTING_RULES_ALL,
+    DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_IP4_ROUTES
+        | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_IP6_ROUTES,
+    DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_QDISCS | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_TFILTERS,
+    DELAYED_ACTION_TYPE_REFRESH_ALL_GENL_FAMILIES,
+};
+
+static gboolean _resync_timeout_cb_genl(gpointer user_data);
+static gboolean _resync_timeout_cb_rtnl(gpointer user_data);
+
+static void
+_resync_schedule_step(NMPlatform        *platform,
+                      NMPNetlinkProtocol netlink_protocol,
+                      guint              timeout_msec)
+{
+    NMLinuxPlatformPrivate *priv   = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    NetlinkResyncData      *resync = &priv->resync_x[netlink_protocol];
+
+    nm_clear_g_source_inst(&resync->timeout_source);
+    resync->timeout_source =
+        nm_g_timeout_add_source(timeout_msec,
+                                netlink_protocol == NMP_NETLINK_ROUTE ? _resync_timeout_cb_rtnl
+                                                                      : _resync_timeout_cb_genl,
+                                platform);
+}
+
+static void
+_resync_update_rcvbuf_size(NMPlatform *platform, NMPNetlinkProtocol netlink_protocol)
+{
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    int                     rcvbuf_size;
+
+    /* The kernel might not grant what we requested. Report what we got. */
+    rcvbuf_size = nl_socket_get_rcvbuf(priv->sk_x[netlink_protocol]);
+    if (rcvbuf_size > 0)
+        priv->resync_x[netlink_protocol].stats.rcvbuf_size = rcvbuf_size;
+}
+
+/**
+ * _resync_start:
+ * @platform: the platform instance
+ * @netlink_protocol: the netlink socket that overflowed
+ *
+ * Called when the receive buffer of the netlink socket overflowed (ENOBUFS).
+ * We lost events and must resync the cache. But dumping all object types
+ * at once during an event storm makes the next overflow only more likely.
+ * Instead, backoff (longer on repeated overflows), grow the receive buffer
+ * and then refresh the object types one group at a time, rate-limited and
+ * in order of priority. Another overflow restarts the resync.
+ */
+static void
+_resync_start(NMPlatform *platform, NMPNetlinkProtocol netlink_protocol)
+{
+    NMLinuxPlatformPrivate *priv     = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    NetlinkResyncData      *resync   = &priv->resync_x[netlink_protocol];
+    gint64                  now_msec = nm_utils_get_monotonic_timestamp_msec();
+    gboolean                repeated;
+
+    repeated = resync->stats.overflows > 0
+               && now_msec < resync->last_overflow_msec + RESYNC_OVERFLOW_WINDOW_MSEC;
+
+    resync->stats.overflows++;
+    resync->last_overflow_msec = now_msec;
+
+    if (repeated)
+        resync->backoff_msec = NM_MIN(resync->backoff_msec * 2u, RESYNC_BACKOFF_MSEC_MAX);
+    else
+        resync->backoff_msec = RESYNC_BACKOFF_MSEC_MIN;
+
+    if (resync->rcvbuf_requested < NETLINK_RCVBUF_SIZE_MAX) {
+        guint32 rcvbuf_size = NM_MIN(resync->rcvbuf_requested * 2u, NETLINK_RCVBUF_SIZE_MAX);
+        int     nle;
+
+        /* SO_RCVBUF is capped at net.core.rmem_max, which is usually much
+         * smaller than what we want. */
+        nle = nl_socket_set_rcvbuf_force(priv->sk_x[netlink_protocol], rcvbuf_size);
+        if (nle < 0) {
+            _LOGW("netlink[%s]: failed to increase receive buffer to %u bytes: %s",
+                  nmp_netlink_protocol_info(netlink_protocol)->name,
+                  rcvbuf_size,
+                  nm_strerror(nle));
+        } else {
+            resync->rcvbuf_requested = rcvbuf_size;
+            _resync_update_rcvbuf_size(platform, netlink_protocol);
+            _LOGD("netlink[%s]: increase receive buffer to %u bytes (effective %u bytes)",
+                  nmp_netlink_protocol_info(netlink_protocol)->name,
+                  rcvbuf_size,
+                  resync->stats.rcvbuf_size);
+        }
+    }
+
+    /* Any object type might be out of sync. Start over with all of them, even
+     * if a previous resync is still in progress. */
+    resync->pending                  = delayed_action_refresh_all_flags(platform, netlink_protocol);
+    resync->stats.resync_in_progress = TRUE;
+
+    /* Netlink notifications are coming faster than what we can process
+     * them. Backoff a bit so we give some time for this burst to finish,
+     * and we don't contribute to starve the system contending for the
+     * kernel's RTNL lock. */
+    _LOGI("netlink[%s]: backoff for %u msec before the resync (overflow #%" G_GUINT64_FORMAT
+          ")",
+          nmp_netlink_protocol_info(netlink_protocol)->name,
+          resync->backoff_msec,
+          resync->stats.overflows);
+    _resync_schedule_step(platform, netlink_protocol, resync->backoff_msec);
+}
+
+static void
+_resync_step(NMPlatform *platform, NMPNetlinkProtocol netlink_protocol)
+{
+    NMLinuxPlatformPrivate *priv        = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    NetlinkResyncData      *resync      = &priv->resync_x[netlink_protocol];
+    DelayedActionType       action_type = DELAYED_ACTION_TYPE_NONE;
+    DelayedActionType       iflags;
+    guint64                 overflows;
+    guint                   i;
+
+    for (i = 0; i < G_N_ELEMENTS(resync_priority_groups); i++) {
+        action_type = resync->pending & resync_priority_groups[i];
+        if (action_type != DELAYED_ACTION_TYPE_NONE)
+            break;
+    }
+    resync->pending &= ~action_type;
+
+    if (action_type != DELAYED_ACTION_TYPE_NONE) {
+        FOR_EACH_DELAYED_ACTION (iflags, action_type)
+            resync->stats.resync_dumps++;
+
+        _LOGt_delayed_action(action_type, NULL, "schedule (resync)");
+
+        overflows = resync->stats.overflows;
+        delayed_action_schedule(platform, action_type, NULL);
+        delayed_action_handle_all(platform);
+
+        if (resync->stats.overflows != overflows) {
+            /* we overflowed again while handling the dump. The resync
+             * was restarted. */
+            return;
+        }
+    }
+
+    if (resync->pending != DELAYED_ACTION_TYPE_NONE) {
+        _resync_schedule_step(platform, netlink_protocol, RESYNC_STEP_MSEC);
+        return;
+    }
+
+    resync->stats.resync_in_progress = FALSE;
+    resync->stats.resyncs_completed++;
+    _LOGI("netlink[%s]: resync completed", nmp_netlink_protocol_info(netlink_protocol)->name);
+}
+
+static gboolean
+_resync_timeout_cb(NMPlatform *platform, NMPNetlinkProtocol netlink_protocol)
+{
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+
+    nm_clear_g_source_inst(&priv->resync_x[netlink_protocol].timeout_source);
+    _resync_step(platform, netlink_protocol);
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+_resync_timeout_cb_genl(gpointer user_data)
+{
+    return _resync_timeout_cb(user_data, NMP_NETLINK_GENERIC);
+}
+
+static gboolean
+_resync_timeout_cb_rtnl(gpointer user_data)
+{
+    return _resync_timeout_cb(user_data, NMP_NETLINK_ROUTE);
+}
+
+static gboolean
+sysctl_stats_get(NMPlatform *platform, NMPlatformSysctlStats *out_stats)
+{
+    *out_stats = NM_LINUX_PLATFORM_GET_PRIVATE(platform)->sysctl_writes.stats;
+    return TRUE;
+}
+
+static gboolean
+netlink_stats_get(NMPlatform *platform, NMPlatformNetlinkStats *out_stats)
+{
+    NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE(platform);
+    NMPNetlinkProtocol      netlink_protocol;
+
+    G_STATIC_ASSERT(sizeof(out_stats->msg_kinds) == sizeof(priv->hotpath_stats.msg_kinds));
+
+    /* The receive buffer size is the one of the rtnetlink socket, which is
+     * the one that matters. The counters are summed up. */
+    *out_stats = (NMPlatformNetlinkStats){
+        .rcvbuf_size     = priv->resync_x[NMP_NETLINK_ROUTE].stats.rcvbuf_size,
+        .refresh_all     = priv->hotpath_stats.refresh_all,
+        .dumps_completed = priv->hotpath_stats.dumps_completed,
+        .dumps_nsec      = priv->hotpath_stats.dumps_nsec,
+        .dumps_max_nsec  = priv->hotpath_stats.dumps_max_nsec,
+    };
+    memcpy(out_stats->msg_kinds, priv->hotpath_stats.msg_kinds, sizeof(out_stats->msg_kinds));
+    for (netlink_protocol = _NMP_NETLINK_FIRST; netlink_protocol < _NMP_NETLINK_NUM;
+         netlink_protocol++) {
+        const NMPlatformNetlinkStats *stats = &priv->resync_x[netlink_protocol].stats;
+
+        out_stats->overflows += stats->overflows;
+        out_stats->resync_dumps += stats->resync_dumps;
+        out_stats->resyncs_completed += stats->resyncs_completed;
+        if (stats->resync_in_progress)
+            out_stats->resync_in_progress = TRUE;
+    }
+    return TRUE;
+}
+
+/*****************************************************************************/
+
 static gboolean
 event_handler_read_netlink(NMPlatform        *platform,
                            NMPNetlinkProtocol netlink_protocol,
@@ -11270,25 +14071,15 @@ event_handler_read_netlink(NMPlatform        *platform,
                               _reason;
                           }));
 
-                    if (nle == -ENOBUFS) {
-                        /* Netlink notifications are coming faster than what
-                         * we can process them. Backoff a bit so we give some
-                         * time for this burst to finish, and we don't
-                         * contribute to starve the system contending for the
-                         * kernel's RTNL lock.
-                         */
-                        _LOGI("netlink[%s]: backoff for %d seconds before the resync.",
-                              nmp_netlink_protocol_info(netlink_protocol)->name,
-                              RESYNC_BACKOFF_SECONDS);
-                        sleep(RESYNC_BACKOFF_SECONDS);
-                    }
-
                     _netlink_recv_handle(platform, netlink_protocol, FALSE);
                     delayed_action_wait_for_nl_response_complete_all(
                         platform,
                         netlink_protocol,
                         WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC);
-                    delayed_action_schedule_refresh_all(platform, netlink_protocol);
+                    if (nle == -ENOBUFS)
+                        _resync_start(platform, netlink_protocol);
+                    else
+                        delayed_action_schedule_refresh_all(platform, netlink_protocol);
                     break;
                 default:
                     _LOGE("netlink[%s]: read: failed to retrieve incoming events: %s (%d)",
@@ -11832,11 +14623,19 @@ nm_linux_platform_init(NMLinuxPlatform *self)
     priv->netlink_recv_buf.len = 32 * 1024;
     priv->netlink_recv_buf.buf = g_malloc(priv->netlink_recv_buf.len);
 
+    priv->resync_x[NMP_NETLINK_GENERIC].rcvbuf_requested = NETLINK_RCVBUF_SIZE_INITIAL;
+    priv->resync_x[NMP_NETLINK_ROUTE].rcvbuf_requested   = NETLINK_RCVBUF_SIZE_INITIAL;
+
+    priv->parse_worker.eventfd = -1;
+
     c_list_init(&priv->sysctl_clear_cache_lst);
     c_list_init(&priv->sysctl_list);
 
     priv->delayed_action.list_controller_connected = g_ptr_array_new();
     priv->delayed_action.list_refresh_link         = g_ptr_array_new();
+    priv->delayed_action.list_refresh_scoped =
+        g_array_new(FALSE, FALSE, sizeof(RefreshScope));
+    priv->pruning_scoped = g_array_new(FALSE, FALSE, sizeof(RefreshScope));
     priv->delayed_action.list_wait_for_response_rtnl =
         g_array_new(FALSE, TRUE, sizeof(DelayedActionWaitForNlResponseData));
     priv->delayed_action.list_wait_for_response_genl =
@@ -11887,13 +14686,16 @@ constructed(GObject *_object)
                         NETLINK_GENERIC,
                         NL_SOCKET_FLAGS_NONBLOCK | NL_SOCKET_FLAGS_PASSCRED
                             | NL_SOCKET_FLAGS_DISABLE_MSG_PEEK,
-                        8 * 1024 * 1024,
+                        NETLINK_RCVBUF_SIZE_INITIAL,
                         0);
     g_assert(!nle);
 
     nle = nl_socket_add_memberships(priv->sk_genl, GENL_ID_CTRL, 0);
     g_assert(!nle);
 
+    (void) nl_socket_set_rcvbuf_force(priv->sk_genl, NETLINK_RCVBUF_SIZE_INITIAL);
+    _resync_update_rcvbuf_size(platform, NMP_NETLINK_GENERIC);
+
     fd = nl_socket_get_fd(priv->sk_genl);
 
     _LOGD("genl: generic netlink socket created: port=%u, fd=%d",
@@ -11913,7 +14715,7 @@ constructed(GObject *_object)
                         NETLINK_ROUTE,
                         NL_SOCKET_FLAGS_NONBLOCK | NL_SOCKET_FLAGS_PASSCRED
                             | NL_SOCKET_FLAGS_DISABLE_MSG_PEEK,
-                        8 * 1024 * 1024,
+                        NETLINK_RCVBUF_SIZE_INITIAL,
                         0);
     g_assert(!nle);
 
@@ -11933,6 +14735,9 @@ constructed(GObject *_object)
         nm_assert(!nle);
     }
 
+    (void) nl_socket_set_rcvbuf_force(priv->sk_rtnl, NETLINK_RCVBUF_SIZE_INITIAL);
+    _resync_update_rcvbuf_size(platform, NMP_NETLINK_ROUTE);
+
     fd = nl_socket_get_fd(priv->sk_rtnl);
 
     _LOGD("rtnl: rtnetlink socket created: port=%u, fd=%d",
@@ -12040,6 +14845,8 @@ dispose(GObject *object)
 
     _LOGD("dispose");
 
+    _parse_worker_stop(platform, FALSE);
+
     delayed_action_wait_for_nl_response_complete_all(platform,
                                                      NMP_NETLINK_GENERIC,
                                                      WAIT_FOR_NL_RESPONSE_RESULT_FAILED_DISPOSING);
@@ -12051,6 +14858,8 @@ dispose(GObject *object)
     priv->delayed_action.flags = DELAYED_ACTION_TYPE_NONE;
     g_ptr_array_set_size(priv->delayed_action.list_controller_connected, 0);
     g_ptr_array_set_size(priv->delayed_action.list_refresh_link, 0);
+    g_array_set_size(priv->delayed_action.list_refresh_scoped, 0);
+    g_array_set_size(priv->pruning_scoped, 0);
 
     G_OBJECT_CLASS(nm_linux_platform_parent_class)->dispose(object);
 }
@@ -12062,11 +14871,25 @@ finalize(GObject *object)
 
     g_ptr_array_unref(priv->delayed_action.list_controller_connected);
     g_ptr_array_unref(priv->delayed_action.list_refresh_link);
+    g_array_unref(priv->delayed_action.list_refresh_scoped);
+    g_array_unref(priv->pruning_scoped);
     g_array_unref(priv->delayed_action.list_wait_for_response_rtnl);
     g_array_unref(priv->delayed_action.list_wait_for_response_genl);
 
     nm_clear_g_source_inst(&priv->event_source_genl);
     nm_clear_g_source_inst(&priv->event_source_rtnl);
+    nm_clear_g_source_inst(&priv->resync_x[NMP_NETLINK_GENERIC].timeout_source);
+    nm_clear_g_source_inst(&priv->resync_x[NMP_NETLINK_ROUTE].timeout_source);
+    nm_clear_g_source_inst(&priv->wireguard_refresh.source);
+    nm_clear_pointer(&priv->wireguard_refresh.ifindexes, g_array_unref);
+    nm_clear_pointer(&priv->link_stats_ifindexes, g_hash_table_unref);
+
+    nm_assert(!priv->sysctl_writes.flush_source);
+    nm_clear_g_source_inst(&priv->sysctl_writes.clear_source);
+    nm_clear_pointer(&priv->sysctl_writes.written, g_hash_table_unref);
+    nm_clear_pointer(&priv->sysctl_writes.pending, g_hash_table_unref);
+    if (priv->sysctl_writes.pool)
+        g_thread_pool_free(priv->sysctl_writes.pool, TRUE, FALSE);
 
     nl_socket_free(priv->sk_genl_sync);
     nl_socket_free(priv->sk_genl);
@@ -12111,7 +14934,8 @@ nm_linux_platform_class_init(NMLinuxPlatformClass *klass)
 
     platform_class->link_change = link_change;
 
-    platform_class->link_refresh = link_refresh;
+    platform_class->link_refresh       = link_refresh;
+    platform_class->link_refresh_stats = link_refresh_stats;
 
     platform_class->link_set_netns = link_set_netns;
 
@@ -12128,6 +14952,7 @@ nm_linux_platform_class_init(NMLinuxPlatformClass *klass)
     platform_class->link_set_sriov_vfs                 = link_set_sriov_vfs;
     platform_class->link_set_bridge_vlans              = link_set_bridge_vlans;
     platform_class->link_get_bridge_vlans              = link_get_bridge_vlans;
+    platform_class->link_del_bridge_vlans              = link_del_bridge_vlans;
     platform_class->link_set_bridge_info               = link_set_bridge_info;
 
     platform_class->link_get_physical_port_id = link_get_physical_port_id;
@@ -12179,17 +15004,25 @@ nm_linux_platform_class_init(NMLinuxPlatformClass *klass)
     platform_class->ip4_address_delete = ip4_address_delete;
     platform_class->ip6_address_delete = ip6_address_delete;
 
-    platform_class->ip_route_add = ip_route_add;
-    platform_class->ip_route_get = ip_route_get;
+    platform_class->ip_route_add   = ip_route_add;
+    platform_class->ip_route_batch = ip_route_batch;
+    platform_class->ip_route_get   = ip_route_get;
 
-    platform_class->routing_rule_add = routing_rule_add;
+    platform_class->routing_rule_add   = routing_rule_add;
+    platform_class->routing_rule_batch = ip_route_batch;
 
     platform_class->qdisc_add      = qdisc_add;
     platform_class->qdisc_delete   = qdisc_delete;
     platform_class->tfilter_add    = tfilter_add;
     platform_class->tfilter_delete = tfilter_delete;
+    platform_class->tc_batch       = tc_batch;
+
+    platform_class->refresh_all       = refresh_all;
+    platform_class->process_events    = process_events;
+    platform_class->netlink_stats_get = netlink_stats_get;
+    platform_class->sysctl_stats_get  = sysctl_stats_get;
 
-    platform_class->process_events = process_events;
+    platform_class->netlink_set_parse_thread = netlink_set_parse_thread;
 
     platform_class->genl_get_family_id = genl_get_family_id;
     platform_class->mptcp_addr_update  = mptcp_addr_update;
@@ -1063,6 +1063,41 @@ nl_socket_set_buffer_size(struct nl_sock *sk, int rxbuf, int txbuf)
     return 0;
 }
 
+/* Unlike SO_RCVBUF, SO_RCVBUFFORCE is not limited by net.core.rmem_max. It
+ * requires CAP_NET_ADMIN, without that fall back to SO_RCVBUF. */
+int
+nl_socket_set_rcvbuf_force(struct nl_sock *sk, int rxbuf)
+{
+    nm_assert_sk(sk);
+    nm_assert(rxbuf > 0);
+
+    if (setsockopt(sk->s_fd, SOL_SOCKET, SO_RCVBUFFORCE, &rxbuf, sizeof(rxbuf)) == 0)
+        return 0;
+    if (errno != EPERM)
+        return -nm_errno_from_native(errno);
+
+    if (setsockopt(sk->s_fd, SOL_SOCKET, SO_RCVBUF, &rxbuf, sizeof(rxbuf)) < 0)
+        return -nm_errno_from_native(errno);
+
+    return 0;
+}
+
+/* Returns the size of the receive buffer as the kernel reports it. That
+ * includes the bookkeeping overhead, so it is twice what was requested. */
+int
+nl_socket_get_rcvbuf(const struct nl_sock *sk)
+{
+    socklen_t len = sizeof(int);
+    int       rxbuf;
+
+    nm_assert_sk(sk);
+
+    if (getsockopt(sk->s_fd, SOL_SOCKET, SO_RCVBUF, &rxbuf, &len) < 0)
+        return -nm_errno_from_native(errno);
+
+    return rxbuf;
+}
+
 int
 nl_socket_add_memberships(struct nl_sock *sk, int group, ...)
 {
@@ -602,6 +602,10 @@ int    nl_socket_set_msg_buf_size(struct nl_sock *sk, size_t bufsize);
 
 int nl_socket_set_buffer_size(struct nl_sock *sk, int rxbuf, int txbuf);
 
+int nl_socket_set_rcvbuf_force(struct nl_sock *sk, int rxbuf);
+
+int nl_socket_get_rcvbuf(const struct nl_sock *sk);
+
 int nl_socket_set_passcred(struct nl_sock *sk, int state);
 
 int nl_socket_set_pktinfo(struct nl_sock *sk, int state);
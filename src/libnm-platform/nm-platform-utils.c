@@ -2338,29 +2338,130 @@ void
 nmp_utils_bridge_vlan_normalize(NMPlatformBridgeVlan *vlans, guint *num_vlans)
 {
     guint i;
+    guint j;
 
     if (*num_vlans <= 1)
         return;
 
     g_qsort_with_data(vlans, *num_vlans, sizeof(NMPlatformBridgeVlan), bridge_vlan_compare, NULL);
 
-    /* Merge VLAN ranges that are contiguous or overlap */
-    i = 0;
-    while (i < *num_vlans - 1) {
-        guint    j         = i + 1;
-        gboolean can_merge = vlans[j].vid_start <= vlans[i].vid_end + 1
-                             && vlans[j].pvid == vlans[i].pvid
-                             && vlans[j].untagged == vlans[i].untagged;
-
-        if (can_merge) {
-            vlans[i].vid_end = NM_MAX(vlans[i].vid_end, vlans[j].vid_end);
-            for (; j < *num_vlans - 1; j++)
-                vlans[j] = vlans[j + 1];
-            *num_vlans -= 1;
-        } else {
-            i++;
+    /* Merge VLAN ranges that are contiguous or overlap. The array is compacted
+     * in one pass, as there might be thousands of single VLANs. */
+    j = 0;
+    for (i = 1; i < *num_vlans; i++) {
+        NMPlatformBridgeVlan *prev      = &vlans[j];
+        gboolean              can_merge = vlans[i].vid_start <= prev->vid_end + 1
+                                          && vlans[i].pvid == prev->pvid
+                                          && vlans[i].untagged == prev->untagged;
+
+        if (can_merge)
+            prev->vid_end = NM_MAX(prev->vid_end, vlans[i].vid_end);
+        else
+            vlans[++j] = vlans[i];
+    }
+    *num_vlans = j + 1;
+}
+
+#define BRIDGE_VLAN_STATE_PRESENT  0x1u
+#define BRIDGE_VLAN_STATE_PVID     0x2u
+#define BRIDGE_VLAN_STATE_UNTAGGED 0x4u
+
+static void
+_bridge_vlan_states_fill(guint8 *states, const NMPlatformBridgeVlan *vlans, guint num_vlans)
+{
+    guint i;
+    guint vid;
+
+    for (i = 0; i < num_vlans; i++) {
+        const NMPlatformBridgeVlan *vlan  = &vlans[i];
+        guint8                      state = BRIDGE_VLAN_STATE_PRESENT;
+
+        if (vlan->pvid)
+            state |= BRIDGE_VLAN_STATE_PVID;
+        if (vlan->untagged)
+            state |= BRIDGE_VLAN_STATE_UNTAGGED;
+
+        for (vid = NM_MAX(vlan->vid_start, 1u); vid <= NM_MIN(vlan->vid_end, 4094u); vid++)
+            states[vid] = state;
+    }
+}
+
+static void
+_bridge_vlan_ranges_append(GArray **p_arr, guint vid, guint8 state)
+{
+    const gboolean        pvid     = NM_FLAGS_HAS(state, BRIDGE_VLAN_STATE_PVID);
+    const gboolean        untagged = NM_FLAGS_HAS(state, BRIDGE_VLAN_STATE_UNTAGGED);
+    NMPlatformBridgeVlan *last;
+
+    if (!*p_arr)
+        *p_arr = g_array_new(FALSE, FALSE, sizeof(NMPlatformBridgeVlan));
+
+    /* The kernel does not accept the PVID flag on a range. */
+    if ((*p_arr)->len > 0 && !pvid) {
+        last = &nm_g_array_last(*p_arr, NMPlatformBridgeVlan);
+        if (!last->pvid && last->untagged == untagged && last->vid_end + 1u == vid) {
+            last->vid_end = vid;
+            return;
         }
     }
+
+    g_array_append_val(*p_arr,
+                       ((NMPlatformBridgeVlan) {
+                           .vid_start = vid,
+                           .vid_end   = vid,
+                           .pvid      = pvid,
+                           .untagged  = untagged,
+                       }));
+}
+
+/**
+ * nmp_utils_bridge_vlan_diff:
+ * @vlans_old: the current bridge VLANs
+ * @num_vlans_old: the number of elements of @vlans_old
+ * @vlans_new: the requested bridge VLANs
+ * @num_vlans_new: the number of elements of @vlans_new
+ * @out_vlans_del: (out) (transfer full): the VLANs to delete
+ * @out_num_vlans_del: (out): the number of elements of @out_vlans_del
+ * @out_vlans_add: (out) (transfer full): the VLANs to add
+ * @out_num_vlans_add: (out): the number of elements of @out_vlans_add
+ *
+ * Compute which VLANs must be deleted and added, to get from @vlans_old
+ * to @vlans_new. Adding a VLAN that already exists updates its flags, so a
+ * VLAN with different flags is only added. The result is merged into
+ * ranges. The input arrays don't need to be normalized.
+ */
+void
+nmp_utils_bridge_vlan_diff(const NMPlatformBridgeVlan *vlans_old,
+                           guint                       num_vlans_old,
+                           const NMPlatformBridgeVlan *vlans_new,
+                           guint                       num_vlans_new,
+                           NMPlatformBridgeVlan      **out_vlans_del,
+                           guint                      *out_num_vlans_del,
+                           NMPlatformBridgeVlan      **out_vlans_add,
+                           guint                      *out_num_vlans_add)
+{
+    guint8  states_old[4095] = {};
+    guint8  states_new[4095] = {};
+    GArray *arr_del          = NULL;
+    GArray *arr_add          = NULL;
+    guint   vid;
+
+    _bridge_vlan_states_fill(states_old, vlans_old, num_vlans_old);
+    _bridge_vlan_states_fill(states_new, vlans_new, num_vlans_new);
+
+    for (vid = 1; vid <= 4094u; vid++) {
+        if (states_old[vid] == states_new[vid])
+            continue;
+        if (states_new[vid] == 0)
+            _bridge_vlan_ranges_append(&arr_del, vid, 0);
+        else
+            _bridge_vlan_ranges_append(&arr_add, vid, states_new[vid]);
+    }
+
+    *out_num_vlans_del = arr_del ? arr_del->len : 0u;
+    *out_vlans_del     = arr_del ? (NMPlatformBridgeVlan *) g_array_free(arr_del, FALSE) : NULL;
+    *out_num_vlans_add = arr_add ? arr_add->len : 0u;
+    *out_vlans_add     = arr_add ? (NMPlatformBridgeVlan *) g_array_free(arr_add, FALSE) : NULL;
 }
 
 /**
@@ -105,6 +105,15 @@ int nmp_utils_modprobe(GError **error, gboolean suppress_error_logging, const ch
 
 void nmp_utils_bridge_vlan_normalize(NMPlatformBridgeVlan *vlans, guint *num_vlans);
 
+void nmp_utils_bridge_vlan_diff(const NMPlatformBridgeVlan *vlans_old,
+                                guint                       num_vlans_old,
+                                const NMPlatformBridgeVlan *vlans_new,
+                                guint                       num_vlans_new,
+                                NMPlatformBridgeVlan      **out_vlans_del,
+                                guint                      *out_num_vlans_del,
+                                NMPlatformBridgeVlan      **out_vlans_add,
+                                guint                      *out_num_vlans_add);
+
 gboolean nmp_utils_bridge_normalized_vlans_equal(const NMPlatformBridgeVlan *vlans_a,
                                                  guint                       num_vlans_a,
                                                  const NMPlatformBridgeVlan *vlans_b,
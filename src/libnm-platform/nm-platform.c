@@ -246,6 +246,23 @@ typedef struct _NMPlatformPrivate {
     CList              ip6_dadfailed_lst_head;
     NMDedupMultiIndex *multi_idx;
     NMPCache          *cache;
+
+    /* If set, only routes in these tables are tracked in the cache. */
+    GArray *route_table_filter;
+
+    /* Tables outside of route_table_filter where we added routes ourselves.
+     * We must track them too, otherwise we could never remove these routes. */
+    GArray *route_tables_auto;
+
+    /* The union of route_table_filter and route_tables_auto, or %NULL to track
+     * all tables. It is never modified, only replaced. See
+     * nm_platform_route_table_filter_ref(). */
+    GArray *route_tables_tracked;
+
+    /* The links whose statistics get refreshed periodically, see
+     * nm_platform_link_stats_set_refresh(). */
+    GHashTable *link_stats_hash;
+    GSource    *link_stats_source;
 } NMPlatformPrivate;
 
 G_DEFINE_TYPE(NMPlatform, nm_platform, G_TYPE_OBJECT)
@@ -276,6 +293,174 @@ nm_platform_get_cache_tc(NMPlatform *self)
     return NM_PLATFORM_GET_PRIVATE(self)->cache_tc;
 }
 
+static void
+_route_tables_tracked_update(NMPlatform *self)
+{
+    NMPlatformPrivate *priv    = NM_PLATFORM_GET_PRIVATE(self);
+    GArray            *tracked = NULL;
+    guint              i;
+
+    if (priv->route_table_filter) {
+        tracked = g_array_sized_new(FALSE,
+                                    FALSE,
+                                    sizeof(NMPlatformRouteTableRange),
+                                    priv->route_table_filter->len
+                                        + nm_g_array_len(priv->route_tables_auto));
+        g_array_append_vals(tracked, priv->route_table_filter->data, priv->route_table_filter->len);
+        for (i = 0; i < nm_g_array_len(priv->route_tables_auto); i++) {
+            NMPlatformRouteTableRange r;
+
+            r.table_from = nm_g_array_index(priv->route_tables_auto, guint32, i);
+            r.table_to   = r.table_from;
+            g_array_append_val(tracked, r);
+        }
+    }
+
+    /* Don't modify the old array, other threads might still use it. */
+    nm_clear_pointer(&priv->route_tables_tracked, g_array_unref);
+    priv->route_tables_tracked = tracked;
+}
+
+/**
+ * nm_platform_set_route_table_filter:
+ * @self: the #NMPlatform instance
+ * @ranges: (nullable): the route table ranges to track.
+ * @n_ranges: the number of elements in @ranges. If zero,
+ *   the filter is cleared and routes of all tables are tracked.
+ *
+ * Restricts the routes that the platform cache tracks to the ones in
+ * the given tables. The platform implementation drops routes of other
+ * tables while parsing the netlink messages, which avoids the overhead
+ * of caching routes that NetworkManager does not care about (for example,
+ * full BGP feeds in separate tables).
+ *
+ * The main and local tables are always tracked. So are the tables where
+ * NetworkManager adds routes via nm_platform_ip_route_add() or
+ * nm_platform_ip_route_sync(), even if they are not in @ranges. Otherwise
+ * these routes would be invisible to nm_platform_ip_route_sync() and
+ * nm_platform_ip_route_get_prune_list(), and never removed.
+ *
+ * Changing the filter triggers a resync of the routes.
+ */
+void
+nm_platform_set_route_table_filter(NMPlatform                      *self,
+                                   const NMPlatformRouteTableRange *ranges,
+                                   guint                            n_ranges)
+{
+    NMPlatformPrivate *priv;
+
+    _CHECK_SELF_VOID(self, klass);
+
+    priv = NM_PLATFORM_GET_PRIVATE(self);
+
+    if (n_ranges == 0) {
+        if (!priv->route_table_filter)
+            return;
+        nm_clear_pointer(&priv->route_table_filter, g_array_unref);
+    } else {
+        if (priv->route_table_filter && priv->route_table_filter->len == n_ranges
+            && memcmp(priv->route_table_filter->data,
+                      ranges,
+                      sizeof(NMPlatformRouteTableRange) * n_ranges)
+                   == 0)
+            return;
+        if (!priv->route_table_filter) {
+            priv->route_table_filter =
+                g_array_sized_new(FALSE, FALSE, sizeof(NMPlatformRouteTableRange), n_ranges);
+        } else
+            g_array_set_size(priv->route_table_filter, 0);
+        g_array_append_vals(priv->route_table_filter, ranges, n_ranges);
+    }
+
+    _route_tables_tracked_update(self);
+
+    if (klass->refresh_all) {
+        klass->refresh_all(self, NMP_OBJECT_TYPE_IP4_ROUTE);
+        klass->refresh_all(self, NMP_OBJECT_TYPE_IP6_ROUTE);
+    }
+}
+
+/**
+ * nm_platform_route_table_filter_ref:
+ * @self: the #NMPlatform instance
+ *
+ * Returns: (transfer full) (nullable): the ranges of the route tables that
+ *   are currently tracked, for nm_platform_route_table_filter_has(). %NULL
+ *   means that all tables are tracked. The array is never modified, when
+ *   the tracked tables change it gets replaced. So the caller can pass it on
+ *   to another thread, which uses it without locking.
+ */
+GArray *
+nm_platform_route_table_filter_ref(NMPlatform *self)
+{
+    NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE(self);
+
+    return priv->route_tables_tracked ? g_array_ref(priv->route_tables_tracked) : NULL;
+}
+
+/**
+ * nm_platform_route_table_filter_has:
+ * @filter: (nullable): the ranges from nm_platform_route_table_filter_ref().
+ * @table: the route table.
+ *
+ * Returns: whether @table is tracked according to @filter.
+ *   Unlike nm_platform_route_table_is_tracked(), this can be called
+ *   from any thread.
+ */
+gboolean
+nm_platform_route_table_filter_has(const GArray *filter, guint32 table)
+{
+    guint i;
+
+    if (G_LIKELY(!filter))
+        return TRUE;
+
+    if (NM_IN_SET(table, RT_TABLE_UNSPEC, RT_TABLE_MAIN, RT_TABLE_LOCAL))
+        return TRUE;
+
+    for (i = 0; i < filter->len; i++) {
+        const NMPlatformRouteTableRange *r =
+            &nm_g_array_index(filter, NMPlatformRouteTableRange, i);
+
+        if (table >= r->table_from && table <= r->table_to)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+nm_platform_route_table_is_tracked(NMPlatform *self, guint32 table)
+{
+    return nm_platform_route_table_filter_has(NM_PLATFORM_GET_PRIVATE(self)->route_tables_tracked,
+                                              table);
+}
+
+static void
+_route_table_ensure_tracked(NMPlatform *self, guint32 table)
+{
+    NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE(self);
+    NMPlatformClass   *klass;
+
+    if (nm_platform_route_table_is_tracked(self, table))
+        return;
+
+    if (!priv->route_tables_auto)
+        priv->route_tables_auto = g_array_new(FALSE, FALSE, sizeof(guint32));
+    g_array_append_val(priv->route_tables_auto, table);
+    _route_tables_tracked_update(self);
+
+    _LOGI("route: start tracking route table %u, which is not in the route table filter but "
+          "has routes configured by NetworkManager",
+          table);
+
+    /* Pick up the routes that are already in the table. */
+    klass = NM_PLATFORM_GET_CLASS(self);
+    if (klass->refresh_all) {
+        klass->refresh_all(self, NMP_OBJECT_TYPE_IP4_ROUTE);
+        klass->refresh_all(self, NMP_OBJECT_TYPE_IP6_ROUTE);
+    }
+}
+
 /*****************************************************************************/
 
 guint
@@ -525,6 +710,87 @@ out:
 
 /*****************************************************************************/
 
+NM_UTILS_LOOKUP_STR_DEFINE(nm_platform_netlink_msg_kind_to_string,
+                           NMPlatformNetlinkMsgKind,
+                           NM_UTILS_LOOKUP_DEFAULT_NM_ASSERT(NULL),
+                           NM_UTILS_LOOKUP_ITEM(NM_PLATFORM_NETLINK_MSG_KIND_LINK, "link"),
+                           NM_UTILS_LOOKUP_ITEM(NM_PLATFORM_NETLINK_MSG_KIND_ADDRESS, "address"),
+                           NM_UTILS_LOOKUP_ITEM(NM_PLATFORM_NETLINK_MSG_KIND_ROUTE, "route"),
+                           NM_UTILS_LOOKUP_ITEM(NM_PLATFORM_NETLINK_MSG_KIND_RULE, "rule"),
+                           NM_UTILS_LOOKUP_ITEM(NM_PLATFORM_NETLINK_MSG_KIND_QDISC, "qdisc"),
+                           NM_UTILS_LOOKUP_ITEM(NM_PLATFORM_NETLINK_MSG_KIND_TFILTER, "tfilter"),
+                           NM_UTILS_LOOKUP_ITEM(NM_PLATFORM_NETLINK_MSG_KIND_GENL, "genl"),
+                           NM_UTILS_LOOKUP_ITEM(NM_PLATFORM_NETLINK_MSG_KIND_OTHER, "other"),
+                           NM_UTILS_LOOKUP_ITEM_IGNORE(_NM_PLATFORM_NETLINK_MSG_KIND_NUM), );
+
+/**
+ * nm_platform_netlink_stats_get:
+ * @self: the #NMPlatform instance
+ * @out_stats: (out): the statistics
+ *
+ * Returns: %TRUE, if the platform implementation supports netlink
+ *   statistics and @out_stats was set. Otherwise, @out_stats is
+ *   zeroed.
+ */
+gboolean
+nm_platform_netlink_stats_get(NMPlatform *self, NMPlatformNetlinkStats *out_stats)
+{
+    _CHECK_SELF(self, klass, FALSE);
+
+    g_return_val_if_fail(out_stats, FALSE);
+
+    if (!klass->netlink_stats_get) {
+        *out_stats = (NMPlatformNetlinkStats){};
+        return FALSE;
+    }
+    return klass->netlink_stats_get(self, out_stats);
+}
+
+/**
+ * nm_platform_sysctl_stats_get:
+ * @self: the #NMPlatform instance
+ * @out_stats: (out): the statistics
+ *
+ * Returns: %TRUE, if the platform implementation supports sysctl
+ *   statistics and @out_stats was set. Otherwise, @out_stats is
+ *   zeroed.
+ */
+gboolean
+nm_platform_sysctl_stats_get(NMPlatform *self, NMPlatformSysctlStats *out_stats)
+{
+    _CHECK_SELF(self, klass, FALSE);
+
+    g_return_val_if_fail(out_stats, FALSE);
+
+    if (!klass->sysctl_stats_get) {
+        *out_stats = (NMPlatformSysctlStats){};
+        return FALSE;
+    }
+    return klass->sysctl_stats_get(self, out_stats);
+}
+
+/**
+ * nm_platform_netlink_set_parse_thread:
+ * @self: the #NMPlatform instance
+ * @enabled: whether to parse netlink messages on a worker thread
+ *
+ * With many address and route events, parsing the netlink messages takes
+ * a considerable part of the time spent in the main loop. When enabled,
+ * the parsing is offloaded to a worker thread and only the resulting
+ * objects are merged into the cache on the main thread. Events are still
+ * applied in the order in which they were received.
+ *
+ * This is a no-op for platform implementations that don't support it.
+ */
+void
+nm_platform_netlink_set_parse_thread(NMPlatform *self, gboolean enabled)
+{
+    _CHECK_SELF_VOID(self, klass);
+
+    if (klass->netlink_set_parse_thread)
+        klass->netlink_set_parse_thread(self, enabled);
+}
+
 /**
  * nm_platform_process_events:
  * @self: platform instance
@@ -1752,6 +2018,152 @@ nm_platform_link_refresh(NMPlatform *self, int ifindex)
     return TRUE;
 }
 
+/*****************************************************************************/
+
+typedef struct {
+    /* must be the first field, the hash table hashes by it. */
+    gconstpointer user_tag;
+    gint64        next_ms;
+    guint         refresh_rate_ms;
+    int           ifindex;
+} LinkStatsData;
+
+static gint64
+_link_stats_next_ms(gint64 now_ms, guint refresh_rate_ms)
+{
+    /* Align the refresh on multiples of the refresh rate. That way, all links with
+     * the same rate are due at the same time and get refreshed with one request. */
+    return ((now_ms / refresh_rate_ms) + 1) * refresh_rate_ms;
+}
+
+static gboolean _link_stats_timeout_cb(gpointer user_data);
+
+static void
+_link_stats_schedule(NMPlatform *self)
+{
+    NMPlatformPrivate *priv    = NM_PLATFORM_GET_PRIVATE(self);
+    gint64             next_ms = G_MAXINT64;
+    GHashTableIter     iter;
+    LinkStatsData     *data;
+    gint64             now_ms;
+
+    nm_clear_g_source_inst(&priv->link_stats_source);
+
+    if (!priv->link_stats_hash || g_hash_table_size(priv->link_stats_hash) == 0)
+        return;
+
+    g_hash_table_iter_init(&iter, priv->link_stats_hash);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &data, NULL))
+        next_ms = MIN(next_ms, data->next_ms);
+
+    now_ms = nm_utils_get_monotonic_timestamp_msec();
+    priv->link_stats_source =
+        nm_g_timeout_add_source(next_ms > now_ms ? (guint) (next_ms - now_ms) : 0u,
+                                _link_stats_timeout_cb,
+                                self);
+}
+
+static gboolean
+_link_stats_timeout_cb(gpointer user_data)
+{
+    NMPlatform            *self      = user_data;
+    NMPlatformClass       *klass     = NM_PLATFORM_GET_CLASS(self);
+    NMPlatformPrivate     *priv      = NM_PLATFORM_GET_PRIVATE(self);
+    gs_unref_array GArray *ifindexes = NULL;
+    GHashTableIter         iter;
+    LinkStatsData         *data;
+    gint64                 now_ms;
+    guint                  i;
+
+    nm_clear_g_source_inst(&priv->link_stats_source);
+
+    now_ms    = nm_utils_get_monotonic_timestamp_msec();
+    ifindexes = g_array_new(FALSE, FALSE, sizeof(int));
+
+    g_hash_table_iter_init(&iter, priv->link_stats_hash);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &data, NULL)) {
+        if (data->next_ms > now_ms)
+            continue;
+        data->next_ms = _link_stats_next_ms(MAX(now_ms, data->next_ms), data->refresh_rate_ms);
+        g_array_append_val(ifindexes, data->ifindex);
+    }
+
+    if (ifindexes->len > 0) {
+        _LOGT("link: refresh statistics of %u links", ifindexes->len);
+
+        if (klass->link_refresh_stats) {
+            klass->link_refresh_stats(self, nm_g_array_first_p(ifindexes, int), ifindexes->len);
+        } else {
+            for (i = 0; i < ifindexes->len; i++)
+                nm_platform_link_refresh(self, nm_g_array_index(ifindexes, int, i));
+        }
+    }
+
+    _link_stats_schedule(self);
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * nm_platform_link_stats_set_refresh:
+ * @self: platform instance
+ * @user_tag: identifies the caller. Each user tag has one registration.
+ * @ifindex: the link whose statistics to refresh.
+ * @refresh_rate_ms: the interval for refreshing the statistics. Zero
+ *   (or a non-positive @ifindex) removes the registration of @user_tag.
+ *
+ * Periodically refresh the statistics of the link in the cache. The
+ * statistics of all links that are due at the same time are refreshed
+ * together, with one request.
+ */
+void
+nm_platform_link_stats_set_refresh(NMPlatform   *self,
+                                   gconstpointer user_tag,
+                                   int           ifindex,
+                                   guint         refresh_rate_ms)
+{
+    NMPlatformPrivate *priv;
+    LinkStatsData     *data;
+
+    _CHECK_SELF_VOID(self, klass);
+
+    nm_assert(user_tag);
+
+    priv = NM_PLATFORM_GET_PRIVATE(self);
+
+    data = priv->link_stats_hash ? g_hash_table_lookup(priv->link_stats_hash, &user_tag) : NULL;
+
+    if (ifindex <= 0 || refresh_rate_ms == 0) {
+        if (!data)
+            return;
+        g_hash_table_remove(priv->link_stats_hash, data);
+        _link_stats_schedule(self);
+        return;
+    }
+
+    if (data && data->ifindex == ifindex && data->refresh_rate_ms == refresh_rate_ms)
+        return;
+
+    if (!data) {
+        if (!priv->link_stats_hash) {
+            priv->link_stats_hash = g_hash_table_new_full(nm_pdirect_hash,
+                                                          nm_pdirect_equal,
+                                                          nm_g_slice_free_fcn(LinkStatsData),
+                                                          NULL);
+        }
+        data  = g_slice_new(LinkStatsData);
+        *data = (LinkStatsData) {
+            .user_tag = user_tag,
+        };
+        g_hash_table_add(priv->link_stats_hash, data);
+    }
+
+    data->ifindex         = ifindex;
+    data->refresh_rate_ms = refresh_rate_ms;
+    data->next_ms = _link_stats_next_ms(nm_utils_get_monotonic_timestamp_msec(), refresh_rate_ms);
+
+    _link_stats_schedule(self);
+}
+
 int
 nm_platform_link_get_ifi_flags(NMPlatform *self, int ifindex, guint requested_flags)
 {
@@ -2139,6 +2551,80 @@ nm_platform_link_get_bridge_vlans(NMPlatform            *self,
     return ret;
 }
 
+/**
+ * nm_platform_link_sync_bridge_vlans:
+ * @self: the #NMPlatform
+ * @ifindex: the ifindex of the bridge or the port
+ * @on_controller: whether to configure the VLANs of a port on the controller
+ * @vlans: the VLANs that should be configured
+ * @num_vlans: the number of elements of @vlans
+ *
+ * Configures the bridge VLANs like a flush followed by
+ * nm_platform_link_set_bridge_vlans(), but only sends the difference to the
+ * VLANs that are currently configured. Contiguous VLANs are sent as ranges, so
+ * that even 4094 VLANs need only few netlink messages. Unlike a flush, the
+ * VLANs that don't change are never removed, so traffic on them is not
+ * interrupted.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+nm_platform_link_sync_bridge_vlans(NMPlatform                 *self,
+                                   int                         ifindex,
+                                   gboolean                    on_controller,
+                                   const NMPlatformBridgeVlan *vlans,
+                                   guint                       num_vlans)
+{
+    gs_free NMPlatformBridgeVlan *vlans_old = NULL;
+    gs_free NMPlatformBridgeVlan *vlans_del = NULL;
+    gs_free NMPlatformBridgeVlan *vlans_add = NULL;
+    guint                         num_vlans_old;
+    guint                         num_vlans_del;
+    guint                         num_vlans_add;
+
+    _CHECK_SELF(self, klass, FALSE);
+
+    g_return_val_if_fail(ifindex > 0, FALSE);
+    g_return_val_if_fail(num_vlans == 0 || vlans, FALSE);
+
+    if (!klass->link_del_bridge_vlans
+        || !nm_platform_link_get_bridge_vlans(self, ifindex, &vlans_old, &num_vlans_old)) {
+        if (!nm_platform_link_set_bridge_vlans(self, ifindex, on_controller, NULL, 0))
+            return FALSE;
+        if (num_vlans == 0)
+            return TRUE;
+        return nm_platform_link_set_bridge_vlans(self, ifindex, on_controller, vlans, num_vlans);
+    }
+
+    nmp_utils_bridge_vlan_diff(vlans_old,
+                               num_vlans_old,
+                               vlans,
+                               num_vlans,
+                               &vlans_del,
+                               &num_vlans_del,
+                               &vlans_add,
+                               &num_vlans_add);
+
+    _LOG3D("link: sync bridge VLANs on %s: %u ranges to delete, %u ranges to add",
+           on_controller ? "controller" : "self",
+           num_vlans_del,
+           num_vlans_add);
+
+    if (num_vlans_del > 0
+        && !klass->link_del_bridge_vlans(self, ifindex, on_controller, vlans_del, num_vlans_del))
+        return FALSE;
+
+    if (num_vlans_add > 0
+        && !nm_platform_link_set_bridge_vlans(self,
+                                              ifindex,
+                                              on_controller,
+                                              vlans_add,
+                                              num_vlans_add))
+        return FALSE;
+
+    return TRUE;
+}
+
 gboolean
 nm_platform_link_set_bridge_info(NMPlatform                            *self,
                                  int                                    ifindex,
@@ -2691,7 +3177,8 @@ static NM_UTILS_FLAGS2STR_DEFINE(
     NM_UTILS_FLAGS2STR(NM_PLATFORM_WIREGUARD_CHANGE_FLAG_REPLACE_PEERS, "replace-peers"),
     NM_UTILS_FLAGS2STR(NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_PRIVATE_KEY, "has-private-key"),
     NM_UTILS_FLAGS2STR(NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT, "has-listen-port"),
-    NM_UTILS_FLAGS2STR(NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK, "has-fwmark"), );
+    NM_UTILS_FLAGS2STR(NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK, "has-fwmark"),
+    NM_UTILS_FLAGS2STR(NM_PLATFORM_WIREGUARD_CHANGE_FLAG_SYNC_PEERS, "sync-peers"), );
 
 static NM_UTILS_FLAGS2STR_DEFINE(
     _wireguard_change_peer_flags_to_string,
@@ -5117,60 +5604,190 @@ nm_platform_ip_route_get_prune_list(NMPlatform            *self,
     return routes_prune;
 }
 
-/**
- * nm_platform_ip_route_sync:
- * @self: the #NMPlatform instance.
- * @addr_family: AF_INET or AF_INET6.
- * @ifindex: the @ifindex for which the routes are to be added.
- * @routes: (nullable): a list of routes to configure. Must contain
- *   NMPObject instances of routes, according to @addr_family.
- * @routes_prune: (nullable): the list of routes to delete.
- *   If platform has such a route configured, it will be deleted
- *   at the end of the operation. Note that if @routes contains
- *   the same route, then it will not be deleted. @routes overrules
- *   @routes_prune list.
- * @out_routes_failed: (out) (optional) (nullable): routes that could
- *   not be synced/added.
- *
- * Returns: %TRUE on success.
- */
-gboolean
-nm_platform_ip_route_sync(NMPlatform *self,
-                          int         addr_family,
-                          int         ifindex,
-                          GPtrArray  *routes,
-                          GPtrArray  *routes_prune,
-                          GPtrArray **out_routes_failed)
+/* How many route operations are passed at once to NMPlatformClass.ip_route_batch().
+ * The implementation sends them without waiting for the individual ACKs,
+ * so this limits the number of requests that are in flight. */
+#define IP_ROUTE_BATCH_SIZE 256u
+
+static void
+_ip_route_batch_op_clear(gpointer data)
 {
-    const int                      IS_IPv4 = NM_IS_IPv4(addr_family);
-    const NMPlatformVTableRoute   *vt;
-    gs_unref_hashtable GHashTable *routes_idx = NULL;
-    const NMPObject               *conf_o;
-    const NMDedupMultiEntry       *plat_entry;
-    guint                          i;
-    int                            i_type;
-    gboolean                       success = TRUE;
-    char                           sbuf1[NM_UTILS_TO_STRING_BUFFER_SIZE];
-    char                           sbuf2[NM_UTILS_TO_STRING_BUFFER_SIZE];
+    NMPlatformIPRouteBatchOp *op = data;
 
-    nm_assert(NM_IS_PLATFORM(self));
-    nm_assert(ifindex > 0);
+    nm_clear_nmp_object(&op->obj);
+    nm_clear_g_free(&op->extack_msg);
+}
 
-    vt = &nm_platform_vtable_route.vx[IS_IPv4];
+static void
+_ip_route_batch_append(GArray **p_ops, const NMPObject *obj, gboolean is_delete)
+{
+    NMPlatformIPRouteBatchOp *op;
 
-    for (i_type = 0; routes && i_type < 2; i_type++) {
-        for (i = 0; i < routes->len; i++) {
-            gs_free char *extack_msg = NULL;
-            int           r;
+    if (!*p_ops) {
+        *p_ops = g_array_new(FALSE, FALSE, sizeof(NMPlatformIPRouteBatchOp));
+        g_array_set_clear_func(*p_ops, _ip_route_batch_op_clear);
+    }
 
-            conf_o = routes->pdata[i];
+    op  = nm_g_array_append_new(*p_ops, NMPlatformIPRouteBatchOp);
+    *op = (NMPlatformIPRouteBatchOp){
+        .obj        = nmp_object_ref(obj),
+        .flags      = NMP_NLM_FLAG_APPEND | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
+        .is_delete  = is_delete,
+        .result     = 0,
+        .extack_msg = NULL,
+    };
+}
 
-            /* User space cannot add IPv6 routes with metric 0. However, kernel can, and we might track such
-             * routes in @route as they are present external. As we already skipped external routes above,
-             * we don't expect a user's choice to add such a route (it won't work anyway). */
-            nm_assert(
-                IS_IPv4
-                || nm_platform_ip6_route_get_effective_metric(NMP_OBJECT_CAST_IP6_ROUTE(conf_o))
+static void
+_ip_route_batch_execute(NMPlatform *self, NMPlatformIPRouteBatchOp *const *ops, guint n_ops)
+{
+    char  sbuf[NM_UTILS_TO_STRING_BUFFER_SIZE];
+    guint i_start;
+    guint i;
+
+    _CHECK_SELF_VOID(self, klass);
+
+    if (!klass->ip_route_batch) {
+        for (i = 0; i < n_ops; i++) {
+            NMPlatformIPRouteBatchOp *op = ops[i];
+
+            if (op->is_delete)
+                op->result = nm_platform_object_delete(self, op->obj) ? 0 : -NME_PL_NETLINK;
+            else
+                op->result = nm_platform_ip_route_add(self, op->flags, op->obj, &op->extack_msg);
+        }
+        return;
+    }
+
+    for (i_start = 0; i_start < n_ops; i_start += IP_ROUTE_BATCH_SIZE) {
+        const guint n = NM_MIN(n_ops - i_start, IP_ROUTE_BATCH_SIZE);
+        gs_free NMPObject                *obj_stacks = g_new(NMPObject, n);
+        gs_free NMPlatformIPRouteBatchOp *batch_ops  = g_new(NMPlatformIPRouteBatchOp, n);
+
+        for (i = 0; i < n; i++) {
+            const NMPlatformIPRouteBatchOp *op        = ops[i_start + i];
+            NMPObject                      *obj_stack = &obj_stacks[i];
+            int        ifindex;
+
+            batch_ops[i] = (NMPlatformIPRouteBatchOp){
+                .obj        = op->obj,
+                .flags      = op->flags,
+                .is_delete  = op->is_delete,
+                .result     = 0,
+                .extack_msg = NULL,
+            };
+
+            ifindex = NMP_OBJECT_CAST_IP_ROUTE(op->obj)->ifindex;
+
+            if (op->is_delete) {
+                _LOG3D("%s: delete %s",
+                       NMP_OBJECT_GET_CLASS(op->obj)->obj_type_name,
+                       nmp_object_to_string(op->obj,
+                                            NMP_OBJECT_TO_STRING_PUBLIC,
+                                            sbuf,
+                                            sizeof(sbuf)));
+                continue;
+            }
+
+            /* Like nm_platform_ip_route_add(), pass on a normalized stack copy. The
+             * caller keeps @op->obj alive, so we can alias the extra_nexthops. */
+            nmp_object_stackinit(obj_stack, NMP_OBJECT_GET_TYPE(op->obj), &op->obj->ip_route);
+            if (NMP_OBJECT_GET_TYPE(op->obj) == NMP_OBJECT_TYPE_IP4_ROUTE
+                && op->obj->ip4_route.n_nexthops > 1u) {
+                nm_assert(op->obj->_ip4_route.extra_nexthops);
+                obj_stack->_ip4_route.extra_nexthops = op->obj->_ip4_route.extra_nexthops;
+            }
+            nm_platform_ip_route_normalize(NMP_OBJECT_GET_ADDR_FAMILY(obj_stack),
+                                           NMP_OBJECT_CAST_IP_ROUTE(obj_stack));
+            batch_ops[i].obj = obj_stack;
+
+            _LOG3D("route: %-10s IPv%c route: %s",
+                   _nmp_nlm_flag_to_string(op->flags & NMP_NLM_FLAG_FMASK),
+                   nm_utils_addr_family_to_char(NMP_OBJECT_GET_ADDR_FAMILY(obj_stack)),
+                   nmp_object_to_string(obj_stack,
+                                        NMP_OBJECT_TO_STRING_PUBLIC,
+                                        sbuf,
+                                        sizeof(sbuf)));
+        }
+
+        klass->ip_route_batch(self, batch_ops, n);
+
+        for (i = 0; i < n; i++) {
+            NMPlatformIPRouteBatchOp *op = ops[i_start + i];
+
+            op->result     = batch_ops[i].result;
+            op->extack_msg = g_steal_pointer(&batch_ops[i].extack_msg);
+        }
+    }
+}
+
+struct _NMPlatformIPRouteSync {
+    GArray *ops;
+    int     addr_family;
+    int     ifindex;
+    bool    executed : 1;
+};
+
+/**
+ * nm_platform_ip_route_sync_prepare:
+ * @self: the #NMPlatform instance.
+ * @addr_family: AF_INET or AF_INET6.
+ * @ifindex: the @ifindex for which the routes are to be added.
+ * @routes: (nullable): the routes to configure.
+ * @routes_prune: (nullable): the routes to delete.
+ *
+ * The first step of nm_platform_ip_route_sync(). It determines the necessary
+ * changes, based on the current platform cache. Call nm_platform_ip_route_sync_execute()
+ * and nm_platform_ip_route_sync_finish() afterwards. In between, the changes
+ * of several interfaces can be executed together.
+ *
+ * Returns: (transfer full) (nullable): the prepared changes or %NULL, if there
+ *   is nothing to do. Must be released with nm_platform_ip_route_sync_finish().
+ */
+NMPlatformIPRouteSync *
+nm_platform_ip_route_sync_prepare(NMPlatform *self,
+                                  int         addr_family,
+                                  int         ifindex,
+                                  GPtrArray  *routes,
+                                  GPtrArray  *routes_prune)
+{
+    const int                      IS_IPv4 = NM_IS_IPv4(addr_family);
+    const NMPlatformVTableRoute   *vt;
+    gs_unref_hashtable GHashTable *routes_idx = NULL;
+    GArray                        *ops        = NULL;
+    NMPlatformIPRouteSync         *sync;
+    const NMPObject               *conf_o;
+    const NMDedupMultiEntry       *plat_entry;
+    guint                          i;
+    int                            i_type;
+    char                           sbuf1[NM_UTILS_TO_STRING_BUFFER_SIZE];
+
+    nm_assert(NM_IS_PLATFORM(self));
+    nm_assert(ifindex > 0);
+
+    vt = &nm_platform_vtable_route.vx[IS_IPv4];
+
+    /* Like nm_platform_ip_route_add(), start tracking the tables that we are
+     * about to add routes to. Otherwise, the routes would never show up in the
+     * cache, and neither this function nor the prune list could see them. */
+    for (i = 0; routes && i < routes->len; i++) {
+        conf_o = routes->pdata[i];
+        _route_table_ensure_tracked(
+            self,
+            nm_platform_route_table_uncoerce(NMP_OBJECT_CAST_IP_ROUTE(conf_o)->table_coerced,
+                                             TRUE));
+    }
+
+    for (i_type = 0; routes && i_type < 2; i_type++) {
+        for (i = 0; i < routes->len; i++) {
+            conf_o = routes->pdata[i];
+
+            /* User space cannot add IPv6 routes with metric 0. However, kernel can, and we might track such
+             * routes in @route as they are present external. As we already skipped external routes above,
+             * we don't expect a user's choice to add such a route (it won't work anyway). */
+            nm_assert(
+                IS_IPv4
+                || nm_platform_ip6_route_get_effective_metric(NMP_OBJECT_CAST_IP6_ROUTE(conf_o))
                        != 0);
 
 #define VTABLE_IS_DEVICE_ROUTE(vt, o)                          \
@@ -5212,66 +5829,10 @@ nm_platform_ip_route_sync(NMPlatform *self,
 
                 /* we need to replace the existing route with a (slightly) different
                  * one. Delete it first. */
-                if (!nm_platform_object_delete(self, plat_o)) {
-                    /* ignore error. */
-                }
+                _ip_route_batch_append(&ops, plat_o, TRUE);
             }
 
-            r = nm_platform_ip_route_add(self,
-                                         NMP_NLM_FLAG_APPEND
-                                             | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
-                                         conf_o,
-                                         &extack_msg);
-            if (r == 0) {
-                /* success */
-            } else if (r == -EEXIST) {
-                /* Don't fail for EEXIST. It's not clear that the existing route
-                 * is identical to the one that we were about to add. However,
-                 * above we should have deleted conflicting (non-identical) routes. */
-                if (_LOGD_ENABLED()) {
-                    plat_entry =
-                        nm_platform_lookup_entry(self, NMP_CACHE_ID_TYPE_OBJECT_TYPE, conf_o);
-                    if (!plat_entry) {
-                        _LOG3D("route-sync: adding route %s failed with EEXIST, however we "
-                               "cannot find such a route",
-                               nmp_object_to_string(conf_o,
-                                                    NMP_OBJECT_TO_STRING_PUBLIC,
-                                                    sbuf1,
-                                                    sizeof(sbuf1)));
-                    } else if (vt->route_cmp(NMP_OBJECT_CAST_IPX_ROUTE(conf_o),
-                                             NMP_OBJECT_CAST_IPX_ROUTE(plat_entry->obj),
-                                             NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY)
-                               != 0) {
-                        _LOG3D("route-sync: adding route %s failed due to existing "
-                               "(different!) route %s",
-                               nmp_object_to_string(conf_o,
-                                                    NMP_OBJECT_TO_STRING_PUBLIC,
-                                                    sbuf1,
-                                                    sizeof(sbuf1)),
-                               nmp_object_to_string(plat_entry->obj,
-                                                    NMP_OBJECT_TO_STRING_PUBLIC,
-                                                    sbuf2,
-                                                    sizeof(sbuf2)));
-                    }
-                }
-            } else {
-                _LOG3D(
-                    "route-sync: failure to add IPv%c route: %s: %s%s%s%s",
-                    vt->is_ip4 ? '4' : '6',
-                    nmp_object_to_string(conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof(sbuf1)),
-                    nm_strerror(r),
-                    NM_PRINT_FMT_QUOTED(extack_msg, " (", extack_msg, ")", ""));
-
-                success = FALSE;
-
-                if (out_routes_failed) {
-                    if (!*out_routes_failed) {
-                        *out_routes_failed =
-                            g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
-                    }
-                    g_ptr_array_add(*out_routes_failed, (gpointer) nmp_object_ref(conf_o));
-                }
-            }
+            _ip_route_batch_append(&ops, conf_o, FALSE);
         }
     }
 
@@ -5292,8 +5853,162 @@ nm_platform_ip_route_sync(NMPlatform *self,
             if (!nm_platform_lookup_entry(self, NMP_CACHE_ID_TYPE_OBJECT_TYPE, prune_o))
                 continue;
 
-            if (!nm_platform_object_delete(self, prune_o)) {
-                /* ignore error... */
+            _ip_route_batch_append(&ops, prune_o, TRUE);
+        }
+    }
+
+    if (!ops)
+        return NULL;
+
+    sync  = g_slice_new(NMPlatformIPRouteSync);
+    *sync = (NMPlatformIPRouteSync){
+        .ops         = ops,
+        .addr_family = addr_family,
+        .ifindex     = ifindex,
+        .executed    = FALSE,
+    };
+    return sync;
+}
+
+/**
+ * nm_platform_ip_route_sync_execute:
+ * @self: the #NMPlatform instance.
+ * @syncs: the prepared changes. %NULL entries are ignored.
+ * @n_syncs: the number of entries in @syncs.
+ *
+ * Sends the changes of all @syncs to the platform together, so that they
+ * are pipelined in as few batches as possible. The order is preserved.
+ */
+void
+nm_platform_ip_route_sync_execute(NMPlatform                   *self,
+                                  NMPlatformIPRouteSync *const *syncs,
+                                  guint                         n_syncs)
+{
+    gs_free NMPlatformIPRouteBatchOp **ops   = NULL;
+    guint                              n_ops = 0;
+    guint                              i;
+    guint                              j;
+
+    nm_assert(NM_IS_PLATFORM(self));
+
+    for (i = 0; i < n_syncs; i++) {
+        if (syncs[i] && !syncs[i]->executed)
+            n_ops += syncs[i]->ops->len;
+    }
+
+    if (n_ops == 0)
+        return;
+
+    ops   = g_new(NMPlatformIPRouteBatchOp *, n_ops);
+    n_ops = 0;
+    for (i = 0; i < n_syncs; i++) {
+        NMPlatformIPRouteSync *sync = syncs[i];
+
+        if (!sync || sync->executed)
+            continue;
+
+        sync->executed = TRUE;
+        for (j = 0; j < sync->ops->len; j++)
+            ops[n_ops++] = &nm_g_array_index(sync->ops, NMPlatformIPRouteBatchOp, j);
+    }
+
+    _ip_route_batch_execute(self, ops, n_ops);
+}
+
+/**
+ * nm_platform_ip_route_sync_finish:
+ * @self: the #NMPlatform instance.
+ * @sync: (transfer full) (nullable): the changes from nm_platform_ip_route_sync_prepare().
+ *   If they were not yet executed, that happens now.
+ * @out_routes_failed: (out) (optional) (nullable): routes that could
+ *   not be synced/added.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+nm_platform_ip_route_sync_finish(NMPlatform             *self,
+                                 NMPlatformIPRouteSync  *sync,
+                                 GPtrArray             **out_routes_failed)
+{
+    const NMPlatformVTableRoute *vt;
+    gs_unref_array GArray       *ops = NULL;
+    const NMPObject             *conf_o;
+    const NMDedupMultiEntry     *plat_entry;
+    int                          ifindex;
+    guint                        i;
+    gboolean                     success = TRUE;
+    char                         sbuf1[NM_UTILS_TO_STRING_BUFFER_SIZE];
+    char                         sbuf2[NM_UTILS_TO_STRING_BUFFER_SIZE];
+
+    nm_assert(NM_IS_PLATFORM(self));
+
+    if (!sync)
+        return TRUE;
+
+    if (!sync->executed)
+        nm_platform_ip_route_sync_execute(self, &sync, 1);
+
+    vt      = &nm_platform_vtable_route.vx[NM_IS_IPv4(sync->addr_family)];
+    ifindex = sync->ifindex;
+    ops     = g_steal_pointer(&sync->ops);
+    nm_g_slice_free(sync);
+
+    for (i = 0; i < ops->len; i++) {
+        const NMPlatformIPRouteBatchOp *op = &nm_g_array_index(ops, NMPlatformIPRouteBatchOp, i);
+
+        if (op->is_delete) {
+            /* ignore error... */
+            continue;
+        }
+
+        conf_o = op->obj;
+
+        if (op->result == 0) {
+            /* success */
+        } else if (op->result == -EEXIST) {
+            /* Don't fail for EEXIST. It's not clear that the existing route
+             * is identical to the one that we were about to add. However,
+             * above we should have deleted conflicting (non-identical) routes. */
+            if (_LOGD_ENABLED()) {
+                plat_entry = nm_platform_lookup_entry(self, NMP_CACHE_ID_TYPE_OBJECT_TYPE, conf_o);
+                if (!plat_entry) {
+                    _LOG3D("route-sync: adding route %s failed with EEXIST, however we "
+                           "cannot find such a route",
+                           nmp_object_to_string(conf_o,
+                                                NMP_OBJECT_TO_STRING_PUBLIC,
+                                                sbuf1,
+                                                sizeof(sbuf1)));
+                } else if (vt->route_cmp(NMP_OBJECT_CAST_IPX_ROUTE(conf_o),
+                                         NMP_OBJECT_CAST_IPX_ROUTE(plat_entry->obj),
+                                         NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY)
+                           != 0) {
+                    _LOG3D("route-sync: adding route %s failed due to existing "
+                           "(different!) route %s",
+                           nmp_object_to_string(conf_o,
+                                                NMP_OBJECT_TO_STRING_PUBLIC,
+                                                sbuf1,
+                                                sizeof(sbuf1)),
+                           nmp_object_to_string(plat_entry->obj,
+                                                NMP_OBJECT_TO_STRING_PUBLIC,
+                                                sbuf2,
+                                                sizeof(sbuf2)));
+                }
+            }
+        } else {
+            _LOG3D("route-sync: failure to add IPv%c route: %s: %s%s%s%s",
+                   vt->is_ip4 ? '4' : '6',
+                   nmp_object_to_string(conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof(sbuf1)),
+                   nm_strerror(op->result),
+                   NM_PRINT_FMT_QUOTED(op->extack_msg, " (", op->extack_msg, ")", ""));
+
+            success = FALSE;
+
+            if (out_routes_failed) {
+                if (!*out_routes_failed) {
+                    *out_routes_failed =
+                        g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+                }
+                g_ptr_array_add(*out_routes_failed, (gpointer) nmp_object_ref(conf_o));
             }
         }
     }
@@ -5301,6 +6016,42 @@ nm_platform_ip_route_sync(NMPlatform *self,
     return success;
 }
 
+/**
+ * nm_platform_ip_route_sync:
+ * @self: the #NMPlatform instance.
+ * @addr_family: AF_INET or AF_INET6.
+ * @ifindex: the @ifindex for which the routes are to be added.
+ * @routes: (nullable): a list of routes to configure. Must contain
+ *   NMPObject instances of routes, according to @addr_family.
+ * @routes_prune: (nullable): the list of routes to delete.
+ *   If platform has such a route configured, it will be deleted
+ *   at the end of the operation. Note that if @routes contains
+ *   the same route, then it will not be deleted. @routes overrules
+ *   @routes_prune list.
+ * @out_routes_failed: (out) (optional) (nullable): routes that could
+ *   not be synced/added.
+ *
+ * The necessary changes are first collected and then passed to the platform
+ * implementation in batches, so that it does not need to wait for the
+ * response of each request before sending the next one. The order of the
+ * operations is preserved.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+nm_platform_ip_route_sync(NMPlatform *self,
+                          int         addr_family,
+                          int         ifindex,
+                          GPtrArray  *routes,
+                          GPtrArray  *routes_prune,
+                          GPtrArray **out_routes_failed)
+{
+    NMPlatformIPRouteSync *sync;
+
+    sync = nm_platform_ip_route_sync_prepare(self, addr_family, ifindex, routes, routes_prune);
+    return nm_platform_ip_route_sync_finish(self, sync, out_routes_failed);
+}
+
 gboolean
 nm_platform_ip_route_flush(NMPlatform *self, int addr_family, int ifindex)
 {
@@ -5501,6 +6252,10 @@ _ip_route_add(NMPlatform *self, NMPNlmFlags flags, NMPObject *obj_stack, char **
     nm_platform_ip_route_normalize(NMP_OBJECT_GET_ADDR_FAMILY((obj_stack)),
                                    NMP_OBJECT_CAST_IP_ROUTE(obj_stack));
 
+    _route_table_ensure_tracked(
+        self,
+        nm_platform_route_table_uncoerce(obj_stack->ip_route.table_coerced, TRUE));
+
     ifindex = obj_stack->ip_route.ifindex;
 
     _LOG3D("route: %-10s IPv%c route: %s",
@@ -5961,6 +6716,77 @@ nm_platform_routing_rule_add(NMPlatform                  *self,
     return klass->routing_rule_add(self, flags, routing_rule);
 }
 
+/**
+ * nm_platform_routing_rule_batch:
+ * @self: the #NMPlatform instance
+ * @rules_to_delete: (nullable): the routing rules (#NMPObject) to delete.
+ * @rules_to_add: (nullable): the routing rules (#NMPObject) to add with
+ *   %NMP_NLM_FLAG_ADD.
+ *
+ * Deletes and then adds the rules. Like for routes, the requests are passed to
+ * the platform in batches so that it does not need to wait for each response
+ * before sending the next request. Failures are only logged.
+ */
+void
+nm_platform_routing_rule_batch(NMPlatform *self,
+                               GPtrArray  *rules_to_delete,
+                               GPtrArray  *rules_to_add)
+{
+    char        sbuf[NM_UTILS_TO_STRING_BUFFER_SIZE];
+    const guint n_del = rules_to_delete ? rules_to_delete->len : 0u;
+    const guint n_ops = n_del + (rules_to_add ? rules_to_add->len : 0u);
+    guint       i_start;
+    guint       i;
+
+    _CHECK_SELF_VOID(self, klass);
+
+    if (!klass->routing_rule_batch) {
+        for (i = 0; i < n_ops; i++) {
+            if (i < n_del)
+                nm_platform_object_delete(self, rules_to_delete->pdata[i]);
+            else {
+                nm_platform_routing_rule_add(
+                    self,
+                    NMP_NLM_FLAG_ADD,
+                    NMP_OBJECT_CAST_ROUTING_RULE(rules_to_add->pdata[i - n_del]));
+            }
+        }
+        return;
+    }
+
+    for (i_start = 0; i_start < n_ops; i_start += IP_ROUTE_BATCH_SIZE) {
+        const guint                       n   = NM_MIN(n_ops - i_start, IP_ROUTE_BATCH_SIZE);
+        gs_free NMPlatformIPRouteBatchOp *ops = g_new(NMPlatformIPRouteBatchOp, n);
+
+        for (i = 0; i < n; i++) {
+            const gboolean   is_delete = (i_start + i < n_del);
+            const NMPObject *obj       = is_delete ? rules_to_delete->pdata[i_start + i]
+                                                   : rules_to_add->pdata[i_start + i - n_del];
+
+            nm_assert(NMP_OBJECT_GET_TYPE(obj) == NMP_OBJECT_TYPE_ROUTING_RULE);
+
+            ops[i] = (NMPlatformIPRouteBatchOp){
+                .obj        = obj,
+                .flags      = NMP_NLM_FLAG_ADD,
+                .is_delete  = is_delete,
+                .result     = 0,
+                .extack_msg = NULL,
+            };
+
+            _LOGD("routing-rule: %s: %s",
+                  is_delete ? "deleting" : "adding or updating",
+                  nm_platform_routing_rule_to_string(NMP_OBJECT_CAST_ROUTING_RULE(obj),
+                                                     sbuf,
+                                                     sizeof(sbuf)));
+        }
+
+        klass->routing_rule_batch(self, ops, n);
+
+        for (i = 0; i < n; i++)
+            g_free(ops[i].extack_msg);
+    }
+}
+
 /*****************************************************************************/
 
 int
@@ -6013,12 +6839,319 @@ nm_platform_tfilter_delete(NMPlatform *self, int ifindex, guint32 parent, gboole
     return klass->tfilter_delete(self, ifindex, parent, log_error);
 }
 
+static void
+_tc_batch_append(GArray **p_ops, const NMPObject *obj, NMPObjectType del_obj_type, guint32 parent)
+{
+    if (!*p_ops)
+        *p_ops = g_array_new(FALSE, FALSE, sizeof(NMPlatformTcBatchOp));
+
+    *nm_g_array_append_new(*p_ops, NMPlatformTcBatchOp) = (NMPlatformTcBatchOp){
+        .obj          = obj,
+        .flags        = NMP_NLM_FLAG_ADD,
+        .del_obj_type = obj ? NMP_OBJECT_TYPE_UNKNOWN : del_obj_type,
+        .del_parent   = obj ? 0u : parent,
+        .result       = 0,
+    };
+}
+
+#define _tc_batch_append_add(p_ops, obj) \
+    _tc_batch_append((p_ops), (obj), NMP_OBJECT_TYPE_UNKNOWN, 0)
+#define _tc_batch_append_delete(p_ops, obj_type, parent) \
+    _tc_batch_append((p_ops), NULL, (obj_type), (parent))
+
+static gboolean
+_tc_batch_execute(NMPlatform *self, int ifindex, GArray *ops)
+{
+    gboolean success = TRUE;
+    guint    i;
+
+    _CHECK_SELF(self, klass, FALSE);
+
+    if (klass->tc_batch)
+        klass->tc_batch(self, ifindex, (NMPlatformTcBatchOp *) ops->data, ops->len);
+
+    for (i = 0; i < ops->len; i++) {
+        NMPlatformTcBatchOp *op = &nm_g_array_index(ops, NMPlatformTcBatchOp, i);
+
+        if (!klass->tc_batch) {
+            if (!op->obj) {
+                op->result = op->del_obj_type == NMP_OBJECT_TYPE_QDISC
+                                 ? nm_platform_qdisc_delete(self, ifindex, op->del_parent, FALSE)
+                                 : nm_platform_tfilter_delete(self, ifindex, op->del_parent, FALSE);
+            } else if (NMP_OBJECT_GET_TYPE(op->obj) == NMP_OBJECT_TYPE_QDISC)
+                op->result = nm_platform_qdisc_add(self, op->flags, NMP_OBJECT_CAST_QDISC(op->obj));
+            else {
+                op->result =
+                    nm_platform_tfilter_add(self, op->flags, NMP_OBJECT_CAST_TFILTER(op->obj));
+            }
+        }
+
+        /* Failures to delete are ignored, there might be nothing to delete. */
+        if (op->obj && op->result < 0)
+            success = FALSE;
+    }
+
+    return success;
+}
+
+/* Whether the qdisc @have from the platform cache is what adding @want would
+ * result in. Kernel fills in defaults for options that we don't set, reports a
+ * refcount in "info" and picks a handle if we don't request one. If in doubt,
+ * report a mismatch: that only costs replacing the qdisc. The default quantum
+ * depends on the MTU, so an unset quantum is not compared. */
+static gboolean
+_tc_qdisc_matches(const NMPlatformQdisc *want, const NMPlatformQdisc *have)
+{
+    if (want->parent != have->parent || !nm_streq0(want->kind, have->kind))
+        return FALSE;
+    if (want->handle != 0 && want->handle != have->handle)
+        return FALSE;
+
+#define _OPT_MATCHES(field, dflt) ((want->field ?: (dflt)) == have->field)
+
+    if (nm_streq0(want->kind, "fq_codel")) {
+        return _OPT_MATCHES(fq_codel.limit, 10240u) && _OPT_MATCHES(fq_codel.flows, 1024u)
+               && _OPT_MATCHES(fq_codel.target, 5000u)
+               && _OPT_MATCHES(fq_codel.interval, 100000u)
+               && (want->fq_codel.quantum == 0 || want->fq_codel.quantum == have->fq_codel.quantum)
+               && want->fq_codel.ce_threshold == have->fq_codel.ce_threshold
+               && (want->fq_codel.memory_limit == NM_PLATFORM_FQ_CODEL_MEMORY_LIMIT_UNSET
+                       ? have->fq_codel.memory_limit == (32u << 20)
+                       : want->fq_codel.memory_limit == have->fq_codel.memory_limit)
+               && have->fq_codel.ecn;
+    }
+
+    if (nm_streq0(want->kind, "sfq")) {
+        return (want->sfq.quantum == 0 || want->sfq.quantum == have->sfq.quantum)
+               && want->sfq.perturb_period == have->sfq.perturb_period
+               && _OPT_MATCHES(sfq.limit, 127u) && _OPT_MATCHES(sfq.divisor, 1024u)
+               && _OPT_MATCHES(sfq.flows, 128u) && _OPT_MATCHES(sfq.depth, 127u);
+    }
+
+#undef _OPT_MATCHES
+
+    if (nm_streq0(want->kind, "tbf")) {
+        /* The limit derived from the latency is not worth recomputing here. */
+        return want->tbf.rate == have->tbf.rate && want->tbf.burst == have->tbf.burst
+               && want->tbf.limit == have->tbf.limit && (want->tbf.limit || !want->tbf.latency);
+    }
+
+    return TRUE;
+}
+
+static gboolean
+_tc_tfilter_matches(const NMPlatformTfilter *want, const NMPlatformTfilter *have)
+{
+    const NMPlatformAction *a = &want->action;
+    const NMPlatformAction *b = &have->action;
+
+    if (want->parent != have->parent || !nm_streq0(want->kind, have->kind))
+        return FALSE;
+    if (want->handle != 0 && want->handle != have->handle)
+        return FALSE;
+
+    /* "info" holds the priority and the protocol. Kernel picks a priority
+     * if we don't set one. */
+    if (TC_H_MIN(want->info) != TC_H_MIN(have->info))
+        return FALSE;
+    if (TC_H_MAJ(want->info) != 0 && TC_H_MAJ(want->info) != TC_H_MAJ(have->info))
+        return FALSE;
+
+    if (!nm_streq0(a->kind, b->kind))
+        return FALSE;
+    if (nm_streq0(a->kind, NM_PLATFORM_ACTION_KIND_SIMPLE))
+        return strncmp(a->simple.sdata, b->simple.sdata, sizeof(a->simple.sdata)) == 0;
+    if (nm_streq0(a->kind, NM_PLATFORM_ACTION_KIND_MIRRED)) {
+        return a->mirred.ifindex == b->mirred.ifindex && a->mirred.egress == b->mirred.egress
+               && a->mirred.ingress == b->mirred.ingress && a->mirred.mirror == b->mirred.mirror
+               && a->mirred.redirect == b->mirred.redirect;
+    }
+    return TRUE;
+}
+
+static gboolean
+_tc_reconcile_qdiscs(NMPlatform *self, int ifindex, GPtrArray *known_qdiscs, GArray **p_ops)
+{
+    NMPLookup                    lookup;
+    gs_unref_ptrarray GPtrArray *plat_qdiscs = NULL;
+    const guint                  n_known     = known_qdiscs ? known_qdiscs->len : 0u;
+    guint                        n_plat;
+    gs_free bool                *plat_keep   = NULL;
+    gs_free guint               *known_match = NULL;
+    gboolean                     changed     = FALSE;
+    gboolean                     again;
+    guint                        i;
+    guint                        j;
+
+    plat_qdiscs = nm_platform_lookup_clone(
+        self,
+        nmp_lookup_init_object_by_ifindex(&lookup, NMP_OBJECT_TYPE_QDISC, ifindex),
+        NULL,
+        NULL);
+    n_plat = plat_qdiscs ? plat_qdiscs->len : 0u;
+
+    plat_keep   = g_new0(bool, n_plat + 1u);
+    known_match = g_new(guint, n_known + 1u);
+
+    /* Find the requested qdiscs that are already configured. */
+    for (i = 0; i < n_known; i++) {
+        const NMPlatformQdisc *want = NMP_OBJECT_CAST_QDISC(known_qdiscs->pdata[i]);
+
+        known_match[i] = G_MAXUINT;
+        for (j = 0; j < n_plat; j++) {
+            if (!plat_keep[j]
+                && _tc_qdisc_matches(want, NMP_OBJECT_CAST_QDISC(plat_qdiscs->pdata[j]))) {
+                plat_keep[j]   = TRUE;
+                known_match[i] = j;
+                break;
+            }
+        }
+    }
+
+    /* Adding a qdisc again destroys its children, so they must be added
+     * again too. */
+    do {
+        again = FALSE;
+        for (i = 0; i < n_known; i++) {
+            const NMPlatformQdisc *want = NMP_OBJECT_CAST_QDISC(known_qdiscs->pdata[i]);
+
+            if (known_match[i] != G_MAXUINT || want->handle == 0)
+                continue;
+            for (j = 0; j < n_known; j++) {
+                const NMPlatformQdisc *child = NMP_OBJECT_CAST_QDISC(known_qdiscs->pdata[j]);
+
+                if (known_match[j] != G_MAXUINT && TC_H_MAJ(child->parent) == want->handle) {
+                    plat_keep[known_match[j]] = FALSE;
+                    known_match[j]            = G_MAXUINT;
+                    again                     = TRUE;
+                }
+            }
+        }
+    } while (again);
+
+    /* Delete the qdiscs that are no longer wanted, unless they go away together
+     * with their parent anyway. Kernel's default qdiscs have no handle, they get
+     * replaced when adding ours. */
+    for (j = 0; j < n_plat; j++) {
+        const NMPlatformQdisc *have = NMP_OBJECT_CAST_QDISC(plat_qdiscs->pdata[j]);
+        gboolean               do_delete;
+        guint                  k;
+
+        if (plat_keep[j] || have->handle == 0)
+            continue;
+
+        do_delete = NM_IN_SET(have->parent, TC_H_ROOT, TC_H_INGRESS);
+        for (k = 0; !do_delete && k < n_plat; k++) {
+            do_delete = plat_keep[k]
+                     && NMP_OBJECT_CAST_QDISC(plat_qdiscs->pdata[k])->handle
+                               == TC_H_MAJ(have->parent);
+        }
+        if (do_delete) {
+            _tc_batch_append_delete(p_ops, NMP_OBJECT_TYPE_QDISC, have->parent);
+            changed = TRUE;
+        }
+    }
+
+    for (i = 0; i < n_known; i++) {
+        if (known_match[i] == G_MAXUINT) {
+            _tc_batch_append_add(p_ops, known_qdiscs->pdata[i]);
+            changed = TRUE;
+        }
+    }
+
+    return changed;
+}
+
+static void
+_tc_reconcile_tfilters(NMPlatform *self,
+                       int         ifindex,
+                       GPtrArray  *known_tfilters,
+                       gboolean    qdiscs_changed,
+                       GArray    **p_ops)
+{
+    NMPLookup                    lookup;
+    gs_unref_ptrarray GPtrArray *plat_tfilters = NULL;
+    gs_unref_array GArray       *parents       = NULL;
+    const guint                  n_known       = known_tfilters ? known_tfilters->len : 0u;
+    guint                        n_plat;
+    gs_free bool                *plat_used = NULL;
+    guint                        i_parent;
+    guint                        i;
+    guint                        j;
+
+    plat_tfilters = nm_platform_lookup_clone(
+        self,
+        nmp_lookup_init_object_by_ifindex(&lookup, NMP_OBJECT_TYPE_TFILTER, ifindex),
+        NULL,
+        NULL);
+    n_plat = plat_tfilters ? plat_tfilters->len : 0u;
+
+    plat_used = g_new0(bool, n_plat + 1u);
+
+    /* Tfilters are deleted per parent, so reconcile them per parent too. */
+    parents = g_array_new(FALSE, FALSE, sizeof(guint32));
+    for (i = 0; i < n_known + n_plat; i++) {
+        guint32 parent = i < n_known
+                             ? NMP_OBJECT_CAST_TFILTER(known_tfilters->pdata[i])->parent
+                             : NMP_OBJECT_CAST_TFILTER(plat_tfilters->pdata[i - n_known])->parent;
+
+        for (j = 0; j < parents->len; j++) {
+            if (nm_g_array_index(parents, guint32, j) == parent)
+                break;
+        }
+        if (j == parents->len)
+            g_array_append_val(parents, parent);
+    }
+
+    for (i_parent = 0; i_parent < parents->len; i_parent++) {
+        const guint32 parent = nm_g_array_index(parents, guint32, i_parent);
+        gboolean      in_sync;
+
+        /* If a qdisc changed, its tfilters might be gone. Add them all again. */
+        in_sync = !qdiscs_changed;
+
+        for (i = 0; in_sync && i < n_known; i++) {
+            const NMPlatformTfilter *want = NMP_OBJECT_CAST_TFILTER(known_tfilters->pdata[i]);
+
+            if (want->parent != parent)
+                continue;
+            in_sync = FALSE;
+            for (j = 0; j < n_plat; j++) {
+                if (!plat_used[j]
+                    && _tc_tfilter_matches(want,
+                                           NMP_OBJECT_CAST_TFILTER(plat_tfilters->pdata[j]))) {
+                    plat_used[j] = TRUE;
+                    in_sync      = TRUE;
+                    break;
+                }
+            }
+        }
+        for (j = 0; in_sync && j < n_plat; j++) {
+            const NMPlatformTfilter *have = NMP_OBJECT_CAST_TFILTER(plat_tfilters->pdata[j]);
+
+            if (!plat_used[j] && have->parent == parent)
+                in_sync = FALSE;
+        }
+
+        if (in_sync)
+            continue;
+
+        _tc_batch_append_delete(p_ops, NMP_OBJECT_TYPE_TFILTER, parent);
+        for (i = 0; i < n_known; i++) {
+            if (NMP_OBJECT_CAST_TFILTER(known_tfilters->pdata[i])->parent == parent)
+                _tc_batch_append_add(p_ops, known_tfilters->pdata[i]);
+        }
+    }
+}
+
 /**
  * nm_platform_tc_sync:
  * @self: the #NMPlatform instance
  * @ifindex: the ifindex where to configure qdiscs and filters.
  * @known_qdiscs: the list of qdiscs (#NMPObject).
  * @known_tfilters: the list of tfilters (#NMPObject).
+ * @mode: whether to replace everything or only what differs from
+ *   the platform cache.
  *
  * The function promises not to take any reference to the
  * instances from @known_qdiscs and @known_tfilters, nor to
@@ -6027,48 +7160,55 @@ nm_platform_tfilter_delete(NMPlatform *self, int ifindex, guint32 parent, gboole
  * NMPlatformTfilter instances which "kind" string have a limited
  * lifetime.
  *
+ * All changes are passed to the platform at once, so that they can
+ * be sent without waiting for each acknowledgement in turn.
+ *
  * Returns: %TRUE on success.
  */
 gboolean
-nm_platform_tc_sync(NMPlatform *self,
-                    int         ifindex,
-                    GPtrArray  *known_qdiscs,
-                    GPtrArray  *known_tfilters)
+nm_platform_tc_sync(NMPlatform          *self,
+                    int                  ifindex,
+                    GPtrArray           *known_qdiscs,
+                    GPtrArray           *known_tfilters,
+                    NMPlatformTcSyncMode mode)
 {
-    guint    i;
-    gboolean success = TRUE;
+    gs_unref_array GArray *ops = NULL;
+    guint                  i;
 
     nm_assert(NM_IS_PLATFORM(self));
     nm_assert(ifindex > 0);
 
-    nm_platform_qdisc_delete(self, ifindex, TC_H_ROOT, FALSE);
-    nm_platform_qdisc_delete(self, ifindex, TC_H_INGRESS, FALSE);
+    if (mode == NM_PLATFORM_TC_SYNC_MODE_RECONCILE && !nm_platform_get_cache_tc(self))
+        mode = NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL;
 
-    /* At this point we can only have a root default qdisc
-     * (which can't be deleted). Ensure it doesn't have any
-     * filters attached.
-     */
-    nm_platform_tfilter_delete(self, ifindex, TC_H_ROOT, FALSE);
+    if (mode == NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL) {
+        _tc_batch_append_delete(&ops, NMP_OBJECT_TYPE_QDISC, TC_H_ROOT);
+        _tc_batch_append_delete(&ops, NMP_OBJECT_TYPE_QDISC, TC_H_INGRESS);
 
-    if (known_qdiscs) {
-        for (i = 0; i < known_qdiscs->len; i++) {
-            const NMPObject *q = g_ptr_array_index(known_qdiscs, i);
+        /* At this point we can only have a root default qdisc
+         * (which can't be deleted). Ensure it doesn't have any
+         * filters attached.
+         */
+        _tc_batch_append_delete(&ops, NMP_OBJECT_TYPE_TFILTER, TC_H_ROOT);
 
-            success &=
-                (nm_platform_qdisc_add(self, NMP_NLM_FLAG_ADD, NMP_OBJECT_CAST_QDISC(q)) >= 0);
-        }
-    }
+        for (i = 0; known_qdiscs && i < known_qdiscs->len; i++)
+            _tc_batch_append_add(&ops, known_qdiscs->pdata[i]);
+        for (i = 0; known_tfilters && i < known_tfilters->len; i++)
+            _tc_batch_append_add(&ops, known_tfilters->pdata[i]);
+    } else {
+        gboolean qdiscs_changed;
 
-    if (known_tfilters) {
-        for (i = 0; i < known_tfilters->len; i++) {
-            const NMPObject *q = g_ptr_array_index(known_tfilters, i);
+        qdiscs_changed = _tc_reconcile_qdiscs(self, ifindex, known_qdiscs, &ops);
+        _tc_reconcile_tfilters(self, ifindex, known_tfilters, qdiscs_changed, &ops);
 
-            success &=
-                (nm_platform_tfilter_add(self, NMP_NLM_FLAG_ADD, NMP_OBJECT_CAST_TFILTER(q)) >= 0);
+        if (!ops) {
+            _LOG3D("tc: qdiscs and tfilters are already up to date");
+            return TRUE;
         }
     }
 
-    return success;
+    _LOG3D("tc: syncing with %u operations", ops->len);
+    return _tc_batch_execute(self, ifindex, ops);
 }
 
 /*****************************************************************************/
@@ -10126,6 +11266,11 @@ finalize(GObject *object)
     nm_clear_g_source(&priv->ip4_dev_route_blacklist_check_id);
     nm_clear_g_source(&priv->ip4_dev_route_blacklist_gc_timeout_id);
     nm_clear_pointer(&priv->ip4_dev_route_blacklist_hash, g_hash_table_unref);
+    nm_clear_pointer(&priv->route_table_filter, g_array_unref);
+    nm_clear_pointer(&priv->route_tables_auto, g_array_unref);
+    nm_clear_pointer(&priv->route_tables_tracked, g_array_unref);
+    nm_clear_g_source_inst(&priv->link_stats_source);
+    nm_clear_pointer(&priv->link_stats_hash, g_hash_table_unref);
     g_clear_object(&self->_netns);
     nm_dedup_multi_index_unref(priv->multi_idx);
     nmp_cache_free(priv->cache);
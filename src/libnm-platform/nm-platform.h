@@ -1006,6 +1006,11 @@ typedef enum {
     NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_PRIVATE_KEY = (1LL << 1),
     NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_LISTEN_PORT = (1LL << 2),
     NM_PLATFORM_WIREGUARD_CHANGE_FLAG_HAS_FWMARK      = (1LL << 3),
+
+    /* Compare the settings and the peers with the cached state and only send
+     * what differs. Cached peers that are not in the list get removed. This
+     * has no effect together with NM_PLATFORM_WIREGUARD_CHANGE_FLAG_REPLACE_PEERS. */
+    NM_PLATFORM_WIREGUARD_CHANGE_FLAG_SYNC_PEERS = (1LL << 4),
 } NMPlatformWireGuardChangeFlags;
 
 typedef enum {
@@ -1036,6 +1041,126 @@ typedef struct {
     gint8    addr_family;
 } NMPlatformMptcpAddr;
 
+typedef struct {
+    /* The route to add or delete. For additions, the object is a normalized
+     * copy, as passed to NMPlatformClass.ip_route_add(). For
+     * NMPlatformClass.routing_rule_batch(), this is a routing rule. */
+    const NMPObject *obj;
+
+    /* The NMP_NLM_FLAG_* flags for additions. Ignored for deletions. */
+    NMPNlmFlags flags;
+
+    bool is_delete : 1;
+
+    /* Output: zero on success or a negative error number. */
+    int result;
+
+    /* Output: the extended ACK message from kernel (if any). */
+    char *extack_msg;
+} NMPlatformIPRouteBatchOp;
+
+typedef struct {
+    /* The qdisc or tfilter to add, or %NULL for a deletion. The object is
+     * owned by the caller. */
+    const NMPObject *obj;
+
+    /* The NMP_NLM_FLAG_* flags for additions. */
+    NMPNlmFlags flags;
+
+    /* For deletions, the type (NMP_OBJECT_TYPE_QDISC or NMP_OBJECT_TYPE_TFILTER)
+     * and the parent of the objects to delete. */
+    NMPObjectType del_obj_type;
+    guint32       del_parent;
+
+    /* Output: zero on success or a negative error number. */
+    int result;
+} NMPlatformTcBatchOp;
+
+typedef enum {
+    /* Delete the root and ingress qdiscs and the root tfilters, then
+     * add all the requested objects. */
+    NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL,
+
+    /* Compare the requested objects with the ones in the platform cache
+     * and only touch those that differ. Falls back to
+     * %NM_PLATFORM_TC_SYNC_MODE_REPLACE_ALL without a TC cache. */
+    NM_PLATFORM_TC_SYNC_MODE_RECONCILE,
+} NMPlatformTcSyncMode;
+
+typedef struct {
+    /* An inclusive range of route table numbers. */
+    guint32 table_from;
+    guint32 table_to;
+} NMPlatformRouteTableRange;
+
+typedef enum {
+    NM_PLATFORM_NETLINK_MSG_KIND_LINK,
+    NM_PLATFORM_NETLINK_MSG_KIND_ADDRESS,
+    NM_PLATFORM_NETLINK_MSG_KIND_ROUTE,
+    NM_PLATFORM_NETLINK_MSG_KIND_RULE,
+    NM_PLATFORM_NETLINK_MSG_KIND_QDISC,
+    NM_PLATFORM_NETLINK_MSG_KIND_TFILTER,
+    NM_PLATFORM_NETLINK_MSG_KIND_GENL,
+    NM_PLATFORM_NETLINK_MSG_KIND_OTHER,
+    _NM_PLATFORM_NETLINK_MSG_KIND_NUM,
+} NMPlatformNetlinkMsgKind;
+
+const char *nm_platform_netlink_msg_kind_to_string(NMPlatformNetlinkMsgKind kind);
+
+typedef struct {
+    /* The number of netlink messages that were received and handled. */
+    guint64 msgs;
+
+    /* The time spent creating NMPObjects from these messages. */
+    guint64 parse_nsec;
+
+    /* The time spent handling the resulting changes of the cache. This is
+     * accounted to the type of the changed object, regardless of what caused
+     * the change. */
+    guint64 cache_nsec;
+} NMPlatformNetlinkMsgStats;
+
+typedef struct {
+    /* The number of times the netlink receive buffer overflowed (ENOBUFS). */
+    guint64 overflows;
+
+    /* The number of dumps that were requested to recover from overflows. */
+    guint64 resync_dumps;
+
+    /* The number of resyncs that completed. */
+    guint64 resyncs_completed;
+
+    /* The number of requested dumps of all objects of a type ("refresh-all"). */
+    guint64 refresh_all;
+
+    /* The number of dumps that completed, and the total and the maximum time
+     * from sending the request until receiving the end of the dump. */
+    guint64 dumps_completed;
+    guint64 dumps_nsec;
+    guint64 dumps_max_nsec;
+
+    NMPlatformNetlinkMsgStats msg_kinds[_NM_PLATFORM_NETLINK_MSG_KIND_NUM];
+
+    /* The current size of the receive buffer of the netlink socket, as reported
+     * by the kernel. That is twice the requested size. */
+    guint32 rcvbuf_size;
+
+    bool resync_in_progress : 1;
+} NMPlatformNetlinkStats;
+
+typedef struct {
+    /* The number of values that were written to sysctl and sysfs files. */
+    guint64 writes;
+
+    /* The number of writes that were skipped, because the same value was
+     * already written to the file in the same main loop iteration. */
+    guint64 write_hits;
+
+    /* The number of async writes that were dropped, because another async
+     * write to the same file followed in the same main loop iteration. */
+    guint64 async_coalesced;
+} NMPlatformSysctlStats;
+
 #undef __NMPlatformObjWithIfindex_COMMON
 
 /*****************************************************************************/
@@ -1137,10 +1262,14 @@ typedef struct {
                              gpointer                data,
                              GCancellable           *cancellable);
     char *(*sysctl_get)(NMPlatform *self, const char *pathid, int dirfd, const char *path);
+    gboolean (*sysctl_stats_get)(NMPlatform *self, NMPlatformSysctlStats *out_stats);
 
     void (*refresh_all)(NMPlatform *self, NMPObjectType obj_type);
     void (*process_events)(NMPlatform *self);
 
+    gboolean (*netlink_stats_get)(NMPlatform *self, NMPlatformNetlinkStats *out_stats);
+    void (*netlink_set_parse_thread)(NMPlatform *self, gboolean enabled);
+
     int (*link_add)(NMPlatform            *self,
                     NMLinkType             type,
                     const char            *name,
@@ -1162,6 +1291,7 @@ typedef struct {
                             NMPlatformLinkChangeFlags     flags);
     gboolean (*link_delete)(NMPlatform *self, int ifindex);
     gboolean (*link_refresh)(NMPlatform *self, int ifindex);
+    void (*link_refresh_stats)(NMPlatform *self, const int *ifindexes, guint n_ifindexes);
     gboolean (*link_set_netns)(NMPlatform *self, int ifindex, int netns_fd);
     int (*link_change_flags)(NMPlatform *platform,
                              int         ifindex,
@@ -1193,6 +1323,11 @@ typedef struct {
                                       int                    ifindex,
                                       NMPlatformBridgeVlan **out_vlans,
                                       guint                 *out_num_vlans);
+    gboolean (*link_del_bridge_vlans)(NMPlatform                 *self,
+                                      int                         ifindex,
+                                      gboolean                    on_controller,
+                                      const NMPlatformBridgeVlan *vlans,
+                                      guint                       num_vlans);
     gboolean (*link_set_bridge_info)(NMPlatform                            *self,
                                      int                                    ifindex,
                                      const NMPlatformLinkSetBridgeInfoData *bridge_info);
@@ -1318,6 +1453,8 @@ typedef struct {
                         NMPObject  *obj_stack,
                         char      **out_extack_msg);
 
+    void (*ip_route_batch)(NMPlatform *self, NMPlatformIPRouteBatchOp *ops, guint n_ops);
+
     int (*ip_route_get)(NMPlatform   *self,
                         int           addr_family,
                         gconstpointer address,
@@ -1329,12 +1466,16 @@ typedef struct {
                             NMPNlmFlags                  flags,
                             const NMPlatformRoutingRule *routing_rule);
 
+    void (*routing_rule_batch)(NMPlatform *self, NMPlatformIPRouteBatchOp *ops, guint n_ops);
+
     int (*qdisc_add)(NMPlatform *self, NMPNlmFlags flags, const NMPlatformQdisc *qdisc);
     int (*qdisc_delete)(NMPlatform *self, int ifindex, guint32 parent, gboolean log_error);
 
     int (*tfilter_add)(NMPlatform *self, NMPNlmFlags flags, const NMPlatformTfilter *tfilter);
     int (*tfilter_delete)(NMPlatform *self, int ifindex, guint32 parent, gboolean log_error);
 
+    void (*tc_batch)(NMPlatform *self, int ifindex, NMPlatformTcBatchOp *ops, guint n_ops);
+
     guint16 (*genl_get_family_id)(NMPlatform *platform, NMPGenlFamilyType family_type);
 
     int (*mptcp_addr_update)(NMPlatform *self, NMOptionBool add, const NMPlatformMptcpAddr *addr);
@@ -1552,6 +1693,17 @@ gboolean nm_platform_get_use_udev(NMPlatform *self);
 gboolean nm_platform_get_log_with_ptr(NMPlatform *self);
 gboolean nm_platform_get_cache_tc(NMPlatform *self);
 
+void     nm_platform_set_route_table_filter(NMPlatform                      *self,
+                                            const NMPlatformRouteTableRange *ranges,
+                                            guint                            n_ranges);
+gboolean nm_platform_route_table_is_tracked(NMPlatform *self, guint32 table);
+GArray  *nm_platform_route_table_filter_ref(NMPlatform *self);
+gboolean nm_platform_route_table_filter_has(const GArray *filter, guint32 table);
+
+gboolean nm_platform_netlink_stats_get(NMPlatform *self, NMPlatformNetlinkStats *out_stats);
+gboolean nm_platform_sysctl_stats_get(NMPlatform *self, NMPlatformSysctlStats *out_stats);
+void     nm_platform_netlink_set_parse_thread(NMPlatform *self, gboolean enabled);
+
 NMPNetns *nm_platform_netns_get(NMPlatform *self);
 gboolean  nm_platform_netns_push(NMPlatform *self, NMPNetns **netns);
 
@@ -2008,6 +2160,10 @@ gboolean     nm_platform_link_supports_ports(NMPlatform *self, int ifindex);
 const char  *nm_platform_link_get_type_name(NMPlatform *self, int ifindex);
 
 gboolean nm_platform_link_refresh(NMPlatform *self, int ifindex);
+void     nm_platform_link_stats_set_refresh(NMPlatform   *self,
+                                            gconstpointer user_tag,
+                                            int           ifindex,
+                                            guint         refresh_rate_ms);
 void     nm_platform_process_events(NMPlatform *self);
 
 const NMPlatformLink *
@@ -2084,6 +2240,11 @@ gboolean nm_platform_link_get_bridge_vlans(NMPlatform            *self,
                                            int                    ifindex,
                                            NMPlatformBridgeVlan **out_vlans,
                                            guint                 *out_num_vlans);
+gboolean nm_platform_link_sync_bridge_vlans(NMPlatform                 *self,
+                                            int                         ifindex,
+                                            gboolean                    on_controller,
+                                            const NMPlatformBridgeVlan *vlans,
+                                            guint                       num_vlans);
 gboolean nm_platform_link_set_bridge_info(NMPlatform                            *self,
                                           int                                    ifindex,
                                           const NMPlatformLinkSetBridgeInfoData *bridge_info);
@@ -2428,6 +2589,22 @@ gboolean nm_platform_ip_route_sync(NMPlatform *self,
                                    GPtrArray  *routes_prune,
                                    GPtrArray **out_routes_failed);
 
+typedef struct _NMPlatformIPRouteSync NMPlatformIPRouteSync;
+
+NMPlatformIPRouteSync *nm_platform_ip_route_sync_prepare(NMPlatform *self,
+                                                         int         addr_family,
+                                                         int         ifindex,
+                                                         GPtrArray  *routes,
+                                                         GPtrArray  *routes_prune);
+
+void nm_platform_ip_route_sync_execute(NMPlatform                   *self,
+                                       NMPlatformIPRouteSync *const *syncs,
+                                       guint                         n_syncs);
+
+gboolean nm_platform_ip_route_sync_finish(NMPlatform             *self,
+                                          NMPlatformIPRouteSync  *sync,
+                                          GPtrArray             **out_routes_failed);
+
 gboolean nm_platform_ip_route_flush(NMPlatform *self, int addr_family, int ifindex);
 
 int nm_platform_ip_route_get(NMPlatform   *self,
@@ -2441,14 +2618,19 @@ int nm_platform_routing_rule_add(NMPlatform                  *self,
                                  NMPNlmFlags                  flags,
                                  const NMPlatformRoutingRule *routing_rule);
 
+void nm_platform_routing_rule_batch(NMPlatform *self,
+                                    GPtrArray  *rules_to_delete,
+                                    GPtrArray  *rules_to_add);
+
 int nm_platform_qdisc_add(NMPlatform *self, NMPNlmFlags flags, const NMPlatformQdisc *qdisc);
 int nm_platform_qdisc_delete(NMPlatform *self, int ifindex, guint32 parent, gboolean log_error);
 int nm_platform_tfilter_add(NMPlatform *self, NMPNlmFlags flags, const NMPlatformTfilter *tfilter);
 int nm_platform_tfilter_delete(NMPlatform *self, int ifindex, guint32 parent, gboolean log_error);
-gboolean nm_platform_tc_sync(NMPlatform *self,
-                             int         ifindex,
-                             GPtrArray  *known_qdiscs,
-                             GPtrArray  *known_tfilters);
+gboolean nm_platform_tc_sync(NMPlatform          *self,
+                             int                  ifindex,
+                             GPtrArray           *known_qdiscs,
+                             GPtrArray           *known_tfilters,
+                             NMPlatformTcSyncMode mode);
 
 const char *nm_platform_link_to_string(const NMPlatformLink *link, char *buf, gsize len);
 const char *nm_platform_lnk_bond_to_string(const NMPlatformLnkBond *lnk, char *buf, gsize len);
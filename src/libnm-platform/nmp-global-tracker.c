@@ -43,6 +43,12 @@
  *
  * NMPGlobalTracker can not only track whether an object should be present,
  * it also can track whether it should be absent. See track_priority_present.
+ *
+ * With many tracked objects (thousands of policy routing rules), walking all
+ * of them on every sync() is expensive. Therefore, each object whose tracking
+ * changes, or that changes in platform, gets queued in sync_lst_heads. sync()
+ * then only looks at the queued objects. Objects that are not tracked are
+ * ignored by sync() anyway, so that is all it needs to consider.
  */
 
 /*****************************************************************************/
@@ -53,7 +59,12 @@ struct _NMPGlobalTracker {
     GHashTable *by_user_tag;
     GHashTable *by_data;
     CList       by_obj_lst_heads[4];
-    guint       ref_count;
+
+    /* The objects that nmp_global_tracker_sync() needs to look at. Only for
+     * routes and routing rules, MPTCP addresses are always synced fully. */
+    CList sync_lst_heads[3];
+
+    guint ref_count;
 };
 
 /*****************************************************************************/
@@ -126,6 +137,9 @@ typedef struct {
 
     CList by_obj_lst;
 
+    /* Linked in sync_lst_heads while the object needs to be synced. */
+    CList sync_lst;
+
     /* indicates whether we configured/removed the object (during sync()). We need that, so
      * if the object gets untracked, that we know to remove/restore it.
      *
@@ -153,25 +167,47 @@ static void _track_data_untrack(NMPGlobalTracker *self,
 
 /*****************************************************************************/
 
-static CList *
-_by_obj_lst_head(NMPGlobalTracker *self, NMPObjectType obj_type)
+static int
+_obj_type_to_idx(NMPObjectType obj_type)
 {
-    G_STATIC_ASSERT(G_N_ELEMENTS(self->by_obj_lst_heads) == 4);
-
     switch (obj_type) {
     case NMP_OBJECT_TYPE_IP4_ROUTE:
-        return &self->by_obj_lst_heads[0];
+        return 0;
     case NMP_OBJECT_TYPE_IP6_ROUTE:
-        return &self->by_obj_lst_heads[1];
+        return 1;
     case NMP_OBJECT_TYPE_ROUTING_RULE:
-        return &self->by_obj_lst_heads[2];
+        return 2;
     case NMP_OBJECT_TYPE_MPTCP_ADDR:
-        return &self->by_obj_lst_heads[3];
+        return 3;
     default:
-        return nm_assert_unreachable_val(NULL);
+        return -1;
     }
 }
 
+static CList *
+_by_obj_lst_head(NMPGlobalTracker *self, NMPObjectType obj_type)
+{
+    const int idx = _obj_type_to_idx(obj_type);
+
+    G_STATIC_ASSERT(G_N_ELEMENTS(self->by_obj_lst_heads) == 4);
+
+    if (idx < 0)
+        return nm_assert_unreachable_val(NULL);
+    return &self->by_obj_lst_heads[idx];
+}
+
+static CList *
+_sync_lst_head(NMPGlobalTracker *self, NMPObjectType obj_type)
+{
+    const int idx = _obj_type_to_idx(obj_type);
+
+    G_STATIC_ASSERT(G_N_ELEMENTS(self->sync_lst_heads) == 3);
+
+    if (idx < 0 || idx >= (int) G_N_ELEMENTS(self->sync_lst_heads))
+        return NULL;
+    return &self->sync_lst_heads[idx];
+}
+
 /*****************************************************************************/
 
 static void
@@ -289,6 +325,19 @@ _track_obj_data_equal(gconstpointer data_a, gconstpointer data_b)
     return nmp_object_id_equal(obj_data_a->obj, obj_data_b->obj);
 }
 
+static void
+_track_obj_data_queue_sync(NMPGlobalTracker *self, TrackObjData *obj_data)
+{
+    CList *sync_lst_head;
+
+    if (c_list_is_linked(&obj_data->sync_lst))
+        return;
+
+    sync_lst_head = _sync_lst_head(self, NMP_OBJECT_GET_TYPE(obj_data->obj));
+    if (sync_lst_head)
+        c_list_link_tail(sync_lst_head, &obj_data->sync_lst);
+}
+
 static void
 _track_obj_data_destroy(gpointer data)
 {
@@ -296,6 +345,7 @@ _track_obj_data_destroy(gpointer data)
 
     c_list_unlink_stale(&obj_data->obj_lst_head);
     c_list_unlink_stale(&obj_data->by_obj_lst);
+    c_list_unlink(&obj_data->sync_lst);
     nmp_object_unref(obj_data->obj);
     nm_g_slice_free(obj_data);
 }
@@ -438,6 +488,7 @@ nmp_global_tracker_track(NMPGlobalTracker *self,
             *obj_data = (TrackObjData) {
                 .obj          = nmp_object_ref(track_data->obj),
                 .obj_lst_head = C_LIST_INIT(obj_data->obj_lst_head),
+                .sync_lst     = C_LIST_INIT(obj_data->sync_lst),
                 .config_state = CONFIG_STATE_NONE,
             };
             g_hash_table_add(self->by_obj, obj_data);
@@ -484,6 +535,8 @@ nmp_global_tracker_track(NMPGlobalTracker *self,
     if (changed) {
         char sbuf[NM_UTILS_TO_STRING_BUFFER_SIZE];
 
+        _track_obj_data_queue_sync(self, g_hash_table_lookup(self->by_obj, &track_data->obj));
+
         _LOGD(
             "track [" NM_HASH_OBFUSCATE_PTR_FMT ",%s%u] %s \"%s\"",
             NM_HASH_OBFUSCATE_PTR(track_data->user_tag),
@@ -534,6 +587,8 @@ _track_data_untrack(NMPGlobalTracker *self,
     nm_assert(c_list_contains(&obj_data->obj_lst_head, &track_data->obj_lst));
     nm_assert(obj_data == g_hash_table_lookup(self->by_obj, &track_data->obj));
 
+    _track_obj_data_queue_sync(self, obj_data);
+
     if (make_owned_by_us) {
         if (obj_data->config_state == CONFIG_STATE_NONE) {
             /* we need to mark this entry that it requires a touch on the next
@@ -963,12 +1018,13 @@ void
 nmp_global_tracker_sync(NMPGlobalTracker *self, NMPObjectType obj_type, gboolean keep_deleted)
 {
     char                         sbuf[NM_UTILS_TO_STRING_BUFFER_SIZE];
-    const NMDedupMultiHeadEntry *pl_head_entry;
     const NMPObject             *plobj;
     gs_unref_ptrarray GPtrArray *objs_to_delete = NULL;
+    gs_unref_ptrarray GPtrArray *objs_to_add    = NULL;
+    gs_unref_ptrarray GPtrArray *objs_kept      = NULL;
     TrackObjData                *obj_data;
     TrackObjData                *obj_data_safe;
-    CList                       *by_obj_lst_head;
+    CList                        sync_lst_head;
     guint                        i;
     const TrackData             *td_best;
 
@@ -978,71 +1034,73 @@ nmp_global_tracker_sync(NMPGlobalTracker *self, NMPObjectType obj_type, gboolean
                                NMP_OBJECT_TYPE_IP6_ROUTE,
                                NMP_OBJECT_TYPE_ROUTING_RULE));
 
-    _LOGD("sync %s%s",
-          nmp_class_from_type(obj_type)->obj_type_name,
-          keep_deleted ? " (don't remove any)" : "");
+    /* Take the queued objects. Objects that change in platform while we
+     * sync get queued again, for the next sync. */
+    c_list_init(&sync_lst_head);
+    c_list_splice(&sync_lst_head, _sync_lst_head(self, obj_type));
 
-    if (obj_type == NMP_OBJECT_TYPE_ROUTING_RULE)
-        pl_head_entry = nm_platform_lookup_obj_type(self->platform, obj_type);
-    else
-        pl_head_entry = nm_platform_lookup_object(self->platform, obj_type, 0);
+    _LOGD("sync %s%s (%zu queued)",
+          nmp_class_from_type(obj_type)->obj_type_name,
+          keep_deleted ? " (don't remove any)" : "",
+          c_list_length(&sync_lst_head));
 
-    if (pl_head_entry) {
-        NMDedupMultiIter pl_iter;
+    /* First, find the objects in platform that we need to delete. */
+    c_list_for_each_entry (obj_data, &sync_lst_head, sync_lst) {
+        nm_assert(NMP_OBJECT_GET_TYPE(obj_data->obj) == obj_type);
 
-        nmp_cache_iter_for_each (&pl_iter, pl_head_entry, &plobj) {
-            obj_data = g_hash_table_lookup(self->by_obj, &plobj);
+        plobj =
+            nm_platform_lookup_obj(self->platform, NMP_CACHE_ID_TYPE_OBJECT_TYPE, obj_data->obj);
+        if (!plobj)
+            continue;
 
-            if (!obj_data) {
-                /* this obj is not tracked. It was externally added, hence we
-                 * ignore it. */
+        td_best = _track_obj_data_get_best_data(obj_data);
+        if (td_best) {
+            if (td_best->track_priority_present) {
+                if (obj_data->config_state == CONFIG_STATE_OWNED_BY_US)
+                    obj_data->config_state = CONFIG_STATE_ADDED_BY_US;
                 continue;
             }
-
-            td_best = _track_obj_data_get_best_data(obj_data);
-            if (td_best) {
-                if (td_best->track_priority_present) {
-                    if (obj_data->config_state == CONFIG_STATE_OWNED_BY_US)
-                        obj_data->config_state = CONFIG_STATE_ADDED_BY_US;
+            if (td_best->track_priority_val == 0) {
+                if (!NM_IN_SET(obj_data->config_state,
+                               CONFIG_STATE_ADDED_BY_US,
+                               CONFIG_STATE_OWNED_BY_US)) {
+                    obj_data->config_state = CONFIG_STATE_NONE;
                     continue;
                 }
-                if (td_best->track_priority_val == 0) {
-                    if (!NM_IN_SET(obj_data->config_state,
-                                   CONFIG_STATE_ADDED_BY_US,
-                                   CONFIG_STATE_OWNED_BY_US)) {
-                        obj_data->config_state = CONFIG_STATE_NONE;
-                        continue;
-                    }
+                if (!keep_deleted)
                     obj_data->config_state = CONFIG_STATE_NONE;
-                }
             }
+        }
 
-            if (keep_deleted) {
+        if (keep_deleted) {
+            if (!td_best) {
                 _LOGD("forget/leak object added by us: %s \"%s\"",
                       NMP_OBJECT_GET_CLASS(plobj)->obj_type_name,
                       nmp_object_to_string(plobj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof(sbuf)));
                 continue;
             }
 
-            if (!objs_to_delete)
-                objs_to_delete = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
-
-            g_ptr_array_add(objs_to_delete, (gpointer) nmp_object_ref(plobj));
-
-            obj_data->config_state = CONFIG_STATE_REMOVED_BY_US;
+            /* The object is still tracked (as absent). Keep it queued, so
+             * that the next sync without @keep_deleted removes it. */
+            _LOGD("keep object for now: %s \"%s\"",
+                  NMP_OBJECT_GET_CLASS(plobj)->obj_type_name,
+                  nmp_object_to_string(plobj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof(sbuf)));
+            if (!objs_kept)
+                objs_kept = g_ptr_array_new();
+            g_ptr_array_add(objs_kept, obj_data);
+            continue;
         }
-    }
 
-    if (objs_to_delete) {
-        for (i = 0; i < objs_to_delete->len; i++)
-            nm_platform_object_delete(self->platform, objs_to_delete->pdata[i]);
-    }
+        if (!objs_to_delete)
+            objs_to_delete = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
 
-    by_obj_lst_head = _by_obj_lst_head(self, obj_type);
+        g_ptr_array_add(objs_to_delete, (gpointer) nmp_object_ref(plobj));
 
-    c_list_for_each_entry_safe (obj_data, obj_data_safe, by_obj_lst_head, by_obj_lst) {
-        nm_assert(NMP_OBJECT_GET_TYPE(obj_data->obj) == obj_type);
+        obj_data->config_state = CONFIG_STATE_REMOVED_BY_US;
+    }
 
+    /* Then, find the objects that we need to add. */
+    c_list_for_each_entry_safe (obj_data, obj_data_safe, &sync_lst_head, sync_lst) {
         td_best = _track_obj_data_get_best_data(obj_data);
 
         if (!td_best) {
@@ -1092,17 +1150,54 @@ nmp_global_tracker_sync(NMPGlobalTracker *self, NMPObjectType obj_type, gboolean
             }
             if (c == 0)
                 continue;
-            nm_platform_object_delete(self->platform, plobj);
+
+            if (!objs_to_delete)
+                objs_to_delete = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+            g_ptr_array_add(objs_to_delete, (gpointer) nmp_object_ref(plobj));
         }
 
         obj_data->config_state = CONFIG_STATE_ADDED_BY_US;
 
-        if (obj_type == NMP_OBJECT_TYPE_ROUTING_RULE) {
-            nm_platform_routing_rule_add(self->platform,
-                                         NMP_NLM_FLAG_ADD,
-                                         NMP_OBJECT_CAST_ROUTING_RULE(obj_data->obj));
-        } else
-            nm_platform_ip_route_add(self->platform, NMP_NLM_FLAG_APPEND, obj_data->obj, NULL);
+        if (!objs_to_add)
+            objs_to_add = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+        g_ptr_array_add(objs_to_add, (gpointer) nmp_object_ref(obj_data->obj));
+    }
+
+    c_list_flush(&sync_lst_head);
+
+    if (objs_kept) {
+        for (i = 0; i < objs_kept->len; i++)
+            _track_obj_data_queue_sync(self, objs_kept->pdata[i]);
+    }
+
+    if (obj_type == NMP_OBJECT_TYPE_ROUTING_RULE)
+        nm_platform_routing_rule_batch(self->platform, objs_to_delete, objs_to_add);
+    else {
+        if (objs_to_delete) {
+            for (i = 0; i < objs_to_delete->len; i++)
+                nm_platform_object_delete(self->platform, objs_to_delete->pdata[i]);
+        }
+        if (objs_to_add) {
+            for (i = 0; i < objs_to_add->len; i++)
+                nm_platform_ip_route_add(self->platform,
+                                         NMP_NLM_FLAG_APPEND,
+                                         objs_to_add->pdata[i],
+                                         NULL);
+        }
+    }
+
+    if (objs_to_add) {
+        /* Objects that we failed to add stay queued, so that the next sync
+         * retries them. */
+        for (i = 0; i < objs_to_add->len; i++) {
+            const NMPObject *obj = objs_to_add->pdata[i];
+
+            if (nm_platform_lookup_obj(self->platform, NMP_CACHE_ID_TYPE_OBJECT_TYPE, obj))
+                continue;
+            obj_data = g_hash_table_lookup(self->by_obj, &obj);
+            if (obj_data)
+                _track_obj_data_queue_sync(self, obj_data);
+        }
     }
 }
 
@@ -1237,6 +1332,30 @@ nmp_global_tracker_track_local_rule(NMPGlobalTracker *self,
 
 /*****************************************************************************/
 
+static void
+_platform_changed_cb(NMPlatform             *platform,
+                     int                     obj_type_i,
+                     int                     ifindex,
+                     const NMPlatformObject *plobj,
+                     int                     change_type_i,
+                     NMPGlobalTracker       *self)
+{
+    const NMPObject *obj = NMP_OBJECT_UP_CAST(plobj);
+    TrackObjData    *obj_data;
+
+    /* We only track routes without ifindex. */
+    if (ifindex != 0)
+        return;
+
+    /* If a tracked object was changed (possibly externally), the next sync
+     * needs to look at it. Untracked objects are ignored by sync anyway. */
+    obj_data = g_hash_table_lookup(self->by_obj, &obj);
+    if (obj_data)
+        _track_obj_data_queue_sync(self, obj_data);
+}
+
+/*****************************************************************************/
+
 NMPGlobalTracker *
 nmp_global_tracker_new(NMPlatform *platform)
 {
@@ -1264,7 +1383,23 @@ nmp_global_tracker_new(NMPlatform *platform)
         .by_obj_lst_heads[1] = C_LIST_INIT(self->by_obj_lst_heads[1]),
         .by_obj_lst_heads[2] = C_LIST_INIT(self->by_obj_lst_heads[2]),
         .by_obj_lst_heads[3] = C_LIST_INIT(self->by_obj_lst_heads[3]),
+        .sync_lst_heads[0]   = C_LIST_INIT(self->sync_lst_heads[0]),
+        .sync_lst_heads[1]   = C_LIST_INIT(self->sync_lst_heads[1]),
+        .sync_lst_heads[2]   = C_LIST_INIT(self->sync_lst_heads[2]),
     };
+
+    g_signal_connect(platform,
+                     NM_PLATFORM_SIGNAL_ROUTING_RULE_CHANGED,
+                     G_CALLBACK(_platform_changed_cb),
+                     self);
+    g_signal_connect(platform,
+                     NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED,
+                     G_CALLBACK(_platform_changed_cb),
+                     self);
+    g_signal_connect(platform,
+                     NM_PLATFORM_SIGNAL_IP6_ROUTE_CHANGED,
+                     G_CALLBACK(_platform_changed_cb),
+                     self);
     return self;
 }
 
@@ -1285,6 +1420,7 @@ nmp_global_tracker_unref(NMPGlobalTracker *self)
     if (--self->ref_count > 0)
         return;
 
+    g_signal_handlers_disconnect_by_func(self->platform, G_CALLBACK(_platform_changed_cb), self);
     g_hash_table_destroy(self->by_user_tag);
     g_hash_table_destroy(self->by_obj);
     g_hash_table_destroy(self->by_data);
@@ -1292,6 +1428,9 @@ nmp_global_tracker_unref(NMPGlobalTracker *self)
     nm_assert(c_list_is_empty(&self->by_obj_lst_heads[1]));
     nm_assert(c_list_is_empty(&self->by_obj_lst_heads[2]));
     nm_assert(c_list_is_empty(&self->by_obj_lst_heads[3]));
+    nm_assert(c_list_is_empty(&self->sync_lst_heads[0]));
+    nm_assert(c_list_is_empty(&self->sync_lst_heads[1]));
+    nm_assert(c_list_is_empty(&self->sync_lst_heads[2]));
     g_object_unref(self->platform);
     nm_g_slice_free(self);
 }
@@ -13,6 +13,7 @@
 #include <libudev.h>
 
 #include "libnm-glib-aux/nm-secret-utils.h"
+#include "libnm-glib-aux/nm-slab.h"
 #include "libnm-platform/nm-platform-utils.h"
 #include "libnm-platform/wifi/nm-wifi-utils.h"
 #include "libnm-platform/wpan/nm-wpan-utils.h"
@@ -288,7 +289,8 @@ _idx_obj_id_hash_update(const NMDedupMultiIdxType *idx_type,
     nm_assert(idx_type && idx_type->klass == &_dedup_multi_idx_type_class);
     nm_assert(NMP_OBJECT_GET_TYPE(o) != NMP_OBJECT_TYPE_UNKNOWN);
 
-    nmp_object_id_hash_update(o, h);
+    /* Hash the (possibly cached) ID hash instead of the ID fields. */
+    nm_hash_update_val(h, nmp_object_id_hash(o));
 }
 
 static gboolean
@@ -778,12 +780,70 @@ _NMP_OBJECT_STRUCT_SIZE(const NMPClass *klass)
     return klass->sizeof_data + G_STRUCT_OFFSET(NMPObject, object);
 }
 
+/* Addresses and routes can exist in very large numbers (for example, with
+ * full BGP tables). Allocate them from type-segregated slabs, to avoid the
+ * per-allocation overhead and fragmentation of the heap. */
+#define _NMP_OBJECT_SLAB_INIT(type) NM_SLAB_INIT(sizeof(type) + G_STRUCT_OFFSET(NMPObject, object))
+
+static NMSlab _nmp_object_slab_ip4_address = _NMP_OBJECT_SLAB_INIT(NMPObjectIP4Address);
+static NMSlab _nmp_object_slab_ip6_address = _NMP_OBJECT_SLAB_INIT(NMPObjectIP6Address);
+static NMSlab _nmp_object_slab_ip4_route   = _NMP_OBJECT_SLAB_INIT(NMPObjectIP4Route);
+static NMSlab _nmp_object_slab_ip6_route   = _NMP_OBJECT_SLAB_INIT(NMPObjectIP6Route);
+
+static NMSlab *
+_nmp_object_slab_get(NMPObjectType obj_type)
+{
+    switch (obj_type) {
+    case NMP_OBJECT_TYPE_IP4_ADDRESS:
+        return &_nmp_object_slab_ip4_address;
+    case NMP_OBJECT_TYPE_IP6_ADDRESS:
+        return &_nmp_object_slab_ip6_address;
+    case NMP_OBJECT_TYPE_IP4_ROUTE:
+        return &_nmp_object_slab_ip4_route;
+    case NMP_OBJECT_TYPE_IP6_ROUTE:
+        return &_nmp_object_slab_ip6_route;
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * nmp_object_slab_trim:
+ *
+ * Release the memory of empty slabs. Call this after a large number of
+ * addresses or routes were removed from the cache.
+ */
+void
+nmp_object_slab_trim(void)
+{
+    nm_slab_trim(&_nmp_object_slab_ip4_address);
+    nm_slab_trim(&_nmp_object_slab_ip6_address);
+    nm_slab_trim(&_nmp_object_slab_ip4_route);
+    nm_slab_trim(&_nmp_object_slab_ip6_route);
+}
+
+gboolean
+nmp_object_slab_get_stats(NMPObjectType obj_type, NMSlabStats *out_stats)
+{
+    NMSlab *slab = _nmp_object_slab_get(obj_type);
+
+    if (!slab)
+        return FALSE;
+    nm_slab_get_stats(slab, out_stats);
+    return TRUE;
+}
+
 static NMPObject *
 _nmp_object_new_from_class(const NMPClass *klass)
 {
     NMPObject *obj;
+    NMSlab    *slab;
 
-    obj                    = g_slice_alloc0(_NMP_OBJECT_STRUCT_SIZE(klass));
+    slab = _nmp_object_slab_get(klass->obj_type);
+    if (slab)
+        obj = nm_slab_alloc0(slab);
+    else
+        obj = g_slice_alloc0(_NMP_OBJECT_STRUCT_SIZE(klass));
     obj->_class            = klass;
     obj->parent._ref_count = 1;
     return obj;
@@ -1481,6 +1541,8 @@ nmp_object_copy(NMPObject *dst, const NMPObject *src, gboolean id_only)
 
         g_return_if_fail(klass == NMP_OBJECT_GET_CLASS(src));
 
+        dst->parent._id_hash = 0;
+
         if (id_only && klass->cmd_plobj_id_copy)
             klass->cmd_plobj_id_copy(&dst->object, &src->object);
         else if (klass->cmd_obj_copy)
@@ -1724,17 +1786,40 @@ _vt_cmd_plobj_id_cmp(mptcp_addr, NMPlatformMptcpAddr, {
     NM_CMP_FIELD(obj1, obj2, port);
 });
 
+static guint
+_nmp_object_id_hash_compute(const NMPObject *obj)
+{
+    NMHashState h;
+
+    nm_hash_init(&h, 914932607u);
+    nmp_object_id_hash_update(obj, &h);
+    return nm_hash_complete(&h);
+}
+
 guint
 nmp_object_id_hash(const NMPObject *obj)
 {
-    NMHashState h;
+    guint hash;
 
     if (!obj)
         return nm_hash_static(914932607u);
 
-    nm_hash_init(&h, 914932607u);
-    nmp_object_id_hash_update(obj, &h);
-    return nm_hash_complete(&h);
+    if (obj->parent._id_hash != 0) {
+#if NM_MORE_ASSERTS > 5
+        nm_assert(obj->parent._id_hash == _nmp_object_id_hash_compute(obj));
+#endif
+        return obj->parent._id_hash;
+    }
+
+    hash = _nmp_object_id_hash_compute(obj);
+
+    /* Objects that are interned in a NMDedupMultiIndex are immutable. The same
+     * object gets hashed over and over (by the NMPCache, by the indexes of the
+     * NML3ConfigData and by NMPGlobalTracker), so remember the hash. */
+    if (obj->parent._multi_idx)
+        ((NMPObject *) obj)->parent._id_hash = hash;
+
+    return hash;
 }
 
 #define _vt_cmd_plobj_id_hash_update(type, plat_type, cmd)                                        \
@@ -1984,6 +2069,7 @@ _vt_dedup_obj_destroy(NMDedupMultiObj *obj)
 {
     NMPObject      *o = (NMPObject *) obj;
     const NMPClass *klass;
+    NMSlab         *slab;
 
     nm_assert(o->parent._ref_count == 0);
     nm_assert(!o->parent._multi_idx);
@@ -1991,7 +2077,11 @@ _vt_dedup_obj_destroy(NMDedupMultiObj *obj)
     klass = o->_class;
     if (klass->cmd_obj_dispose)
         klass->cmd_obj_dispose(o);
-    g_slice_free1(_NMP_OBJECT_STRUCT_SIZE(klass), o);
+    slab = _nmp_object_slab_get(klass->obj_type);
+    if (slab)
+        nm_slab_free(slab, o);
+    else
+        g_slice_free1(_NMP_OBJECT_STRUCT_SIZE(klass), o);
 }
 
 static const NMDedupMultiObj *
@@ -3228,6 +3318,51 @@ nmp_cache_update_link_controller_connected(NMPCache         *cache,
     return NMP_CACHE_OPS_UPDATED;
 }
 
+NMPCacheOpsType
+nmp_cache_update_link_stats(NMPCache         *cache,
+                            int               ifindex,
+                            guint64           rx_packets,
+                            guint64           rx_bytes,
+                            guint64           tx_packets,
+                            guint64           tx_bytes,
+                            const NMPObject **out_obj_old,
+                            const NMPObject **out_obj_new)
+{
+    const NMDedupMultiEntry  *entry_old;
+    const NMDedupMultiEntry  *entry_new = NULL;
+    const NMPObject          *obj_old;
+    nm_auto_nmpobj NMPObject *obj_new = NULL;
+
+    entry_old = nmp_cache_lookup_entry_link(cache, ifindex);
+
+    if (!entry_old) {
+        NM_SET_OUT(out_obj_old, NULL);
+        NM_SET_OUT(out_obj_new, NULL);
+        return NMP_CACHE_OPS_UNCHANGED;
+    }
+
+    obj_old = entry_old->obj;
+
+    if (!obj_old->_link.netlink.is_in_netlink
+        || (obj_old->link.rx_packets == rx_packets && obj_old->link.rx_bytes == rx_bytes
+            && obj_old->link.tx_packets == tx_packets && obj_old->link.tx_bytes == tx_bytes)) {
+        NM_SET_OUT(out_obj_old, nmp_object_ref(obj_old));
+        NM_SET_OUT(out_obj_new, nmp_object_ref(obj_old));
+        return NMP_CACHE_OPS_UNCHANGED;
+    }
+
+    obj_new                  = nmp_object_clone(obj_old, FALSE);
+    obj_new->link.rx_packets = rx_packets;
+    obj_new->link.rx_bytes   = rx_bytes;
+    obj_new->link.tx_packets = tx_packets;
+    obj_new->link.tx_bytes   = tx_bytes;
+
+    NM_SET_OUT(out_obj_old, nmp_object_ref(obj_old));
+    _idxcache_update(cache, entry_old, obj_new, FALSE, &entry_new);
+    NM_SET_OUT(out_obj_new, nmp_object_ref(entry_new->obj));
+    return NMP_CACHE_OPS_UPDATED;
+}
+
 /*****************************************************************************/
 
 void
@@ -10,6 +10,7 @@
 
 #include "libnm-glib-aux/nm-obj.h"
 #include "libnm-glib-aux/nm-dedup-multi.h"
+#include "libnm-glib-aux/nm-slab.h"
 #include "nm-platform.h"
 
 struct udev_device;
@@ -828,6 +829,11 @@ guint nmp_object_id_hash(const NMPObject *obj);
 static inline gboolean
 nmp_object_id_equal(const NMPObject *obj1, const NMPObject *obj2)
 {
+    if (obj1 && obj2 && obj1->parent._id_hash != 0 && obj2->parent._id_hash != 0
+        && obj1->parent._id_hash != obj2->parent._id_hash) {
+        /* Both objects have their ID hash cached, and it differs. */
+        return FALSE;
+    }
     return nmp_object_id_cmp(obj1, obj2) == 0;
 }
 
@@ -1006,6 +1012,14 @@ NMPCacheOpsType nmp_cache_update_link_controller_connected(NMPCache         *cac
                                                            int               ifindex,
                                                            const NMPObject **out_obj_old,
                                                            const NMPObject **out_obj_new);
+NMPCacheOpsType nmp_cache_update_link_stats(NMPCache         *cache,
+                                            int               ifindex,
+                                            guint64           rx_packets,
+                                            guint64           rx_bytes,
+                                            guint64           tx_packets,
+                                            guint64           tx_bytes,
+                                            const NMPObject **out_obj_old,
+                                            const NMPObject **out_obj_new);
 
 static inline const NMDedupMultiEntry *
 nmp_cache_reresolve_main_entry(NMPCache                *cache,
@@ -1038,6 +1052,9 @@ void nmp_cache_dirty_set_all_main(NMPCache *cache, const NMPLookup *lookup);
 NMPCache *nmp_cache_new(NMDedupMultiIndex *multi_idx, gboolean use_udev);
 void      nmp_cache_free(NMPCache *cache);
 
+void     nmp_object_slab_trim(void);
+gboolean nmp_object_slab_get_stats(NMPObjectType obj_type, NMSlabStats *out_stats);
+
 static inline void
 ASSERT_nmp_cache_ops(const NMPCache  *cache,
                      NMPCacheOpsType  ops_type,
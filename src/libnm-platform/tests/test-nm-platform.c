@@ -351,6 +351,172 @@ test_nmp_utils_bridge_vlans_normalize(void)
     g_assert(nmp_utils_bridge_normalized_vlans_equal(vlans, vlans_len, expect, vlans_len));
 }
 
+static void
+test_nmp_utils_bridge_vlan_diff(void)
+{
+    gs_free NMPlatformBridgeVlan *vlans_del = NULL;
+    gs_free NMPlatformBridgeVlan *vlans_add = NULL;
+    NMPlatformBridgeVlan          vlans_old[10];
+    NMPlatformBridgeVlan          vlans_new[10];
+    NMPlatformBridgeVlan          expect[10];
+    guint                         num_del;
+    guint                         num_add;
+    guint                         i;
+
+    /* Equal sets give no difference, even if not normalized */
+    vlans_old[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 1,
+        .vid_end   = 4094,
+    };
+    vlans_new[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 1,
+        .vid_end   = 100,
+    };
+    vlans_new[1] = (NMPlatformBridgeVlan) {
+        .vid_start = 101,
+        .vid_end   = 4094,
+    };
+    nmp_utils_bridge_vlan_diff(vlans_old,
+                               1,
+                               vlans_new,
+                               2,
+                               &vlans_del,
+                               &num_del,
+                               &vlans_add,
+                               &num_add);
+    g_assert_cmpuint(num_del, ==, 0);
+    g_assert_cmpuint(num_add, ==, 0);
+    g_assert(!vlans_del);
+    g_assert(!vlans_add);
+
+    /* Removed VLANs are deleted, new VLANs and VLANs with changed flags are
+     * added. Contiguous VLANs are merged, except the PVID. */
+    vlans_old[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 1,
+        .vid_end   = 1,
+        .untagged  = TRUE,
+        .pvid      = TRUE,
+    };
+    vlans_old[1] = (NMPlatformBridgeVlan) {
+        .vid_start = 10,
+        .vid_end   = 20,
+    };
+    vlans_old[2] = (NMPlatformBridgeVlan) {
+        .vid_start = 30,
+        .vid_end   = 30,
+    };
+    vlans_new[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 1,
+        .vid_end   = 1,
+        .untagged  = TRUE,
+    };
+    vlans_new[1] = (NMPlatformBridgeVlan) {
+        .vid_start = 2,
+        .vid_end   = 2,
+        .untagged  = TRUE,
+        .pvid      = TRUE,
+    };
+    vlans_new[2] = (NMPlatformBridgeVlan) {
+        .vid_start = 3,
+        .vid_end   = 5,
+        .untagged  = TRUE,
+    };
+    vlans_new[3] = (NMPlatformBridgeVlan) {
+        .vid_start = 12,
+        .vid_end   = 15,
+    };
+    vlans_new[4] = (NMPlatformBridgeVlan) {
+        .vid_start = 16,
+        .vid_end   = 16,
+        .untagged  = TRUE,
+    };
+    nm_clear_g_free(&vlans_del);
+    nm_clear_g_free(&vlans_add);
+    nmp_utils_bridge_vlan_diff(vlans_old,
+                               3,
+                               vlans_new,
+                               5,
+                               &vlans_del,
+                               &num_del,
+                               &vlans_add,
+                               &num_add);
+
+    expect[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 10,
+        .vid_end   = 11,
+    };
+    expect[1] = (NMPlatformBridgeVlan) {
+        .vid_start = 17,
+        .vid_end   = 20,
+    };
+    expect[2] = (NMPlatformBridgeVlan) {
+        .vid_start = 30,
+        .vid_end   = 30,
+    };
+    g_assert_cmpuint(num_del, ==, 3);
+    g_assert(nmp_utils_bridge_normalized_vlans_equal(vlans_del, num_del, expect, num_del));
+
+    expect[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 1,
+        .vid_end   = 1,
+        .untagged  = TRUE,
+    };
+    expect[1] = (NMPlatformBridgeVlan) {
+        .vid_start = 2,
+        .vid_end   = 2,
+        .untagged  = TRUE,
+        .pvid      = TRUE,
+    };
+    expect[2] = (NMPlatformBridgeVlan) {
+        .vid_start = 3,
+        .vid_end   = 5,
+        .untagged  = TRUE,
+    };
+    expect[3] = (NMPlatformBridgeVlan) {
+        .vid_start = 16,
+        .vid_end   = 16,
+        .untagged  = TRUE,
+    };
+    g_assert_cmpuint(num_add, ==, 4);
+    g_assert(nmp_utils_bridge_normalized_vlans_equal(vlans_add, num_add, expect, num_add));
+
+    /* All VLANs as single entries are added as one range */
+    nm_clear_g_free(&vlans_del);
+    nm_clear_g_free(&vlans_add);
+    nmp_utils_bridge_vlan_diff(NULL, 0, NULL, 0, &vlans_del, &num_del, &vlans_add, &num_add);
+    g_assert_cmpuint(num_del, ==, 0);
+    g_assert_cmpuint(num_add, ==, 0);
+    {
+        gs_free NMPlatformBridgeVlan *vlans_all = g_new(NMPlatformBridgeVlan, 4094);
+
+        for (i = 0; i < 4094; i++) {
+            vlans_all[i] = (NMPlatformBridgeVlan) {
+                .vid_start = 4094 - i,
+                .vid_end   = 4094 - i,
+            };
+        }
+        nmp_utils_bridge_vlan_diff(NULL,
+                                   0,
+                                   vlans_all,
+                                   4094,
+                                   &vlans_del,
+                                   &num_del,
+                                   &vlans_add,
+                                   &num_add);
+        g_assert_cmpuint(num_del, ==, 0);
+        g_assert_cmpuint(num_add, ==, 1);
+        g_assert_cmpuint(vlans_add[0].vid_start, ==, 1);
+        g_assert_cmpuint(vlans_add[0].vid_end, ==, 4094);
+
+        /* ... and normalized into one range as well. */
+        i = 4094;
+        nmp_utils_bridge_vlan_normalize(vlans_all, &i);
+        g_assert_cmpuint(i, ==, 1);
+        g_assert_cmpuint(vlans_all[0].vid_start, ==, 1);
+        g_assert_cmpuint(vlans_all[0].vid_end, ==, 4094);
+    }
+}
+
 static void
 test_nmp_utils_bridge_normalized_vlans_equal(void)
 {
@@ -474,6 +640,124 @@ test_nmpclass_consistency(void)
 
 /*****************************************************************************/
 
+static void
+test_nmp_object_slab(void)
+{
+    const guint                  N    = 20000u + (nmtst_get_rand_uint32() % 20000u);
+    gs_unref_ptrarray GPtrArray *objs = NULL;
+    NMSlabStats                  stats0;
+    NMSlabStats                  stats;
+    guint                        i;
+
+    /* Measure the memory used for IPv4 routes in the slab allocator,
+     * compared to allocating each object individually. */
+
+    nmp_object_slab_trim();
+    g_assert(nmp_object_slab_get_stats(NMP_OBJECT_TYPE_IP4_ROUTE, &stats0));
+    g_assert(!nmp_object_slab_get_stats(NMP_OBJECT_TYPE_LINK, &stats));
+
+    objs = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    for (i = 0; i < N; i++) {
+        const NMPlatformIP4Route r = {
+            .ifindex   = 1 + (i % 7),
+            .network   = htonl(0x0a000000u + (i << 8)),
+            .plen      = 24,
+            .metric    = i,
+            .rt_source = NM_IP_CONFIG_SOURCE_USER,
+        };
+        NMPObject *obj;
+
+        obj = nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, &r);
+        g_assert(obj);
+        g_assert(NMP_OBJECT_CAST_IP4_ROUTE(obj)->metric == i);
+        g_assert(!NMP_OBJECT_CAST_IP4_ROUTE(obj)->extra_nexthops);
+        g_ptr_array_add(objs, obj);
+    }
+
+    g_assert(nmp_object_slab_get_stats(NMP_OBJECT_TYPE_IP4_ROUTE, &stats));
+    g_assert_cmpuint(stats.n_chunks, ==, stats0.n_chunks + N);
+    g_assert_cmpuint(stats.n_slabs, >, 0);
+
+    g_test_message("slab: %u routes of %zu bytes use %u slabs (%zu KiB, %.1f bytes/route). With "
+                   "malloc, each route needs at least %zu bytes.",
+                   N,
+                   stats.chunk_size,
+                   stats.n_slabs,
+                   (stats.n_slabs * NM_SLAB_SIZE) / 1024u,
+                   ((double) (stats.n_slabs * NM_SLAB_SIZE)) / ((double) stats.n_chunks),
+                   NM_ALIGN_TO(stats.chunk_size + sizeof(gsize), 2 * sizeof(gsize)));
+
+    /* release every other object, and then the rest. */
+    for (i = 0; i < objs->len; i += 2)
+        nm_clear_nmp_object((const NMPObject **) &objs->pdata[i]);
+    g_assert(nmp_object_slab_get_stats(NMP_OBJECT_TYPE_IP4_ROUTE, &stats));
+    g_assert_cmpuint(stats.n_chunks, ==, stats0.n_chunks + (N / 2u));
+
+    g_ptr_array_set_size(objs, 0);
+    g_assert(nmp_object_slab_get_stats(NMP_OBJECT_TYPE_IP4_ROUTE, &stats));
+    g_assert_cmpuint(stats.n_chunks, ==, stats0.n_chunks);
+    g_assert_cmpuint(stats.n_slabs_empty, <=, NM_SLAB_KEEP_EMPTY);
+
+    nmp_object_slab_trim();
+    g_assert(nmp_object_slab_get_stats(NMP_OBJECT_TYPE_IP4_ROUTE, &stats));
+    g_assert_cmpuint(stats.n_slabs_empty, ==, 0);
+    g_assert_cmpuint(stats.n_slabs, <=, stats0.n_slabs);
+}
+
+/*****************************************************************************/
+
+static void
+test_nmp_object_id_hash_cached(void)
+{
+    NMDedupMultiIndex              *multi_idx = nm_dedup_multi_index_new();
+    nm_auto_nmpobj const NMPObject *obj_a     = NULL;
+    nm_auto_nmpobj const NMPObject *obj_b     = NULL;
+    nm_auto_nmpobj const NMPObject *obj_c     = NULL;
+    nm_auto_nmpobj const NMPObject *obj_a_i   = NULL;
+    nm_auto_nmpobj const NMPObject *obj_c_i   = NULL;
+    NMPlatformIP4Route              r;
+    guint                           hash_a;
+
+    r = (NMPlatformIP4Route) {
+        .ifindex   = 5,
+        .network   = htonl(0x0a000000u),
+        .plen      = 24,
+        .metric    = 100,
+        .rt_source = NM_IP_CONFIG_SOURCE_USER,
+    };
+
+    obj_a  = nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, &r);
+    hash_a = nmp_object_id_hash(obj_a);
+
+    /* The hash is only cached for interned (immutable) objects. */
+    g_assert_cmpuint(obj_a->parent._id_hash, ==, 0);
+
+    obj_a_i = nm_dedup_multi_index_obj_intern(multi_idx, obj_a);
+    g_assert(obj_a_i == obj_a);
+    g_assert_cmpuint(nmp_object_id_hash(obj_a), ==, hash_a);
+    g_assert_cmpuint(obj_a->parent._id_hash, ==, hash_a);
+
+    obj_b = nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, &r);
+    g_assert_cmpuint(nmp_object_id_hash(obj_b), ==, hash_a);
+    g_assert(nmp_object_id_equal(obj_a, obj_b));
+
+    r.metric = 101;
+    obj_c    = nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, &r);
+    obj_c_i  = nm_dedup_multi_index_obj_intern(multi_idx, obj_c);
+    g_assert_cmpuint(nmp_object_id_hash(obj_c), !=, hash_a);
+    g_assert_cmpuint(obj_c->parent._id_hash, !=, 0);
+    g_assert(!nmp_object_id_equal(obj_a, obj_c));
+    g_assert(!nmp_object_id_equal(obj_b, obj_c));
+
+    /* When the objects are no longer interned, the cached hash is dropped. */
+    nm_dedup_multi_index_unref(multi_idx);
+    g_assert_cmpuint(obj_a->parent._id_hash, ==, 0);
+    g_assert_cmpuint(obj_c->parent._id_hash, ==, 0);
+    g_assert_cmpuint(nmp_object_id_hash(obj_a), ==, hash_a);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE();
 
 int
@@ -485,8 +769,12 @@ main(int argc, char **argv)
     g_test_add_func("/nm-platform/test_nmp_link_mode_all_advertised_modes_bits",
                     test_nmp_link_mode_all_advertised_modes_bits);
     g_test_add_func("/nm-platform/test_nmpclass_consistency", test_nmpclass_consistency);
+    g_test_add_func("/nm-platform/test_nmp_object_slab", test_nmp_object_slab);
+    g_test_add_func("/nm-platform/test_nmp_object_id_hash_cached", test_nmp_object_id_hash_cached);
     g_test_add_func("/nm-platform/test_nmp_utils_bridge_vlans_normalize",
                     test_nmp_utils_bridge_vlans_normalize);
+    g_test_add_func("/nm-platform/test_nmp_utils_bridge_vlan_diff",
+                    test_nmp_utils_bridge_vlan_diff);
     g_test_add_func("/nm-platform/nmp-utils-bridge-vlans-equal",
                     test_nmp_utils_bridge_normalized_vlans_equal);
 
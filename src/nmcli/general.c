@@ -303,16 +303,51 @@ static const NmcMetaGenericInfo
 
 /*****************************************************************************/
 
+typedef struct {
+    const char *name;
+    GVariant   *value;
+} GeneralStatsData;
+
+static gconstpointer
+_metagen_general_stats_get_fcn(NMC_META_GENERIC_INFO_GET_FCN_ARGS)
+{
+    const GeneralStatsData *d = target;
+
+    NMC_HANDLE_COLOR(NM_META_COLOR_NONE);
+
+    switch (info->info_type) {
+    case NMC_GENERIC_INFO_TYPE_GENERAL_STATS_NAME:
+        return d->name;
+    case NMC_GENERIC_INFO_TYPE_GENERAL_STATS_VALUE:
+        return (*out_to_free = g_variant_print(d->value, FALSE));
+    default:
+        break;
+    }
+
+    g_return_val_if_reached(NULL);
+}
+
+static const NmcMetaGenericInfo
+    *const metagen_general_stats[_NMC_GENERIC_INFO_TYPE_GENERAL_STATS_NUM + 1] = {
+#define _METAGEN_GENERAL_STATS(type, name) \
+    [type] = NMC_META_GENERIC(name, .info_type = type, .get_fcn = _metagen_general_stats_get_fcn)
+        _METAGEN_GENERAL_STATS(NMC_GENERIC_INFO_TYPE_GENERAL_STATS_NAME, "NAME"),
+        _METAGEN_GENERAL_STATS(NMC_GENERIC_INFO_TYPE_GENERAL_STATS_VALUE, "VALUE"),
+};
+
+/*****************************************************************************/
+
 static void
 usage_general(void)
 {
     nmc_printerr(_("Usage: nmcli general { COMMAND | help }\n\n"
-                   "COMMAND := { status | hostname | permissions | logging | reload }\n\n"
+                   "COMMAND := { status | hostname | permissions | logging | reload | stats }\n\n"
                    "  status\n\n"
                    "  hostname [<hostname>]\n\n"
                    "  permissions\n\n"
                    "  logging [level <log level>] [domains <log domains>]\n\n"
-                   "  reload [<flags>]\n\n"));
+                   "  reload [<flags>]\n\n"
+                   "  stats\n\n"));
 }
 
 static void
@@ -393,6 +428,17 @@ usage_general_logging(void)
           "for the list of possible logging domains.\n\n"));
 }
 
+static void
+usage_general_stats(void)
+{
+    nmc_printerr(_("Usage: nmcli general stats { help }\n"
+                   "\n"
+                   "Show statistics about how NetworkManager processes the netlink messages\n"
+                   "from the kernel: the number of messages per kind, the time spent parsing\n"
+                   "and handling them, buffer overflows and the duration of dumps. The\n"
+                   "values count from the start of NetworkManager.\n\n"));
+}
+
 static void
 usage_networking(void)
 {
@@ -897,6 +943,101 @@ do_general_logging(const NMCCommand *cmd, NmCli *nmc, int argc, const char *cons
     }
 }
 
+static void
+_general_stats_cb(GObject *object, GAsyncResult *result, gpointer user_data)
+{
+    NmCli                     *nmc        = user_data;
+    gs_unref_variant GVariant *res        = NULL;
+    gs_unref_variant GVariant *dict       = NULL;
+    gs_free_error GError      *error      = NULL;
+    gs_free GeneralStatsData  *rows       = NULL;
+    gs_free gpointer          *targets    = NULL;
+    const char                *fields_str = NULL;
+    GVariantIter               iter;
+    const char                *name;
+    GVariant                  *value;
+    gsize                      n;
+    gsize                      i;
+
+    res = nm_client_dbus_call_finish(NM_CLIENT(object), result, &error);
+    if (!res) {
+        g_dbus_error_strip_remote_error(error);
+        g_string_printf(nmc->return_text,
+                        _("Error: failed to get statistics: %s"),
+                        nmc_error_get_simple_message(error));
+        nmc->return_value = NMC_RESULT_ERROR_UNKNOWN;
+        quit();
+        return;
+    }
+
+    if (!nmc->required_fields || g_ascii_strcasecmp(nmc->required_fields, "common") == 0) {
+        /* pass */
+    } else if (g_ascii_strcasecmp(nmc->required_fields, "all") == 0) {
+        /* pass */
+    } else
+        fields_str = nmc->required_fields;
+
+    g_variant_get(res, "(@a{sv})", &dict);
+
+    n       = g_variant_n_children(dict);
+    rows    = g_new(GeneralStatsData, n);
+    targets = g_new(gpointer, n + 1);
+
+    i = 0;
+    g_variant_iter_init(&iter, dict);
+    while (g_variant_iter_next(&iter, "{&sv}", &name, &value)) {
+        rows[i] = (GeneralStatsData) {
+            .name  = name,
+            .value = value,
+        };
+        targets[i] = &rows[i];
+        i++;
+    }
+    targets[i] = NULL;
+
+    if (!nmc_print_table(&nmc->nmc_config,
+                         targets,
+                         NULL,
+                         _("NetworkManager statistics"),
+                         (const NMMetaAbstractInfo *const *) metagen_general_stats,
+                         fields_str,
+                         &error)) {
+        g_string_printf(nmc->return_text, _("Error: 'general stats': %s"), error->message);
+        nmc->return_value = NMC_RESULT_ERROR_USER_INPUT;
+    }
+
+    for (i = 0; i < n; i++)
+        g_variant_unref(rows[i].value);
+
+    quit();
+}
+
+static void
+do_general_stats(const NMCCommand *cmd, NmCli *nmc, int argc, const char *const *argv)
+{
+    next_arg(nmc, &argc, &argv, NULL);
+    if (nmc->complete)
+        return;
+
+    if (argc > 0) {
+        g_string_printf(nmc->return_text, _("Error: extra argument '%s'"), *argv);
+        nmc->return_value = NMC_RESULT_ERROR_USER_INPUT;
+        return;
+    }
+
+    nmc->should_wait++;
+    nm_client_dbus_call(nmc->client,
+                        NM_DBUS_PATH,
+                        NM_DBUS_INTERFACE,
+                        "GetPlatformStats",
+                        NULL,
+                        G_VARIANT_TYPE("(a{sv})"),
+                        -1,
+                        NULL,
+                        _general_stats_cb,
+                        nmc);
+}
+
 static void
 save_hostname_cb(GObject *object, GAsyncResult *result, gpointer user_data)
 {
@@ -948,6 +1089,7 @@ nmc_command_func_general(const NMCCommand *cmd, NmCli *nmc, int argc, const char
         {"permissions", do_general_permissions, usage_general_permissions, TRUE, TRUE},
         {"logging", do_general_logging, usage_general_logging, TRUE, TRUE},
         {"reload", do_general_reload, usage_general_reload, FALSE, FALSE},
+        {"stats", do_general_stats, usage_general_stats, TRUE, TRUE},
         {NULL, do_general_status, usage_general, TRUE, TRUE},
     };
 
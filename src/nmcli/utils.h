@@ -104,6 +104,10 @@ typedef enum {
     NMC_GENERIC_INFO_TYPE_GENERAL_LOGGING_DOMAINS,
     _NMC_GENERIC_INFO_TYPE_GENERAL_LOGGING_NUM,
 
+    NMC_GENERIC_INFO_TYPE_GENERAL_STATS_NAME = 0,
+    NMC_GENERIC_INFO_TYPE_GENERAL_STATS_VALUE,
+    _NMC_GENERIC_INFO_TYPE_GENERAL_STATS_NUM,
+
     NMC_GENERIC_INFO_TYPE_IP4_CONFIG_ADDRESS = 0,
     NMC_GENERIC_INFO_TYPE_IP4_CONFIG_GATEWAY,
     NMC_GENERIC_INFO_TYPE_IP4_CONFIG_ROUTE,